@@ -0,0 +1,32 @@
+﻿#include "Common.h"
+#include "AssetPackBuilder.h"
+#include "GameException.h"
+#include <iostream>
+
+using namespace Library;
+
+// Packs a content directory into an archive that Game mounts over the loose Content folder
+int wmain(int argc, wchar_t* argv[])
+{
+	if (argc != 3)
+	{
+		std::wcerr << L"Usage: AssetPacker <content directory> <pack filename>" << std::endl;
+		return 1;
+	}
+
+	try
+	{
+		AssetPackBuilder builder;
+		builder.AddDirectory("", argv[1]);
+		builder.Save(argv[2]);
+
+		std::wcout << argv[2] << L": " << builder.EntryCount() << L" entries, " << builder.BlobCount() << L" unique blobs" << std::endl;
+	}
+	catch (GameException ex)
+	{
+		std::wcerr << L"AssetPacker: " << ex.whatw() << std::endl;
+		return 1;
+	}
+
+	return 0;
+}
\ No newline at end of file
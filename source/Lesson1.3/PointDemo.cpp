@@ -58,10 +58,11 @@ namespace Rendering
 
 	void PointDemo::Draw(const GameTime& gameTime)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glUseProgram(mShaderProgram);
+		RenderStateCache& renderStates = mGame->RenderStates();
+
+		renderStates.BindVertexArray(mVertexArrayObject);
+		renderStates.UseProgram(mShaderProgram);
 		glPointSize(80.0f);
 		glDrawArrays(GL_POINTS, 0, 1);
-		glBindVertexArray(0);
 	}
 }
\ No newline at end of file
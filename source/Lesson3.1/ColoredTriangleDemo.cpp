@@ -24,15 +24,20 @@ namespace Rendering
 		glDeleteVertexArrays(1, &mVertexArrayObject);
 	}
 
+	void ColoredTriangleDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\ColoredTriangleDemo.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\ColoredTriangleDemo.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
 	void ColoredTriangleDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\ColoredTriangleDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\ColoredTriangleDemo.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 		
 		// Create the vertex buffer
 		VertexPositionColor vertices[] =
@@ -61,10 +66,11 @@ namespace Rendering
 
 	void ColoredTriangleDemo::Draw(const GameTime& gameTime)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glUseProgram(mShaderProgram.Program());		
+		RenderStateCache& renderStates = mGame->RenderStates();
+
+		renderStates.BindVertexArray(mVertexArrayObject);
+		renderStates.BindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+		renderStates.UseProgram(mShaderProgram.Program());
 		glDrawArrays(GL_TRIANGLES, 0, 3);
-		glBindVertexArray(0);
 	}
 }
\ No newline at end of file
@@ -15,6 +15,7 @@ namespace Rendering
 		ColoredTriangleDemo(Game& game, Camera& camera);
 		~ColoredTriangleDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Draw(const GameTime& gameTime) override;
 
@@ -29,15 +29,20 @@ namespace Rendering
 		glDeleteVertexArrays(1, &mVertexArrayObject);
 	}
 
+	void CubeDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\CubeDemo.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\CubeDemo.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
 	void CubeDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\CubeDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\CubeDemo.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 		
 		// Create the vertex buffer object
 		VertexPositionColor vertices[] =
@@ -112,19 +117,20 @@ namespace Rendering
 
 	void CubeDemo::Draw(const GameTime& gameTime)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+		RenderStateCache& renderStates = mGame->RenderStates();
+
+		renderStates.BindVertexArray(mVertexArrayObject);
+		renderStates.BindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+		renderStates.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
 
-		glUseProgram(mShaderProgram.Program());
+		renderStates.UseProgram(mShaderProgram.Program());
 
 		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
 		glUniformMatrix4fv(mWorldViewProjectionLocation, 1, GL_FALSE, &wvp[0][0]);
 
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
+		renderStates.SetCullingEnabled(true);
+		renderStates.SetFrontFace(GL_CCW);
 
 		glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
 	}
 }
\ No newline at end of file
@@ -15,6 +15,7 @@ namespace Rendering
 		CubeDemo(Game& game, Camera& camera);
 		~CubeDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
 		virtual void Draw(const GameTime& gameTime) override;
@@ -9,6 +9,7 @@
 #include "VectorHelper.h"
 #include "Model.h"
 #include "Mesh.h"
+#include "OcclusionCuller.h"
 
 using namespace glm;
 
@@ -18,26 +19,32 @@ namespace Rendering
 
 	ModelDemo::ModelDemo(Game& game, Camera& camera)
 		: DrawableGameComponent(game, camera), mShaderProgram(), mVertexArrayObject(0), mVertexBuffer(0),
-		mIndexBuffer(0), mWorldViewProjectionLocation(-1), mWorldMatrix(), mIndexCount()
+		mIndexBuffer(0), mWorldViewProjectionLocation(-1), mWorldMatrix(), mIndexCount(), mOccluder(0)
 	{
 	}
 
 	ModelDemo::~ModelDemo()
 	{
+		mGame->OcclusionCulling().RemoveOccluder(mOccluder);
 		glDeleteBuffers(1, &mIndexBuffer);
 		glDeleteBuffers(1, &mVertexBuffer);
 		glDeleteVertexArrays(1, &mVertexArrayObject);
 	}
 
+	void ModelDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\ModelDemo.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\ModelDemo.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
 	void ModelDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\ModelDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\ModelDemo.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 		
 		// Load the model
 		std::unique_ptr<Model> model(new Model(*mGame, "Content\\Models\\Sphere.obj"));
@@ -48,6 +55,9 @@ namespace Rendering
 		mesh->CreateIndexBuffer(mIndexBuffer);
 		mIndexCount = mesh->Indices().size();
 
+		// The sphere is solid, so its own triangles hide whatever sits behind it
+		mOccluder = mGame->OcclusionCulling().AddOccluder(*mesh, mWorldMatrix);
+
 		glGenVertexArrays(1, &mVertexArrayObject);
 		glBindVertexArray(mVertexArrayObject);
 
@@ -68,17 +78,19 @@ namespace Rendering
 
 	void ModelDemo::Draw(const GameTime& gameTime)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+		RenderStateCache& renderStates = mGame->RenderStates();
+
+		renderStates.BindVertexArray(mVertexArrayObject);
+		renderStates.BindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+		renderStates.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
 
 		mShaderProgram.Use();
 
 		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
 		glUniformMatrix4fv(mWorldViewProjectionLocation, 1, GL_FALSE, &wvp[0][0]);
 
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
+		renderStates.SetCullingEnabled(true);
+		renderStates.SetFrontFace(GL_CCW);
 
 		glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
 	}
@@ -20,6 +20,7 @@ namespace Rendering
 		ModelDemo(Game& game, Camera& camera);
 		~ModelDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Draw(const GameTime& gameTime) override;
 
@@ -43,5 +44,6 @@ namespace Rendering
 		GLint mWorldViewProjectionLocation;
 		glm::mat4 mWorldMatrix;
 		GLuint mIndexCount;
+		UINT mOccluder;
 	};
 }
@@ -4,6 +4,7 @@
 #include "ColorHelper.h"
 #include "VectorHelper.h"
 #include "Grid.h"
+#include "ProxyModel.h"
 #include "ModelDemo.h"
 
 using namespace glm;
@@ -12,10 +13,14 @@ namespace Rendering
 {
 	RTTI_DEFINITIONS(RenderingGame)
 
+	const UINT RenderingGame::OccludeeCount = 8;
+	const float RenderingGame::OccludeeSpacing = 4.0f;
+	const float RenderingGame::OccludeeScale = 0.2f;
+
 	RenderingGame::RenderingGame(HINSTANCE instance, const std::wstring& windowTitle)
 		:  Game(instance, windowTitle),
 		mCamera(nullptr), mKeyboardHandler(nullptr),
-		mModelDemo(nullptr)
+		mModelDemo(nullptr), mOccludees()
 	{
 		mDepthStencilBufferEnabled = true;
 	}
@@ -36,6 +41,15 @@ namespace Rendering
 		mModelDemo = new ModelDemo(*this, *mCamera);
 		mComponents.push_back(mModelDemo);
 
+		// A line of small spheres running away behind the model; the ones it hides are rejected by the occlusion culler
+		for (UINT i = 0; i < OccludeeCount; i++)
+		{
+			ProxyModel* occludee = new ProxyModel(*this, *mCamera, "Content\\Models\\Sphere.obj", OccludeeScale);
+			occludee->SetPosition(0.0f, 0.0f, -(i + 2) * OccludeeSpacing);
+			mOccludees.push_back(occludee);
+			mComponents.push_back(occludee);
+		}
+
 		Game::Initialize();
 
 		mCamera->SetPosition(0, 5, 10);
@@ -44,6 +58,12 @@ namespace Rendering
 
 	void RenderingGame::Shutdown()
 	{
+		for (ProxyModel* occludee : mOccludees)
+		{
+			DeleteObject(occludee);
+		}
+		mOccludees.clear();
+
 		DeleteObject(mModelDemo);
 
 		DeleteObject(mGrid);
@@ -9,6 +9,7 @@ namespace Library
 	class GameTime;
 	class FirstPersonCamera;
 	class Grid;
+	class ProxyModel;
 }
 
 namespace Rendering
@@ -30,10 +31,15 @@ namespace Rendering
 	private:
 		void OnKey(int key, int scancode, int action, int mods);
 
+		static const UINT OccludeeCount;
+		static const float OccludeeSpacing;
+		static const float OccludeeScale;
+
 		FirstPersonCamera* mCamera;
 		KeyboardHandler mKeyboardHandler;
 		Grid* mGrid;
 
 		ModelDemo* mModelDemo;
+		std::vector<ProxyModel*> mOccludees;
 	};
 }
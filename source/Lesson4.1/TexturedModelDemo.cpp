@@ -1,4 +1,5 @@
 #include "TexturedModelDemo.h"
+#include "Game.h"
 #include "GameException.h"
 #include "ColorHelper.h"
 #include "Camera.h"
@@ -35,15 +36,20 @@ namespace Rendering
 
 	}
 
+	void TexturedModelDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\TexturedModelDemo.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\TexturedModelDemo.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
 	void TexturedModelDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\TexturedModelDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\TexturedModelDemo.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 		
 		// Load the model
 		std::unique_ptr<Model> model(new Model(*mGame, "Content\\Models\\Sphere.obj", true));
@@ -94,21 +100,22 @@ namespace Rendering
 
 	void TexturedModelDemo::Draw(const GameTime& gameTime)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);		
-		glBindTexture(GL_TEXTURE_2D, mActiveTexture);
+		RenderStateCache& renderStates = mGame->RenderStates();
+
+		renderStates.BindVertexArray(mVertexArrayObject);
+		renderStates.BindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+		renderStates.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+		renderStates.BindTexture(0, GL_TEXTURE_2D, mActiveTexture);
 
-		glUseProgram(mShaderProgram.Program());
+		renderStates.UseProgram(mShaderProgram.Program());
 
 		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
 		glUniformMatrix4fv(mWorldViewProjectionLocation, 1, GL_FALSE, &wvp[0][0]);
 
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
+		renderStates.SetCullingEnabled(true);
+		renderStates.SetFrontFace(GL_CCW);
 
 		glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
 	}
 
 	void TexturedModelDemo::CreateVertexBuffer(const Mesh& mesh, GLuint& vertexBuffer)
@@ -21,6 +21,7 @@ namespace Rendering
 		TexturedModelDemo(Game& game, Camera& camera);
 		~TexturedModelDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Draw(const GameTime& gameTime) override;
 
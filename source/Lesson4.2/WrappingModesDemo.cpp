@@ -1,4 +1,5 @@
 #include "WrappingModesDemo.h"
+#include "Game.h"
 #include "GameException.h"
 #include "ColorHelper.h"
 #include "Camera.h"
@@ -18,29 +19,33 @@ namespace Rendering
 	WrappingModesDemo::WrappingModesDemo(Game& game, Camera& camera)
 		: DrawableGameComponent(game, camera), mShaderProgram(), mVertexArrayObject(0), mVertexBuffer(0),
 		mIndexBuffer(0), mWorldViewProjectionLocation(-1), mWorldMatrix(), mIndexCount(), mColorTexture(0),
-		mTextureSamplers(), mTextureSamplersByWrappingMode(), mActiveWrappingMode(WrappingModeRepeat), mKeyboardHandler(nullptr)
+		mTextureSamplersByWrappingMode(), mActiveWrappingMode(WrappingModeRepeat), mKeyboardHandler(nullptr)
 	{
 	}
 
 	WrappingModesDemo::~WrappingModesDemo()
 	{
 		mGame->RemoveKeyboardHandler(mKeyboardHandler);
-		glDeleteSamplers(mTextureSamplers.size(), &mTextureSamplers[0]);
 		glDeleteTextures(1, &mColorTexture);
 		glDeleteBuffers(1, &mIndexBuffer);
 		glDeleteBuffers(1, &mVertexBuffer);
 		glDeleteVertexArrays(1, &mVertexArrayObject);
 	}
 
+	void WrappingModesDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\WrappingModesDemo.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\WrappingModesDemo.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
 	void WrappingModesDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\WrappingModesDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\WrappingModesDemo.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 		
 		float size = 10.0f;
 		float halfSize = size / 2.0f;
@@ -80,27 +85,22 @@ namespace Rendering
 			throw GameException("SOIL_load_OGL_texture() failed.");
 		}
 
-		// Configure the texture samplers
-		mTextureSamplers.resize(WrappingModeEnd);
-		glGenSamplers(mTextureSamplers.size(), &mTextureSamplers[0]);
-
-		for (WrappingMode mode = (WrappingMode)0; mode < WrappingModeEnd; mode = (WrappingMode)(mode + 1))
-		{
-			mTextureSamplersByWrappingMode[mode] = mTextureSamplers[mode];
-		}
+		// Acquire the texture samplers
+		SamplerCache& samplers = mGame->Samplers();
+		SamplerDescription samplerDescription;
 
-		glSamplerParameteri(mTextureSamplersByWrappingMode[WrappingModeRepeat], GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glSamplerParameteri(mTextureSamplersByWrappingMode[WrappingModeRepeat], GL_TEXTURE_WRAP_T, GL_REPEAT);
+		samplerDescription.WrapS = samplerDescription.WrapT = GL_REPEAT;
+		mTextureSamplersByWrappingMode[WrappingModeRepeat] = samplers.Sampler(samplerDescription);
 
-		glSamplerParameteri(mTextureSamplersByWrappingMode[WrappingModeMirroredRepeat], GL_TEXTURE_WRAP_S, GL_MIRRORED_REPEAT);
-		glSamplerParameteri(mTextureSamplersByWrappingMode[WrappingModeMirroredRepeat], GL_TEXTURE_WRAP_T, GL_MIRRORED_REPEAT);
+		samplerDescription.WrapS = samplerDescription.WrapT = GL_MIRRORED_REPEAT;
+		mTextureSamplersByWrappingMode[WrappingModeMirroredRepeat] = samplers.Sampler(samplerDescription);
 
-		glSamplerParameteri(mTextureSamplersByWrappingMode[WrappingModeClampToEdge], GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glSamplerParameteri(mTextureSamplersByWrappingMode[WrappingModeClampToEdge], GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		samplerDescription.WrapS = samplerDescription.WrapT = GL_CLAMP_TO_EDGE;
+		mTextureSamplersByWrappingMode[WrappingModeClampToEdge] = samplers.Sampler(samplerDescription);
 
-		glSamplerParameteri(mTextureSamplersByWrappingMode[WrappingModeClampToBorder], GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-		glSamplerParameteri(mTextureSamplersByWrappingMode[WrappingModeClampToBorder], GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
-		glSamplerParameterfv(mTextureSamplersByWrappingMode[WrappingModeClampToBorder], GL_TEXTURE_BORDER_COLOR, &ColorHelper::Purple[0]);
+		samplerDescription.WrapS = samplerDescription.WrapT = GL_CLAMP_TO_BORDER;
+		samplerDescription.BorderColor = ColorHelper::Purple;
+		mTextureSamplersByWrappingMode[WrappingModeClampToBorder] = samplers.Sampler(samplerDescription);
 
 		// Create the vertex array object
 		glGenVertexArrays(1, &mVertexArrayObject);
@@ -122,23 +122,24 @@ namespace Rendering
 
 	void WrappingModesDemo::Draw(const GameTime& gameTime)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
-		glBindTexture(GL_TEXTURE_2D, mColorTexture);
+		RenderStateCache& renderStates = mGame->RenderStates();
+
+		renderStates.BindVertexArray(mVertexArrayObject);
+		renderStates.BindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+		renderStates.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+		renderStates.BindTexture(0, GL_TEXTURE_2D, mColorTexture);
 
-		glBindSampler(0, mTextureSamplersByWrappingMode[mActiveWrappingMode]);
+		renderStates.BindSampler(0, mTextureSamplersByWrappingMode[mActiveWrappingMode]);
 
-		glUseProgram(mShaderProgram.Program());
+		renderStates.UseProgram(mShaderProgram.Program());
 
 		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
 		glUniformMatrix4fv(mWorldViewProjectionLocation, 1, GL_FALSE, &wvp[0][0]);
 
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
+		renderStates.SetCullingEnabled(true);
+		renderStates.SetFrontFace(GL_CCW);
 
 		glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
 	}
 
 	void WrappingModesDemo::CreateVertexBuffer(VertexPositionTexture* vertices, GLuint vertexCount, GLuint& vertexBuffer)
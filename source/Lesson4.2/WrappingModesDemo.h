@@ -22,6 +22,7 @@ namespace Rendering
 		WrappingModesDemo(Game& game, Camera& camera);
 		~WrappingModesDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Draw(const GameTime& gameTime) override;
 
@@ -57,7 +58,6 @@ namespace Rendering
 		glm::mat4 mWorldMatrix;
 		GLuint mIndexCount;
 		GLuint mColorTexture;
-		std::vector<GLuint> mTextureSamplers;
 		std::map<WrappingMode, GLuint> mTextureSamplersByWrappingMode;
 		WrappingMode mActiveWrappingMode;
 		Game::KeyboardHandler mKeyboardHandler;
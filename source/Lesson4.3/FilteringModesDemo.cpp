@@ -1,4 +1,5 @@
 #include "FilteringModesDemo.h"
+#include "Game.h"
 #include "GameException.h"
 #include "ColorHelper.h"
 #include "Camera.h"
@@ -29,29 +30,33 @@ namespace Rendering
 	FilteringModesDemo::FilteringModesDemo(Game& game, Camera& camera)
 		: DrawableGameComponent(game, camera), mShaderProgram(), mVertexArrayObject(0), mVertexBuffer(0),
 		mIndexBuffer(0), mWorldViewProjectionLocation(-1), mWorldMatrix(), mIndexCount(), mColorTexture(0),
-		mTextureSamplers(), mTextureSamplersByFilteringMode(), mActiveFilteringMode(FilteringModePoint), mKeyboardHandler(nullptr)
+		mTextureSamplersByFilteringMode(), mActiveFilteringMode(FilteringModePoint), mKeyboardHandler(nullptr)
 	{
 	}
 
 	FilteringModesDemo::~FilteringModesDemo()
 	{
 		mGame->RemoveKeyboardHandler(mKeyboardHandler);
-		glDeleteSamplers(mTextureSamplers.size(), &mTextureSamplers[0]);
 		glDeleteTextures(1, &mColorTexture);
 		glDeleteBuffers(1, &mIndexBuffer);
 		glDeleteBuffers(1, &mVertexBuffer);
 		glDeleteVertexArrays(1, &mVertexArrayObject);
 	}
 
+	void FilteringModesDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\FilteringModesDemo.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\FilteringModesDemo.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
 	void FilteringModesDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\FilteringModesDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\FilteringModesDemo.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 		
 		float size = 10.0f;
 		float halfSize = size / 2.0f;
@@ -91,32 +96,14 @@ namespace Rendering
 			throw GameException("SOIL_load_OGL_texture() failed.");
 		}
 
-		// Configure the texture samplers
-		mTextureSamplers.resize(FilteringModeEnd);
-		glGenSamplers(mTextureSamplers.size(), &mTextureSamplers[0]);
-
-		for (FilteringMode mode = (FilteringMode)0; mode < FilteringModeEnd; mode = (FilteringMode)(mode + 1))
-		{
-			mTextureSamplersByFilteringMode[mode] = mTextureSamplers[mode];
-		}
-
-		glSamplerParameteri(mTextureSamplersByFilteringMode[FilteringModePoint], GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-		glSamplerParameteri(mTextureSamplersByFilteringMode[FilteringModePoint], GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
-		glSamplerParameteri(mTextureSamplersByFilteringMode[FilteringModeLinear], GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glSamplerParameteri(mTextureSamplersByFilteringMode[FilteringModeLinear], GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		glSamplerParameteri(mTextureSamplersByFilteringMode[FilteringModePointMipMapPoint], GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
-		glSamplerParameteri(mTextureSamplersByFilteringMode[FilteringModePointMipMapPoint], GL_TEXTURE_MAG_FILTER, GL_NEAREST_MIPMAP_NEAREST);
-
-		glSamplerParameteri(mTextureSamplersByFilteringMode[FilteringModeLinearMipMapPoint], GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_NEAREST);
-		glSamplerParameteri(mTextureSamplersByFilteringMode[FilteringModeLinearMipMapPoint], GL_TEXTURE_MAG_FILTER, GL_LINEAR_MIPMAP_NEAREST);
-
-		glSamplerParameteri(mTextureSamplersByFilteringMode[FilteringModePointMipMapLinear], GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_LINEAR);
-		glSamplerParameteri(mTextureSamplersByFilteringMode[FilteringModePointMipMapLinear], GL_TEXTURE_MAG_FILTER, GL_NEAREST_MIPMAP_LINEAR);
-
-		glSamplerParameteri(mTextureSamplersByFilteringMode[FilteringModeTriLinear], GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-		glSamplerParameteri(mTextureSamplersByFilteringMode[FilteringModeTriLinear], GL_TEXTURE_MAG_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		// Acquire the texture samplers; the magnification filter has no mipmap variants
+		SamplerCache& samplers = mGame->Samplers();
+		mTextureSamplersByFilteringMode[FilteringModePoint] = samplers.Sampler(SamplerDescription(GL_NEAREST, GL_NEAREST, GL_REPEAT));
+		mTextureSamplersByFilteringMode[FilteringModeLinear] = samplers.Sampler(SamplerDescription(GL_LINEAR, GL_LINEAR, GL_REPEAT));
+		mTextureSamplersByFilteringMode[FilteringModePointMipMapPoint] = samplers.Sampler(SamplerDescription(GL_NEAREST_MIPMAP_NEAREST, GL_NEAREST, GL_REPEAT));
+		mTextureSamplersByFilteringMode[FilteringModeLinearMipMapPoint] = samplers.Sampler(SamplerDescription(GL_LINEAR_MIPMAP_NEAREST, GL_LINEAR, GL_REPEAT));
+		mTextureSamplersByFilteringMode[FilteringModePointMipMapLinear] = samplers.Sampler(SamplerDescription(GL_NEAREST_MIPMAP_LINEAR, GL_NEAREST, GL_REPEAT));
+		mTextureSamplersByFilteringMode[FilteringModeTriLinear] = samplers.Sampler(SamplerDescription::TrilinearWrap);
 
 		// Create the vertex array object
 		glGenVertexArrays(1, &mVertexArrayObject);
@@ -142,23 +129,24 @@ namespace Rendering
 
 	void FilteringModesDemo::Draw(const GameTime& gameTime)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
-		glBindTexture(GL_TEXTURE_2D, mColorTexture);
+		RenderStateCache& renderStates = mGame->RenderStates();
 
-		glBindSampler(0, mTextureSamplersByFilteringMode[mActiveFilteringMode]);
+		renderStates.BindVertexArray(mVertexArrayObject);
+		renderStates.BindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+		renderStates.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+		renderStates.BindTexture(0, GL_TEXTURE_2D, mColorTexture);
 
-		glUseProgram(mShaderProgram.Program());
+		renderStates.BindSampler(0, mTextureSamplersByFilteringMode[mActiveFilteringMode]);
+
+		renderStates.UseProgram(mShaderProgram.Program());
 
 		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
 		glUniformMatrix4fv(mWorldViewProjectionLocation, 1, GL_FALSE, &wvp[0][0]);
 
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
+		renderStates.SetCullingEnabled(true);
+		renderStates.SetFrontFace(GL_CCW);
 
 		glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
 	}
 
 	void FilteringModesDemo::CreateVertexBuffer(VertexPositionTexture* vertices, GLuint vertexCount, GLuint& vertexBuffer)
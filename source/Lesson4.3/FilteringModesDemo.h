@@ -22,6 +22,7 @@ namespace Rendering
 		FilteringModesDemo(Game& game, Camera& camera);
 		~FilteringModesDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Draw(const GameTime& gameTime) override;
 
@@ -62,7 +63,6 @@ namespace Rendering
 		glm::mat4 mWorldMatrix;
 		GLuint mIndexCount;
 		GLuint mColorTexture;
-		std::vector<GLuint> mTextureSamplers;
 		std::map<FilteringMode, GLuint> mTextureSamplersByFilteringMode;
 		FilteringMode mActiveFilteringMode;
 		Game::KeyboardHandler mKeyboardHandler;
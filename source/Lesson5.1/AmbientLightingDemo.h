@@ -21,6 +21,7 @@ namespace Rendering
 		AmbientLightingDemo(Game& game, Camera& camera);
 		~AmbientLightingDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
 		virtual void Draw(const GameTime& gameTime) override;
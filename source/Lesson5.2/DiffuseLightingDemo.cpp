@@ -40,15 +40,20 @@ namespace Rendering
 		glDeleteVertexArrays(1, &mVertexArrayObject);
 	}
 
+	void DiffuseLightingDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\DiffuseLightingDemo.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\DiffuseLightingDemo.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
 	void DiffuseLightingDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\DiffuseLightingDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\DiffuseLightingDemo.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 		
 		// Load the model
 		std::unique_ptr<Model> model(new Model(*mGame, "Content\\Models\\Sphere.obj", true));
@@ -132,11 +137,13 @@ namespace Rendering
 
 	void DiffuseLightingDemo::Draw(const GameTime& gameTime)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+		RenderStateCache& renderStates = mGame->RenderStates();
 
-		glUseProgram(mShaderProgram.Program());
+		renderStates.BindVertexArray(mVertexArrayObject);
+		renderStates.BindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+		renderStates.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+
+		renderStates.UseProgram(mShaderProgram.Program());
 
 		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
 		glUniformMatrix4fv(mWorldViewProjectionLocation, 1, GL_FALSE, &wvp[0][0]);
@@ -144,15 +151,13 @@ namespace Rendering
 		glUniform4fv(mAmbientColorLocation, 1, &mAmbientLight->Color()[0]);
 		glUniform4fv(mLightColorLocation, 1, &mDirectionalLight->Color()[0]);
 		glUniform3fv(mLightDirectionLocation, 1, &mDirectionalLight->Direction()[0]);
-		glBindTexture(GL_TEXTURE_2D, mColorTexture);
+		renderStates.BindTexture(0, GL_TEXTURE_2D, mColorTexture);
 
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
+		renderStates.SetCullingEnabled(true);
+		renderStates.SetFrontFace(GL_CCW);
 
 		glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
 
-		glBindVertexArray(0);
-
 		mProxyModel->Draw(gameTime);
 	}
 
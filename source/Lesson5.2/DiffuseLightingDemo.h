@@ -23,6 +23,7 @@ namespace Rendering
 		DiffuseLightingDemo(Game& game, Camera& camera);
 		~DiffuseLightingDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
 		virtual void Draw(const GameTime& gameTime) override;
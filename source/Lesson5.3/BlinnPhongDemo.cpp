@@ -9,6 +9,7 @@
 #include "Mesh.h"
 #include "DirectionalLight.h"
 #include "ProxyModel.h"
+#include "RenderCommandList.h"
 #include "SOIL.h"
 
 using namespace glm;
@@ -39,15 +40,20 @@ namespace Rendering
 		glDeleteVertexArrays(1, &mVertexArrayObject);
 	}
 
+	void BlinnPhongDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\LightingEffect.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\LightingEffect.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
 	void BlinnPhongDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\BlinnPhongDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\BlinnPhongDemo.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 		
 		// Load the model
 		std::unique_ptr<Model> model(new Model(*mGame, "Content\\Models\\Sphere.obj", true));
@@ -75,6 +81,11 @@ namespace Rendering
 
 		mDirectionalLight = new DirectionalLight(*mGame);
 
+		FrameConstants& frameConstants = mGame->FrameData();
+		frameConstants.SetCamera(mCamera);
+		frameConstants.SetAmbientLight(mAmbientLight);
+		frameConstants.SetLight(mDirectionalLight);
+
 		mProxyModel = new ProxyModel(*mGame, *mCamera, "Content\\Models\\DirectionalLightProxy.obj", 0.5f);
 		mProxyModel->Initialize();
 		mProxyModel->SetPosition(10.0f, 0.0, 0.0f);
@@ -90,33 +101,26 @@ namespace Rendering
 		mProxyModel->Update(gameTime);
 	}
 
-	void BlinnPhongDemo::Draw(const GameTime& gameTime)
+	bool BlinnPhongDemo::Record(const GameTime& gameTime, RenderCommandList& commandList)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
-
-		mShaderProgram.Use();
-
-		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
-		mShaderProgram.WorldViewProjection() << wvp;
-		mShaderProgram.World() << mWorldMatrix;
-		mShaderProgram.AmbientColor() << mAmbientLight->Color();
-		mShaderProgram.LightColor() << mDirectionalLight->Color();
-		mShaderProgram.LightDirection() << mDirectionalLight->Direction();
-		mShaderProgram.CameraPosition() << mCamera->Position();
-		mShaderProgram.SpecularColor() << mSpecularColor;
-		mShaderProgram.SpecularPower() << mSpecularPower;
-
-		glBindTexture(GL_TEXTURE_2D, mColorTexture);
-
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
-
-		glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
-
-		mProxyModel->Draw(gameTime);
+		DrawItem drawItem;
+		drawItem.Program = &mShaderProgram;
+		drawItem.VertexArray = mVertexArrayObject;
+		drawItem.VertexBuffer = mVertexBuffer;
+		drawItem.IndexBuffer = mIndexBuffer;
+		drawItem.Count = mIndexCount;
+		drawItem.Textures[0] = mColorTexture;
+		drawItem.TextureCount = 1;
+		drawItem.Depth = RenderQueue::ViewDepth(*mCamera, vec3(mWorldMatrix[3]));
+
+		commandList.Submit(drawItem);
+		commandList.SetUniform(mShaderProgram.World(), mWorldMatrix);
+		commandList.SetUniform(mShaderProgram.SpecularColor(), mSpecularColor);
+		commandList.SetUniform(mShaderProgram.SpecularPower(), mSpecularPower);
+
+		mProxyModel->Record(gameTime, commandList);
+
+		return true;
 	}
 
 	void BlinnPhongDemo::UpdateAmbientLight(const GameTime& gameTime)
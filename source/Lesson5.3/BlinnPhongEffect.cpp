@@ -11,19 +11,12 @@ namespace Library
 
     BlinnPhongEffect::BlinnPhongEffect()
         : ShaderProgram(),
-		SHADER_VARIABLE_INITIALIZATION(WorldViewProjection), SHADER_VARIABLE_INITIALIZATION(World),
-		SHADER_VARIABLE_INITIALIZATION(AmbientColor), SHADER_VARIABLE_INITIALIZATION(LightColor),
-		SHADER_VARIABLE_INITIALIZATION(LightDirection), SHADER_VARIABLE_INITIALIZATION(CameraPosition),
-		SHADER_VARIABLE_INITIALIZATION(SpecularColor), SHADER_VARIABLE_INITIALIZATION(SpecularPower)
+		SHADER_VARIABLE_INITIALIZATION(World), SHADER_VARIABLE_INITIALIZATION(SpecularColor),
+		SHADER_VARIABLE_INITIALIZATION(SpecularPower)
     {
     }
 
-    SHADER_VARIABLE_DEFINITION(BlinnPhongEffect, WorldViewProjection)
 	SHADER_VARIABLE_DEFINITION(BlinnPhongEffect, World)
-	SHADER_VARIABLE_DEFINITION(BlinnPhongEffect, AmbientColor)
-	SHADER_VARIABLE_DEFINITION(BlinnPhongEffect, LightColor)
-	SHADER_VARIABLE_DEFINITION(BlinnPhongEffect, LightDirection)
-	SHADER_VARIABLE_DEFINITION(BlinnPhongEffect, CameraPosition)
 	SHADER_VARIABLE_DEFINITION(BlinnPhongEffect, SpecularColor)
 	SHADER_VARIABLE_DEFINITION(BlinnPhongEffect, SpecularPower)
 
@@ -31,12 +24,7 @@ namespace Library
     {
         ShaderProgram::Initialize(vertexArrayObject);
 
-        SHADER_VARIABLE_INSTANTIATE(WorldViewProjection)
 		SHADER_VARIABLE_INSTANTIATE(World)
-		SHADER_VARIABLE_INSTANTIATE(AmbientColor)
-		SHADER_VARIABLE_INSTANTIATE(LightColor)
-		SHADER_VARIABLE_INSTANTIATE(LightDirection)
-		SHADER_VARIABLE_INSTANTIATE(CameraPosition)
 		SHADER_VARIABLE_INSTANTIATE(SpecularColor)
 		SHADER_VARIABLE_INSTANTIATE(SpecularPower)
 
@@ -10,12 +10,7 @@ namespace Library
     {
 		RTTI_DECLARATIONS(BlinnPhongEffect, ShaderProgram)
 
-        SHADER_VARIABLE_DECLARATION(WorldViewProjection)
 		SHADER_VARIABLE_DECLARATION(World)
-		SHADER_VARIABLE_DECLARATION(AmbientColor)
-		SHADER_VARIABLE_DECLARATION(LightColor)
-		SHADER_VARIABLE_DECLARATION(LightDirection)
-		SHADER_VARIABLE_DECLARATION(CameraPosition)
 		SHADER_VARIABLE_DECLARATION(SpecularColor)
 		SHADER_VARIABLE_DECLARATION(SpecularPower)
 
@@ -4,6 +4,9 @@
 #include "ColorHelper.h"
 #include "VectorHelper.h"
 #include "Grid.h"
+#include "InstancedModel.h"
+#include "StaticBatch.h"
+#include "Model.h"
 
 #include "BlinnPhongDemo.h"
 
@@ -13,10 +16,14 @@ namespace Rendering
 {
 	RTTI_DEFINITIONS(RenderingGame)
 
+	const int RenderingGame::InstanceFieldExtent = 12;
+	const float RenderingGame::InstanceSpacing = 2.5f;
+	const float RenderingGame::InstanceScale = 0.25f;
+
 	RenderingGame::RenderingGame(HINSTANCE instance, const std::wstring& windowTitle)
 		:  Game(instance, windowTitle),
 		mCamera(nullptr), mKeyboardHandler(nullptr),
-		mBlinnPhongDemo(nullptr)
+		mBlinnPhongDemo(nullptr), mInstancedModel(nullptr), mStaticBatch(nullptr), mSphereFieldMode(SphereFieldModeInstanced)
 	{
 		mDepthStencilBufferEnabled = true;
 	}
@@ -37,6 +44,28 @@ namespace Rendering
 		mBlinnPhongDemo = new BlinnPhongDemo(*this, *mCamera);
 		mComponents.push_back(mBlinnPhongDemo);
 
+		// A field of small spheres around the globe, lit by the demo's directional light. The field never moves, so the
+		// same spheres also go into a static batch; B cycles between one instanced call, one multi-draw and one draw per sphere.
+		mInstancedModel = new InstancedModel(*this, *mCamera, "Content\\Models\\Sphere.obj");
+		mStaticBatch = new StaticBatch(*this, *mCamera);
+		Model sphere(*this, "Content\\Models\\Sphere.obj", true);
+		for (int z = -InstanceFieldExtent; z <= InstanceFieldExtent; z++)
+		{
+			for (int x = -InstanceFieldExtent; x <= InstanceFieldExtent; x++)
+			{
+				if (abs(x) > 1 || abs(z) > 1)
+				{
+					mat4 world = scale(translate(mat4(), vec3(x * InstanceSpacing, 0.0f, z * InstanceSpacing)), vec3(InstanceScale));
+					vec4 color = ColorHelper::RandomColor();
+					mInstancedModel->AddInstance(world, color);
+					mStaticBatch->Add(sphere, world, color);
+				}
+			}
+		}
+		mComponents.push_back(mInstancedModel);
+		mComponents.push_back(mStaticBatch);
+		SetSphereFieldMode(SphereFieldModeInstanced);
+
 		Game::Initialize();
 
 		mCamera->SetPosition(0, 5, 20);
@@ -44,6 +73,8 @@ namespace Rendering
 
 	void RenderingGame::Shutdown()
 	{
+		DeleteObject(mStaticBatch);
+		DeleteObject(mInstancedModel);
 		DeleteObject(mBlinnPhongDemo);
 
 		DeleteObject(mGrid);
@@ -71,5 +102,19 @@ namespace Rendering
 		{
 			Exit();
 		}
+
+		if (key == GLFW_KEY_B && action == GLFW_PRESS)
+		{
+			SetSphereFieldMode(static_cast<SphereFieldMode>((mSphereFieldMode + 1) % SphereFieldModeEnd));
+		}
+	}
+
+	void RenderingGame::SetSphereFieldMode(SphereFieldMode mode)
+	{
+		mSphereFieldMode = mode;
+
+		mInstancedModel->SetVisible(mode == SphereFieldModeInstanced);
+		mStaticBatch->SetVisible(mode != SphereFieldModeInstanced);
+		mStaticBatch->SetBatched(mode == SphereFieldModeBatched);
 	}
 }
\ No newline at end of file
@@ -9,6 +9,8 @@ namespace Library
 	class GameTime;
 	class FirstPersonCamera;
 	class Grid;
+	class InstancedModel;
+	class StaticBatch;
 }
 
 namespace Rendering
@@ -28,12 +30,28 @@ namespace Rendering
 		virtual void Shutdown() override;
 
 	private:
+		enum SphereFieldMode
+		{
+			SphereFieldModeInstanced = 0,
+			SphereFieldModeBatched,
+			SphereFieldModeUnbatched,
+			SphereFieldModeEnd
+		};
+
 		void OnKey(int key, int scancode, int action, int mods);
+		void SetSphereFieldMode(SphereFieldMode mode);
+
+		static const int InstanceFieldExtent;
+		static const float InstanceSpacing;
+		static const float InstanceScale;
 
 		FirstPersonCamera* mCamera;
 		KeyboardHandler mKeyboardHandler;
 		Grid* mGrid;
 
 		BlinnPhongDemo* mBlinnPhongDemo;
+		InstancedModel* mInstancedModel;
+		StaticBatch* mStaticBatch;
+		SphereFieldMode mSphereFieldMode;
 	};
 }
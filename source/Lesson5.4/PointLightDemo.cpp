@@ -8,7 +8,9 @@
 #include "Model.h"
 #include "Mesh.h"
 #include "PointLight.h"
+#include "ClusteredLighting.h"
 #include "ProxyModel.h"
+#include "RenderCommandList.h"
 #include "SOIL.h"
 
 using namespace glm;
@@ -20,18 +22,30 @@ namespace Rendering
 	const float PointLightDemo::LightModulationRate = UCHAR_MAX;
 	const float PointLightDemo::LightMovementRate = 10.0f;
 	const float PointLightDemo::RadiusModulationRate = UCHAR_MAX;
+	const UINT PointLightDemo::ClusteredLightCount = 16;
+	const float PointLightDemo::ClusteredLightOrbitRadius = 2.0f;
+	const float PointLightDemo::ClusteredLightOrbitRate = 0.5f;
+	const float PointLightDemo::ClusteredLightRadius = 1.5f;
 
 	PointLightDemo::PointLightDemo(Game& game, Camera& camera)
 		: DrawableGameComponent(game, camera), mShaderProgram(), mVertexArrayObject(0), mVertexBuffer(0),
 		mIndexBuffer(0), mWorldMatrix(), mIndexCount(), mColorTexture(0), mAmbientLight(nullptr),
 		mPointLight(nullptr), mSpecularColor(ColorHelper::White), mSpecularPower(25.0f),
-		mProxyModel(nullptr)
+		mClusteredLights(), mProxyModel(nullptr), mUseDeferredShading(true), mKeyboardHandler(nullptr)
 	{
 	}
 
 	PointLightDemo::~PointLightDemo()
 	{
+		mGame->RemoveKeyboardHandler(mKeyboardHandler);
 		DeleteObject(mProxyModel);
+
+		for (PointLight* light : mClusteredLights)
+		{
+			mGame->ClusteredLights().RemoveLight(*light);
+			DeleteObject(light);
+		}
+
 		DeleteObject(mPointLight);
 		DeleteObject(mAmbientLight);
 		glDeleteTextures(1, &mColorTexture);
@@ -40,15 +54,21 @@ namespace Rendering
 		glDeleteVertexArrays(1, &mVertexArrayObject);
 	}
 
+	void PointLightDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\LightingEffect.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\LightingEffect.frag"));
+		mShaderProgram.SetPermutation(ShaderPermutation());
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
 	void PointLightDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\PointLightDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\PointLightDemo.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 		
 		// Load the model
 		std::unique_ptr<Model> model(new Model(*mGame, "Content\\Models\\Sphere.obj", true));
@@ -78,8 +98,31 @@ namespace Rendering
 		mPointLight->SetRadius(50.0f);
 		mPointLight->SetPosition(5.0f, 0.0f, 10.0f);
 
+		FrameConstants& frameConstants = mGame->FrameData();
+		frameConstants.SetCamera(mCamera);
+		frameConstants.SetAmbientLight(mAmbientLight);
+		frameConstants.SetLight(mPointLight);
+
+		// A ring of small colored lights shaded through the cluster grid, on top of the movable point light
+		for (UINT i = 0; i < ClusteredLightCount; i++)
+		{
+			PointLight* light = new PointLight(*mGame);
+			light->SetColor(ColorHelper::RandomColor());
+			light->SetRadius(ClusteredLightRadius);
+			mGame->ClusteredLights().AddLight(*light);
+			mClusteredLights.push_back(light);
+		}
+
 		mProxyModel = new ProxyModel(*mGame, *mCamera, "Content\\Models\\PointLightProxy.obj", 0.5f);
 		mProxyModel->Initialize();
+
+		// The sphere starts out lit from the G-buffer; space switches it to clustered forward shading
+		mGame->DeferredShading().SetEnabled(mUseDeferredShading);
+
+		// Attach the keyboard handler
+		using namespace std::placeholders;
+		mKeyboardHandler = std::bind(&PointLightDemo::OnKey, this, _1, _2, _3, _4);
+		mGame->AddKeyboardHandler(mKeyboardHandler);
 	}
 
 	void PointLightDemo::Update(const GameTime& gameTime)
@@ -87,38 +130,37 @@ namespace Rendering
 		UpdateAmbientLight(gameTime);
 		UpdatePointLight(gameTime);
 		UpdateSpecularLight(gameTime);
+		UpdateClusteredLights(gameTime);
+
+		// The deferred resolve shades every G-buffer pixel with one specular term
+		DeferredRenderer& deferredShading = mGame->DeferredShading();
+		deferredShading.SpecularColor() = mSpecularColor;
+		deferredShading.SpecularPower() = mSpecularPower;
 
 		mProxyModel->Update(gameTime);
 	}
 
-	void PointLightDemo::Draw(const GameTime& gameTime)
+	bool PointLightDemo::Record(const GameTime& gameTime, RenderCommandList& commandList)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
-
-		mShaderProgram.Use();
-
-		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
-		mShaderProgram.WorldViewProjection() << wvp;
-		mShaderProgram.World() << mWorldMatrix;
-		mShaderProgram.AmbientColor() << mAmbientLight->Color();
-		mShaderProgram.LightColor() << mPointLight->Color();
-		mShaderProgram.LightPosition() << mPointLight->Position();
-		mShaderProgram.LightRadius() << mPointLight->Radius();
-		mShaderProgram.CameraPosition() << mCamera->Position();
-		mShaderProgram.SpecularColor() << mSpecularColor;
-		mShaderProgram.SpecularPower() << mSpecularPower;
-
-		glBindTexture(GL_TEXTURE_2D, mColorTexture);
-
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
-
-		glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
-
-		mProxyModel->Draw(gameTime);
+		DrawItem drawItem;
+		drawItem.Program = &mShaderProgram;
+		drawItem.VertexArray = mVertexArrayObject;
+		drawItem.VertexBuffer = mVertexBuffer;
+		drawItem.IndexBuffer = mIndexBuffer;
+		drawItem.Count = mIndexCount;
+		drawItem.Textures[0] = mColorTexture;
+		drawItem.TextureCount = 1;
+		drawItem.Depth = RenderQueue::ViewDepth(*mCamera, vec3(mWorldMatrix[3]));
+		drawItem.Layer = (mUseDeferredShading ? RenderLayerDeferred : RenderLayerOpaque);
+
+		commandList.Submit(drawItem);
+		commandList.SetUniform(mShaderProgram.World(), mWorldMatrix);
+		commandList.SetUniform(mShaderProgram.SpecularColor(), mSpecularColor);
+		commandList.SetUniform(mShaderProgram.SpecularPower(), mSpecularPower);
+
+		mProxyModel->Record(gameTime, commandList);
+
+		return true;
 	}
 
 	void PointLightDemo::UpdateAmbientLight(const GameTime& gameTime)
@@ -252,4 +294,32 @@ namespace Rendering
 			mSpecularPower = specularPower;
 		}
 	}
+
+	void PointLightDemo::UpdateClusteredLights(const GameTime& gameTime)
+	{
+		float orbitAngle = static_cast<float>(gameTime.TotalGameTime()) * ClusteredLightOrbitRate;
+		float spacing = radians(360.0f) / ClusteredLightCount;
+
+		for (UINT i = 0; i < mClusteredLights.size(); i++)
+		{
+			float angle = orbitAngle + spacing * i;
+			mClusteredLights[i]->SetPosition(ClusteredLightOrbitRadius * cos(angle), 0.0f, ClusteredLightOrbitRadius * sin(angle));
+		}
+	}
+
+	void PointLightDemo::OnKey(int key, int scancode, int action, int mods)
+	{
+		if (key == GLFW_KEY_SPACE && action == GLFW_PRESS)
+		{
+			mUseDeferredShading = !mUseDeferredShading;
+			mGame->DeferredShading().SetEnabled(mUseDeferredShading);
+			mShaderProgram.SetPermutation(ShadingPermutation());
+		}
+	}
+
+	UINT PointLightDemo::ShadingPermutation() const
+	{
+		// Both paths light the sphere with the movable light and the clustered ring
+		return (mUseDeferredShading ? ShaderPermutationGBuffer : ShaderPermutationPointLight | ShaderPermutationClusteredLights);
+	}
 }
\ No newline at end of file
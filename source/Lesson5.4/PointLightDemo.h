@@ -2,6 +2,7 @@
 
 #include "DrawableGameComponent.h"
 #include "PointLightEffect.h"
+#include "Game.h"
 
 namespace Library
 {
@@ -22,9 +23,10 @@ namespace Rendering
 		PointLightDemo(Game& game, Camera& camera);
 		~PointLightDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
-		virtual void Draw(const GameTime& gameTime) override;
+		virtual bool Record(const GameTime& gameTime, RenderCommandList& commandList) override;
 
 	private:
 		PointLightDemo();
@@ -34,10 +36,17 @@ namespace Rendering
 		void UpdateAmbientLight(const GameTime& gameTime);
 		void UpdatePointLight(const GameTime& gameTime);
 		void UpdateSpecularLight(const GameTime& gameTime);
+		void UpdateClusteredLights(const GameTime& gameTime);
+		void OnKey(int key, int scancode, int action, int mods);
+		UINT ShadingPermutation() const;
 
 		static const float LightModulationRate;
 		static const float LightMovementRate;
 		static const float RadiusModulationRate;
+		static const UINT ClusteredLightCount;
+		static const float ClusteredLightOrbitRadius;
+		static const float ClusteredLightOrbitRate;
+		static const float ClusteredLightRadius;
 
 		PointLightEffect mShaderProgram;
 		GLuint mVertexArrayObject;
@@ -50,7 +59,10 @@ namespace Rendering
 		PointLight* mPointLight;
 		glm::vec4 mSpecularColor;
 		float mSpecularPower;
+		std::vector<PointLight*> mClusteredLights;
 
 		ProxyModel* mProxyModel;
+		bool mUseDeferredShading;
+		Game::KeyboardHandler mKeyboardHandler;
 	};
 }
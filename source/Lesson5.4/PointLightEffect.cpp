@@ -11,21 +11,12 @@ namespace Library
 
     PointLightEffect::PointLightEffect()
         : ShaderProgram(),
-		SHADER_VARIABLE_INITIALIZATION(WorldViewProjection), SHADER_VARIABLE_INITIALIZATION(World),
-		SHADER_VARIABLE_INITIALIZATION(AmbientColor), SHADER_VARIABLE_INITIALIZATION(LightColor),
-		SHADER_VARIABLE_INITIALIZATION(LightPosition), SHADER_VARIABLE_INITIALIZATION(LightRadius),
-		SHADER_VARIABLE_INITIALIZATION(CameraPosition), SHADER_VARIABLE_INITIALIZATION(SpecularColor),
+		SHADER_VARIABLE_INITIALIZATION(World), SHADER_VARIABLE_INITIALIZATION(SpecularColor),
 		SHADER_VARIABLE_INITIALIZATION(SpecularPower)
     {
     }
 
-    SHADER_VARIABLE_DEFINITION(PointLightEffect, WorldViewProjection)
 	SHADER_VARIABLE_DEFINITION(PointLightEffect, World)
-	SHADER_VARIABLE_DEFINITION(PointLightEffect, AmbientColor)
-	SHADER_VARIABLE_DEFINITION(PointLightEffect, LightColor)
-	SHADER_VARIABLE_DEFINITION(PointLightEffect, LightPosition)
-	SHADER_VARIABLE_DEFINITION(PointLightEffect, LightRadius)
-	SHADER_VARIABLE_DEFINITION(PointLightEffect, CameraPosition)
 	SHADER_VARIABLE_DEFINITION(PointLightEffect, SpecularColor)
 	SHADER_VARIABLE_DEFINITION(PointLightEffect, SpecularPower)
 
@@ -33,13 +24,7 @@ namespace Library
     {
         ShaderProgram::Initialize(vertexArrayObject);
 
-        SHADER_VARIABLE_INSTANTIATE(WorldViewProjection)
 		SHADER_VARIABLE_INSTANTIATE(World)
-		SHADER_VARIABLE_INSTANTIATE(AmbientColor)
-		SHADER_VARIABLE_INSTANTIATE(LightColor)
-		SHADER_VARIABLE_INSTANTIATE(LightPosition)
-		SHADER_VARIABLE_INSTANTIATE(LightRadius)
-		SHADER_VARIABLE_INSTANTIATE(CameraPosition)
 		SHADER_VARIABLE_INSTANTIATE(SpecularColor)
 		SHADER_VARIABLE_INSTANTIATE(SpecularPower)
 
@@ -8,6 +8,7 @@
 #include "VectorHelper.h"
 #include "SpotLight.h"
 #include "ProxyModel.h"
+#include "RenderCommandList.h"
 #include "SOIL.h"
 
 using namespace glm;
@@ -39,15 +40,21 @@ namespace Rendering
 		glDeleteVertexArrays(1, &mVertexArrayObject);
 	}
 
+	void SpotLightDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\LightingEffect.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\LightingEffect.frag"));
+		mShaderProgram.SetPermutation(ShaderPermutationSpotLight);
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
 	void SpotLightDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\SpotLightDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\SpotLightDemo.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 
 		// Create the vertex buffer
 		VertexPositionTextureNormal vertices[] =
@@ -91,6 +98,11 @@ namespace Rendering
 		mSpotLight->SetRadius(500.0f);
 		mSpotLight->SetPosition(5.0f, 0.0f, 10.0f);
 
+		FrameConstants& frameConstants = mGame->FrameData();
+		frameConstants.SetCamera(mCamera);
+		frameConstants.SetAmbientLight(mAmbientLight);
+		frameConstants.SetLight(mSpotLight);
+
 		mProxyModel = new ProxyModel(*mGame, *mCamera, "Content\\Models\\SpotLightProxy.obj", 0.5f);
 		mProxyModel->Initialize();
 		mProxyModel->ApplyRotation(rotate(mat4(), 90.0f, Vector3Helper::Right));
@@ -107,37 +119,26 @@ namespace Rendering
 		mProxyModel->Update(gameTime);
 	}
 
-	void SpotLightDemo::Draw(const GameTime& gameTime)
+	bool SpotLightDemo::Record(const GameTime& gameTime, RenderCommandList& commandList)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
-
-		mShaderProgram.Use();
-
-		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
-		mShaderProgram.WorldViewProjection() << wvp;
-		mShaderProgram.World() << mWorldMatrix;
-		mShaderProgram.AmbientColor() << mAmbientLight->Color();
-		mShaderProgram.LightColor() << mSpotLight->Color();
-		mShaderProgram.LightPosition() << mSpotLight->Position();
-		mShaderProgram.LightRadius() << mSpotLight->Radius();
-		mShaderProgram.LightLookAt() << mSpotLight->Direction();
-		mShaderProgram.CameraPosition() << mCamera->Position();
-		mShaderProgram.SpecularColor() << mSpecularColor;
-		mShaderProgram.SpecularPower() << mSpecularPower;
-		mShaderProgram.SpotLightInnerAngle() << mSpotLight->InnerAngle();
-		mShaderProgram.SpotLightOuterAngle() << mSpotLight->OuterAngle();
-
-		glBindTexture(GL_TEXTURE_2D, mColorTexture);
-
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
-
-		glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
-
-		mProxyModel->Draw(gameTime);
+		DrawItem drawItem;
+		drawItem.Program = &mShaderProgram;
+		drawItem.VertexArray = mVertexArrayObject;
+		drawItem.VertexBuffer = mVertexBuffer;
+		drawItem.IndexBuffer = mIndexBuffer;
+		drawItem.Count = mIndexCount;
+		drawItem.Textures[0] = mColorTexture;
+		drawItem.TextureCount = 1;
+		drawItem.Depth = RenderQueue::ViewDepth(*mCamera, vec3(mWorldMatrix[3]));
+
+		commandList.Submit(drawItem);
+		commandList.SetUniform(mShaderProgram.World(), mWorldMatrix);
+		commandList.SetUniform(mShaderProgram.SpecularColor(), mSpecularColor);
+		commandList.SetUniform(mShaderProgram.SpecularPower(), mSpecularPower);
+
+		mProxyModel->Record(gameTime, commandList);
+
+		return true;
 	}
 
 	void SpotLightDemo::UpdateAmbientLight(const GameTime& gameTime)
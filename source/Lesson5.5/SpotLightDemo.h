@@ -22,9 +22,10 @@ namespace Rendering
 		SpotLightDemo(Game& game, Camera& camera);
 		~SpotLightDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
-		virtual void Draw(const GameTime& gameTime) override;
+		virtual bool Record(const GameTime& gameTime, RenderCommandList& commandList) override;
 
 	private:
 		SpotLightDemo();
@@ -10,18 +10,9 @@ namespace Library
     {
 		RTTI_DECLARATIONS(SpotLightEffect, ShaderProgram)
 
-        SHADER_VARIABLE_DECLARATION(WorldViewProjection)
 		SHADER_VARIABLE_DECLARATION(World)
-		SHADER_VARIABLE_DECLARATION(AmbientColor)
-		SHADER_VARIABLE_DECLARATION(LightColor)
-		SHADER_VARIABLE_DECLARATION(LightPosition)
-		SHADER_VARIABLE_DECLARATION(LightRadius)
-		SHADER_VARIABLE_DECLARATION(LightLookAt)
-		SHADER_VARIABLE_DECLARATION(CameraPosition)
 		SHADER_VARIABLE_DECLARATION(SpecularColor)
 		SHADER_VARIABLE_DECLARATION(SpecularPower)
-		SHADER_VARIABLE_DECLARATION(SpotLightInnerAngle)
-		SHADER_VARIABLE_DECLARATION(SpotLightOuterAngle)
 
     public:
         SpotLightEffect();
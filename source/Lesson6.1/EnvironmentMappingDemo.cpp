@@ -1,5 +1,6 @@
 #include "EnvironmentMappingDemo.h"
 #include "Game.h"
+#include "RenderCommandList.h"
 #include "GameException.h"
 #include "ColorHelper.h"
 #include "Camera.h"
@@ -8,8 +9,8 @@
 #include "Model.h"
 #include "Mesh.h"
 #include "Light.h"
+#include "CubemapLoader.h"
 #include "SOIL.h"
-#include <sstream>
 
 using namespace glm;
 
@@ -27,8 +28,6 @@ namespace Rendering
 
 	EnvironmentMappingDemo::~EnvironmentMappingDemo()
 	{
-		glDeleteSamplers(1, &mEnvironmentMapSampler);
-		glDeleteSamplers(1, &mColorTextureSampler);
 		DeleteObject(mAmbientLight);
 		glDeleteTextures(1, &mEnvironmentMap);
 		glDeleteTextures(1, &mColorTexture);
@@ -37,15 +36,20 @@ namespace Rendering
 		glDeleteVertexArrays(1, &mVertexArrayObject);
 	}
 
+	void EnvironmentMappingDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\EnvironmentMappingDemo.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\EnvironmentMappingDemo.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
 	void EnvironmentMappingDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\EnvironmentMappingDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\EnvironmentMappingDemo.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 		
 		// Load the model
 		std::unique_ptr<Model> model(new Model(*mGame, "Content\\Models\\Sphere.obj", true));
@@ -63,29 +67,12 @@ namespace Rendering
 			throw GameException("SOIL_load_OGL_texture() failed.");
 		}
 
-		glGenSamplers(1, &mColorTextureSampler);
-		glSamplerParameteri(mColorTextureSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glSamplerParameteri(mColorTextureSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glSamplerParameteri(mColorTextureSampler, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glSamplerParameteri(mColorTextureSampler, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		mColorTextureSampler = mGame->Samplers().Sampler(SamplerDescription::LinearWrap);
 
 		// Load the environment map
-		std::wostringstream environmentMapFilename;
-		environmentMapFilename << Utility::ExecutableDirectory() << "\\Content\\Textures\\Maskonaive2_1024";
-		SetCurrentDirectory(environmentMapFilename.str().c_str());
-		
-		mEnvironmentMap = SOIL_load_OGL_cubemap("posx.jpg", "negx.jpg", "posy.jpg", "negy.jpg", "posz.jpg", "negz.jpg", SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID, SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT);
-		if (mEnvironmentMap == 0)
-		{
-			throw GameException("SOIL_load_OGL_cubemap() failed.");
-		}
+		mEnvironmentMap = CubemapLoader::LoadCubemap("Content/Textures/Maskonaive2_1024/posx.jpg", "Content/Textures/Maskonaive2_1024/negx.jpg", "Content/Textures/Maskonaive2_1024/posy.jpg", "Content/Textures/Maskonaive2_1024/negy.jpg", "Content/Textures/Maskonaive2_1024/posz.jpg", "Content/Textures/Maskonaive2_1024/negz.jpg", SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT);
 
-		glGenSamplers(1, &mEnvironmentMapSampler);
-		glSamplerParameteri(mEnvironmentMapSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glSamplerParameteri(mEnvironmentMapSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glSamplerParameteri(mEnvironmentMapSampler, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glSamplerParameteri(mEnvironmentMapSampler, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glSamplerParameteri(mEnvironmentMapSampler, GL_TEXTURE_WRAP_R, GL_REPEAT);
+		mEnvironmentMapSampler = mGame->Samplers().Sampler(SamplerDescription::LinearWrap);
 
 		// Create the vertex array object
 		glGenVertexArrays(1, &mVertexArrayObject);
@@ -102,35 +89,31 @@ namespace Rendering
 		UpdateReflectionAmount(gameTime);
 	}
 
-	void EnvironmentMappingDemo::Draw(const GameTime& gameTime)
+	bool EnvironmentMappingDemo::Record(const GameTime& gameTime, RenderCommandList& commandList)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
-		
-		mShaderProgram.Use();
-
-		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
-		mShaderProgram.WorldViewProjection() << wvp;
-		mShaderProgram.World() << mWorldMatrix;
-		mShaderProgram.AmbientColor() << mAmbientLight->Color();
-		mShaderProgram.EnvironmentColor() << mEnvironmentColor;
-		mShaderProgram.ReflectionAmount() << mReflectionAmount;
-		mShaderProgram.CameraPosition() << mCamera->Position();
-
-		glBindSampler(0, mEnvironmentMapSampler);
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, mEnvironmentMap);
-
-		glBindSampler(1, mColorTextureSampler);
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, mColorTexture);
-	
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
-
-		glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
+		DrawItem drawItem;
+		drawItem.Program = &mShaderProgram;
+		drawItem.VertexArray = mVertexArrayObject;
+		drawItem.VertexBuffer = mVertexBuffer;
+		drawItem.IndexBuffer = mIndexBuffer;
+		drawItem.Count = mIndexCount;
+		drawItem.TextureTargets[0] = GL_TEXTURE_CUBE_MAP;
+		drawItem.Textures[0] = mEnvironmentMap;
+		drawItem.Textures[1] = mColorTexture;
+		drawItem.Samplers[0] = mEnvironmentMapSampler;
+		drawItem.Samplers[1] = mColorTextureSampler;
+		drawItem.TextureCount = 2;
+		drawItem.Depth = RenderQueue::ViewDepth(*mCamera, vec3(mWorldMatrix[3]));
+
+		commandList.Submit(drawItem);
+		commandList.SetUniform(mShaderProgram.WorldViewProjection(), mCamera->ViewProjectionMatrix() * mWorldMatrix);
+		commandList.SetUniform(mShaderProgram.World(), mWorldMatrix);
+		commandList.SetUniform(mShaderProgram.AmbientColor(), mAmbientLight->Color());
+		commandList.SetUniform(mShaderProgram.EnvironmentColor(), mEnvironmentColor);
+		commandList.SetUniform(mShaderProgram.ReflectionAmount(), mReflectionAmount);
+		commandList.SetUniform(mShaderProgram.CameraPosition(), mCamera->Position());
+
+		return true;
 	}
 
 	void EnvironmentMappingDemo::UpdateAmbientLight(const GameTime& gameTime)
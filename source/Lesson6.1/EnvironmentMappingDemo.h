@@ -20,9 +20,10 @@ namespace Rendering
 		EnvironmentMappingDemo(Game& game, Camera& camera);
 		~EnvironmentMappingDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
-		virtual void Draw(const GameTime& gameTime) override;
+		virtual bool Record(const GameTime& gameTime, RenderCommandList& commandList) override;
 
 	private:
 		EnvironmentMappingDemo();
@@ -6,16 +6,23 @@
 #include "Grid.h"
 #include "Utility.h"
 #include "Skybox.h"
+#include "TransformHierarchy.h"
+#include "SkinnedModel.h"
+#include "AnimationPlayer.h"
 #include "FogDemo.h"
 
 namespace Rendering
 {
 	RTTI_DEFINITIONS(RenderingGame)
 
+	const int RenderingGame::SkinnedModelColumns = 2;
+	const UINT RenderingGame::SkinnedModelRows = 3;
+	const float RenderingGame::SkinnedModelSpacing = 8.0f;
+
 	RenderingGame::RenderingGame(HINSTANCE instance, const std::wstring& windowTitle)
 		: Game(instance, windowTitle),
 		mCamera(nullptr), mKeyboardHandler(nullptr), mGrid(nullptr), mSkybox(nullptr),
-		mFogDemo(nullptr)
+		mFogDemo(nullptr), mSkinnedModels()
 	{
 		mDepthStencilBufferEnabled = true;
 	}
@@ -41,13 +48,41 @@ namespace Rendering
 		mFogDemo = new FogDemo(*this, *mCamera);
 		mComponents.push_back(mFogDemo);
 
+		// Rows of swaying tentacles on both sides of the globe, fading into the fog with distance
+		for (UINT row = 0; row < SkinnedModelRows; row++)
+		{
+			for (int column = -SkinnedModelColumns; column <= SkinnedModelColumns; column++)
+			{
+				if (column != 0)
+				{
+					SkinnedModel* skinnedModel = new SkinnedModel(*this, *mCamera, "Content\\Models\\Tentacle.dae");
+					Transforms().SetLocalTranslation(skinnedModel->TransformNode(), glm::vec3(column * SkinnedModelSpacing, 0.0f, -(row * 2.0f + 1.0f) * SkinnedModelSpacing));
+					skinnedModel->Color() = ColorHelper::RandomColor();
+					mSkinnedModels.push_back(skinnedModel);
+					mComponents.push_back(skinnedModel);
+				}
+			}
+		}
+
 		Game::Initialize();
 
+		// Differing playback rates keep the tentacles out of step
+		for (UINT i = 0; i < mSkinnedModels.size(); i++)
+		{
+			mSkinnedModels[i]->Player().TimeScale() = 0.7f + 0.1f * (i % 6);
+		}
+
 		mCamera->SetPosition(0, 5, 20);
 	}
 
 	void RenderingGame::Shutdown()
 	{
+		for (SkinnedModel* skinnedModel : mSkinnedModels)
+		{
+			DeleteObject(skinnedModel);
+		}
+		mSkinnedModels.clear();
+
 		DeleteObject(mFogDemo);
 
 		RemoveKeyboardHandler(mKeyboardHandler);
@@ -10,6 +10,7 @@ namespace Library
 	class FirstPersonCamera;
 	class Grid;
 	class Skybox;
+	class SkinnedModel;
 }
 
 namespace Rendering
@@ -31,11 +32,16 @@ namespace Rendering
 	private:
 		void OnKey(int key, int scancode, int action, int mods);
 
+		static const int SkinnedModelColumns;
+		static const UINT SkinnedModelRows;
+		static const float SkinnedModelSpacing;
+
 		FirstPersonCamera* mCamera;
 		KeyboardHandler mKeyboardHandler;
 		Grid* mGrid;
 		Skybox* mSkybox;
 
 		FogDemo* mFogDemo;
+		std::vector<SkinnedModel*> mSkinnedModels;
 	};
 }
@@ -7,6 +7,7 @@
 #include "VectorHelper.h"
 #include "DirectionalLight.h"
 #include "ProxyModel.h"
+#include "RenderCommandList.h"
 #include "SOIL.h"
 
 using namespace glm;
@@ -29,7 +30,6 @@ namespace Rendering
 
 	TransparencyMappingDemo::~TransparencyMappingDemo()
 	{
-		glDeleteSamplers(1, &mTrilinearSampler);
 		glDeleteTextures(1, &mAlphaMap);
 		DeleteObject(mProxyModel);
 		DeleteObject(mDirectionalLight);
@@ -40,15 +40,21 @@ namespace Rendering
 		glDeleteVertexArrays(1, &mVertexArrayObject);
 	}
 
+	void TransparencyMappingDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\LightingEffect.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\LightingEffect.frag"));
+		mShaderProgram.SetPermutation(ShaderPermutationFog | ShaderPermutationAlphaMap);
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
 	void TransparencyMappingDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\TransparencyMappingDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\TransparencyMappingDemo.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 
 		// Create the vertex buffer
 		VertexPositionTextureNormal vertices[] =
@@ -89,12 +95,8 @@ namespace Rendering
 			throw GameException("SOIL_load_OGL_texture() failed.");
 		}
 
-		// Create the trilinear texture sampler
-		glGenSamplers(1, &mTrilinearSampler);
-		glSamplerParameteri(mTrilinearSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glSamplerParameteri(mTrilinearSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glSamplerParameteri(mTrilinearSampler, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glSamplerParameteri(mTrilinearSampler, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		// Acquire the shared texture sampler
+		mTrilinearSampler = mGame->Samplers().Sampler(SamplerDescription::LinearWrap);
 
 		// Create the vertex array object
 		glGenVertexArrays(1, &mVertexArrayObject);
@@ -106,6 +108,11 @@ namespace Rendering
 
 		mDirectionalLight = new DirectionalLight(*mGame);
 
+		FrameConstants& frameConstants = mGame->FrameData();
+		frameConstants.SetCamera(mCamera);
+		frameConstants.SetAmbientLight(mAmbientLight);
+		frameConstants.SetLight(mDirectionalLight);
+
 		mProxyModel = new ProxyModel(*mGame, *mCamera, "Content\\Models\\DirectionalLightProxy.obj", 0.5f);
 		mProxyModel->Initialize();
 		mProxyModel->SetPosition(10.0f, 0.0, 0.0f);
@@ -123,47 +130,34 @@ namespace Rendering
 		mProxyModel->Update(gameTime);
 	}
 
-	void TransparencyMappingDemo::Draw(const GameTime& gameTime)
+	bool TransparencyMappingDemo::Record(const GameTime& gameTime, RenderCommandList& commandList)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
-
-		mShaderProgram.Use();
-
-		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
-		mShaderProgram.WorldViewProjection() << wvp;
-		mShaderProgram.World() << mWorldMatrix;
-		mShaderProgram.AmbientColor() << mAmbientLight->Color();
-		mShaderProgram.LightColor() << mDirectionalLight->Color();
-		mShaderProgram.LightDirection() << mDirectionalLight->Direction();
-		mShaderProgram.CameraPosition() << mCamera->Position();
-		mShaderProgram.SpecularColor() << mSpecularColor;
-		mShaderProgram.SpecularPower() << mSpecularPower;
-		mShaderProgram.FogColor() << mFogColor;
-		mShaderProgram.FogStart() << mFogStart;
-		mShaderProgram.FogRange() << mFogRange;
-
-		glBindSampler(0, mTrilinearSampler);
-		glBindSampler(1, mTrilinearSampler);
-
-		glActiveTexture(GL_TEXTURE0);
-		glBindTexture(GL_TEXTURE_2D, mColorTexture);
-
-		glActiveTexture(GL_TEXTURE1);
-		glBindTexture(GL_TEXTURE_2D, mAlphaMap);
-
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
-
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-		glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
-		glDisable(GL_BLEND);
-
-		glBindVertexArray(0);
-
-		mProxyModel->Draw(gameTime);
+		DrawItem drawItem;
+		drawItem.Layer = RenderLayerTransparent;
+		drawItem.DepthWriteEnabled = false;
+		drawItem.Program = &mShaderProgram;
+		drawItem.VertexArray = mVertexArrayObject;
+		drawItem.VertexBuffer = mVertexBuffer;
+		drawItem.IndexBuffer = mIndexBuffer;
+		drawItem.Count = mIndexCount;
+		drawItem.Textures[0] = mColorTexture;
+		drawItem.Textures[1] = mAlphaMap;
+		drawItem.Samplers[0] = mTrilinearSampler;
+		drawItem.Samplers[1] = mTrilinearSampler;
+		drawItem.TextureCount = 2;
+		drawItem.Depth = RenderQueue::ViewDepth(*mCamera, vec3(mWorldMatrix[3]));
+
+		commandList.Submit(drawItem);
+		commandList.SetUniform(mShaderProgram.World(), mWorldMatrix);
+		commandList.SetUniform(mShaderProgram.SpecularColor(), mSpecularColor);
+		commandList.SetUniform(mShaderProgram.SpecularPower(), mSpecularPower);
+		commandList.SetUniform(mShaderProgram.FogColor(), mFogColor);
+		commandList.SetUniform(mShaderProgram.FogStart(), mFogStart);
+		commandList.SetUniform(mShaderProgram.FogRange(), mFogRange);
+
+		mProxyModel->Record(gameTime, commandList);
+
+		return true;
 	}
 
 	void TransparencyMappingDemo::UpdateAmbientLight(const GameTime& gameTime)
@@ -22,9 +22,10 @@ namespace Rendering
 		TransparencyMappingDemo(Game& game, Camera& camera);
 		~TransparencyMappingDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
-		virtual void Draw(const GameTime& gameTime) override;
+		virtual bool Record(const GameTime& gameTime, RenderCommandList& commandList) override;
 
 	private:
 		TransparencyMappingDemo();
@@ -11,21 +11,13 @@ namespace Library
 
 	TransparencyMappingEffect::TransparencyMappingEffect()
 		: ShaderProgram(),
-		SHADER_VARIABLE_INITIALIZATION(WorldViewProjection), SHADER_VARIABLE_INITIALIZATION(World),
-		SHADER_VARIABLE_INITIALIZATION(AmbientColor), SHADER_VARIABLE_INITIALIZATION(LightColor),
-		SHADER_VARIABLE_INITIALIZATION(LightDirection), SHADER_VARIABLE_INITIALIZATION(CameraPosition),
-		SHADER_VARIABLE_INITIALIZATION(SpecularColor), SHADER_VARIABLE_INITIALIZATION(SpecularPower),
-		SHADER_VARIABLE_INITIALIZATION(FogColor), SHADER_VARIABLE_INITIALIZATION(FogStart),
-		SHADER_VARIABLE_INITIALIZATION(FogRange)
+		SHADER_VARIABLE_INITIALIZATION(World), SHADER_VARIABLE_INITIALIZATION(SpecularColor),
+		SHADER_VARIABLE_INITIALIZATION(SpecularPower), SHADER_VARIABLE_INITIALIZATION(FogColor),
+		SHADER_VARIABLE_INITIALIZATION(FogStart), SHADER_VARIABLE_INITIALIZATION(FogRange)
 	{
 	}
 
-	SHADER_VARIABLE_DEFINITION(TransparencyMappingEffect, WorldViewProjection)
 	SHADER_VARIABLE_DEFINITION(TransparencyMappingEffect, World)
-	SHADER_VARIABLE_DEFINITION(TransparencyMappingEffect, AmbientColor)
-	SHADER_VARIABLE_DEFINITION(TransparencyMappingEffect, LightColor)
-	SHADER_VARIABLE_DEFINITION(TransparencyMappingEffect, LightDirection)
-	SHADER_VARIABLE_DEFINITION(TransparencyMappingEffect, CameraPosition)
 	SHADER_VARIABLE_DEFINITION(TransparencyMappingEffect, SpecularColor)
 	SHADER_VARIABLE_DEFINITION(TransparencyMappingEffect, SpecularPower)
 	SHADER_VARIABLE_DEFINITION(TransparencyMappingEffect, FogColor)
@@ -36,12 +28,7 @@ namespace Library
 	{
 		ShaderProgram::Initialize(vertexArrayObject);
 
-		SHADER_VARIABLE_INSTANTIATE(WorldViewProjection)
 		SHADER_VARIABLE_INSTANTIATE(World)
-		SHADER_VARIABLE_INSTANTIATE(AmbientColor)
-		SHADER_VARIABLE_INSTANTIATE(LightColor)
-		SHADER_VARIABLE_INSTANTIATE(LightDirection)
-		SHADER_VARIABLE_INSTANTIATE(CameraPosition)
 		SHADER_VARIABLE_INSTANTIATE(SpecularColor)
 		SHADER_VARIABLE_INSTANTIATE(SpecularPower)
 		SHADER_VARIABLE_INSTANTIATE(FogColor)
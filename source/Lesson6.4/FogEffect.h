@@ -1,43 +0,0 @@
-#pragma once
-
-#include "Common.h"
-#include "ShaderProgram.h"
-#include "VertexDeclarations.h"
-
-namespace Library
-{
-	class FogEffect : public ShaderProgram
-	{
-		RTTI_DECLARATIONS(FogEffect, ShaderProgram)
-
-		SHADER_VARIABLE_DECLARATION(WorldViewProjection)
-		SHADER_VARIABLE_DECLARATION(World)
-		SHADER_VARIABLE_DECLARATION(AmbientColor)
-		SHADER_VARIABLE_DECLARATION(LightColor)
-		SHADER_VARIABLE_DECLARATION(LightDirection)
-		SHADER_VARIABLE_DECLARATION(CameraPosition)
-		SHADER_VARIABLE_DECLARATION(SpecularColor)
-		SHADER_VARIABLE_DECLARATION(SpecularPower)
-		SHADER_VARIABLE_DECLARATION(FogColor)
-		SHADER_VARIABLE_DECLARATION(FogStart)
-		SHADER_VARIABLE_DECLARATION(FogRange)
-
-	public:
-		FogEffect();
-		FogEffect(const FogEffect& rhs);
-		FogEffect& operator=(const FogEffect& rhs);
-
-		virtual void Initialize(GLuint vertexArrayObject) override;
-		virtual void CreateVertexBuffer(const Mesh& mesh, GLuint& vertexBuffer) const override;
-		void CreateVertexBuffer(VertexPositionTextureNormal* vertices, UINT vertexCount, GLuint& vertexBuffer) const;
-		virtual UINT VertexSize() const override;
-
-	private:
-		enum VertexAttribute
-		{
-			VertexAttributePosition = 0,
-			VertexAttributeTextureCoordinate = 1,
-			VertexAttributeNormal = 2
-		};
-	};
-}
\ No newline at end of file
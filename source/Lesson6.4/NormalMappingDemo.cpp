@@ -7,6 +7,7 @@
 #include "VectorHelper.h"
 #include "DirectionalLight.h"
 #include "ProxyModel.h"
+#include "RenderCommandList.h"
 #include "SOIL.h"
 
 using namespace glm;
@@ -19,8 +20,8 @@ namespace Rendering
 	const float NormalMappingDemo::LightModulationRate = UCHAR_MAX;
 
 	NormalMappingDemo::NormalMappingDemo(Game& game, Camera& camera)
-		: DrawableGameComponent(game, camera), mNormalMappingEffect(), mFogEffect(), mNormalMappingVAO(0), mFogVAO(0),
-		mNormalMappingVertexBuffer(0), mFogVertexBuffer(0), mIndexBuffer(0), mWorldMatrix(), mIndexCount(), mColorTexture(0), mAmbientLight(nullptr),
+		: DrawableGameComponent(game, camera), mNormalMappingEffect(), mVertexArrayObject(0),
+		mVertexBuffer(0), mIndexBuffer(0), mWorldMatrix(), mIndexCount(), mColorTexture(0), mAmbientLight(nullptr),
 		mDirectionalLight(nullptr), mSpecularColor(ColorHelper::Black), mSpecularPower(25.0f),
 		mFogColor(ColorHelper::CornflowerBlue), mFogStart(20.0f), mFogRange(40.0f),
 		mNormalMap(0), mTrilinearSampler(0), mProxyModel(nullptr), mShowNormalMapping(true), mKeyboardHandler(nullptr)
@@ -30,33 +31,32 @@ namespace Rendering
 	NormalMappingDemo::~NormalMappingDemo()
 	{
 		mGame->RemoveKeyboardHandler(mKeyboardHandler);
-		glDeleteSamplers(1, &mTrilinearSampler);
 		glDeleteTextures(1, &mNormalMap);
 		DeleteObject(mProxyModel);
 		DeleteObject(mDirectionalLight);
 		DeleteObject(mAmbientLight);
 		glDeleteTextures(1, &mColorTexture);
 		glDeleteBuffers(1, &mIndexBuffer);
-		glDeleteBuffers(1, &mNormalMappingVertexBuffer);
-		glDeleteBuffers(1, &mFogVertexBuffer);
-		glDeleteVertexArrays(1, &mFogVAO);
-		glDeleteVertexArrays(1, &mNormalMappingVAO);
+		glDeleteBuffers(1, &mVertexBuffer);
+		glDeleteVertexArrays(1, &mVertexArrayObject);
+	}
+
+	void NormalMappingDemo::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		// The fog-only variant is compiled the first time it is shown
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\LightingEffect.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\LightingEffect.frag"));
+		mNormalMappingEffect.SetPermutation(ShaderPermutationFog | ShaderPermutationNormalMap);
+		builds.push_back(ShaderProgramBuild(&mNormalMappingEffect, shaders));
 	}
 
 	void NormalMappingDemo::Initialize()
 	{
 		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
 
-		// Build the shader programs
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\NormalMappingDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\NormalMappingDemo.frag"));
-		mNormalMappingEffect.BuildProgram(shaders);
-
-		shaders.clear();
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\FogDemo.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\FogDemo.frag"));
-		mFogEffect.BuildProgram(shaders);
+		// Build the shader program
+		BuildPrograms();
 
 		// Load the color texture
 		mColorTexture = SOIL_load_OGL_texture("Content\\Textures\\Blocks_COLOR.tga", SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID, SOIL_FLAG_MIPMAPS | SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT);
@@ -72,19 +72,15 @@ namespace Rendering
 			throw GameException("SOIL_load_OGL_texture() failed.");
 		}
 
-		// Create the trilinear texture sampler
-		glGenSamplers(1, &mTrilinearSampler);
-		glSamplerParameteri(mTrilinearSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glSamplerParameteri(mTrilinearSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glSamplerParameteri(mTrilinearSampler, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glSamplerParameteri(mTrilinearSampler, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		// Acquire the shared texture sampler
+		mTrilinearSampler = mGame->Samplers().Sampler(SamplerDescription::LinearWrap);
 
-		// Create the normal mapping vertex array object
-		glGenVertexArrays(1, &mNormalMappingVAO);
-		glBindVertexArray(mNormalMappingVAO);
+		// Create the vertex array object
+		glGenVertexArrays(1, &mVertexArrayObject);
+		glBindVertexArray(mVertexArrayObject);
 
-		// Create the normal mapping vertex buffer
-		VertexPositionTextureNormalTangentBinormal normalMappingVertices[] =
+		// Create the vertex buffer; the fog-only variant ignores the tangent and binormal
+		VertexPositionTextureNormalTangentBinormal vertices[] =
 		{
 			VertexPositionTextureNormalTangentBinormal(vec4(-1.0f, 0.1f, 0.0f, 1.0f), vec2(0.0f, 1.0f), Vector3Helper::Backward, Vector3Helper::Down, Vector3Helper::Right),
 			VertexPositionTextureNormalTangentBinormal(vec4(-1.0f, 2.1f, 0.0f, 1.0f), vec2(0.0f, 0.0f), Vector3Helper::Backward, Vector3Helper::Down, Vector3Helper::Right),
@@ -92,24 +88,8 @@ namespace Rendering
 			VertexPositionTextureNormalTangentBinormal(vec4(1.0f, 0.1f, 0.0f, 1.0f), vec2(1.0f, 1.0f), Vector3Helper::Backward, Vector3Helper::Down, Vector3Helper::Right)
 		};
 
-		mNormalMappingEffect.CreateVertexBuffer(normalMappingVertices, ARRAYSIZE(normalMappingVertices), mNormalMappingVertexBuffer);
-		mNormalMappingEffect.Initialize(mNormalMappingVAO);
-
-		// Create the fog vertex array object
-		glGenVertexArrays(1, &mFogVAO);
-		glBindVertexArray(mFogVAO);
-		
-		// Create the fog vertex buffer
-		VertexPositionTextureNormal fogVertices[] =
-		{
-			VertexPositionTextureNormal(vec4(-1.0f, 0.1f, 0.0f, 1.0f), vec2(0.0f, 1.0f), Vector3Helper::Backward),
-			VertexPositionTextureNormal(vec4(-1.0f, 2.1f, 0.0f, 1.0f), vec2(0.0f, 0.0f), Vector3Helper::Backward),
-			VertexPositionTextureNormal(vec4(1.0f, 2.1f, 0.0f, 1.0f), vec2(1.0f, 0.0f), Vector3Helper::Backward),
-			VertexPositionTextureNormal(vec4(1.0f, 0.1f, 0.0f, 1.0f), vec2(1.0f, 1.0f), Vector3Helper::Backward)
-		};
-
-		mFogEffect.CreateVertexBuffer(fogVertices, ARRAYSIZE(fogVertices), mFogVertexBuffer);
-		mFogEffect.Initialize(mFogVAO);
+		mNormalMappingEffect.CreateVertexBuffer(vertices, ARRAYSIZE(vertices), mVertexBuffer);
+		mNormalMappingEffect.Initialize(mVertexArrayObject);
 		glBindVertexArray(0);
 		
 		// Create the index buffer
@@ -130,6 +110,11 @@ namespace Rendering
 
 		mDirectionalLight = new DirectionalLight(*mGame);
 
+		FrameConstants& frameConstants = mGame->FrameData();
+		frameConstants.SetCamera(mCamera);
+		frameConstants.SetAmbientLight(mAmbientLight);
+		frameConstants.SetLight(mDirectionalLight);
+
 		mProxyModel = new ProxyModel(*mGame, *mCamera, "Content\\Models\\DirectionalLightProxy.obj", 0.5f);
 		mProxyModel->Initialize();
 		mProxyModel->SetPosition(10.0f, 0.0, 0.0f);
@@ -152,71 +137,32 @@ namespace Rendering
 		mProxyModel->Update(gameTime);
 	}
 
-	void NormalMappingDemo::Draw(const GameTime& gameTime)
+	bool NormalMappingDemo::Record(const GameTime& gameTime, RenderCommandList& commandList)
 	{
-		if (mShowNormalMapping)
-		{
-			glBindVertexArray(mNormalMappingVAO);
-			glBindBuffer(GL_ARRAY_BUFFER, mNormalMappingVertexBuffer);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
-
-			mNormalMappingEffect.Use();
-
-			mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
-			mNormalMappingEffect.WorldViewProjection() << wvp;
-			mNormalMappingEffect.World() << mWorldMatrix;
-			mNormalMappingEffect.AmbientColor() << mAmbientLight->Color();
-			mNormalMappingEffect.LightColor() << mDirectionalLight->Color();
-			mNormalMappingEffect.LightDirection() << mDirectionalLight->Direction();
-			mNormalMappingEffect.CameraPosition() << mCamera->Position();
-			mNormalMappingEffect.SpecularColor() << mSpecularColor;
-			mNormalMappingEffect.SpecularPower() << mSpecularPower;
-			mNormalMappingEffect.FogColor() << mFogColor;
-			mNormalMappingEffect.FogStart() << mFogStart;
-			mNormalMappingEffect.FogRange() << mFogRange;
-
-			glBindSampler(0, mTrilinearSampler);
-			glBindSampler(1, mTrilinearSampler);
-
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, mColorTexture);
-
-			glActiveTexture(GL_TEXTURE1);
-			glBindTexture(GL_TEXTURE_2D, mNormalMap);
-		}
-		else
-		{
-			glBindVertexArray(mFogVAO);
-			glBindBuffer(GL_ARRAY_BUFFER, mFogVertexBuffer);
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
-
-			mFogEffect.Use();
-
-			mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
-			mFogEffect.WorldViewProjection() << wvp;
-			mFogEffect.World() << mWorldMatrix;
-			mFogEffect.AmbientColor() << mAmbientLight->Color();
-			mFogEffect.LightColor() << mDirectionalLight->Color();
-			mFogEffect.LightDirection() << mDirectionalLight->Direction();
-			mFogEffect.CameraPosition() << mCamera->Position();
-			mFogEffect.SpecularColor() << mSpecularColor;
-			mFogEffect.SpecularPower() << mSpecularPower;
-			mFogEffect.FogColor() << mFogColor;
-			mFogEffect.FogStart() << mFogStart;
-			mFogEffect.FogRange() << mFogRange;
-
-			glBindSampler(0, mTrilinearSampler);
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, mColorTexture);
-		}
-
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
-
-		glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
-		glBindVertexArray(0);
-
-		mProxyModel->Draw(gameTime);
+		DrawItem drawItem;
+		drawItem.Program = &mNormalMappingEffect;
+		drawItem.VertexArray = mVertexArrayObject;
+		drawItem.VertexBuffer = mVertexBuffer;
+		drawItem.IndexBuffer = mIndexBuffer;
+		drawItem.Count = mIndexCount;
+		drawItem.Textures[0] = mColorTexture;
+		drawItem.Textures[1] = mNormalMap;
+		drawItem.Samplers[0] = mTrilinearSampler;
+		drawItem.Samplers[1] = mTrilinearSampler;
+		drawItem.TextureCount = 2;
+		drawItem.Depth = RenderQueue::ViewDepth(*mCamera, vec3(mWorldMatrix[3]));
+
+		commandList.Submit(drawItem);
+		commandList.SetUniform(mNormalMappingEffect.World(), mWorldMatrix);
+		commandList.SetUniform(mNormalMappingEffect.SpecularColor(), mSpecularColor);
+		commandList.SetUniform(mNormalMappingEffect.SpecularPower(), mSpecularPower);
+		commandList.SetUniform(mNormalMappingEffect.FogColor(), mFogColor);
+		commandList.SetUniform(mNormalMappingEffect.FogStart(), mFogStart);
+		commandList.SetUniform(mNormalMappingEffect.FogRange(), mFogRange);
+
+		mProxyModel->Record(gameTime, commandList);
+
+		return true;
 	}
 
 	void NormalMappingDemo::UpdateAmbientLight(const GameTime& gameTime)
@@ -342,6 +288,7 @@ namespace Rendering
 		if (key == GLFW_KEY_SPACE && action == GLFW_PRESS)
 		{
 			mShowNormalMapping = !mShowNormalMapping;
+			mNormalMappingEffect.SetPermutation(mShowNormalMapping ? ShaderPermutationFog | ShaderPermutationNormalMap : ShaderPermutationFog);
 		}
 	}
 }
\ No newline at end of file
@@ -2,7 +2,6 @@
 
 #include "DrawableGameComponent.h"
 #include "NormalMappingEffect.h"
-#include "FogEffect.h"
 #include "Game.h"
 
 namespace Library
@@ -24,9 +23,10 @@ namespace Rendering
 		NormalMappingDemo(Game& game, Camera& camera);
 		~NormalMappingDemo();
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;
-		virtual void Draw(const GameTime& gameTime) override;
+		virtual bool Record(const GameTime& gameTime, RenderCommandList& commandList) override;
 
 	private:
 		NormalMappingDemo();
@@ -42,11 +42,8 @@ namespace Rendering
 		static const float LightModulationRate;
 
 		NormalMappingEffect mNormalMappingEffect;
-		FogEffect mFogEffect;
-		GLuint mNormalMappingVAO;
-		GLuint mFogVAO;
-		GLuint mNormalMappingVertexBuffer;
-		GLuint mFogVertexBuffer;
+		GLuint mVertexArrayObject;
+		GLuint mVertexBuffer;
 		GLuint mIndexBuffer;
 		glm::mat4 mWorldMatrix;
 		GLuint mIndexCount;
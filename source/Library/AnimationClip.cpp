@@ -0,0 +1,293 @@
+#include "AnimationClip.h"
+#include "AnimationPose.h"
+#include "GameException.h"
+#include "Model.h"
+#include <assimp/scene.h>
+#include <cmath>
+
+using namespace glm;
+
+namespace Library
+{
+	const float AnimationClip::DefaultSampleRate = 30.0f;
+	const float AnimationClip::ConstantTolerance = 0.00001f;
+
+	AnimationClip::AnimationClip(Model& model, aiAnimation& animation)
+		: mName(animation.mName.C_Str()), mDuration(0.0f), mSampleRate(DefaultSampleRate), mFrameCount(1), mTracks()
+	{
+		// Assimp leaves the tick rate at zero when the source format does not specify one
+		double ticksPerSecond = (animation.mTicksPerSecond > 0.0 ? animation.mTicksPerSecond : 25.0);
+		mDuration = static_cast<float>(animation.mDuration / ticksPerSecond);
+		mFrameCount = static_cast<UINT>(ceil(mDuration * mSampleRate)) + 1;
+
+		std::vector<vec3> translations;
+		std::vector<quat> rotations;
+		std::vector<vec3> scales;
+
+		for (UINT i = 0; i < animation.mNumChannels; i++)
+		{
+			const aiNodeAnim& channel = *(animation.mChannels[i]);
+
+			// Channels can target nodes the model does not keep, and some exporters leave a key list empty
+			UINT joint = model.NodeIndex(channel.mNodeName.C_Str());
+			if (joint == Model::NullNode || channel.mNumPositionKeys == 0 || channel.mNumRotationKeys == 0 || channel.mNumScalingKeys == 0)
+			{
+				continue;
+			}
+
+			ResampleChannel(channel, ticksPerSecond, mSampleRate, mFrameCount, mDuration, translations, rotations, scales);
+
+			Track track;
+			track.Joint = joint;
+			EncodeVectors(translations, track.TranslationMinimum, track.TranslationExtent, track.Translations);
+			EncodeRotations(rotations, track.Rotations);
+			EncodeVectors(scales, track.ScaleMinimum, track.ScaleExtent, track.Scales);
+
+			mTracks.push_back(track);
+		}
+	}
+
+	AnimationClip::~AnimationClip()
+	{
+	}
+
+	const std::string& AnimationClip::Name() const
+	{
+		return mName;
+	}
+
+	float AnimationClip::Duration() const
+	{
+		return mDuration;
+	}
+
+	float AnimationClip::SampleRate() const
+	{
+		return mSampleRate;
+	}
+
+	UINT AnimationClip::FrameCount() const
+	{
+		return mFrameCount;
+	}
+
+	UINT AnimationClip::TrackCount() const
+	{
+		return mTracks.size();
+	}
+
+	UINT AnimationClip::CompressedSize() const
+	{
+		UINT size = 0;
+		for (const Track& track : mTracks)
+		{
+			size += sizeof(Track) + (track.Translations.size() + track.Rotations.size() + track.Scales.size()) * sizeof(std::uint16_t);
+		}
+
+		return size;
+	}
+
+	void AnimationClip::Sample(float time, bool loop, const AnimationPose& bindPose, AnimationPose& pose, AnimationPose& scratch) const
+	{
+		float lastFrame = static_cast<float>(mFrameCount - 1);
+		float frame = time * mSampleRate;
+		if (loop && lastFrame > 0.0f)
+		{
+			frame = fmod(frame, lastFrame);
+			frame = (frame < 0.0f ? frame + lastFrame : frame);
+		}
+		else
+		{
+			frame = (frame < 0.0f ? 0.0f : (frame > lastFrame ? lastFrame : frame));
+		}
+
+		UINT frame0 = static_cast<UINT>(frame);
+		UINT frame1 = (frame0 + 1 < mFrameCount ? frame0 + 1 : frame0);
+
+		// Joints without a track keep the bind pose in both frames, so the blend leaves them untouched
+		pose = bindPose;
+		scratch = bindPose;
+		DecodeFrame(frame0, pose);
+		DecodeFrame(frame1, scratch);
+		AnimationPose::Blend(pose, scratch, frame - frame0, pose);
+	}
+
+	void AnimationClip::DecodeFrame(UINT frame, AnimationPose& pose) const
+	{
+		for (const Track& track : mTracks)
+		{
+			UINT translationKey = (track.Translations.size() > 3 ? frame * 3 : 0);
+			UINT rotationKey = (track.Rotations.size() > 3 ? frame * 3 : 0);
+			UINT scaleKey = (track.Scales.size() > 3 ? frame * 3 : 0);
+
+			pose.Translations[track.Joint] = vec4(DecodeVector(&track.Translations[translationKey], track.TranslationMinimum, track.TranslationExtent), 0.0f);
+			pose.Rotations[track.Joint] = DecodeRotation(&track.Rotations[rotationKey]);
+			pose.Scales[track.Joint] = vec4(DecodeVector(&track.Scales[scaleKey], track.ScaleMinimum, track.ScaleExtent), 0.0f);
+		}
+	}
+
+	void AnimationClip::EncodeVectors(const std::vector<vec3>& values, vec3& minimum, vec3& extent, std::vector<std::uint16_t>& encoded)
+	{
+		minimum = values.front();
+		vec3 maximum = values.front();
+		for (const vec3& value : values)
+		{
+			minimum = min(minimum, value);
+			maximum = max(maximum, value);
+		}
+
+		extent = maximum - minimum;
+		bool constant = (extent.x < ConstantTolerance && extent.y < ConstantTolerance && extent.z < ConstantTolerance);
+		UINT keyCount = (constant ? 1 : values.size());
+
+		encoded.resize(keyCount * 3);
+		for (UINT i = 0; i < keyCount; i++)
+		{
+			for (UINT axis = 0; axis < 3; axis++)
+			{
+				float normalized = (extent[axis] > 0.0f ? (values[i][axis] - minimum[axis]) / extent[axis] : 0.0f);
+				encoded[i * 3 + axis] = static_cast<std::uint16_t>(normalized * 65535.0f + 0.5f);
+			}
+		}
+	}
+
+	vec3 AnimationClip::DecodeVector(const std::uint16_t* encoded, const vec3& minimum, const vec3& extent)
+	{
+		const float scale = 1.0f / 65535.0f;
+		return minimum + vec3(encoded[0], encoded[1], encoded[2]) * scale * extent;
+	}
+
+	void AnimationClip::EncodeRotations(const std::vector<quat>& values, std::vector<std::uint16_t>& encoded)
+	{
+		bool constant = true;
+		for (const quat& value : values)
+		{
+			if (abs(dot(value, values.front())) < 1.0f - ConstantTolerance)
+			{
+				constant = false;
+				break;
+			}
+		}
+
+		UINT keyCount = (constant ? 1 : values.size());
+		encoded.resize(keyCount * 3);
+
+		// Smallest three: the largest component is dropped and rebuilt from unit length, so the other three
+		// lie within +-1/sqrt(2). Its index rides in the top bits of the first two words.
+		const float halfSqrt2 = 0.70710678f;
+		for (UINT i = 0; i < keyCount; i++)
+		{
+			const quat& value = values[i];
+			float components[4] = { value.x, value.y, value.z, value.w };
+
+			UINT largest = 0;
+			for (UINT j = 1; j < 4; j++)
+			{
+				largest = (abs(components[j]) > abs(components[largest]) ? j : largest);
+			}
+
+			float sign = (components[largest] < 0.0f ? -1.0f : 1.0f);
+			std::uint16_t* key = &encoded[i * 3];
+			for (UINT j = 0, k = 0; j < 4; j++)
+			{
+				if (j != largest)
+				{
+					float normalized = clamp(components[j] * sign / halfSqrt2 * 0.5f + 0.5f, 0.0f, 1.0f);
+					key[k++] = static_cast<std::uint16_t>(normalized * 32767.0f + 0.5f);
+				}
+			}
+
+			key[0] |= static_cast<std::uint16_t>((largest & 1) << 15);
+			key[1] |= static_cast<std::uint16_t>((largest >> 1) << 15);
+		}
+	}
+
+	quat AnimationClip::DecodeRotation(const std::uint16_t* encoded)
+	{
+		const float halfSqrt2 = 0.70710678f;
+		UINT largest = (encoded[0] >> 15) | ((encoded[1] >> 15) << 1);
+
+		float components[4];
+		float sumSquared = 0.0f;
+		for (UINT j = 0, k = 0; j < 4; j++)
+		{
+			if (j != largest)
+			{
+				float component = ((encoded[k++] & 0x7FFF) / 32767.0f * 2.0f - 1.0f) * halfSqrt2;
+				components[j] = component;
+				sumSquared += component * component;
+			}
+		}
+
+		components[largest] = sqrt(sumSquared < 1.0f ? 1.0f - sumSquared : 0.0f);
+
+		return quat(components[3], components[0], components[1], components[2]);
+	}
+
+	void AnimationClip::ResampleChannel(const aiNodeAnim& channel, double ticksPerSecond, float sampleRate, UINT frameCount, float duration,
+		std::vector<vec3>& translations, std::vector<quat>& rotations, std::vector<vec3>& scales)
+	{
+		translations.resize(frameCount);
+		rotations.resize(frameCount);
+		scales.resize(frameCount);
+
+		// Frame times only increase, so each key list is walked once with a cursor
+		UINT positionKey = 0;
+		UINT rotationKey = 0;
+		UINT scalingKey = 0;
+
+		for (UINT frame = 0; frame < frameCount; frame++)
+		{
+			float seconds = frame / sampleRate;
+			double ticks = (seconds < duration ? seconds : duration) * ticksPerSecond;
+
+			while (positionKey + 1 < channel.mNumPositionKeys && channel.mPositionKeys[positionKey + 1].mTime <= ticks)
+			{
+				positionKey++;
+			}
+
+			aiVector3D position = channel.mPositionKeys[positionKey].mValue;
+			if (positionKey + 1 < channel.mNumPositionKeys)
+			{
+				const aiVectorKey& from = channel.mPositionKeys[positionKey];
+				const aiVectorKey& to = channel.mPositionKeys[positionKey + 1];
+				float factor = static_cast<float>((ticks - from.mTime) / (to.mTime - from.mTime));
+				factor = clamp(factor, 0.0f, 1.0f);
+				position = from.mValue + (to.mValue - from.mValue) * factor;
+			}
+
+			while (rotationKey + 1 < channel.mNumRotationKeys && channel.mRotationKeys[rotationKey + 1].mTime <= ticks)
+			{
+				rotationKey++;
+			}
+
+			aiQuaternion rotation = channel.mRotationKeys[rotationKey].mValue;
+			if (rotationKey + 1 < channel.mNumRotationKeys)
+			{
+				const aiQuatKey& from = channel.mRotationKeys[rotationKey];
+				const aiQuatKey& to = channel.mRotationKeys[rotationKey + 1];
+				float factor = static_cast<float>((ticks - from.mTime) / (to.mTime - from.mTime));
+				aiQuaternion::Interpolate(rotation, from.mValue, to.mValue, clamp(factor, 0.0f, 1.0f));
+			}
+
+			while (scalingKey + 1 < channel.mNumScalingKeys && channel.mScalingKeys[scalingKey + 1].mTime <= ticks)
+			{
+				scalingKey++;
+			}
+
+			aiVector3D scaling = channel.mScalingKeys[scalingKey].mValue;
+			if (scalingKey + 1 < channel.mNumScalingKeys)
+			{
+				const aiVectorKey& from = channel.mScalingKeys[scalingKey];
+				const aiVectorKey& to = channel.mScalingKeys[scalingKey + 1];
+				float factor = static_cast<float>((ticks - from.mTime) / (to.mTime - from.mTime));
+				factor = clamp(factor, 0.0f, 1.0f);
+				scaling = from.mValue + (to.mValue - from.mValue) * factor;
+			}
+
+			translations[frame] = vec3(position.x, position.y, position.z);
+			rotations[frame] = normalize(quat(rotation.w, rotation.x, rotation.y, rotation.z));
+			scales[frame] = vec3(scaling.x, scaling.y, scaling.z);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "Common.h"
+#include <cstdint>
+
+struct aiAnimation;
+struct aiNodeAnim;
+
+namespace Library
+{
+	class Model;
+	struct AnimationPose;
+
+	// An imported animation resampled to a fixed rate, so every joint shares the same key times and sampling
+	// never searches. Keys are quantized: rotations keep their three smallest components in 15 bits each,
+	// translations and scales store 16 bits per axis within the track's range, and a channel that never
+	// changes collapses to a single key.
+	class AnimationClip
+	{
+		friend class Model;
+
+	public:
+		~AnimationClip();
+
+		const std::string& Name() const;
+		float Duration() const;
+		float SampleRate() const;
+		UINT FrameCount() const;
+		UINT TrackCount() const;
+		UINT CompressedSize() const;
+
+		void Sample(float time, bool loop, const AnimationPose& bindPose, AnimationPose& pose, AnimationPose& scratch) const;
+
+		// The key codecs; three words per key, or one key in total when every value matches the first
+		static void EncodeVectors(const std::vector<glm::vec3>& values, glm::vec3& minimum, glm::vec3& extent, std::vector<std::uint16_t>& encoded);
+		static glm::vec3 DecodeVector(const std::uint16_t* encoded, const glm::vec3& minimum, const glm::vec3& extent);
+		static void EncodeRotations(const std::vector<glm::quat>& values, std::vector<std::uint16_t>& encoded);
+		static glm::quat DecodeRotation(const std::uint16_t* encoded);
+
+		static const float DefaultSampleRate;
+
+	private:
+		AnimationClip(Model& model, aiAnimation& animation);
+		AnimationClip(const AnimationClip& rhs);
+		AnimationClip& operator=(const AnimationClip& rhs);
+
+		// Three quantized values per key; a single key when the channel is constant
+		struct Track
+		{
+			UINT Joint;
+			glm::vec3 TranslationMinimum;
+			glm::vec3 TranslationExtent;
+			glm::vec3 ScaleMinimum;
+			glm::vec3 ScaleExtent;
+			std::vector<std::uint16_t> Translations;
+			std::vector<std::uint16_t> Rotations;
+			std::vector<std::uint16_t> Scales;
+		};
+
+		void DecodeFrame(UINT frame, AnimationPose& pose) const;
+
+		static void ResampleChannel(const aiNodeAnim& channel, double ticksPerSecond, float sampleRate, UINT frameCount, float duration,
+			std::vector<glm::vec3>& translations, std::vector<glm::quat>& rotations, std::vector<glm::vec3>& scales);
+
+		static const float ConstantTolerance;
+
+		std::string mName;
+		float mDuration;
+		float mSampleRate;
+		UINT mFrameCount;
+		std::vector<Track> mTracks;
+	};
+}
\ No newline at end of file
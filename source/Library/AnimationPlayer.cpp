@@ -0,0 +1,116 @@
+#include "AnimationPlayer.h"
+#include "AnimationClip.h"
+#include "Skeleton.h"
+
+using namespace glm;
+
+namespace Library
+{
+	AnimationPlayer::AnimationPlayer(const Skeleton& skeleton)
+		: mSkeleton(skeleton), mClip(nullptr), mTime(0.0f), mLoop(true), mPreviousClip(nullptr), mPreviousTime(0.0f), mPreviousLoop(true),
+		  mFadeDuration(0.0f), mFadeTime(0.0f), mTimeScale(1.0f), mPaletteOffset(0),
+		  mPose(skeleton.BindPose()), mPreviousPose(skeleton.BindPose()), mScratchPose(skeleton.BindPose()), mModelMatrices(skeleton.JointCount())
+	{
+	}
+
+	const Skeleton& AnimationPlayer::GetSkeleton() const
+	{
+		return mSkeleton;
+	}
+
+	const AnimationClip* AnimationPlayer::CurrentClip() const
+	{
+		return mClip;
+	}
+
+	float AnimationPlayer::CurrentTime() const
+	{
+		return mTime;
+	}
+
+	bool AnimationPlayer::IsFading() const
+	{
+		return (mPreviousClip != nullptr);
+	}
+
+	float& AnimationPlayer::TimeScale()
+	{
+		return mTimeScale;
+	}
+
+	UINT AnimationPlayer::PaletteOffset() const
+	{
+		return mPaletteOffset;
+	}
+
+	void AnimationPlayer::Play(const AnimationClip& clip, bool loop)
+	{
+		mClip = &clip;
+		mTime = 0.0f;
+		mLoop = loop;
+		mPreviousClip = nullptr;
+	}
+
+	void AnimationPlayer::CrossFade(const AnimationClip& clip, float fadeDuration, bool loop)
+	{
+		if (mClip == nullptr || fadeDuration <= 0.0f)
+		{
+			Play(clip, loop);
+			return;
+		}
+
+		mPreviousClip = mClip;
+		mPreviousTime = mTime;
+		mPreviousLoop = mLoop;
+		mFadeDuration = fadeDuration;
+		mFadeTime = 0.0f;
+
+		mClip = &clip;
+		mTime = 0.0f;
+		mLoop = loop;
+	}
+
+	void AnimationPlayer::Stop()
+	{
+		mClip = nullptr;
+		mPreviousClip = nullptr;
+	}
+
+	void AnimationPlayer::Advance(float elapsedTime)
+	{
+		float step = elapsedTime * mTimeScale;
+		mTime += step;
+
+		if (mPreviousClip != nullptr)
+		{
+			mPreviousTime += step;
+			mFadeTime += step;
+			if (mFadeTime >= mFadeDuration)
+			{
+				mPreviousClip = nullptr;
+			}
+		}
+	}
+
+	void AnimationPlayer::Evaluate(mat4* palette)
+	{
+		const AnimationPose& bindPose = mSkeleton.BindPose();
+		if (mClip != nullptr)
+		{
+			mClip->Sample(mTime, mLoop, bindPose, mPose, mScratchPose);
+
+			if (mPreviousClip != nullptr)
+			{
+				mPreviousClip->Sample(mPreviousTime, mPreviousLoop, bindPose, mPreviousPose, mScratchPose);
+				AnimationPose::Blend(mPreviousPose, mPose, mFadeTime / mFadeDuration, mPose);
+			}
+		}
+		else
+		{
+			mPose = bindPose;
+		}
+
+		mSkeleton.ComputeModelMatrices(mPose, &mModelMatrices.front());
+		mSkeleton.ComputeSkinningPalette(&mModelMatrices.front(), palette);
+	}
+}
\ No newline at end of file
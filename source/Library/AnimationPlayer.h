@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Common.h"
+#include "AnimationPose.h"
+
+namespace Library
+{
+	class Skeleton;
+	class AnimationClip;
+
+	// Plays clips on one skeleton instance and cross-fades between them. Advance and Evaluate only touch
+	// this player's state, which is what lets AnimationSystem run many players on worker threads.
+	class AnimationPlayer
+	{
+		friend class AnimationSystem;
+
+	public:
+		explicit AnimationPlayer(const Skeleton& skeleton);
+
+		const Skeleton& GetSkeleton() const;
+		const AnimationClip* CurrentClip() const;
+		float CurrentTime() const;
+		bool IsFading() const;
+		float& TimeScale();
+		UINT PaletteOffset() const;
+
+		void Play(const AnimationClip& clip, bool loop = true);
+		void CrossFade(const AnimationClip& clip, float fadeDuration, bool loop = true);
+		void Stop();
+
+		void Advance(float elapsedTime);
+		void Evaluate(glm::mat4* palette);
+
+	private:
+		AnimationPlayer(const AnimationPlayer& rhs);
+		AnimationPlayer& operator=(const AnimationPlayer& rhs);
+
+		const Skeleton& mSkeleton;
+		const AnimationClip* mClip;
+		float mTime;
+		bool mLoop;
+		const AnimationClip* mPreviousClip;
+		float mPreviousTime;
+		bool mPreviousLoop;
+		float mFadeDuration;
+		float mFadeTime;
+		float mTimeScale;
+		UINT mPaletteOffset;
+
+		AnimationPose mPose;
+		AnimationPose mPreviousPose;
+		AnimationPose mScratchPose;
+		std::vector<glm::mat4> mModelMatrices;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "AnimationPose.h"
+#include "GameException.h"
+#include <xmmintrin.h>
+
+using namespace glm;
+
+namespace Library
+{
+	UINT AnimationPose::JointCount() const
+	{
+		return Translations.size();
+	}
+
+	void AnimationPose::Resize(UINT jointCount)
+	{
+		Translations.resize(jointCount, vec4(0.0f));
+		Rotations.resize(jointCount, quat());
+		Scales.resize(jointCount, vec4(1.0f, 1.0f, 1.0f, 0.0f));
+	}
+
+	void AnimationPose::Blend(const AnimationPose& from, const AnimationPose& to, float weight, AnimationPose& result)
+	{
+		UINT jointCount = from.JointCount();
+		if (to.JointCount() != jointCount)
+		{
+			throw GameException("AnimationPose::Blend() poses belong to different skeletons.");
+		}
+
+		result.Resize(jointCount);
+
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 signMask = _mm_set1_ps(-0.0f);
+		__m128 blendWeight = _mm_set1_ps(weight);
+
+		// Every joint is read before it is written, so result may be either input
+		for (UINT i = 0; i < jointCount; i++)
+		{
+			__m128 fromTranslation = _mm_loadu_ps(&from.Translations[i].x);
+			__m128 toTranslation = _mm_loadu_ps(&to.Translations[i].x);
+			_mm_storeu_ps(&result.Translations[i].x, _mm_add_ps(fromTranslation, _mm_mul_ps(_mm_sub_ps(toTranslation, fromTranslation), blendWeight)));
+
+			__m128 fromScale = _mm_loadu_ps(&from.Scales[i].x);
+			__m128 toScale = _mm_loadu_ps(&to.Scales[i].x);
+			_mm_storeu_ps(&result.Scales[i].x, _mm_add_ps(fromScale, _mm_mul_ps(_mm_sub_ps(toScale, fromScale), blendWeight)));
+
+			// Normalized lerp, taking the shorter arc by flipping the target when the quaternions point apart
+			__m128 fromRotation = _mm_loadu_ps(&from.Rotations[i].x);
+			__m128 toRotation = _mm_loadu_ps(&to.Rotations[i].x);
+
+			__m128 product = _mm_mul_ps(fromRotation, toRotation);
+			product = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+			product = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(1, 0, 3, 2)));
+			toRotation = _mm_xor_ps(toRotation, _mm_and_ps(_mm_cmplt_ps(product, zero), signMask));
+
+			__m128 rotation = _mm_add_ps(fromRotation, _mm_mul_ps(_mm_sub_ps(toRotation, fromRotation), blendWeight));
+			__m128 lengthSquared = _mm_mul_ps(rotation, rotation);
+			lengthSquared = _mm_add_ps(lengthSquared, _mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(2, 3, 0, 1)));
+			lengthSquared = _mm_add_ps(lengthSquared, _mm_shuffle_ps(lengthSquared, lengthSquared, _MM_SHUFFLE(1, 0, 3, 2)));
+			_mm_storeu_ps(&result.Rotations[i].x, _mm_div_ps(rotation, _mm_sqrt_ps(lengthSquared)));
+		}
+	}
+}
\ No newline at end of file
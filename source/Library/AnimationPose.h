@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Common.h"
+#include "glm/gtc/quaternion.hpp"
+
+namespace Library
+{
+	// Joint-local transforms for one skeleton. Translations and scales are padded to four floats so that
+	// blending works a whole joint component per SSE register.
+	struct AnimationPose
+	{
+		std::vector<glm::vec4> Translations;
+		std::vector<glm::quat> Rotations;
+		std::vector<glm::vec4> Scales;
+
+		UINT JointCount() const;
+		void Resize(UINT jointCount);
+
+		static void Blend(const AnimationPose& from, const AnimationPose& to, float weight, AnimationPose& result);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,116 @@
+#include "AnimationSystem.h"
+#include "AnimationPlayer.h"
+#include "GameException.h"
+#include "GameTime.h"
+#include "JobSystem.h"
+#include "RenderStateCache.h"
+#include "Skeleton.h"
+#include <algorithm>
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(AnimationSystem)
+
+	const GLuint AnimationSystem::PaletteBinding = 3;
+	const UINT AnimationSystem::MinimumPlayersPerWorker = 4;
+
+	AnimationSystem::AnimationSystem()
+		: mPlayers(), mPalette(), mPaletteBuffer(0)
+	{
+	}
+
+	AnimationSystem::~AnimationSystem()
+	{
+		if (mPaletteBuffer != 0)
+		{
+			glDeleteBuffers(1, &mPaletteBuffer);
+		}
+	}
+
+	AnimationSystem* AnimationSystem::Instance()
+	{
+		return static_cast<AnimationSystem*>(GlobalServices.GetService(AnimationSystem::TypeIdClass()));
+	}
+
+	void AnimationSystem::AddPlayer(AnimationPlayer& player)
+	{
+		if (std::find(mPlayers.begin(), mPlayers.end(), &player) != mPlayers.end())
+		{
+			throw GameException("AnimationSystem::AddPlayer() player is already registered.");
+		}
+
+		mPlayers.push_back(&player);
+	}
+
+	void AnimationSystem::RemovePlayer(AnimationPlayer& player)
+	{
+		mPlayers.erase(std::remove(mPlayers.begin(), mPlayers.end(), &player), mPlayers.end());
+	}
+
+	UINT AnimationSystem::PlayerCount() const
+	{
+		return mPlayers.size();
+	}
+
+	UINT AnimationSystem::PaletteSize() const
+	{
+		return mPalette.size();
+	}
+
+	GLuint AnimationSystem::PaletteBuffer() const
+	{
+		return mPaletteBuffer;
+	}
+
+	void AnimationSystem::Update(const GameTime& gameTime)
+	{
+		// Offsets are assigned up front so every worker writes a disjoint slice
+		UINT paletteSize = 0;
+		for (AnimationPlayer* player : mPlayers)
+		{
+			player->mPaletteOffset = paletteSize;
+			paletteSize += player->GetSkeleton().BoneCount();
+		}
+
+		mPalette.resize(paletteSize);
+		if (paletteSize == 0)
+		{
+			return;
+		}
+
+		float elapsedTime = static_cast<float>(gameTime.ElapsedGameTime());
+		JobSystem::ParallelFor(mPlayers.size(), MinimumPlayersPerWorker, [this, elapsedTime](UINT begin, UINT end)
+		{
+			for (UINT i = begin; i < end; i++)
+			{
+				AnimationPlayer* player = mPlayers[i];
+				player->Advance(elapsedTime);
+				if (player->GetSkeleton().BoneCount() > 0)
+				{
+					player->Evaluate(&mPalette[player->PaletteOffset()]);
+				}
+			}
+		});
+	}
+
+	void AnimationSystem::UploadPalettes()
+	{
+		if (mPalette.empty())
+		{
+			return;
+		}
+
+		if (mPaletteBuffer == 0)
+		{
+			glGenBuffers(1, &mPaletteBuffer);
+		}
+
+		// Respecifying the store each frame orphans the one the GPU may still be reading
+		RenderStateCache& renderStates = *RenderStateCache::Instance();
+		renderStates.BindBuffer(GL_SHADER_STORAGE_BUFFER, mPaletteBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(mat4) * mPalette.size(), &mPalette.front(), GL_STREAM_DRAW);
+		renderStates.BindBufferBase(GL_SHADER_STORAGE_BUFFER, PaletteBinding, mPaletteBuffer);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Common.h"
+
+namespace Library
+{
+	class AnimationPlayer;
+	class GameTime;
+
+	// Steps every registered player once per frame. Players are independent, so they advance and evaluate in
+	// parallel, each writing its bones into its own slice of one shared palette. The palette is then uploaded
+	// as a single shader storage buffer that skinned vertex shaders index with the player's offset.
+	class AnimationSystem : public RTTI
+	{
+		RTTI_DECLARATIONS(AnimationSystem, RTTI)
+
+	public:
+		AnimationSystem();
+		~AnimationSystem();
+
+		static AnimationSystem* Instance();
+
+		void AddPlayer(AnimationPlayer& player);
+		void RemovePlayer(AnimationPlayer& player);
+		UINT PlayerCount() const;
+		UINT PaletteSize() const;
+		GLuint PaletteBuffer() const;
+
+		void Update(const GameTime& gameTime);
+		void UploadPalettes();
+
+		static const GLuint PaletteBinding;
+
+	private:
+		AnimationSystem(const AnimationSystem& rhs);
+		AnimationSystem& operator=(const AnimationSystem& rhs);
+
+		static const UINT MinimumPlayersPerWorker;
+
+		std::vector<AnimationPlayer*> mPlayers;
+		std::vector<glm::mat4> mPalette;
+		GLuint mPaletteBuffer;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "AssetPack.h"
+#include "FileBuffer.h"
+#include "GameException.h"
+#include "HashHelper.h"
+#include "LZ4Helper.h"
+#include "VirtualFileSystem.h"
+#include <algorithm>
+
+namespace Library
+{
+	const char AssetPack::Magic[4] = { 'L', 'P', 'A', 'K' };
+	const std::uint32_t AssetPack::Version = 1;
+	const std::uint64_t AssetPack::Alignment = 4096;
+
+	static_assert(sizeof(AssetPackHeader) == 48, "AssetPackHeader layout changed.");
+	static_assert(sizeof(AssetPackEntry) == 24, "AssetPackEntry layout changed.");
+	static_assert(sizeof(AssetPackBlob) == 40, "AssetPackBlob layout changed.");
+
+	AssetPack::AssetPack(const std::wstring& filename)
+		: mBuffer(), mHeader(nullptr), mEntries(nullptr), mBlobs(nullptr), mStrings(nullptr)
+	{
+		mBuffer = std::shared_ptr<const FileBuffer>(new MappedFileBuffer(filename));
+
+		if (mBuffer->Size() < sizeof(AssetPackHeader))
+		{
+			throw GameException("AssetPack::AssetPack() file is too small to be an asset pack.");
+		}
+
+		mHeader = reinterpret_cast<const AssetPackHeader*>(mBuffer->Data());
+		if (memcmp(mHeader->Magic, Magic, sizeof(Magic)) != 0 || mHeader->Version != Version)
+		{
+			throw GameException("AssetPack::AssetPack() unrecognized asset pack format.");
+		}
+
+		// The counts are 32-bit and the records small, so the table lengths are exact in 64 bits
+		std::uint64_t size = mBuffer->Size();
+		if (RangeFits(mHeader->EntryTableOffset, static_cast<std::uint64_t>(mHeader->EntryCount) * sizeof(AssetPackEntry), size) == false ||
+			RangeFits(mHeader->BlobTableOffset, static_cast<std::uint64_t>(mHeader->BlobCount) * sizeof(AssetPackBlob), size) == false ||
+			RangeFits(mHeader->StringTableOffset, mHeader->StringTableSize, size) == false)
+		{
+			throw GameException("AssetPack::AssetPack() asset pack is truncated.");
+		}
+
+		mEntries = reinterpret_cast<const AssetPackEntry*>(mBuffer->Data() + mHeader->EntryTableOffset);
+		mBlobs = reinterpret_cast<const AssetPackBlob*>(mBuffer->Data() + mHeader->BlobTableOffset);
+		mStrings = mBuffer->Data() + mHeader->StringTableOffset;
+	}
+
+	AssetPack::~AssetPack()
+	{
+	}
+
+	bool AssetPack::Contains(const std::string& path) const
+	{
+		return (FindEntry(path) != nullptr);
+	}
+
+	bool AssetPack::OpenFile(const std::string& path, FileView& fileView) const
+	{
+		const AssetPackEntry* entry = FindEntry(path);
+		if (entry == nullptr)
+		{
+			return false;
+		}
+
+		if (entry->BlobIndex >= mHeader->BlobCount)
+		{
+			throw GameException("AssetPack::OpenFile() entry refers to a missing blob.");
+		}
+
+		const AssetPackBlob& blob = mBlobs[entry->BlobIndex];
+		if (RangeFits(blob.Offset, blob.StoredSize, mBuffer->Size()) == false)
+		{
+			throw GameException("AssetPack::OpenFile() blob lies outside the asset pack.");
+		}
+
+		if (blob.Size > SIZE_MAX)
+		{
+			throw GameException("AssetPack::OpenFile() blob is too large to load.");
+		}
+
+		switch (blob.Compression)
+		{
+			case AssetPackCompressionNone:
+				if (blob.Size != blob.StoredSize)
+				{
+					throw GameException("AssetPack::OpenFile() stored blob size does not match its contents.");
+				}
+
+				// Stored entries are served straight out of the mapping
+				fileView = FileView(mBuffer, static_cast<size_t>(blob.Offset), static_cast<size_t>(blob.Size));
+				break;
+
+			case AssetPackCompressionLZ4:
+			{
+				std::vector<char> data(static_cast<size_t>(blob.Size));
+				if (data.empty() == false)
+				{
+					LZ4Helper::Decompress(mBuffer->Data() + blob.Offset, static_cast<size_t>(blob.StoredSize), &data.front(), data.size());
+				}
+
+				fileView = FileView(std::shared_ptr<const FileBuffer>(new MemoryFileBuffer(data)));
+				break;
+			}
+
+			default:
+				throw GameException("AssetPack::OpenFile() unsupported compression method.");
+		}
+
+		return true;
+	}
+
+	UINT AssetPack::EntryCount() const
+	{
+		return mHeader->EntryCount;
+	}
+
+	UINT AssetPack::BlobCount() const
+	{
+		return mHeader->BlobCount;
+	}
+
+	const AssetPackEntry* AssetPack::FindEntry(const std::string& path) const
+	{
+		std::string normalizedPath = VirtualFileSystem::NormalizePath(path);
+		std::uint64_t pathHash = HashHelper::Hash(normalizedPath);
+
+		const AssetPackEntry* entriesEnd = mEntries + mHeader->EntryCount;
+		const AssetPackEntry* entry = std::lower_bound(mEntries, entriesEnd, pathHash, [](const AssetPackEntry& lhs, std::uint64_t hash) { return lhs.PathHash < hash; });
+
+		// Walk any hash collisions and confirm against the stored path
+		for (; entry != entriesEnd && entry->PathHash == pathHash; ++entry)
+		{
+			if (RangeFits(entry->PathOffset, entry->PathLength, mHeader->StringTableSize) &&
+				normalizedPath.compare(0, std::string::npos, mStrings + entry->PathOffset, entry->PathLength) == 0)
+			{
+				return entry;
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool AssetPack::RangeFits(std::uint64_t offset, std::uint64_t length, std::uint64_t size)
+	{
+		// Compared by subtraction so that corrupt offsets and lengths can't wrap past the check
+		return (offset <= size && length <= size - offset);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "Common.h"
+#include "FileView.h"
+#include <cstdint>
+
+namespace Library
+{
+	class FileBuffer;
+
+	enum AssetPackCompression
+	{
+		AssetPackCompressionNone = 0,
+		AssetPackCompressionLZ4,
+		AssetPackCompressionZstd
+	};
+
+	// On-disk layout (little-endian):
+	//   AssetPackHeader, padded to AssetPack::Alignment
+	//   blobs, each starting on an AssetPack::Alignment boundary
+	//   AssetPackEntry[EntryCount], sorted by PathHash
+	//   AssetPackBlob[BlobCount]
+	//   path string table
+	struct AssetPackHeader
+	{
+		char Magic[4];
+		std::uint32_t Version;
+		std::uint32_t EntryCount;
+		std::uint32_t BlobCount;
+		std::uint64_t EntryTableOffset;
+		std::uint64_t BlobTableOffset;
+		std::uint64_t StringTableOffset;
+		std::uint64_t StringTableSize;
+	};
+
+	struct AssetPackEntry
+	{
+		std::uint64_t PathHash;
+		std::uint32_t PathOffset;
+		std::uint32_t PathLength;
+		std::uint32_t BlobIndex;
+		std::uint32_t Reserved;
+	};
+
+	struct AssetPackBlob
+	{
+		std::uint64_t Offset;
+		std::uint64_t StoredSize;
+		std::uint64_t Size;
+		std::uint64_t ContentHash;
+		std::uint32_t Compression;
+		std::uint32_t Reserved;
+	};
+
+	class AssetPack
+	{
+	public:
+		AssetPack(const std::wstring& filename);
+		~AssetPack();
+
+		bool Contains(const std::string& path) const;
+		bool OpenFile(const std::string& path, FileView& fileView) const;
+
+		UINT EntryCount() const;
+		UINT BlobCount() const;
+
+		static const char Magic[4];
+		static const std::uint32_t Version;
+		static const std::uint64_t Alignment;
+
+	private:
+		AssetPack(const AssetPack& rhs);
+		AssetPack& operator=(const AssetPack& rhs);
+
+		const AssetPackEntry* FindEntry(const std::string& path) const;
+		static bool RangeFits(std::uint64_t offset, std::uint64_t length, std::uint64_t size);
+
+		std::shared_ptr<const FileBuffer> mBuffer;
+		const AssetPackHeader* mHeader;
+		const AssetPackEntry* mEntries;
+		const AssetPackBlob* mBlobs;
+		const char* mStrings;
+	};
+}
\ No newline at end of file
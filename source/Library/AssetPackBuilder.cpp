@@ -0,0 +1,286 @@
+#include "AssetPackBuilder.h"
+#include "FileBuffer.h"
+#include "GameException.h"
+#include "HashHelper.h"
+#include "LZ4Helper.h"
+#include "Utility.h"
+#include "VirtualFileSystem.h"
+#include <algorithm>
+#include <cwctype>
+#include <fstream>
+
+#if !defined(_WIN32)
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+namespace Library
+{
+	AssetPackBuilder::AssetPackBuilder()
+		: mEntries(), mBlobs(), mBlobContents(), mBlobsByContentHash()
+	{
+	}
+
+	void AssetPackBuilder::AddFile(const std::string& path, const std::wstring& sourceFilename, AssetPackCompression compression)
+	{
+		MappedFileBuffer source(sourceFilename);
+		std::vector<char> data(source.Data(), source.Data() + source.Size());
+
+		AddData(path, data, compression);
+	}
+
+	void AssetPackBuilder::AddData(const std::string& path, const std::vector<char>& data, AssetPackCompression compression)
+	{
+		std::string normalizedPath = VirtualFileSystem::NormalizePath(path);
+		if (mEntries.find(normalizedPath) != mEntries.end())
+		{
+			throw GameException("AssetPackBuilder::AddData() duplicate path.");
+		}
+
+		mEntries[normalizedPath] = FindOrAddBlob(data, compression);
+	}
+
+	void AssetPackBuilder::AddDirectory(const std::string& path, const std::wstring& sourceDirectory)
+	{
+		std::string prefix = VirtualFileSystem::NormalizePath(path);
+		if (prefix.empty() == false)
+		{
+			prefix += "/";
+		}
+
+#if defined(_WIN32)
+		WIN32_FIND_DATAW findData;
+		HANDLE find = FindFirstFileW((sourceDirectory + L"\\*").c_str(), &findData);
+		if (find == INVALID_HANDLE_VALUE)
+		{
+			throw GameException("FindFirstFileW() failed.", HRESULT_FROM_WIN32(GetLastError()));
+		}
+
+		do
+		{
+			std::wstring name(findData.cFileName);
+			if (name == L"." || name == L"..")
+			{
+				continue;
+			}
+
+			std::wstring sourceFilename = sourceDirectory + L"\\" + name;
+			if (findData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			{
+				AddDirectory(prefix + Utility::ToString(name), sourceFilename);
+			}
+			else
+			{
+				AddFile(prefix + Utility::ToString(name), sourceFilename, SelectCompression(sourceFilename));
+			}
+		} while (FindNextFileW(find, &findData));
+
+		FindClose(find);
+#else
+		std::string directory = Utility::ToString(sourceDirectory);
+		DIR* dir = opendir(directory.c_str());
+		if (dir == nullptr)
+		{
+			throw GameException("AssetPackBuilder::AddDirectory() could not open directory.");
+		}
+
+		for (dirent* entry = readdir(dir); entry != nullptr; entry = readdir(dir))
+		{
+			std::string name(entry->d_name);
+			if (name == "." || name == "..")
+			{
+				continue;
+			}
+
+			std::string sourceFilename = directory + "/" + name;
+			struct stat status;
+			if (stat(sourceFilename.c_str(), &status) != 0)
+			{
+				continue;
+			}
+
+			if (S_ISDIR(status.st_mode))
+			{
+				AddDirectory(prefix + name, Utility::ToWideString(sourceFilename));
+			}
+			else
+			{
+				AddFile(prefix + name, Utility::ToWideString(sourceFilename), SelectCompression(Utility::ToWideString(sourceFilename)));
+			}
+		}
+
+		closedir(dir);
+#endif
+	}
+
+	void AssetPackBuilder::Save(const std::wstring& filename) const
+	{
+		// Directory entries sorted by path hash so the reader can binary search
+		std::vector<AssetPackEntry> entries;
+		std::string strings;
+		entries.reserve(mEntries.size());
+
+		for (const auto& pathEntry : mEntries)
+		{
+			AssetPackEntry entry;
+			entry.PathHash = HashHelper::Hash(pathEntry.first);
+			entry.PathOffset = static_cast<std::uint32_t>(strings.size());
+			entry.PathLength = static_cast<std::uint32_t>(pathEntry.first.size());
+			entry.BlobIndex = pathEntry.second;
+			entry.Reserved = 0;
+
+			entries.push_back(entry);
+			strings += pathEntry.first;
+		}
+
+		std::sort(entries.begin(), entries.end(), [](const AssetPackEntry& lhs, const AssetPackEntry& rhs) { return lhs.PathHash < rhs.PathHash; });
+
+		// Lay out blobs on page boundaries so each stored entry can be mapped in place
+		std::vector<AssetPackBlob> blobs;
+		blobs.reserve(mBlobs.size());
+
+		std::uint64_t offset = AssetPack::Alignment;
+		for (const Blob& blob : mBlobs)
+		{
+			AssetPackBlob packBlob;
+			packBlob.Offset = offset;
+			packBlob.StoredSize = blob.StoredData.size();
+			packBlob.Size = blob.Size;
+			packBlob.ContentHash = blob.ContentHash;
+			packBlob.Compression = blob.Compression;
+			packBlob.Reserved = 0;
+
+			blobs.push_back(packBlob);
+			offset += (packBlob.StoredSize + AssetPack::Alignment - 1) / AssetPack::Alignment * AssetPack::Alignment;
+		}
+
+		AssetPackHeader header;
+		memcpy(header.Magic, AssetPack::Magic, sizeof(header.Magic));
+		header.Version = AssetPack::Version;
+		header.EntryCount = static_cast<std::uint32_t>(entries.size());
+		header.BlobCount = static_cast<std::uint32_t>(blobs.size());
+		header.EntryTableOffset = offset;
+		header.BlobTableOffset = header.EntryTableOffset + entries.size() * sizeof(AssetPackEntry);
+		header.StringTableOffset = header.BlobTableOffset + blobs.size() * sizeof(AssetPackBlob);
+		header.StringTableSize = strings.size();
+
+#if defined(_WIN32)
+		std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+#else
+		std::ofstream file(Utility::ToString(filename).c_str(), std::ios::binary | std::ios::trunc);
+#endif
+		if (file.fail())
+		{
+			throw GameException("AssetPackBuilder::Save() could not open file.");
+		}
+
+		std::vector<char> padding(static_cast<size_t>(AssetPack::Alignment), 0);
+
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+		file.write(&padding.front(), AssetPack::Alignment - sizeof(header));
+
+		for (const Blob& blob : mBlobs)
+		{
+			size_t storedSize = blob.StoredData.size();
+			if (storedSize > 0)
+			{
+				file.write(&blob.StoredData.front(), storedSize);
+			}
+
+			size_t paddingSize = static_cast<size_t>((AssetPack::Alignment - storedSize % AssetPack::Alignment) % AssetPack::Alignment);
+			file.write(&padding.front(), paddingSize);
+		}
+
+		if (entries.empty() == false)
+		{
+			file.write(reinterpret_cast<const char*>(&entries.front()), entries.size() * sizeof(AssetPackEntry));
+		}
+
+		if (blobs.empty() == false)
+		{
+			file.write(reinterpret_cast<const char*>(&blobs.front()), blobs.size() * sizeof(AssetPackBlob));
+		}
+
+		file.write(strings.c_str(), strings.size());
+
+		if (file.fail())
+		{
+			throw GameException("AssetPackBuilder::Save() failed to write the asset pack.");
+		}
+	}
+
+	UINT AssetPackBuilder::EntryCount() const
+	{
+		return mEntries.size();
+	}
+
+	UINT AssetPackBuilder::BlobCount() const
+	{
+		return mBlobs.size();
+	}
+
+	AssetPackCompression AssetPackBuilder::SelectCompression(const std::wstring& sourceFilename)
+	{
+		// Image formats are already compressed; leaving them raw keeps them mappable in place
+		std::wstring extension = sourceFilename.substr(std::min<size_t>(sourceFilename.find_last_of(L'.'), sourceFilename.size()));
+		std::transform(extension.begin(), extension.end(), extension.begin(), ::towlower);
+
+		if (extension == L".png" || extension == L".jpg" || extension == L".jpeg" || extension == L".dds")
+		{
+			return AssetPackCompressionNone;
+		}
+
+		return AssetPackCompressionLZ4;
+	}
+
+	UINT AssetPackBuilder::FindOrAddBlob(const std::vector<char>& data, AssetPackCompression compression)
+	{
+		std::uint64_t contentHash = HashHelper::Hash(data.empty() ? nullptr : &data.front(), data.size());
+
+		// Identical content is stored once, no matter how many paths refer to it
+		auto candidates = mBlobsByContentHash.equal_range(contentHash);
+		for (auto it = candidates.first; it != candidates.second; ++it)
+		{
+			if (mBlobContents[it->second] == data)
+			{
+				return it->second;
+			}
+		}
+
+		Blob blob;
+		blob.Size = data.size();
+		blob.ContentHash = contentHash;
+		blob.Compression = AssetPackCompressionNone;
+
+		switch (compression)
+		{
+			case AssetPackCompressionNone:
+				break;
+
+			case AssetPackCompressionLZ4:
+				if (data.empty() == false)
+				{
+					LZ4Helper::Compress(&data.front(), data.size(), blob.StoredData);
+					blob.Compression = AssetPackCompressionLZ4;
+				}
+				break;
+
+			default:
+				throw GameException("AssetPackBuilder::FindOrAddBlob() unsupported compression method.");
+		}
+
+		// Keep entries that do not shrink uncompressed so they can still be mapped in place
+		if (blob.Compression == AssetPackCompressionNone || blob.StoredData.size() >= data.size())
+		{
+			blob.StoredData = data;
+			blob.Compression = AssetPackCompressionNone;
+		}
+
+		UINT blobIndex = mBlobs.size();
+		mBlobs.push_back(blob);
+		mBlobContents.push_back(data);
+		mBlobsByContentHash.insert(std::make_pair(contentHash, blobIndex));
+
+		return blobIndex;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Common.h"
+#include "AssetPack.h"
+
+namespace Library
+{
+	class AssetPackBuilder
+	{
+	public:
+		AssetPackBuilder();
+
+		void AddFile(const std::string& path, const std::wstring& sourceFilename, AssetPackCompression compression = AssetPackCompressionNone);
+		void AddData(const std::string& path, const std::vector<char>& data, AssetPackCompression compression = AssetPackCompressionNone);
+		void AddDirectory(const std::string& path, const std::wstring& sourceDirectory);
+		void Save(const std::wstring& filename) const;
+
+		UINT EntryCount() const;
+		UINT BlobCount() const;
+
+	private:
+		AssetPackBuilder(const AssetPackBuilder& rhs);
+		AssetPackBuilder& operator=(const AssetPackBuilder& rhs);
+
+		struct Blob
+		{
+			std::vector<char> StoredData;
+			std::uint64_t Size;
+			std::uint64_t ContentHash;
+			AssetPackCompression Compression;
+		};
+
+		static AssetPackCompression SelectCompression(const std::wstring& sourceFilename);
+
+		UINT FindOrAddBlob(const std::vector<char>& data, AssetPackCompression compression);
+
+		std::map<std::string, UINT> mEntries;
+		std::vector<Blob> mBlobs;
+		std::vector<std::vector<char>> mBlobContents;
+		std::multimap<std::uint64_t, UINT> mBlobsByContentHash;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,120 @@
+#include "AssimpIOSystem.h"
+#include "VirtualFileSystem.h"
+#include <algorithm>
+
+namespace Library
+{
+	AssimpIOStream::AssimpIOStream(const FileView& fileView)
+		: mFileView(fileView), mPosition(0)
+	{
+	}
+
+	AssimpIOStream::~AssimpIOStream()
+	{
+	}
+
+	size_t AssimpIOStream::Read(void* buffer, size_t size, size_t count)
+	{
+		if (size == 0)
+		{
+			return 0;
+		}
+
+		size_t elementCount = std::min<size_t>(count, (mFileView.Size() - mPosition) / size);
+		size_t byteCount = elementCount * size;
+
+		memcpy(buffer, mFileView.Data() + mPosition, byteCount);
+		mPosition += byteCount;
+
+		return elementCount;
+	}
+
+	size_t AssimpIOStream::Write(const void* buffer, size_t size, size_t count)
+	{
+		return 0;
+	}
+
+	aiReturn AssimpIOStream::Seek(size_t offset, aiOrigin origin)
+	{
+		size_t position;
+		switch (origin)
+		{
+			case aiOrigin_SET:
+				position = offset;
+				break;
+
+			case aiOrigin_CUR:
+				position = mPosition + offset;
+				break;
+
+			case aiOrigin_END:
+				if (offset > mFileView.Size())
+				{
+					return aiReturn_FAILURE;
+				}
+				position = mFileView.Size() - offset;
+				break;
+
+			default:
+				return aiReturn_FAILURE;
+		}
+
+		if (position > mFileView.Size())
+		{
+			return aiReturn_FAILURE;
+		}
+
+		mPosition = position;
+
+		return aiReturn_SUCCESS;
+	}
+
+	size_t AssimpIOStream::Tell() const
+	{
+		return mPosition;
+	}
+
+	size_t AssimpIOStream::FileSize() const
+	{
+		return mFileView.Size();
+	}
+
+	void AssimpIOStream::Flush()
+	{
+	}
+
+	AssimpIOSystem::AssimpIOSystem(VirtualFileSystem& fileSystem)
+		: mFileSystem(fileSystem)
+	{
+	}
+
+	AssimpIOSystem::~AssimpIOSystem()
+	{
+	}
+
+	bool AssimpIOSystem::Exists(const char* file) const
+	{
+		return mFileSystem.Exists(file);
+	}
+
+	char AssimpIOSystem::getOsSeparator() const
+	{
+		return '/';
+	}
+
+	Assimp::IOStream* AssimpIOSystem::Open(const char* file, const char* mode)
+	{
+		// The virtual file system is read-only
+		if (strchr(mode, 'w') != nullptr || strchr(mode, 'a') != nullptr || mFileSystem.Exists(file) == false)
+		{
+			return nullptr;
+		}
+
+		return new AssimpIOStream(mFileSystem.OpenFile(file));
+	}
+
+	void AssimpIOSystem::Close(Assimp::IOStream* file)
+	{
+		delete file;
+	}
+}
\ No newline at end of file
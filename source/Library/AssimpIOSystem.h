@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Common.h"
+#include "FileView.h"
+#include <assimp/IOSystem.hpp>
+#include <assimp/IOStream.hpp>
+
+namespace Library
+{
+	class VirtualFileSystem;
+
+	class AssimpIOStream : public Assimp::IOStream
+	{
+	public:
+		AssimpIOStream(const FileView& fileView);
+		virtual ~AssimpIOStream();
+
+		virtual size_t Read(void* buffer, size_t size, size_t count) override;
+		virtual size_t Write(const void* buffer, size_t size, size_t count) override;
+		virtual aiReturn Seek(size_t offset, aiOrigin origin) override;
+		virtual size_t Tell() const override;
+		virtual size_t FileSize() const override;
+		virtual void Flush() override;
+
+	private:
+		AssimpIOStream(const AssimpIOStream& rhs);
+		AssimpIOStream& operator=(const AssimpIOStream& rhs);
+
+		FileView mFileView;
+		size_t mPosition;
+	};
+
+	class AssimpIOSystem : public Assimp::IOSystem
+	{
+	public:
+		AssimpIOSystem(VirtualFileSystem& fileSystem);
+		virtual ~AssimpIOSystem();
+
+		virtual bool Exists(const char* file) const override;
+		virtual char getOsSeparator() const override;
+		virtual Assimp::IOStream* Open(const char* file, const char* mode) override;
+		virtual void Close(Assimp::IOStream* file) override;
+
+	private:
+		AssimpIOSystem(const AssimpIOSystem& rhs);
+		AssimpIOSystem& operator=(const AssimpIOSystem& rhs);
+
+		VirtualFileSystem& mFileSystem;
+	};
+}
\ No newline at end of file
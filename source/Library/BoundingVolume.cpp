@@ -0,0 +1,142 @@
+#include "BoundingVolume.h"
+
+using namespace glm;
+
+namespace Library
+{
+	// An empty box is inverted, so merging the first point or box replaces it outright
+	BoundingBox::BoundingBox()
+		: Minimum(FLT_MAX), Maximum(-FLT_MAX)
+	{
+	}
+
+	BoundingBox::BoundingBox(const vec3& minimum, const vec3& maximum)
+		: Minimum(minimum), Maximum(maximum)
+	{
+	}
+
+	bool BoundingBox::IsEmpty() const
+	{
+		return (Minimum.x > Maximum.x || Minimum.y > Maximum.y || Minimum.z > Maximum.z);
+	}
+
+	vec3 BoundingBox::Center() const
+	{
+		return (Minimum + Maximum) * 0.5f;
+	}
+
+	vec3 BoundingBox::Extents() const
+	{
+		return (Maximum - Minimum) * 0.5f;
+	}
+
+	float BoundingBox::SurfaceArea() const
+	{
+		if (IsEmpty())
+		{
+			return 0.0f;
+		}
+
+		vec3 size = Maximum - Minimum;
+		return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+	}
+
+	bool BoundingBox::Contains(const BoundingBox& box) const
+	{
+		return (Minimum.x <= box.Minimum.x && Minimum.y <= box.Minimum.y && Minimum.z <= box.Minimum.z &&
+				box.Maximum.x <= Maximum.x && box.Maximum.y <= Maximum.y && box.Maximum.z <= Maximum.z);
+	}
+
+	bool BoundingBox::Intersects(const BoundingBox& box) const
+	{
+		return (Minimum.x <= box.Maximum.x && box.Minimum.x <= Maximum.x &&
+				Minimum.y <= box.Maximum.y && box.Minimum.y <= Maximum.y &&
+				Minimum.z <= box.Maximum.z && box.Minimum.z <= Maximum.z);
+	}
+
+	void BoundingBox::Merge(const vec3& point)
+	{
+		Minimum = glm::min(Minimum, point);
+		Maximum = glm::max(Maximum, point);
+	}
+
+	void BoundingBox::Merge(const BoundingBox& box)
+	{
+		if (box.IsEmpty() == false)
+		{
+			Minimum = glm::min(Minimum, box.Minimum);
+			Maximum = glm::max(Maximum, box.Maximum);
+		}
+	}
+
+	BoundingBox BoundingBox::Transform(const mat4& transform) const
+	{
+		if (IsEmpty())
+		{
+			return *this;
+		}
+
+		// Transform the center, then project the extents onto each world axis through the absolute matrix
+		vec3 center = vec3(transform * vec4(Center(), 1.0f));
+		vec3 extents = Extents();
+
+		vec3 worldExtents;
+		for (int row = 0; row < 3; row++)
+		{
+			worldExtents[row] = abs(transform[0][row]) * extents.x + abs(transform[1][row]) * extents.y + abs(transform[2][row]) * extents.z;
+		}
+
+		return BoundingBox(center - worldExtents, center + worldExtents);
+	}
+
+	BoundingBox BoundingBox::FromPoints(const std::vector<vec3>& points)
+	{
+		BoundingBox box;
+		for (const vec3& point : points)
+		{
+			box.Merge(point);
+		}
+
+		return box;
+	}
+
+	BoundingSphere::BoundingSphere()
+		: Center(), Radius(0.0f)
+	{
+	}
+
+	BoundingSphere::BoundingSphere(const vec3& center, float radius)
+		: Center(center), Radius(radius)
+	{
+	}
+
+	BoundingSphere BoundingSphere::Transform(const mat4& transform) const
+	{
+		// Non-uniform scale grows the sphere by its largest axis
+		float scaleSquared = dot(vec3(transform[0]), vec3(transform[0]));
+		float axisSquared = dot(vec3(transform[1]), vec3(transform[1]));
+		scaleSquared = (axisSquared > scaleSquared ? axisSquared : scaleSquared);
+		axisSquared = dot(vec3(transform[2]), vec3(transform[2]));
+		scaleSquared = (axisSquared > scaleSquared ? axisSquared : scaleSquared);
+
+		return BoundingSphere(vec3(transform * vec4(Center, 1.0f)), Radius * sqrt(scaleSquared));
+	}
+
+	BoundingSphere BoundingSphere::FromPoints(const std::vector<vec3>& points, const BoundingBox& bounds)
+	{
+		// Centered on the box; not minimal, but tight for the roughly convex shapes models tend to be
+		BoundingSphere sphere(bounds.Center(), 0.0f);
+
+		float radiusSquared = 0.0f;
+		for (const vec3& point : points)
+		{
+			vec3 offset = point - sphere.Center;
+			float distanceSquared = dot(offset, offset);
+			radiusSquared = (distanceSquared > radiusSquared ? distanceSquared : radiusSquared);
+		}
+
+		sphere.Radius = sqrt(radiusSquared);
+
+		return sphere;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Common.h"
+
+namespace Library
+{
+	struct BoundingBox
+	{
+		glm::vec3 Minimum;
+		glm::vec3 Maximum;
+
+		BoundingBox();
+		BoundingBox(const glm::vec3& minimum, const glm::vec3& maximum);
+
+		bool IsEmpty() const;
+		glm::vec3 Center() const;
+		glm::vec3 Extents() const;
+		float SurfaceArea() const;
+		bool Contains(const BoundingBox& box) const;
+		bool Intersects(const BoundingBox& box) const;
+
+		void Merge(const glm::vec3& point);
+		void Merge(const BoundingBox& box);
+		BoundingBox Transform(const glm::mat4& transform) const;
+
+		static BoundingBox FromPoints(const std::vector<glm::vec3>& points);
+	};
+
+	struct BoundingSphere
+	{
+		glm::vec3 Center;
+		float Radius;
+
+		BoundingSphere();
+		BoundingSphere(const glm::vec3& center, float radius);
+
+		BoundingSphere Transform(const glm::mat4& transform) const;
+
+		static BoundingSphere FromPoints(const std::vector<glm::vec3>& points, const BoundingBox& bounds);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,782 @@
+#include "BoundingVolumeHierarchy.h"
+#include "Frustum.h"
+#include "GameException.h"
+#include "JobSystem.h"
+#include <algorithm>
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(BoundingVolumeHierarchy)
+
+	const UINT BoundingVolumeHierarchy::NullNode = 0xFFFFFFFF;
+	const float BoundingVolumeHierarchy::DefaultFatMargin = 0.1f;
+	const UINT BoundingVolumeHierarchy::SahBinCount = 16;
+	const UINT BoundingVolumeHierarchy::MinimumBatchPerWorker = 16;
+
+	Ray::Ray()
+		: Origin(), Direction(0.0f, 0.0f, -1.0f), MaxDistance(FLT_MAX)
+	{
+	}
+
+	Ray::Ray(const vec3& origin, const vec3& direction, float maxDistance)
+		: Origin(origin), Direction(direction), MaxDistance(maxDistance)
+	{
+	}
+
+	bool BoundingVolumeHierarchy::Node::IsLeaf() const
+	{
+		return (Child1 == NullNode);
+	}
+
+	BoundingVolumeHierarchy::BoundingVolumeHierarchy(float fatMargin)
+		: mNodes(), mRoot(NullNode), mFreeList(NullNode), mProxyCount(0), mFatMargin(fatMargin)
+	{
+	}
+
+	BoundingVolumeHierarchy::~BoundingVolumeHierarchy()
+	{
+	}
+
+	BoundingVolumeHierarchy* BoundingVolumeHierarchy::Instance()
+	{
+		return static_cast<BoundingVolumeHierarchy*>(GlobalServices.GetService(BoundingVolumeHierarchy::TypeIdClass()));
+	}
+
+	UINT BoundingVolumeHierarchy::Insert(const BoundingBox& bounds, void* userData)
+	{
+		UINT proxy = AllocateNode();
+
+		Node& node = mNodes[proxy];
+		node.Bounds = Fatten(bounds);
+		node.ObjectBounds = bounds;
+		node.UserData = userData;
+		node.Height = 0;
+
+		InsertLeaf(proxy);
+		mProxyCount++;
+
+		return proxy;
+	}
+
+	void BoundingVolumeHierarchy::Remove(UINT proxy)
+	{
+		if (proxy >= mNodes.size() || mNodes[proxy].Height != 0)
+		{
+			throw GameException("BoundingVolumeHierarchy::Remove() invalid proxy.");
+		}
+
+		RemoveLeaf(proxy);
+		FreeNode(proxy);
+		mProxyCount--;
+	}
+
+	bool BoundingVolumeHierarchy::Update(UINT proxy, const BoundingBox& bounds)
+	{
+		if (proxy >= mNodes.size() || mNodes[proxy].Height != 0)
+		{
+			throw GameException("BoundingVolumeHierarchy::Update() invalid proxy.");
+		}
+
+		// Still inside the fat box: the tree is already conservative for it
+		mNodes[proxy].ObjectBounds = bounds;
+		if (mNodes[proxy].Bounds.Contains(bounds))
+		{
+			return false;
+		}
+
+		RemoveLeaf(proxy);
+		mNodes[proxy].Bounds = Fatten(bounds);
+		InsertLeaf(proxy);
+
+		return true;
+	}
+
+	void BoundingVolumeHierarchy::Rebuild()
+	{
+		std::vector<UINT> leaves;
+		leaves.reserve(mProxyCount);
+
+		for (UINT i = 0; i < mNodes.size(); i++)
+		{
+			Node& node = mNodes[i];
+			if (node.Height < 0)
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				node.Bounds = Fatten(node.ObjectBounds);
+				leaves.push_back(i);
+			}
+			else
+			{
+				FreeNode(i);
+			}
+		}
+
+		mRoot = NullNode;
+		if (leaves.empty() == false)
+		{
+			mRoot = BuildRange(leaves, 0, leaves.size());
+			mNodes[mRoot].Parent = NullNode;
+		}
+	}
+
+	void BoundingVolumeHierarchy::Clear()
+	{
+		mNodes.clear();
+		mRoot = NullNode;
+		mFreeList = NullNode;
+		mProxyCount = 0;
+	}
+
+	void* BoundingVolumeHierarchy::UserData(UINT proxy) const
+	{
+		return mNodes.at(proxy).UserData;
+	}
+
+	const BoundingBox& BoundingVolumeHierarchy::Bounds(UINT proxy) const
+	{
+		return mNodes.at(proxy).ObjectBounds;
+	}
+
+	UINT BoundingVolumeHierarchy::ProxyCount() const
+	{
+		return mProxyCount;
+	}
+
+	UINT BoundingVolumeHierarchy::Height() const
+	{
+		return (mRoot == NullNode ? 0 : mNodes[mRoot].Height);
+	}
+
+	float BoundingVolumeHierarchy::Cost() const
+	{
+		// The SAH cost of internal nodes, relative to the root; lower means cheaper traversals
+		if (mRoot == NullNode)
+		{
+			return 0.0f;
+		}
+
+		float rootArea = mNodes[mRoot].Bounds.SurfaceArea();
+		if (rootArea <= 0.0f)
+		{
+			return 0.0f;
+		}
+
+		float totalArea = 0.0f;
+		for (const Node& node : mNodes)
+		{
+			if (node.Height > 0)
+			{
+				totalArea += node.Bounds.SurfaceArea();
+			}
+		}
+
+		return totalArea / rootArea;
+	}
+
+	void BoundingVolumeHierarchy::QueryFrustum(const Frustum& frustum, std::vector<void*>& results) const
+	{
+		if (mRoot == NullNode)
+		{
+			return;
+		}
+
+		std::vector<UINT> stack;
+		stack.reserve(64);
+		stack.push_back(mRoot);
+
+		while (stack.empty() == false)
+		{
+			UINT nodeIndex = stack.back();
+			const Node& node = mNodes[nodeIndex];
+			stack.pop_back();
+
+			if (node.IsLeaf())
+			{
+				if (frustum.Intersects(node.ObjectBounds))
+				{
+					results.push_back(node.UserData);
+				}
+			}
+			else if (frustum.Contains(node.Bounds))
+			{
+				// Every leaf below a fully contained node is visible; gather them without further plane tests
+				CollectLeaves(nodeIndex, stack, results);
+			}
+			else if (frustum.Intersects(node.Bounds))
+			{
+				stack.push_back(node.Child1);
+				stack.push_back(node.Child2);
+			}
+		}
+	}
+
+	void BoundingVolumeHierarchy::QuerySphere(const BoundingSphere& sphere, std::vector<void*>& results) const
+	{
+		Traverse([&sphere](const BoundingBox& bounds) { return IntersectSphere(bounds, sphere); },
+			[&sphere, &results](const Node& leaf)
+			{
+				if (IntersectSphere(leaf.ObjectBounds, sphere))
+				{
+					results.push_back(leaf.UserData);
+				}
+			});
+	}
+
+	void BoundingVolumeHierarchy::QueryRay(const Ray& ray, std::vector<RayHit>& results) const
+	{
+		// Division by a zero component yields infinity, which the slab test handles
+		vec3 inverseDirection = 1.0f / ray.Direction;
+		const vec3& origin = ray.Origin;
+		float maxDistance = ray.MaxDistance;
+		UINT firstResult = results.size();
+
+		Traverse([&origin, &inverseDirection, maxDistance](const BoundingBox& bounds)
+			{
+				float distance;
+				return IntersectRay(bounds, origin, inverseDirection, maxDistance, distance);
+			},
+			[&origin, &inverseDirection, maxDistance, &results](const Node& leaf)
+			{
+				RayHit hit;
+				if (IntersectRay(leaf.ObjectBounds, origin, inverseDirection, maxDistance, hit.Distance))
+				{
+					hit.UserData = leaf.UserData;
+					results.push_back(hit);
+				}
+			});
+
+		// Nearest first, which is what picking wants
+		std::sort(results.begin() + firstResult, results.end(), [](const RayHit& lhs, const RayHit& rhs) { return lhs.Distance < rhs.Distance; });
+	}
+
+	void BoundingVolumeHierarchy::QueryFrustums(const std::vector<Frustum>& frustums, std::vector<std::vector<void*>>& results) const
+	{
+		results.resize(frustums.size());
+		RunBatch(frustums.size(), [this, &frustums, &results](UINT index)
+		{
+			results[index].clear();
+			QueryFrustum(frustums[index], results[index]);
+		});
+	}
+
+	void BoundingVolumeHierarchy::QuerySpheres(const std::vector<BoundingSphere>& spheres, std::vector<std::vector<void*>>& results) const
+	{
+		results.resize(spheres.size());
+		RunBatch(spheres.size(), [this, &spheres, &results](UINT index)
+		{
+			results[index].clear();
+			QuerySphere(spheres[index], results[index]);
+		});
+	}
+
+	void BoundingVolumeHierarchy::QueryRays(const std::vector<Ray>& rays, std::vector<std::vector<RayHit>>& results) const
+	{
+		results.resize(rays.size());
+		RunBatch(rays.size(), [this, &rays, &results](UINT index)
+		{
+			results[index].clear();
+			QueryRay(rays[index], results[index]);
+		});
+	}
+
+	UINT BoundingVolumeHierarchy::AllocateNode()
+	{
+		UINT index;
+		if (mFreeList != NullNode)
+		{
+			index = mFreeList;
+			mFreeList = mNodes[index].Parent;
+		}
+		else
+		{
+			index = mNodes.size();
+			mNodes.push_back(Node());
+		}
+
+		Node& node = mNodes[index];
+		node.Bounds = BoundingBox();
+		node.ObjectBounds = BoundingBox();
+		node.UserData = nullptr;
+		node.Parent = NullNode;
+		node.Child1 = NullNode;
+		node.Child2 = NullNode;
+		node.Height = 0;
+
+		return index;
+	}
+
+	void BoundingVolumeHierarchy::FreeNode(UINT node)
+	{
+		// Free nodes chain through Parent and are marked with a negative height
+		mNodes[node].Parent = mFreeList;
+		mNodes[node].Height = -1;
+		mFreeList = node;
+	}
+
+	void BoundingVolumeHierarchy::InsertLeaf(UINT leaf)
+	{
+		if (mRoot == NullNode)
+		{
+			mRoot = leaf;
+			mNodes[mRoot].Parent = NullNode;
+			return;
+		}
+
+		// Descend toward the sibling that least increases the total surface area
+		BoundingBox leafBounds = mNodes[leaf].Bounds;
+		UINT index = mRoot;
+		while (mNodes[index].IsLeaf() == false)
+		{
+			const Node& node = mNodes[index];
+			UINT child1 = node.Child1;
+			UINT child2 = node.Child2;
+
+			float area = node.Bounds.SurfaceArea();
+			float combinedArea = Combine(node.Bounds, leafBounds).SurfaceArea();
+
+			// Pairing with this node creates a new parent; descending pushes the growth down to every ancestor
+			float cost = 2.0f * combinedArea;
+			float inheritanceCost = 2.0f * (combinedArea - area);
+
+			float cost1 = Combine(mNodes[child1].Bounds, leafBounds).SurfaceArea() + inheritanceCost;
+			if (mNodes[child1].IsLeaf() == false)
+			{
+				cost1 -= mNodes[child1].Bounds.SurfaceArea();
+			}
+
+			float cost2 = Combine(mNodes[child2].Bounds, leafBounds).SurfaceArea() + inheritanceCost;
+			if (mNodes[child2].IsLeaf() == false)
+			{
+				cost2 -= mNodes[child2].Bounds.SurfaceArea();
+			}
+
+			if (cost < cost1 && cost < cost2)
+			{
+				break;
+			}
+
+			index = (cost1 < cost2 ? child1 : child2);
+		}
+
+		UINT sibling = index;
+		UINT oldParent = mNodes[sibling].Parent;
+		UINT newParent = AllocateNode();
+
+		mNodes[newParent].Parent = oldParent;
+		mNodes[newParent].Bounds = Combine(leafBounds, mNodes[sibling].Bounds);
+		mNodes[newParent].Height = mNodes[sibling].Height + 1;
+		mNodes[newParent].Child1 = sibling;
+		mNodes[newParent].Child2 = leaf;
+		mNodes[sibling].Parent = newParent;
+		mNodes[leaf].Parent = newParent;
+
+		if (oldParent != NullNode)
+		{
+			if (mNodes[oldParent].Child1 == sibling)
+			{
+				mNodes[oldParent].Child1 = newParent;
+			}
+			else
+			{
+				mNodes[oldParent].Child2 = newParent;
+			}
+		}
+		else
+		{
+			mRoot = newParent;
+		}
+
+		RefitAncestors(mNodes[leaf].Parent);
+	}
+
+	void BoundingVolumeHierarchy::RemoveLeaf(UINT leaf)
+	{
+		if (leaf == mRoot)
+		{
+			mRoot = NullNode;
+			return;
+		}
+
+		UINT parent = mNodes[leaf].Parent;
+		UINT grandParent = mNodes[parent].Parent;
+		UINT sibling = (mNodes[parent].Child1 == leaf ? mNodes[parent].Child2 : mNodes[parent].Child1);
+
+		// The parent goes away and the sibling takes its place
+		if (grandParent != NullNode)
+		{
+			if (mNodes[grandParent].Child1 == parent)
+			{
+				mNodes[grandParent].Child1 = sibling;
+			}
+			else
+			{
+				mNodes[grandParent].Child2 = sibling;
+			}
+
+			mNodes[sibling].Parent = grandParent;
+			FreeNode(parent);
+			RefitAncestors(grandParent);
+		}
+		else
+		{
+			mRoot = sibling;
+			mNodes[sibling].Parent = NullNode;
+			FreeNode(parent);
+		}
+	}
+
+	void BoundingVolumeHierarchy::RefitAncestors(UINT node)
+	{
+		UINT index = node;
+		while (index != NullNode)
+		{
+			index = Balance(index);
+
+			Node& current = mNodes[index];
+			const Node& child1 = mNodes[current.Child1];
+			const Node& child2 = mNodes[current.Child2];
+
+			current.Height = 1 + (child1.Height > child2.Height ? child1.Height : child2.Height);
+			current.Bounds = Combine(child1.Bounds, child2.Bounds);
+
+			index = current.Parent;
+		}
+	}
+
+	UINT BoundingVolumeHierarchy::Balance(UINT indexA)
+	{
+		Node& a = mNodes[indexA];
+		if (a.IsLeaf() || a.Height < 2)
+		{
+			return indexA;
+		}
+
+		UINT indexB = a.Child1;
+		UINT indexC = a.Child2;
+		Node& b = mNodes[indexB];
+		Node& c = mNodes[indexC];
+
+		int balance = c.Height - b.Height;
+
+		// Rotate C up
+		if (balance > 1)
+		{
+			UINT indexF = c.Child1;
+			UINT indexG = c.Child2;
+			Node& f = mNodes[indexF];
+			Node& g = mNodes[indexG];
+
+			c.Child1 = indexA;
+			c.Parent = a.Parent;
+			a.Parent = indexC;
+
+			if (c.Parent != NullNode)
+			{
+				if (mNodes[c.Parent].Child1 == indexA)
+				{
+					mNodes[c.Parent].Child1 = indexC;
+				}
+				else
+				{
+					mNodes[c.Parent].Child2 = indexC;
+				}
+			}
+			else
+			{
+				mRoot = indexC;
+			}
+
+			if (f.Height > g.Height)
+			{
+				c.Child2 = indexF;
+				a.Child2 = indexG;
+				g.Parent = indexA;
+				a.Bounds = Combine(b.Bounds, g.Bounds);
+				c.Bounds = Combine(a.Bounds, f.Bounds);
+				a.Height = 1 + (b.Height > g.Height ? b.Height : g.Height);
+				c.Height = 1 + (a.Height > f.Height ? a.Height : f.Height);
+			}
+			else
+			{
+				c.Child2 = indexG;
+				a.Child2 = indexF;
+				f.Parent = indexA;
+				a.Bounds = Combine(b.Bounds, f.Bounds);
+				c.Bounds = Combine(a.Bounds, g.Bounds);
+				a.Height = 1 + (b.Height > f.Height ? b.Height : f.Height);
+				c.Height = 1 + (a.Height > g.Height ? a.Height : g.Height);
+			}
+
+			return indexC;
+		}
+
+		// Rotate B up
+		if (balance < -1)
+		{
+			UINT indexD = b.Child1;
+			UINT indexE = b.Child2;
+			Node& d = mNodes[indexD];
+			Node& e = mNodes[indexE];
+
+			b.Child1 = indexA;
+			b.Parent = a.Parent;
+			a.Parent = indexB;
+
+			if (b.Parent != NullNode)
+			{
+				if (mNodes[b.Parent].Child1 == indexA)
+				{
+					mNodes[b.Parent].Child1 = indexB;
+				}
+				else
+				{
+					mNodes[b.Parent].Child2 = indexB;
+				}
+			}
+			else
+			{
+				mRoot = indexB;
+			}
+
+			if (d.Height > e.Height)
+			{
+				b.Child2 = indexD;
+				a.Child1 = indexE;
+				e.Parent = indexA;
+				a.Bounds = Combine(c.Bounds, e.Bounds);
+				b.Bounds = Combine(a.Bounds, d.Bounds);
+				a.Height = 1 + (c.Height > e.Height ? c.Height : e.Height);
+				b.Height = 1 + (a.Height > d.Height ? a.Height : d.Height);
+			}
+			else
+			{
+				b.Child2 = indexE;
+				a.Child1 = indexD;
+				d.Parent = indexA;
+				a.Bounds = Combine(c.Bounds, d.Bounds);
+				b.Bounds = Combine(a.Bounds, e.Bounds);
+				a.Height = 1 + (c.Height > d.Height ? c.Height : d.Height);
+				b.Height = 1 + (a.Height > e.Height ? a.Height : e.Height);
+			}
+
+			return indexB;
+		}
+
+		return indexA;
+	}
+
+	UINT BoundingVolumeHierarchy::BuildRange(std::vector<UINT>& leaves, UINT begin, UINT end)
+	{
+		UINT count = end - begin;
+		if (count == 1)
+		{
+			return leaves[begin];
+		}
+
+		// Bin leaf centroids along the widest centroid axis
+		BoundingBox centroidBounds;
+		for (UINT i = begin; i < end; i++)
+		{
+			centroidBounds.Merge(mNodes[leaves[i]].Bounds.Center());
+		}
+
+		vec3 centroidSize = centroidBounds.Maximum - centroidBounds.Minimum;
+		int axis = (centroidSize.x > centroidSize.y ? 0 : 1);
+		axis = (centroidSize.z > centroidSize[axis] ? 2 : axis);
+
+		UINT middle = begin + count / 2;
+		float axisMinimum = centroidBounds.Minimum[axis];
+		float axisExtent = centroidSize[axis];
+
+		if (axisExtent > 0.0f)
+		{
+			std::vector<UINT> binCounts(SahBinCount, 0);
+			std::vector<BoundingBox> binBounds(SahBinCount);
+			float binScale = SahBinCount / axisExtent;
+
+			auto binOf = [&](UINT leaf) -> UINT
+			{
+				UINT bin = static_cast<UINT>((mNodes[leaf].Bounds.Center()[axis] - axisMinimum) * binScale);
+				return (bin < SahBinCount ? bin : SahBinCount - 1);
+			};
+
+			for (UINT i = begin; i < end; i++)
+			{
+				UINT bin = binOf(leaves[i]);
+				binCounts[bin]++;
+				binBounds[bin].Merge(mNodes[leaves[i]].Bounds);
+			}
+
+			// Sweep from the right to get each split's right-hand area and count, then from the left to price them
+			std::vector<float> rightAreas(SahBinCount, 0.0f);
+			std::vector<UINT> rightCounts(SahBinCount, 0);
+			BoundingBox accumulated;
+			UINT accumulatedCount = 0;
+			for (UINT bin = SahBinCount - 1; bin > 0; bin--)
+			{
+				accumulated.Merge(binBounds[bin]);
+				accumulatedCount += binCounts[bin];
+				rightAreas[bin] = accumulated.SurfaceArea();
+				rightCounts[bin] = accumulatedCount;
+			}
+
+			float bestCost = FLT_MAX;
+			UINT bestSplit = 0;
+			accumulated = BoundingBox();
+			accumulatedCount = 0;
+			for (UINT split = 1; split < SahBinCount; split++)
+			{
+				accumulated.Merge(binBounds[split - 1]);
+				accumulatedCount += binCounts[split - 1];
+
+				if (accumulatedCount == 0 || rightCounts[split] == 0)
+				{
+					continue;
+				}
+
+				float cost = accumulated.SurfaceArea() * accumulatedCount + rightAreas[split] * rightCounts[split];
+				if (cost < bestCost)
+				{
+					bestCost = cost;
+					bestSplit = split;
+				}
+			}
+
+			if (bestSplit > 0)
+			{
+				std::vector<UINT>::iterator partition = std::partition(leaves.begin() + begin, leaves.begin() + end, [&](UINT leaf) { return binOf(leaf) < bestSplit; });
+				middle = partition - leaves.begin();
+			}
+		}
+
+		// Coincident centroids leave nothing to split on; halve the range instead
+		if (middle == begin || middle == end)
+		{
+			middle = begin + count / 2;
+		}
+
+		UINT child1 = BuildRange(leaves, begin, middle);
+		UINT child2 = BuildRange(leaves, middle, end);
+
+		UINT node = AllocateNode();
+		Node& parent = mNodes[node];
+		parent.Child1 = child1;
+		parent.Child2 = child2;
+		parent.Bounds = Combine(mNodes[child1].Bounds, mNodes[child2].Bounds);
+		parent.Height = 1 + (mNodes[child1].Height > mNodes[child2].Height ? mNodes[child1].Height : mNodes[child2].Height);
+		mNodes[child1].Parent = node;
+		mNodes[child2].Parent = node;
+
+		return node;
+	}
+
+	BoundingBox BoundingVolumeHierarchy::Fatten(const BoundingBox& bounds) const
+	{
+		return BoundingBox(bounds.Minimum - mFatMargin, bounds.Maximum + mFatMargin);
+	}
+
+	void BoundingVolumeHierarchy::RunBatch(UINT queryCount, const std::function<void(UINT)>& query) const
+	{
+		JobSystem::ParallelFor(queryCount, MinimumBatchPerWorker, [&query](UINT begin, UINT end)
+		{
+			for (UINT i = begin; i < end; i++)
+			{
+				query(i);
+			}
+		});
+	}
+
+	void BoundingVolumeHierarchy::CollectLeaves(UINT node, std::vector<UINT>& stack, std::vector<void*>& results) const
+	{
+		// Works on top of the caller's traversal stack and leaves it as it was found
+		size_t base = stack.size();
+		stack.push_back(node);
+
+		while (stack.size() > base)
+		{
+			const Node& current = mNodes[stack.back()];
+			stack.pop_back();
+
+			if (current.IsLeaf())
+			{
+				results.push_back(current.UserData);
+			}
+			else
+			{
+				stack.push_back(current.Child1);
+				stack.push_back(current.Child2);
+			}
+		}
+	}
+
+	template <typename NodeTest, typename LeafVisitor>
+	void BoundingVolumeHierarchy::Traverse(const NodeTest& overlaps, const LeafVisitor& visit) const
+	{
+		if (mRoot == NullNode)
+		{
+			return;
+		}
+
+		std::vector<UINT> stack;
+		stack.reserve(64);
+		stack.push_back(mRoot);
+
+		while (stack.empty() == false)
+		{
+			const Node& node = mNodes[stack.back()];
+			stack.pop_back();
+
+			if (overlaps(node.Bounds) == false)
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				visit(node);
+			}
+			else
+			{
+				stack.push_back(node.Child1);
+				stack.push_back(node.Child2);
+			}
+		}
+	}
+
+	BoundingBox BoundingVolumeHierarchy::Combine(const BoundingBox& a, const BoundingBox& b)
+	{
+		BoundingBox combined = a;
+		combined.Merge(b);
+
+		return combined;
+	}
+
+	bool BoundingVolumeHierarchy::IntersectRay(const BoundingBox& box, const vec3& origin, const vec3& inverseDirection, float maxDistance, float& distance)
+	{
+		// Slab test
+		vec3 t1 = (box.Minimum - origin) * inverseDirection;
+		vec3 t2 = (box.Maximum - origin) * inverseDirection;
+		vec3 tNear = glm::min(t1, t2);
+		vec3 tFar = glm::max(t1, t2);
+
+		float entry = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, 0.0f));
+		float exit = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, maxDistance));
+
+		distance = entry;
+		return (entry <= exit);
+	}
+
+	bool BoundingVolumeHierarchy::IntersectSphere(const BoundingBox& box, const BoundingSphere& sphere)
+	{
+		vec3 closest = glm::clamp(sphere.Center, box.Minimum, box.Maximum);
+		vec3 offset = closest - sphere.Center;
+
+		return (dot(offset, offset) <= sphere.Radius * sphere.Radius);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "Common.h"
+#include "BoundingVolume.h"
+#include <functional>
+
+namespace Library
+{
+	class Frustum;
+
+	struct Ray
+	{
+		glm::vec3 Origin;
+		glm::vec3 Direction;
+		float MaxDistance;
+
+		Ray();
+		Ray(const glm::vec3& origin, const glm::vec3& direction, float maxDistance = FLT_MAX);
+	};
+
+	struct RayHit
+	{
+		void* UserData;
+		float Distance;
+	};
+
+	// A dynamic AABB tree over scene objects. Leaves hold a fattened copy of each object's bounds, so small
+	// movements refit nothing; larger ones reinsert the leaf, and AVL-style rotations keep the tree balanced.
+	// Rebuild() replaces the incremental structure with a binned SAH build. Queries are read-only, so the
+	// batched variants fan out across worker threads while the tree is left untouched.
+	class BoundingVolumeHierarchy : public RTTI
+	{
+		RTTI_DECLARATIONS(BoundingVolumeHierarchy, RTTI)
+
+	public:
+		BoundingVolumeHierarchy(float fatMargin = DefaultFatMargin);
+		~BoundingVolumeHierarchy();
+
+		static BoundingVolumeHierarchy* Instance();
+
+		UINT Insert(const BoundingBox& bounds, void* userData);
+		void Remove(UINT proxy);
+		bool Update(UINT proxy, const BoundingBox& bounds);
+		void Rebuild();
+		void Clear();
+
+		void* UserData(UINT proxy) const;
+		const BoundingBox& Bounds(UINT proxy) const;
+		UINT ProxyCount() const;
+		UINT Height() const;
+		float Cost() const;
+
+		void QueryFrustum(const Frustum& frustum, std::vector<void*>& results) const;
+		void QuerySphere(const BoundingSphere& sphere, std::vector<void*>& results) const;
+		void QueryRay(const Ray& ray, std::vector<RayHit>& results) const;
+
+		void QueryFrustums(const std::vector<Frustum>& frustums, std::vector<std::vector<void*>>& results) const;
+		void QuerySpheres(const std::vector<BoundingSphere>& spheres, std::vector<std::vector<void*>>& results) const;
+		void QueryRays(const std::vector<Ray>& rays, std::vector<std::vector<RayHit>>& results) const;
+
+		static const UINT NullNode;
+		static const float DefaultFatMargin;
+
+	private:
+		BoundingVolumeHierarchy(const BoundingVolumeHierarchy& rhs);
+		BoundingVolumeHierarchy& operator=(const BoundingVolumeHierarchy& rhs);
+
+		struct Node
+		{
+			BoundingBox Bounds;
+			BoundingBox ObjectBounds;
+			void* UserData;
+			UINT Parent;
+			UINT Child1;
+			UINT Child2;
+			int Height;
+
+			bool IsLeaf() const;
+		};
+
+		UINT AllocateNode();
+		void FreeNode(UINT node);
+		void InsertLeaf(UINT leaf);
+		void RemoveLeaf(UINT leaf);
+		void RefitAncestors(UINT node);
+		UINT Balance(UINT node);
+		UINT BuildRange(std::vector<UINT>& leaves, UINT begin, UINT end);
+		BoundingBox Fatten(const BoundingBox& bounds) const;
+		void CollectLeaves(UINT node, std::vector<UINT>& stack, std::vector<void*>& results) const;
+		void RunBatch(UINT queryCount, const std::function<void(UINT)>& query) const;
+
+		template <typename NodeTest, typename LeafVisitor>
+		void Traverse(const NodeTest& overlaps, const LeafVisitor& visit) const;
+
+		static BoundingBox Combine(const BoundingBox& a, const BoundingBox& b);
+		static bool IntersectRay(const BoundingBox& box, const glm::vec3& origin, const glm::vec3& inverseDirection, float maxDistance, float& distance);
+		static bool IntersectSphere(const BoundingBox& box, const BoundingSphere& sphere);
+
+		static const UINT SahBinCount;
+		static const UINT MinimumBatchPerWorker;
+
+		std::vector<Node> mNodes;
+		UINT mRoot;
+		UINT mFreeList;
+		UINT mProxyCount;
+		glm::vec3 mFatMargin;
+	};
+}
\ No newline at end of file
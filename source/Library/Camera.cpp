@@ -16,14 +16,16 @@ namespace Library
 	Camera::Camera(Game& game)
 		: GameComponent(game),
 		mFieldOfView(DefaultFieldOfView), mAspectRatio(game.AspectRatio()), mNearPlaneDistance(DefaultNearPlaneDistance), mFarPlaneDistance(DefaultFarPlaneDistance),
-		mPosition(), mDirection(), mUp(), mRight(), mViewMatrix(), mProjectionMatrix()
+		mPosition(), mDirection(), mUp(), mRight(), mViewMatrix(), mProjectionMatrix(),
+		mViewProjectionMatrix(), mFrustum()
 	{
 	}
 
 	Camera::Camera(Game& game, float fieldOfView, float aspectRatio, float nearPlaneDistance, float farPlaneDistance)
 		: GameComponent(game),
 		mFieldOfView(fieldOfView), mAspectRatio(aspectRatio), mNearPlaneDistance(nearPlaneDistance), mFarPlaneDistance(farPlaneDistance),
-		mPosition(), mDirection(), mUp(), mRight(), mViewMatrix(), mProjectionMatrix()
+		mPosition(), mDirection(), mUp(), mRight(), mViewMatrix(), mProjectionMatrix(),
+		mViewProjectionMatrix(), mFrustum()
 	{
 	}
 
@@ -81,9 +83,14 @@ namespace Library
 		return mProjectionMatrix;
 	}
 
-	glm::mat4 Camera::ViewProjectionMatrix() const
+	const glm::mat4& Camera::ViewProjectionMatrix() const
 	{
-		return mProjectionMatrix * mViewMatrix;
+		return mViewProjectionMatrix;
+	}
+
+	const Frustum& Camera::ViewFrustum() const
+	{
+		return mFrustum;
 	}
 
 	void Camera::SetPosition(FLOAT x, FLOAT y, FLOAT z)
@@ -121,11 +128,19 @@ namespace Library
 	{
 		vec3 target = mPosition + mDirection;
 		mViewMatrix = lookAt(mPosition, target, mUp);
+		UpdateViewProjection();
 	}
 
 	void Camera::UpdateProjectionMatrix()
 	{
 		mProjectionMatrix = perspective(mFieldOfView, mAspectRatio, mNearPlaneDistance, mFarPlaneDistance);
+		UpdateViewProjection();
+	}
+
+	void Camera::UpdateViewProjection()
+	{
+		mViewProjectionMatrix = mProjectionMatrix * mViewMatrix;
+		mFrustum.SetMatrix(mViewProjectionMatrix);
 	}
 
 	void Camera::ApplyRotation(const glm::mat4& transform)
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "GameComponent.h"
+#include "Frustum.h"
 
 namespace Library
 {
@@ -28,7 +29,8 @@ namespace Library
 
 		const glm::mat4& ViewMatrix() const;
 		const glm::mat4& ProjectionMatrix() const;
-		glm::mat4 ViewProjectionMatrix() const;
+		const glm::mat4& ViewProjectionMatrix() const;
+		const Frustum& ViewFrustum() const;
 
 		virtual void SetPosition(FLOAT x, FLOAT y, FLOAT z);
 		virtual void SetPosition(const glm::vec3& position);
@@ -59,8 +61,13 @@ namespace Library
 		glm::mat4 mProjectionMatrix;
 
 	private:
+		void UpdateViewProjection();
+
+		// Rebuilt on the main thread whenever the view or projection changes, so workers recording draws only read them
+		glm::mat4 mViewProjectionMatrix;
+		Frustum mFrustum;
+
 		Camera(const Camera& rhs);
 		Camera& operator=(const Camera& rhs);
 	};
-}
-
+}
\ No newline at end of file
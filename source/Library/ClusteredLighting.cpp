@@ -0,0 +1,396 @@
+#include "ClusteredLighting.h"
+#include "Camera.h"
+#include "GameException.h"
+#include "JobSystem.h"
+#include "RenderStateCache.h"
+#include "SpotLight.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(ClusteredLighting)
+
+	const GLuint ClusteredLighting::LightBinding = 4;
+	const GLuint ClusteredLighting::ClusterBinding = 5;
+	const GLuint ClusteredLighting::LightIndexBinding = 6;
+
+	const UINT ClusteredLighting::ClusterCountX = 16;
+	const UINT ClusteredLighting::ClusterCountY = 9;
+	const UINT ClusteredLighting::ClusterCountZ = 24;
+	const UINT ClusteredLighting::MaxLightsPerCluster = 128;
+
+	// Slice 0 spans the near plane to this depth; the rest are logarithmic out to the far plane, which keeps
+	// a tiny near plane from spending most of the slices in the first few centimetres. A near plane at or
+	// beyond this depth starts the logarithmic slices there instead
+	const float ClusteredLighting::FirstSliceDepth = 1.0f;
+
+	ClusteredLighting::ClusteredLighting()
+		: mLights(), mLightData(), mLightBounds(), mClusterBounds(), mClusterLights(ClusterCountX * ClusterCountY * ClusterCountZ),
+		  mSliceOverflowCounts(ClusterCountZ), mClusters(), mLightIndices(), mHeader(), mProjection(0.0f), mNearDepth(0.0f), mFarDepth(0.0f), mViewportWidth(0), mViewportHeight(0), mSliceScale(0.0f), mSliceBias(0.0f), mOverflowLightCount(0),
+		  mLightBuffer(0), mClusterBuffer(0), mLightIndexBuffer(0)
+	{
+	}
+
+	ClusteredLighting::~ClusteredLighting()
+	{
+		// The buffers only exist once a frame has uploaded, so CPU-only users never need a context
+		if (mLightBuffer != 0)
+		{
+			glDeleteBuffers(1, &mLightIndexBuffer);
+			glDeleteBuffers(1, &mClusterBuffer);
+			glDeleteBuffers(1, &mLightBuffer);
+		}
+	}
+
+	ClusteredLighting* ClusteredLighting::Instance()
+	{
+		return static_cast<ClusteredLighting*>(GlobalServices.GetService(ClusteredLighting::TypeIdClass()));
+	}
+
+	void ClusteredLighting::AddLight(const PointLight& light)
+	{
+		if (std::find(mLights.begin(), mLights.end(), &light) != mLights.end())
+		{
+			throw GameException("ClusteredLighting::AddLight() light is already registered.");
+		}
+
+		mLights.push_back(&light);
+	}
+
+	void ClusteredLighting::RemoveLight(const PointLight& light)
+	{
+		mLights.erase(std::remove(mLights.begin(), mLights.end(), &light), mLights.end());
+	}
+
+	void ClusteredLighting::ClearLights()
+	{
+		mLights.clear();
+	}
+
+	UINT ClusteredLighting::LightCount() const
+	{
+		return mLights.size();
+	}
+
+	UINT ClusteredLighting::VisibleLightCount() const
+	{
+		return mLightBounds.size();
+	}
+
+	UINT ClusteredLighting::LightIndexCount() const
+	{
+		return mLightIndices.size();
+	}
+
+	UINT ClusteredLighting::ClusterCount() const
+	{
+		return mClusterLights.size();
+	}
+
+	UINT ClusteredLighting::OverflowLightCount() const
+	{
+		return mOverflowLightCount;
+	}
+
+	const BoundingBox& ClusteredLighting::ClusterBounds(UINT cluster) const
+	{
+		return mClusterBounds.at(cluster);
+	}
+
+	const std::vector<UINT>& ClusteredLighting::ClusterLights(UINT cluster) const
+	{
+		return mClusterLights.at(cluster);
+	}
+
+	UINT ClusteredLighting::ClusterIndex(const vec2& windowPosition, float depth) const
+	{
+		// Same lookup as the shader, which passes gl_FragCoord.xy
+		vec2 tile = windowPosition * vec2(mHeader.Scale);
+		UINT x = std::min<UINT>(static_cast<UINT>(std::max<float>(tile.x, 0.0f)), ClusterCountX - 1);
+		UINT y = std::min<UINT>(static_cast<UINT>(std::max<float>(tile.y, 0.0f)), ClusterCountY - 1);
+
+		return x + ClusterCountX * (y + ClusterCountY * SliceIndex(depth));
+	}
+
+	void ClusteredLighting::Update(const Camera& camera, UINT viewportWidth, UINT viewportHeight)
+	{
+		// Games that never register a light never pay for the grid
+		if (mLights.empty() && mLightBuffer == 0)
+		{
+			return;
+		}
+
+		AssignLights(camera.ViewMatrix(), camera.ProjectionMatrix(), camera.NearPlaneDistance(), camera.FarPlaneDistance(), viewportWidth, viewportHeight);
+		Upload();
+	}
+
+	void ClusteredLighting::AssignLights(const mat4& view, const mat4& projection, float nearDepth, float farDepth, UINT viewportWidth, UINT viewportHeight)
+	{
+		UpdateClusterBounds(projection, nearDepth, farDepth, viewportWidth, viewportHeight);
+		GatherLights(view, nearDepth, farDepth);
+
+		// Each slice owns a disjoint set of clusters, so slices assign in parallel without locks
+		JobSystem::ParallelFor(ClusterCountZ, 1, [this](UINT begin, UINT end)
+		{
+			for (UINT slice = begin; slice < end; slice++)
+			{
+				AssignSlice(slice);
+			}
+		});
+
+		mOverflowLightCount = 0;
+		for (UINT overflowCount : mSliceOverflowCounts)
+		{
+			mOverflowLightCount += overflowCount;
+		}
+
+		PackClusters();
+	}
+
+	void ClusteredLighting::UpdateClusterBounds(const mat4& projection, float nearDepth, float farDepth, UINT viewportWidth, UINT viewportHeight)
+	{
+		if (projection == mProjection && nearDepth == mNearDepth && farDepth == mFarDepth && viewportWidth == mViewportWidth && viewportHeight == mViewportHeight)
+		{
+			return;
+		}
+
+		mProjection = projection;
+		mNearDepth = nearDepth;
+		mFarDepth = farDepth;
+		mViewportWidth = viewportWidth;
+		mViewportHeight = viewportHeight;
+
+		// slice = log(depth) * scale + bias, with ClusterCountZ at the far plane. Slice 1 starts at FirstSliceDepth
+		// when the near plane is closer than that; otherwise slice 0 starts the logarithmic run at the near plane,
+		// so it never collapses to zero thickness
+		UINT firstLogarithmicSlice = (nearDepth < FirstSliceDepth ? 1 : 0);
+		float logarithmicStart = std::min<float>(std::max<float>(FirstSliceDepth, nearDepth), farDepth);
+		mSliceScale = (ClusterCountZ - firstLogarithmicSlice) / std::max<float>(log(farDepth / logarithmicStart), FLT_EPSILON);
+		mSliceBias = firstLogarithmicSlice - log(logarithmicStart) * mSliceScale;
+
+		mHeader.Scale = vec4(static_cast<float>(ClusterCountX) / viewportWidth, static_cast<float>(ClusterCountY) / viewportHeight, mSliceScale, 0.0f);
+		mHeader.Bias = vec4(0.0f, 0.0f, mSliceBias, 0.0f);
+		mHeader.Dimensions = uvec4(ClusterCountX, ClusterCountY, ClusterCountZ, 0);
+
+		// View space is right-handed looking down -z: x = (ndc.x + P[2][0]) * depth / P[0][0]
+		mClusterBounds.resize(mClusterLights.size());
+		for (UINT z = 0; z < ClusterCountZ; z++)
+		{
+			float sliceNear = (z == 0 ? nearDepth : exp((z - mSliceBias) / mSliceScale));
+			float sliceFar = (z + 1 == ClusterCountZ ? farDepth : exp((z + 1 - mSliceBias) / mSliceScale));
+
+			for (UINT y = 0; y < ClusterCountY; y++)
+			{
+				float ndcBottom = -1.0f + 2.0f * y / ClusterCountY;
+				float ndcTop = -1.0f + 2.0f * (y + 1) / ClusterCountY;
+
+				for (UINT x = 0; x < ClusterCountX; x++)
+				{
+					float ndcLeft = -1.0f + 2.0f * x / ClusterCountX;
+					float ndcRight = -1.0f + 2.0f * (x + 1) / ClusterCountX;
+
+					BoundingBox bounds;
+					const float depths[] = { sliceNear, sliceFar };
+					for (float depth : depths)
+					{
+						float left = (ndcLeft + projection[2][0]) * depth / projection[0][0];
+						float right = (ndcRight + projection[2][0]) * depth / projection[0][0];
+						float bottom = (ndcBottom + projection[2][1]) * depth / projection[1][1];
+						float top = (ndcTop + projection[2][1]) * depth / projection[1][1];
+
+						bounds.Merge(vec3(left, bottom, -depth));
+						bounds.Merge(vec3(right, top, -depth));
+					}
+
+					mClusterBounds[x + ClusterCountX * (y + ClusterCountY * z)] = bounds;
+				}
+			}
+		}
+	}
+
+	void ClusteredLighting::GatherLights(const mat4& view, float nearDepth, float farDepth)
+	{
+		mLightData.clear();
+		mLightBounds.clear();
+
+		// Lights wholly in front of the near plane or past the far plane never reach the grid
+		for (const PointLight* light : mLights)
+		{
+			vec3 center = vec3(view * vec4(light->Position(), 1.0f));
+			float radius = light->Radius();
+			float depth = -center.z;
+			if (depth + radius < nearDepth || depth - radius > farDepth || radius <= 0.0f)
+			{
+				continue;
+			}
+
+			LightData data;
+			data.Position = vec4(light->Position(), radius);
+			data.Color = light->Color();
+			data.Direction = vec4(0.0f);
+			data.Parameters = vec4(0.0f);
+
+			const SpotLight* spotLight = light->As<SpotLight>();
+			if (spotLight != nullptr)
+			{
+				data.Direction = vec4(spotLight->Direction(), spotLight->InnerAngle());
+				data.Parameters = vec4(spotLight->OuterAngle(), 1.0f, 0.0f, 0.0f);
+			}
+
+			LightBounds bounds;
+			bounds.Center = center;
+			bounds.Radius = radius;
+			bounds.FirstSlice = SliceIndex(depth - radius);
+			bounds.LastSlice = SliceIndex(depth + radius);
+
+			mLightData.push_back(data);
+			mLightBounds.push_back(bounds);
+		}
+	}
+
+	void ClusteredLighting::AssignSlice(UINT slice)
+	{
+		UINT sliceBase = slice * ClusterCountX * ClusterCountY;
+		for (UINT i = 0; i < ClusterCountX * ClusterCountY; i++)
+		{
+			mClusterLights[sliceBase + i].clear();
+		}
+
+		// Counted per slice so the parallel slices never share a counter
+		UINT& overflowCount = mSliceOverflowCounts[slice];
+		overflowCount = 0;
+
+		const BoundingBox& firstCluster = mClusterBounds[sliceBase];
+		float sliceNear = -firstCluster.Maximum.z;
+		float sliceFar = -firstCluster.Minimum.z;
+
+		for (UINT lightIndex = 0; lightIndex < mLightBounds.size(); lightIndex++)
+		{
+			const LightBounds& light = mLightBounds[lightIndex];
+			if (slice < light.FirstSlice || slice > light.LastSlice)
+			{
+				continue;
+			}
+
+			// Conservative tile range: project the sphere's box over the part of the slice it overlaps
+			UINT minimumX = 0;
+			UINT maximumX = ClusterCountX - 1;
+			UINT minimumY = 0;
+			UINT maximumY = ClusterCountY - 1;
+
+			float nearDepth = std::max<float>(-light.Center.z - light.Radius, sliceNear);
+			float farDepth = std::min<float>(-light.Center.z + light.Radius, sliceFar);
+			if (nearDepth > 0.0f)
+			{
+				vec2 boxMinimum = vec2(light.Center) - light.Radius;
+				vec2 boxMaximum = vec2(light.Center) + light.Radius;
+				vec2 projectedMinimum = min(boxMinimum / nearDepth, boxMinimum / farDepth);
+				vec2 projectedMaximum = max(boxMaximum / nearDepth, boxMaximum / farDepth);
+
+				vec2 scale = vec2(mProjection[0][0], mProjection[1][1]);
+				vec2 offset = vec2(mProjection[2][0], mProjection[2][1]);
+				vec2 ndcMinimum = projectedMinimum * scale - offset;
+				vec2 ndcMaximum = projectedMaximum * scale - offset;
+
+				if (ndcMinimum.x > 1.0f || ndcMinimum.y > 1.0f || ndcMaximum.x < -1.0f || ndcMaximum.y < -1.0f)
+				{
+					continue;
+				}
+
+				vec2 counts = vec2(ClusterCountX, ClusterCountY);
+				vec2 tileMinimum = clamp((ndcMinimum * 0.5f + 0.5f) * counts, vec2(0.0f), counts - 1.0f);
+				vec2 tileMaximum = clamp((ndcMaximum * 0.5f + 0.5f) * counts, vec2(0.0f), counts - 1.0f);
+				minimumX = static_cast<UINT>(tileMinimum.x);
+				maximumX = static_cast<UINT>(tileMaximum.x);
+				minimumY = static_cast<UINT>(tileMinimum.y);
+				maximumY = static_cast<UINT>(tileMaximum.y);
+			}
+
+			// Exact sphere-box test against each candidate cluster
+			float radiusSquared = light.Radius * light.Radius;
+			for (UINT y = minimumY; y <= maximumY; y++)
+			{
+				for (UINT x = minimumX; x <= maximumX; x++)
+				{
+					UINT cluster = sliceBase + x + ClusterCountX * y;
+					const BoundingBox& bounds = mClusterBounds[cluster];
+					vec3 closest = clamp(light.Center, bounds.Minimum, bounds.Maximum);
+					vec3 delta = closest - light.Center;
+					if (dot(delta, delta) <= radiusSquared)
+					{
+						if (mClusterLights[cluster].size() < MaxLightsPerCluster)
+						{
+							mClusterLights[cluster].push_back(lightIndex);
+						}
+						else
+						{
+							overflowCount++;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void ClusteredLighting::PackClusters()
+	{
+		mClusters.resize(mClusterLights.size());
+		mLightIndices.clear();
+
+		for (UINT cluster = 0; cluster < mClusterLights.size(); cluster++)
+		{
+			const std::vector<UINT>& lights = mClusterLights[cluster];
+			mClusters[cluster] = uvec2(mLightIndices.size(), lights.size());
+			mLightIndices.insert(mLightIndices.end(), lights.begin(), lights.end());
+		}
+	}
+
+	void ClusteredLighting::Upload()
+	{
+		if (mLightBuffer == 0)
+		{
+			glGenBuffers(1, &mLightBuffer);
+			glGenBuffers(1, &mClusterBuffer);
+			glGenBuffers(1, &mLightIndexBuffer);
+		}
+
+		RenderStateCache& renderStates = *RenderStateCache::Instance();
+
+		// Respecified every frame so the driver can orphan the stores the previous frame is still reading;
+		// the light and index buffers keep at least one element so the bindings are never zero-sized
+		renderStates.BindBuffer(GL_SHADER_STORAGE_BUFFER, mLightBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(LightData) * std::max<UINT>(mLightData.size(), 1), nullptr, GL_STREAM_DRAW);
+		if (mLightData.empty() == false)
+		{
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(LightData) * mLightData.size(), &mLightData.front());
+		}
+
+		renderStates.BindBuffer(GL_SHADER_STORAGE_BUFFER, mClusterBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(ClusterHeader) + sizeof(uvec2) * mClusters.size(), nullptr, GL_STREAM_DRAW);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(ClusterHeader), &mHeader);
+		glBufferSubData(GL_SHADER_STORAGE_BUFFER, sizeof(ClusterHeader), sizeof(uvec2) * mClusters.size(), &mClusters.front());
+
+		renderStates.BindBuffer(GL_SHADER_STORAGE_BUFFER, mLightIndexBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(UINT) * std::max<UINT>(mLightIndices.size(), 1), nullptr, GL_STREAM_DRAW);
+		if (mLightIndices.empty() == false)
+		{
+			glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(UINT) * mLightIndices.size(), &mLightIndices.front());
+		}
+
+		renderStates.BindBufferBase(GL_SHADER_STORAGE_BUFFER, LightBinding, mLightBuffer);
+		renderStates.BindBufferBase(GL_SHADER_STORAGE_BUFFER, ClusterBinding, mClusterBuffer);
+		renderStates.BindBufferBase(GL_SHADER_STORAGE_BUFFER, LightIndexBinding, mLightIndexBuffer);
+	}
+
+	UINT ClusteredLighting::SliceIndex(float depth) const
+	{
+		// Matches the shader: everything nearer than slice 1 lands in slice 0
+		float slice = (depth > 0.0f ? log(depth) * mSliceScale + mSliceBias : 0.0f);
+		slice = (slice > 0.0f ? slice : 0.0f);
+
+		return std::min<UINT>(static_cast<UINT>(slice), ClusterCountZ - 1);
+	}
+}
\ No newline at end of file
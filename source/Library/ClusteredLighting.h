@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Common.h"
+#include "BoundingVolume.h"
+
+namespace Library
+{
+	class Camera;
+	class PointLight;
+
+	// Clustered forward lighting. The view frustum is split into screen tiles and exponential depth slices
+	// (froxels); every frame each registered point or spot light is assigned to the froxels its sphere
+	// touches, and the lights, per-cluster ranges and index lists are uploaded as shader storage buffers.
+	// Shaders built with ShaderPermutationClusteredLights find their cluster from gl_FragCoord and view depth
+	// and only loop over that cluster's lights, so shading cost tracks local light density, not light count.
+	class ClusteredLighting : public RTTI
+	{
+		RTTI_DECLARATIONS(ClusteredLighting, RTTI)
+
+	public:
+		ClusteredLighting();
+		~ClusteredLighting();
+
+		static ClusteredLighting* Instance();
+
+		void AddLight(const PointLight& light);
+		void RemoveLight(const PointLight& light);
+		void ClearLights();
+
+		UINT LightCount() const;
+		UINT VisibleLightCount() const;
+		UINT LightIndexCount() const;
+		UINT ClusterCount() const;
+
+		// Light-cluster pairs the last assignment dropped because the cluster already held MaxLightsPerCluster lights
+		UINT OverflowLightCount() const;
+
+		// CPU-side results of the last assignment, indexed x + ClusterCountX * (y + ClusterCountY * z)
+		const BoundingBox& ClusterBounds(UINT cluster) const;
+		const std::vector<UINT>& ClusterLights(UINT cluster) const;
+		UINT ClusterIndex(const glm::vec2& windowPosition, float depth) const;
+
+		void Update(const Camera& camera, UINT viewportWidth, UINT viewportHeight);
+		void AssignLights(const glm::mat4& view, const glm::mat4& projection, float nearDepth, float farDepth, UINT viewportWidth, UINT viewportHeight);
+
+		// Must match the binding qualifiers in Content/Effects/ClusteredLighting.glsl
+		static const GLuint LightBinding;
+		static const GLuint ClusterBinding;
+		static const GLuint LightIndexBinding;
+
+		static const UINT ClusterCountX;
+		static const UINT ClusterCountY;
+		static const UINT ClusterCountZ;
+		static const UINT MaxLightsPerCluster;
+		static const float FirstSliceDepth;
+
+	private:
+		ClusteredLighting(const ClusteredLighting& rhs);
+		ClusteredLighting& operator=(const ClusteredLighting& rhs);
+
+		// std430 layouts
+		struct LightData
+		{
+			glm::vec4 Position;
+			glm::vec4 Color;
+			glm::vec4 Direction;
+			glm::vec4 Parameters;
+		};
+
+		struct ClusterHeader
+		{
+			glm::vec4 Scale;
+			glm::vec4 Bias;
+			glm::uvec4 Dimensions;
+		};
+
+		struct LightBounds
+		{
+			glm::vec3 Center;
+			float Radius;
+			UINT FirstSlice;
+			UINT LastSlice;
+		};
+
+		void UpdateClusterBounds(const glm::mat4& projection, float nearDepth, float farDepth, UINT viewportWidth, UINT viewportHeight);
+		void GatherLights(const glm::mat4& view, float nearDepth, float farDepth);
+		void AssignSlice(UINT slice);
+		void PackClusters();
+		void Upload();
+
+		UINT SliceIndex(float depth) const;
+
+		std::vector<const PointLight*> mLights;
+		std::vector<LightData> mLightData;
+		std::vector<LightBounds> mLightBounds;
+		std::vector<BoundingBox> mClusterBounds;
+		std::vector<std::vector<UINT>> mClusterLights;
+		std::vector<UINT> mSliceOverflowCounts;
+		std::vector<glm::uvec2> mClusters;
+		std::vector<UINT> mLightIndices;
+		ClusterHeader mHeader;
+		glm::mat4 mProjection;
+		float mNearDepth;
+		float mFarDepth;
+		UINT mViewportWidth;
+		UINT mViewportHeight;
+		float mSliceScale;
+		float mSliceBias;
+		UINT mOverflowLightCount;
+		GLuint mLightBuffer;
+		GLuint mClusterBuffer;
+		GLuint mLightIndexBuffer;
+	};
+}
\ No newline at end of file
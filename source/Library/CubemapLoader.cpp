@@ -0,0 +1,317 @@
+#include "CubemapLoader.h"
+#include "ExtensionHelper.h"
+#include "VirtualFileSystem.h"
+#include "GameException.h"
+#include "SOIL.h"
+#include <future>
+#include <algorithm>
+#include <sstream>
+#include <cstdlib>
+#include <cstring>
+
+// Exported by SOIL.lib (image_DXT.h and image_helper.h) but not declared in SOIL.h
+extern "C"
+{
+	unsigned char* convert_image_to_DXT1(const unsigned char *const uncompressed, int width, int height, int channels, int *out_size);
+	unsigned char* convert_image_to_DXT5(const unsigned char *const uncompressed, int width, int height, int channels, int *out_size);
+	int scale_image_RGB_to_NTSC_safe(unsigned char* orig, int width, int height, int channels);
+	int up_scale_image(const unsigned char* const orig, int width, int height, int channels, unsigned char* resampled, int resampled_width, int resampled_height);
+	int mipmap_image(const unsigned char* const orig, int width, int height, int channels, unsigned char* resampled, int block_size_x, int block_size_y);
+}
+
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT		0x83F0
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT	0x83F3
+
+namespace Library
+{
+	const UINT CubemapLoader::FaceCount = 6;
+	const UINT CubemapLoader::UnsupportedFlags = SOIL_FLAG_DDS_LOAD_DIRECT | SOIL_FLAG_CoCg_Y | SOIL_FLAG_TEXTURE_RECTANGLE;
+	std::mutex CubemapLoader::sDecodeMutex;
+
+	CubemapLoader::CubemapFace::CubemapFace()
+		: Levels(), Width(0), Height(0), Channels(0), Error()
+	{
+	}
+
+	CubemapLoader::CubemapFace::~CubemapFace()
+	{
+		for (CubemapLevel& level : Levels)
+		{
+			SOIL_free_image_data(level.Data);
+		}
+	}
+
+	GLuint CubemapLoader::LoadCubemap(const std::string& posXFilename, const std::string& negXFilename, const std::string& posYFilename, const std::string& negYFilename, const std::string& posZFilename, const std::string& negZFilename, UINT flags)
+	{
+		if ((flags & UnsupportedFlags) != 0)
+		{
+			throw GameException("CubemapLoader::LoadCubemap() SOIL_FLAG_DDS_LOAD_DIRECT, SOIL_FLAG_CoCg_Y and SOIL_FLAG_TEXTURE_RECTANGLE are not supported.");
+		}
+
+		const std::string* filenames[] = { &posXFilename, &negXFilename, &posYFilename, &negYFilename, &posZFilename, &negZFilename };
+		CubemapFace faces[FaceCount];
+
+		// Query the GL on the context thread; the workers never touch the GL
+		bool compressToDXT = ((flags & SOIL_FLAG_COMPRESS_TO_DXT) != 0) && ExtensionHelper::IsSupported("GL_EXT_texture_compression_s3tc");
+		GLint maxSize;
+		glGetIntegerv(GL_MAX_CUBE_MAP_TEXTURE_SIZE, &maxSize);
+
+		// Decode and compress every face concurrently
+		std::vector<std::future<void>> decodeTasks;
+		decodeTasks.reserve(FaceCount);
+		for (UINT i = 0; i < FaceCount; i++)
+		{
+			decodeTasks.push_back(std::async(std::launch::async, &CubemapLoader::DecodeFace, std::cref(*filenames[i]), flags, compressToDXT, maxSize, std::ref(faces[i])));
+		}
+
+		for (std::future<void>& decodeTask : decodeTasks)
+		{
+			decodeTask.get();
+		}
+
+		for (UINT i = 0; i < FaceCount; i++)
+		{
+			if (faces[i].Levels.empty())
+			{
+				std::stringstream errorMessage;
+				errorMessage << "CubemapLoader::LoadCubemap() failed to load " << *filenames[i] << ".\n" << faces[i].Error;
+
+				throw GameException(errorMessage.str().c_str());
+			}
+
+			if (faces[i].Width != faces[0].Width || faces[i].Height != faces[0].Height)
+			{
+				throw GameException("CubemapLoader::LoadCubemap() cubemap faces must share the same dimensions.");
+			}
+
+			// The luminance swizzle below is per texture, so grey faces can't be mixed with colour ones
+			if (faces[i].Channels != faces[0].Channels && (faces[i].Channels < 3 || faces[0].Channels < 3))
+			{
+				throw GameException("CubemapLoader::LoadCubemap() greyscale cubemap faces must share the same channel count.");
+			}
+		}
+
+		// Upload on the context thread
+		GLuint texture;
+		glGenTextures(1, &texture);
+		glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+
+		for (UINT i = 0; i < FaceCount; i++)
+		{
+			UploadFace(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, faces[i]);
+		}
+
+		// Core profiles have no luminance formats; swizzle grey faces to sample the way SOIL's GL_LUMINANCE(_ALPHA) uploads do.
+		// DXT1 replicates grey into RGB, so the grey swizzle suits compressed levels too, but DXT5 grey-alpha needs none.
+		if (faces[0].Channels == 1)
+		{
+			GLint swizzle[] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+			glTexParameteriv(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+		}
+		else if (faces[0].Channels == 2)
+		{
+			bool compressed = faces[0].Levels[0].Compressed;
+			for (const CubemapFace& face : faces)
+			{
+				for (const CubemapLevel& level : face.Levels)
+				{
+					if (level.Compressed != compressed)
+					{
+						glDeleteTextures(1, &texture);
+						throw GameException("CubemapLoader::LoadCubemap() grey-alpha cubemap faces must all compress or all stay uncompressed.");
+					}
+				}
+			}
+
+			if (compressed == false)
+			{
+				GLint swizzle[] = { GL_RED, GL_RED, GL_RED, GL_GREEN };
+				glTexParameteriv(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+			}
+		}
+
+		// Match the texture state SOIL_load_OGL_cubemap() leaves behind
+		GLint wrapMode = ((flags & SOIL_FLAG_TEXTURE_REPEATS) != 0 ? GL_REPEAT : GL_CLAMP_TO_EDGE);
+		GLint minFilter = ((flags & SOIL_FLAG_MIPMAPS) != 0 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, minFilter);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, wrapMode);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, wrapMode);
+		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, wrapMode);
+
+		glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+		return texture;
+	}
+
+	void CubemapLoader::DecodeFace(const std::string& filename, UINT flags, bool compressToDXT, int maxSize, CubemapFace& face)
+	{
+		FileView file;
+		try
+		{
+			file = VirtualFileSystem::Instance().OpenFile(filename);
+		}
+		catch (GameException& ex)
+		{
+			face.Error = ex.what();
+			return;
+		}
+
+		int width;
+		int height;
+		int channels;
+		unsigned char* image;
+
+		{
+			// SOIL and stb_image record every call's result in process-wide globals, so decoding is serialized;
+			// the processing and DXT compression below still run concurrently
+			std::lock_guard<std::mutex> lock(sDecodeMutex);
+
+			image = SOIL_load_image_from_memory(reinterpret_cast<const unsigned char*>(file.Data()), static_cast<int>(file.Size()), &width, &height, &channels, SOIL_LOAD_AUTO);
+			if (image == nullptr)
+			{
+				face.Error = SOIL_last_result();
+				return;
+			}
+		}
+
+		// The same steps, in the same order, as SOIL_internal_create_OGL_texture()
+		if ((flags & SOIL_FLAG_INVERT_Y) != 0)
+		{
+			int rowSize = width * channels;
+			for (int top = 0, bottom = height - 1; top < bottom; top++, bottom--)
+			{
+				std::swap_ranges(image + top * rowSize, image + (top + 1) * rowSize, image + bottom * rowSize);
+			}
+		}
+
+		if ((flags & SOIL_FLAG_NTSC_SAFE_RGB) != 0)
+		{
+			scale_image_RGB_to_NTSC_safe(image, width, height, channels);
+		}
+
+		if ((flags & SOIL_FLAG_MULTIPLY_ALPHA) != 0 && (channels == 2 || channels == 4))
+		{
+			int alphaOffset = channels - 1;
+			for (int i = 0; i < width * height * channels; i += channels)
+			{
+				for (int j = 0; j < alphaOffset; j++)
+				{
+					image[i + j] = static_cast<unsigned char>((image[i + j] * image[i + alphaOffset] + 128) >> 8);
+				}
+			}
+		}
+
+		if ((flags & (SOIL_FLAG_POWER_OF_TWO | SOIL_FLAG_MIPMAPS)) != 0 || width > maxSize || height > maxSize)
+		{
+			int powerOfTwoWidth = 1;
+			int powerOfTwoHeight = 1;
+			while (powerOfTwoWidth < width)
+			{
+				powerOfTwoWidth *= 2;
+			}
+
+			while (powerOfTwoHeight < height)
+			{
+				powerOfTwoHeight *= 2;
+			}
+
+			if (powerOfTwoWidth != width || powerOfTwoHeight != height)
+			{
+				unsigned char* resampled = static_cast<unsigned char*>(malloc(channels * powerOfTwoWidth * powerOfTwoHeight));
+				up_scale_image(image, width, height, channels, resampled, powerOfTwoWidth, powerOfTwoHeight);
+				SOIL_free_image_data(image);
+
+				image = resampled;
+				width = powerOfTwoWidth;
+				height = powerOfTwoHeight;
+			}
+		}
+
+		if (width > maxSize || height > maxSize)
+		{
+			// Already a power of two, so a box filter reduces it to the largest size the GL accepts
+			int blockWidth = std::max<int>(width / maxSize, 1);
+			int blockHeight = std::max<int>(height / maxSize, 1);
+			int reducedWidth = width / blockWidth;
+			int reducedHeight = height / blockHeight;
+
+			unsigned char* resampled = static_cast<unsigned char*>(malloc(channels * reducedWidth * reducedHeight));
+			mipmap_image(image, width, height, channels, resampled, blockWidth, blockHeight);
+			SOIL_free_image_data(image);
+
+			image = resampled;
+			width = reducedWidth;
+			height = reducedHeight;
+		}
+
+		face.Width = width;
+		face.Height = height;
+		face.Channels = channels;
+
+		CubemapLevel baseLevel = { image, width * height * channels, width, height, false };
+		face.Levels.push_back(baseLevel);
+
+		if ((flags & SOIL_FLAG_MIPMAPS) != 0)
+		{
+			// Like SOIL, every level is box-filtered straight from the base image
+			int mipWidth = (width + 1) / 2;
+			int mipHeight = (height + 1) / 2;
+			for (int mipLevel = 1; (1 << mipLevel) <= width || (1 << mipLevel) <= height; mipLevel++)
+			{
+				unsigned char* resampled = static_cast<unsigned char*>(malloc(channels * mipWidth * mipHeight));
+				mipmap_image(image, width, height, channels, resampled, 1 << mipLevel, 1 << mipLevel);
+
+				CubemapLevel level = { resampled, mipWidth * mipHeight * channels, mipWidth, mipHeight, false };
+				face.Levels.push_back(level);
+
+				mipWidth = (mipWidth + 1) / 2;
+				mipHeight = (mipHeight + 1) / 2;
+			}
+		}
+
+		if (compressToDXT)
+		{
+			// Same selection as SOIL: DXT1 for opaque images, DXT5 when there is an alpha channel
+			for (CubemapLevel& level : face.Levels)
+			{
+				int compressedSize = 0;
+				unsigned char* compressedImage = ((channels == 1 || channels == 3) ?
+					convert_image_to_DXT1(level.Data, level.Width, level.Height, channels, &compressedSize) :
+					convert_image_to_DXT5(level.Data, level.Width, level.Height, channels, &compressedSize));
+
+				if (compressedImage != nullptr)
+				{
+					SOIL_free_image_data(level.Data);
+					level.Data = compressedImage;
+					level.DataSize = compressedSize;
+					level.Compressed = true;
+				}
+			}
+		}
+	}
+
+	void CubemapLoader::UploadFace(GLenum target, const CubemapFace& face)
+	{
+		static const GLenum formats[] = { GL_RED, GL_RED, GL_RG, GL_RGB, GL_RGBA };
+		GLenum format = formats[face.Channels];
+		GLenum compressedFormat = ((face.Channels == 1 || face.Channels == 3) ? GL_COMPRESSED_RGB_S3TC_DXT1_EXT : GL_COMPRESSED_RGBA_S3TC_DXT5_EXT);
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+		for (UINT i = 0; i < face.Levels.size(); i++)
+		{
+			const CubemapLevel& level = face.Levels[i];
+			if (level.Compressed)
+			{
+				glCompressedTexImage2D(target, i, compressedFormat, level.Width, level.Height, 0, level.DataSize, level.Data);
+			}
+			else
+			{
+				glTexImage2D(target, i, format, level.Width, level.Height, 0, format, GL_UNSIGNED_BYTE, level.Data);
+			}
+		}
+
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+	}
+}
\ No newline at end of file
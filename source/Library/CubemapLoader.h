@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Common.h"
+#include <mutex>
+
+namespace Library
+{
+	class CubemapLoader
+	{
+	public:
+		static GLuint LoadCubemap(const std::string& posXFilename, const std::string& negXFilename, const std::string& posYFilename, const std::string& negYFilename, const std::string& posZFilename, const std::string& negZFilename, UINT flags);
+
+		static const UINT UnsupportedFlags;
+
+	private:
+		struct CubemapLevel
+		{
+			unsigned char* Data;
+			int DataSize;
+			int Width;
+			int Height;
+			bool Compressed;
+		};
+
+		struct CubemapFace
+		{
+			CubemapFace();
+			~CubemapFace();
+
+			std::vector<CubemapLevel> Levels;
+			int Width;
+			int Height;
+			int Channels;
+			std::string Error;
+		};
+
+		static void DecodeFace(const std::string& filename, UINT flags, bool compressToDXT, int maxSize, CubemapFace& face);
+		static void UploadFace(GLenum target, const CubemapFace& face);
+
+		static const UINT FaceCount;
+		static std::mutex sDecodeMutex;
+
+		CubemapLoader();
+		CubemapLoader(const CubemapLoader& rhs);
+		CubemapLoader& operator=(const CubemapLoader& rhs);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include "DeferredLightingEffect.h"
+#include "GameException.h"
+#include "Mesh.h"
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(DeferredLightingEffect)
+
+	DeferredLightingEffect::DeferredLightingEffect()
+		: ShaderProgram(),
+		  SHADER_VARIABLE_INITIALIZATION(InverseViewProjection), SHADER_VARIABLE_INITIALIZATION(SpecularColor), SHADER_VARIABLE_INITIALIZATION(SpecularPower)
+	{
+	}
+
+	SHADER_VARIABLE_DEFINITION(DeferredLightingEffect, InverseViewProjection)
+	SHADER_VARIABLE_DEFINITION(DeferredLightingEffect, SpecularColor)
+	SHADER_VARIABLE_DEFINITION(DeferredLightingEffect, SpecularPower)
+
+	void DeferredLightingEffect::Initialize(GLuint vertexArrayObject)
+	{
+		ShaderProgram::Initialize(vertexArrayObject);
+
+		SHADER_VARIABLE_INSTANTIATE(InverseViewProjection)
+		SHADER_VARIABLE_INSTANTIATE(SpecularColor)
+		SHADER_VARIABLE_INSTANTIATE(SpecularPower)
+
+		glVertexAttribPointer(VertexAttributePosition, 4, GL_FLOAT, GL_FALSE, sizeof(VertexPosition), (void*)offsetof(VertexPosition, Position));
+		glEnableVertexAttribArray(VertexAttributePosition);
+	}
+
+	void DeferredLightingEffect::CreateVertexBuffer(const Mesh& mesh, GLuint& vertexBuffer) const
+	{
+		const std::vector<vec3>& sourceVertices = mesh.Vertices();
+
+		std::vector<VertexPosition> vertices;
+		vertices.reserve(sourceVertices.size());
+		for (const vec3& position : sourceVertices)
+		{
+			vertices.push_back(VertexPosition(vec4(position, 1.0f)));
+		}
+
+		CreateVertexBuffer(&vertices[0], vertices.size(), vertexBuffer);
+	}
+
+	void DeferredLightingEffect::CreateVertexBuffer(const VertexPosition* vertices, UINT vertexCount, GLuint& vertexBuffer) const
+	{
+		glGenBuffers(1, &vertexBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, VertexSize() * vertexCount, &vertices[0], GL_STATIC_DRAW);
+	}
+
+	UINT DeferredLightingEffect::VertexSize() const
+	{
+		return sizeof(VertexPosition);
+	}
+}
\ No newline at end of file
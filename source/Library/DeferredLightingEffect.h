@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Common.h"
+#include "ShaderProgram.h"
+#include "VertexDeclarations.h"
+
+namespace Library
+{
+	// Shared by every deferred lighting pass; variables a pass does not declare are skipped when staged
+	class DeferredLightingEffect : public ShaderProgram
+	{
+		RTTI_DECLARATIONS(DeferredLightingEffect, ShaderProgram)
+
+		SHADER_VARIABLE_DECLARATION(InverseViewProjection)
+		SHADER_VARIABLE_DECLARATION(SpecularColor)
+		SHADER_VARIABLE_DECLARATION(SpecularPower)
+
+	public:
+		DeferredLightingEffect();
+
+		virtual void Initialize(GLuint vertexArrayObject) override;
+		virtual void CreateVertexBuffer(const Mesh& mesh, GLuint& vertexBuffer) const override;
+		void CreateVertexBuffer(const VertexPosition* vertices, UINT vertexCount, GLuint& vertexBuffer) const;
+		virtual UINT VertexSize() const override;
+
+	private:
+		DeferredLightingEffect(const DeferredLightingEffect& rhs);
+		DeferredLightingEffect& operator=(const DeferredLightingEffect& rhs);
+
+		enum VertexAttribute
+		{
+			VertexAttributePosition = 0
+		};
+	};
+}
\ No newline at end of file
@@ -0,0 +1,453 @@
+#include "DeferredRenderer.h"
+#include "Camera.h"
+#include "ColorHelper.h"
+#include "GameException.h"
+#include "RenderStateCache.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(DeferredRenderer)
+
+	const GLuint DeferredRenderer::AlbedoTextureUnit = 0;
+	const GLuint DeferredRenderer::NormalTextureUnit = 1;
+	const GLuint DeferredRenderer::DepthTextureUnit = 2;
+	const GLuint DeferredRenderer::LightingTextureUnit = 3;
+
+	// One subdivision of an icosahedron (80 faces) hugs the sphere closely enough that the enlarged volume
+	// covers few pixels the light cannot reach
+	const UINT DeferredRenderer::VolumeSubdivisions = 1;
+
+	DeferredRenderer::DeferredRenderer()
+		: mEnabled(false), mIsInitialized(false), mWidth(0), mHeight(0), mGeometryFramebuffer(0), mLightingFramebuffer(0),
+		  mAlbedoTexture(0), mNormalTexture(0), mDepthTexture(0), mLightingTexture(0), mLightingDepthBuffer(0),
+		  mSceneLightEffect(), mStencilEffect(), mLightVolumeEffect(), mCompositeEffect(),
+		  mVolumeVertexArray(0), mVolumeVertexBuffer(0), mVolumeIndexBuffer(0), mVolumeIndexCount(0),
+		  mSpecularColor(ColorHelper::White), mSpecularPower(25.0f), mLightVolumeCount(0)
+	{
+	}
+
+	DeferredRenderer::~DeferredRenderer()
+	{
+		DeleteTargets();
+
+		glDeleteBuffers(1, &mVolumeIndexBuffer);
+		glDeleteBuffers(1, &mVolumeVertexBuffer);
+		glDeleteVertexArrays(1, &mVolumeVertexArray);
+	}
+
+	DeferredRenderer* DeferredRenderer::Instance()
+	{
+		return static_cast<DeferredRenderer*>(GlobalServices.GetService(DeferredRenderer::TypeIdClass()));
+	}
+
+	bool DeferredRenderer::Enabled() const
+	{
+		return mEnabled;
+	}
+
+	void DeferredRenderer::SetEnabled(bool enabled)
+	{
+		mEnabled = enabled;
+	}
+
+	vec4& DeferredRenderer::SpecularColor()
+	{
+		return mSpecularColor;
+	}
+
+	float& DeferredRenderer::SpecularPower()
+	{
+		return mSpecularPower;
+	}
+
+	GLuint DeferredRenderer::AlbedoTexture() const
+	{
+		return mAlbedoTexture;
+	}
+
+	GLuint DeferredRenderer::NormalTexture() const
+	{
+		return mNormalTexture;
+	}
+
+	GLuint DeferredRenderer::DepthTexture() const
+	{
+		return mDepthTexture;
+	}
+
+	GLuint DeferredRenderer::LightingTexture() const
+	{
+		return mLightingTexture;
+	}
+
+	UINT DeferredRenderer::LightVolumeCount() const
+	{
+		return mLightVolumeCount;
+	}
+
+	void DeferredRenderer::BeginGeometryPass(UINT width, UINT height)
+	{
+		// Built on first use, so games that stay forward never compile the lighting programs
+		if (mIsInitialized == false)
+		{
+			Initialize();
+		}
+
+		if (width != mWidth || height != mHeight)
+		{
+			CreateTargets(width, height);
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, mGeometryFramebuffer);
+
+		// Clears honor the depth write mask
+		RenderStateCache& renderStates = *RenderStateCache::Instance();
+		renderStates.SetDepthTestEnabled(true);
+		renderStates.SetDepthWriteEnabled(true);
+		renderStates.SetDepthFunction(GL_LEQUAL);
+
+		const vec4 clearColor(0.0f);
+		glClearBufferfv(GL_COLOR, 0, &clearColor[0]);
+		glClearBufferfv(GL_COLOR, 1, &clearColor[0]);
+		glClearBufferfi(GL_DEPTH_STENCIL, 0, 1.0f, 0);
+	}
+
+	void DeferredRenderer::Resolve(const Camera& camera, UINT lightCount)
+	{
+		if (mIsInitialized == false)
+		{
+			throw GameException("DeferredRenderer::Resolve() called before BeginGeometryPass().");
+		}
+
+		mat4 inverseViewProjection = inverse(camera.ViewProjectionMatrix());
+
+		// The lighting passes depth-test against a copy, so they can sample the G-buffer depth without a feedback loop
+		glBindFramebuffer(GL_READ_FRAMEBUFFER, mGeometryFramebuffer);
+		glBindFramebuffer(GL_DRAW_FRAMEBUFFER, mLightingFramebuffer);
+		glBlitFramebuffer(0, 0, mWidth, mHeight, 0, 0, mWidth, mHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+		glBindFramebuffer(GL_FRAMEBUFFER, mLightingFramebuffer);
+
+		const vec4 clearColor(0.0f);
+		const GLint clearStencil = 0;
+		glClearBufferfv(GL_COLOR, 0, &clearColor[0]);
+		glClearBufferiv(GL_STENCIL, 0, &clearStencil);
+
+		// The fullscreen passes ignore the vertex attribute, so every pass shares the volume's vertex array
+		RenderStateCache& renderStates = *RenderStateCache::Instance();
+		renderStates.BindVertexArray(mVolumeVertexArray);
+
+		const GLenum targets[] = { GL_TEXTURE_2D, GL_TEXTURE_2D, GL_TEXTURE_2D };
+		const GLuint textures[] = { mAlbedoTexture, mNormalTexture, mDepthTexture };
+		renderStates.BindSamplers(AlbedoTextureUnit, 3, nullptr);
+		renderStates.BindTextures(AlbedoTextureUnit, 3, targets, textures);
+
+		DrawSceneLight(inverseViewProjection);
+
+		mLightVolumeCount = lightCount;
+		if (lightCount > 0)
+		{
+			DrawLightVolumes(inverseViewProjection, lightCount);
+		}
+
+		Composite();
+	}
+
+	void DeferredRenderer::Initialize()
+	{
+		// The volume's buffers are captured by its vertex array, so it is bound before they are created
+		glGenVertexArrays(1, &mVolumeVertexArray);
+		glBindVertexArray(mVolumeVertexArray);
+		CreateLightVolume();
+
+		std::vector<ShaderDefinition> sceneLightShaders;
+		sceneLightShaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content/Effects/DeferredFullscreen.vert"));
+		sceneLightShaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content/Effects/DeferredSceneLight.frag"));
+
+		// Stencil marking writes no color, so that program has no fragment stage
+		std::vector<ShaderDefinition> stencilShaders;
+		stencilShaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content/Effects/DeferredLightVolume.vert"));
+
+		std::vector<ShaderDefinition> lightVolumeShaders;
+		lightVolumeShaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content/Effects/DeferredLightVolume.vert"));
+		lightVolumeShaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content/Effects/DeferredLightVolume.frag"));
+
+		std::vector<ShaderDefinition> compositeShaders;
+		compositeShaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content/Effects/DeferredFullscreen.vert"));
+		compositeShaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content/Effects/DeferredComposite.frag"));
+
+		std::vector<ShaderProgramBuild> builds;
+		builds.push_back(ShaderProgramBuild(&mSceneLightEffect, sceneLightShaders));
+		builds.push_back(ShaderProgramBuild(&mStencilEffect, stencilShaders));
+		builds.push_back(ShaderProgramBuild(&mLightVolumeEffect, lightVolumeShaders));
+		builds.push_back(ShaderProgramBuild(&mCompositeEffect, compositeShaders));
+		ShaderProgram::BuildPrograms(builds);
+
+		mSceneLightEffect.Initialize(mVolumeVertexArray);
+		mStencilEffect.Initialize(mVolumeVertexArray);
+		mLightVolumeEffect.Initialize(mVolumeVertexArray);
+		mCompositeEffect.Initialize(mVolumeVertexArray);
+		glBindVertexArray(0);
+
+		// Direct binds above bypass the cache
+		RenderStateCache::Instance()->Invalidate();
+
+		mIsInitialized = true;
+	}
+
+	void DeferredRenderer::CreateLightVolume()
+	{
+		// Icosahedron, wound counter-clockwise seen from outside
+		const float t = (1.0f + sqrt(5.0f)) / 2.0f;
+		std::vector<vec3> positions;
+		positions.push_back(vec3(-1.0f, t, 0.0f));
+		positions.push_back(vec3(1.0f, t, 0.0f));
+		positions.push_back(vec3(-1.0f, -t, 0.0f));
+		positions.push_back(vec3(1.0f, -t, 0.0f));
+		positions.push_back(vec3(0.0f, -1.0f, t));
+		positions.push_back(vec3(0.0f, 1.0f, t));
+		positions.push_back(vec3(0.0f, -1.0f, -t));
+		positions.push_back(vec3(0.0f, 1.0f, -t));
+		positions.push_back(vec3(t, 0.0f, -1.0f));
+		positions.push_back(vec3(t, 0.0f, 1.0f));
+		positions.push_back(vec3(-t, 0.0f, -1.0f));
+		positions.push_back(vec3(-t, 0.0f, 1.0f));
+
+		static const UINT faces[] =
+		{
+			0, 11, 5,	0, 5, 1,	0, 1, 7,	0, 7, 10,	0, 10, 11,
+			1, 5, 9,	5, 11, 4,	11, 10, 2,	10, 7, 6,	7, 1, 8,
+			3, 9, 4,	3, 4, 2,	3, 2, 6,	3, 6, 8,	3, 8, 9,
+			4, 9, 5,	2, 4, 11,	6, 2, 10,	8, 6, 7,	9, 8, 1
+		};
+
+		for (vec3& position : positions)
+		{
+			position = normalize(position);
+		}
+
+		std::vector<UINT> indices(faces, faces + sizeof(faces) / sizeof(faces[0]));
+		for (UINT subdivision = 0; subdivision < VolumeSubdivisions; subdivision++)
+		{
+			// Shared edges get one midpoint, so the volume stays closed for the stencil count
+			std::map<std::pair<UINT, UINT>, UINT> midpoints;
+			auto midpoint = [&positions, &midpoints](UINT first, UINT second)
+			{
+				std::pair<UINT, UINT> edge(std::min<UINT>(first, second), std::max<UINT>(first, second));
+				auto it = midpoints.find(edge);
+				if (it == midpoints.end())
+				{
+					positions.push_back(normalize(positions[first] + positions[second]));
+					it = midpoints.insert(std::pair<std::pair<UINT, UINT>, UINT>(edge, positions.size() - 1)).first;
+				}
+
+				return it->second;
+			};
+
+			std::vector<UINT> subdividedIndices;
+			subdividedIndices.reserve(indices.size() * 4);
+			for (UINT i = 0; i < indices.size(); i += 3)
+			{
+				UINT a = indices[i];
+				UINT b = indices[i + 1];
+				UINT c = indices[i + 2];
+				UINT ab = midpoint(a, b);
+				UINT bc = midpoint(b, c);
+				UINT ca = midpoint(c, a);
+
+				UINT triangles[] = { a, ab, ca,	b, bc, ab,	c, ca, bc,	ab, bc, ca };
+				subdividedIndices.insert(subdividedIndices.end(), triangles, triangles + 12);
+			}
+
+			indices.swap(subdividedIndices);
+		}
+
+		// The vertices sit on the unit sphere but the faces cut inside it; pushing the nearest face plane out to
+		// radius one makes the volume enclose the whole sphere
+		float inradius = 1.0f;
+		for (UINT i = 0; i < indices.size(); i += 3)
+		{
+			const vec3& a = positions[indices[i]];
+			vec3 normal = normalize(cross(positions[indices[i + 1]] - a, positions[indices[i + 2]] - a));
+			inradius = std::min<float>(inradius, dot(normal, a));
+		}
+
+		std::vector<VertexPosition> vertices;
+		vertices.reserve(positions.size());
+		for (const vec3& position : positions)
+		{
+			vertices.push_back(VertexPosition(vec4(position / inradius, 1.0f)));
+		}
+
+		mLightVolumeEffect.CreateVertexBuffer(&vertices[0], vertices.size(), mVolumeVertexBuffer);
+
+		glGenBuffers(1, &mVolumeIndexBuffer);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mVolumeIndexBuffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(UINT) * indices.size(), &indices[0], GL_STATIC_DRAW);
+		mVolumeIndexCount = indices.size();
+	}
+
+	void DeferredRenderer::CreateTargets(UINT width, UINT height)
+	{
+		DeleteTargets();
+
+		mWidth = width;
+		mHeight = height;
+
+		mAlbedoTexture = CreateTarget(GL_RGBA8, width, height);
+		mNormalTexture = CreateTarget(GL_RG16_SNORM, width, height);
+		mDepthTexture = CreateTarget(GL_DEPTH24_STENCIL8, width, height);
+		mLightingTexture = CreateTarget(GL_RGBA16F, width, height);
+
+		glGenRenderbuffers(1, &mLightingDepthBuffer);
+		glBindRenderbuffer(GL_RENDERBUFFER, mLightingDepthBuffer);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+
+		const GLenum drawBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+
+		glGenFramebuffers(1, &mGeometryFramebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, mGeometryFramebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mAlbedoTexture, 0);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, mNormalTexture, 0);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_TEXTURE_2D, mDepthTexture, 0);
+		glDrawBuffers(2, drawBuffers);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			throw GameException("DeferredRenderer::CreateTargets() G-buffer framebuffer is incomplete.");
+		}
+
+		glGenFramebuffers(1, &mLightingFramebuffer);
+		glBindFramebuffer(GL_FRAMEBUFFER, mLightingFramebuffer);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, mLightingTexture, 0);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, mLightingDepthBuffer);
+		glDrawBuffers(1, drawBuffers);
+		if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+		{
+			throw GameException("DeferredRenderer::CreateTargets() lighting framebuffer is incomplete.");
+		}
+
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
+	void DeferredRenderer::DeleteTargets()
+	{
+		glDeleteFramebuffers(1, &mLightingFramebuffer);
+		glDeleteFramebuffers(1, &mGeometryFramebuffer);
+		glDeleteRenderbuffers(1, &mLightingDepthBuffer);
+		glDeleteTextures(1, &mLightingTexture);
+		glDeleteTextures(1, &mDepthTexture);
+		glDeleteTextures(1, &mNormalTexture);
+		glDeleteTextures(1, &mAlbedoTexture);
+
+		mLightingFramebuffer = 0;
+		mGeometryFramebuffer = 0;
+		mLightingDepthBuffer = 0;
+		mLightingTexture = 0;
+		mDepthTexture = 0;
+		mNormalTexture = 0;
+		mAlbedoTexture = 0;
+		mWidth = 0;
+		mHeight = 0;
+	}
+
+	void DeferredRenderer::DrawSceneLight(const mat4& inverseViewProjection)
+	{
+		// Writes every covered pixel, so it needs neither depth testing nor blending
+		RenderStateCache& renderStates = *RenderStateCache::Instance();
+		renderStates.SetDepthTestEnabled(false);
+		renderStates.SetBlendEnabled(false);
+		renderStates.SetCullingEnabled(false);
+
+		ApplyUniforms(mSceneLightEffect, inverseViewProjection);
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+	}
+
+	void DeferredRenderer::DrawLightVolumes(const mat4& inverseViewProjection, UINT lightCount)
+	{
+		RenderStateCache& renderStates = *RenderStateCache::Instance();
+		renderStates.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mVolumeIndexBuffer);
+
+		// Without clamping, volumes reaching past the far plane would lose their back faces
+		glEnable(GL_DEPTH_CLAMP);
+		glEnable(GL_STENCIL_TEST);
+
+		// Depth-fail counting over every volume at once: back faces behind the geometry increment and front faces
+		// behind it decrement, leaving a non-zero count only where the geometry is inside a volume, wherever the camera is
+		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		renderStates.SetDepthTestEnabled(true);
+		renderStates.SetDepthWriteEnabled(false);
+		renderStates.SetDepthFunction(GL_LESS);
+		renderStates.SetCullingEnabled(false);
+		renderStates.SetFrontFace(GL_CCW);
+		glStencilFunc(GL_ALWAYS, 0, 0xFF);
+		glStencilOpSeparate(GL_BACK, GL_KEEP, GL_INCR_WRAP, GL_KEEP);
+		glStencilOpSeparate(GL_FRONT, GL_KEEP, GL_DECR_WRAP, GL_KEEP);
+
+		ApplyUniforms(mStencilEffect, inverseViewProjection);
+		glDrawElementsInstanced(GL_TRIANGLES, mVolumeIndexCount, GL_UNSIGNED_INT, 0, lightCount);
+
+		// Back faces at or behind the geometry, on marked pixels only; each light's attenuation settles the rest
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		glStencilFunc(GL_NOTEQUAL, 0, 0xFF);
+		glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+		renderStates.SetDepthFunction(GL_GEQUAL);
+		renderStates.SetCullingEnabled(true);
+		renderStates.SetCullFace(GL_FRONT);
+		renderStates.SetBlendEnabled(true);
+		renderStates.SetBlendFunction(GL_ONE, GL_ONE);
+
+		ApplyUniforms(mLightVolumeEffect, inverseViewProjection);
+		glDrawElementsInstanced(GL_TRIANGLES, mVolumeIndexCount, GL_UNSIGNED_INT, 0, lightCount);
+
+		glDisable(GL_STENCIL_TEST);
+		glDisable(GL_DEPTH_CLAMP);
+		renderStates.SetCullFace(GL_BACK);
+		renderStates.SetBlendEnabled(false);
+	}
+
+	void DeferredRenderer::Composite()
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+		RenderStateCache& renderStates = *RenderStateCache::Instance();
+		renderStates.SetDepthTestEnabled(true);
+		renderStates.SetDepthWriteEnabled(true);
+		renderStates.SetDepthFunction(GL_LEQUAL);
+		renderStates.SetCullingEnabled(false);
+
+		const GLenum targets[] = { GL_TEXTURE_2D, GL_TEXTURE_2D };
+		const GLuint textures[] = { mDepthTexture, mLightingTexture };
+		renderStates.BindSamplers(DepthTextureUnit, 2, nullptr);
+		renderStates.BindTextures(DepthTextureUnit, 2, targets, textures);
+
+		mCompositeEffect.Use();
+		mCompositeEffect.CommitUniforms();
+		glDrawArrays(GL_TRIANGLES, 0, 3);
+	}
+
+	void DeferredRenderer::ApplyUniforms(DeferredLightingEffect& effect, const mat4& inverseViewProjection)
+	{
+		effect.Use();
+		effect.InverseViewProjection() << inverseViewProjection;
+		effect.SpecularColor() << mSpecularColor;
+		effect.SpecularPower() << mSpecularPower;
+		effect.CommitUniforms();
+	}
+
+	GLuint DeferredRenderer::CreateTarget(GLenum format, UINT width, UINT height)
+	{
+		GLuint texture;
+		glGenTextures(1, &texture);
+		RenderStateCache::Instance()->BindTexture(0, GL_TEXTURE_2D, texture);
+		glTexStorage2D(GL_TEXTURE_2D, 1, format, width, height);
+
+		// Passes read single texels; nearest filtering also keeps the one-level texture complete
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+		return texture;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "Common.h"
+#include "DeferredLightingEffect.h"
+
+namespace Library
+{
+	class Camera;
+
+	// Optional deferred shading for the render queue's deferred layer. Programs built with ShaderPermutationGBuffer
+	// write a compact G-buffer: albedo with the gloss map in alpha (RGBA8), an octahedral normal (RG16 snorm) and
+	// depth, from which world positions are reconstructed. Ambient light and the FrameConstants light are resolved in
+	// one fullscreen pass; every visible ClusteredLighting light is then drawn as an instanced sphere volume, and a
+	// stencil pass restricts those volumes to pixels whose geometry lies inside one, so each pixel is shaded only by
+	// the lights that reach it, however much the scene overdraws. The lit image is composited into the default
+	// framebuffer along with its depth, so the opaque and transparent layers and immediate-mode components draw
+	// forward on top.
+	class DeferredRenderer : public RTTI
+	{
+		RTTI_DECLARATIONS(DeferredRenderer, RTTI)
+
+	public:
+		DeferredRenderer();
+		~DeferredRenderer();
+
+		static DeferredRenderer* Instance();
+
+		bool Enabled() const;
+		void SetEnabled(bool enabled);
+		glm::vec4& SpecularColor();
+		float& SpecularPower();
+
+		GLuint AlbedoTexture() const;
+		GLuint NormalTexture() const;
+		GLuint DepthTexture() const;
+		GLuint LightingTexture() const;
+		UINT LightVolumeCount() const;
+
+		void BeginGeometryPass(UINT width, UINT height);
+		void Resolve(const Camera& camera, UINT lightCount);
+
+		// Must match the binding qualifiers in Content/Effects/DeferredLighting.glsl and DeferredComposite.frag
+		static const GLuint AlbedoTextureUnit;
+		static const GLuint NormalTextureUnit;
+		static const GLuint DepthTextureUnit;
+		static const GLuint LightingTextureUnit;
+
+		static const UINT VolumeSubdivisions;
+
+	private:
+		DeferredRenderer(const DeferredRenderer& rhs);
+		DeferredRenderer& operator=(const DeferredRenderer& rhs);
+
+		void Initialize();
+		void CreateLightVolume();
+		void CreateTargets(UINT width, UINT height);
+		void DeleteTargets();
+		void DrawSceneLight(const glm::mat4& inverseViewProjection);
+		void DrawLightVolumes(const glm::mat4& inverseViewProjection, UINT lightCount);
+		void Composite();
+		void ApplyUniforms(DeferredLightingEffect& effect, const glm::mat4& inverseViewProjection);
+
+		static GLuint CreateTarget(GLenum format, UINT width, UINT height);
+
+		bool mEnabled;
+		bool mIsInitialized;
+		UINT mWidth;
+		UINT mHeight;
+		GLuint mGeometryFramebuffer;
+		GLuint mLightingFramebuffer;
+		GLuint mAlbedoTexture;
+		GLuint mNormalTexture;
+		GLuint mDepthTexture;
+		GLuint mLightingTexture;
+		GLuint mLightingDepthBuffer;
+		DeferredLightingEffect mSceneLightEffect;
+		DeferredLightingEffect mStencilEffect;
+		DeferredLightingEffect mLightVolumeEffect;
+		DeferredLightingEffect mCompositeEffect;
+		GLuint mVolumeVertexArray;
+		GLuint mVolumeVertexBuffer;
+		GLuint mVolumeIndexBuffer;
+		UINT mVolumeIndexCount;
+		glm::vec4 mSpecularColor;
+		float mSpecularPower;
+		UINT mLightVolumeCount;
+	};
+}
\ No newline at end of file
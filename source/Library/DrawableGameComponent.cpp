@@ -1,26 +1,31 @@
 #include "DrawableGameComponent.h"
+#include "Game.h"
 
 namespace Library
 {
 	RTTI_DEFINITIONS(DrawableGameComponent)
 
 	DrawableGameComponent::DrawableGameComponent()
-		: GameComponent(), mVisible(true), mCamera(nullptr)
+		: GameComponent(), mVisible(true), mCamera(nullptr), mSpatialProxy(BoundingVolumeHierarchy::NullNode), mProgramsSubmitted(false)
 	{
 	}
 
 	DrawableGameComponent::DrawableGameComponent(Game& game)
-		: GameComponent(game), mVisible(true), mCamera(nullptr)
+		: GameComponent(game), mVisible(true), mCamera(nullptr), mSpatialProxy(BoundingVolumeHierarchy::NullNode), mProgramsSubmitted(false)
 	{
 	}
 
 	DrawableGameComponent::DrawableGameComponent(Game& game, Camera& camera)
-		: GameComponent(game), mVisible(true), mCamera(&camera)
+		: GameComponent(game), mVisible(true), mCamera(&camera), mSpatialProxy(BoundingVolumeHierarchy::NullNode), mProgramsSubmitted(false)
 	{
 	}
 
 	DrawableGameComponent::~DrawableGameComponent()
 	{
+		if (mSpatialProxy != BoundingVolumeHierarchy::NullNode)
+		{
+			mGame->SpatialIndex().Remove(mSpatialProxy);
+		}
 	}
 
 	bool DrawableGameComponent::Visible() const
@@ -43,6 +48,58 @@ namespace Library
 		mCamera = camera;
 	}
 
+	UINT DrawableGameComponent::SpatialProxy() const
+	{
+		return mSpatialProxy;
+	}
+
+	void DrawableGameComponent::SubmitPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		// Each component's programs are submitted once, either in Game's batch or from its own Initialize
+		if (mProgramsSubmitted == false)
+		{
+			CollectPrograms(builds);
+			mProgramsSubmitted = true;
+		}
+	}
+
+	void DrawableGameComponent::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+	}
+
+	void DrawableGameComponent::BuildPrograms()
+	{
+		// Components created after Game::Initialize's batch (a demo's proxy models, say) build their own here
+		std::vector<ShaderProgramBuild> builds;
+		SubmitPrograms(builds);
+		if (builds.size() > 0)
+		{
+			ShaderProgram::BuildPrograms(builds);
+		}
+	}
+
+	void DrawableGameComponent::UpdateSpatialProxy()
+	{
+		// Game inserts its bounded components on first sight; after that they refit their own leaf when they move
+		BoundingBox bounds;
+		if (mSpatialProxy != BoundingVolumeHierarchy::NullNode && WorldBounds(bounds))
+		{
+			mGame->SpatialIndex().Update(mSpatialProxy, bounds);
+		}
+	}
+
+	bool DrawableGameComponent::WorldBounds(BoundingBox& bounds) const
+	{
+		// Unbounded by default, which keeps a component out of frustum culling
+		return false;
+	}
+
+	bool DrawableGameComponent::Record(const GameTime& gameTime, RenderCommandList& commandList)
+	{
+		// Called on a worker thread; components that only know how to Draw are drawn on the GL thread instead
+		return false;
+	}
+
 	void DrawableGameComponent::Draw(const GameTime& gameTime)
 	{
 	}
@@ -2,15 +2,20 @@
 
 #include "Common.h"
 #include "GameComponent.h"
+#include "ShaderProgram.h"
 
 namespace Library
 {
 	class Camera;
+	class RenderCommandList;
+	struct BoundingBox;
 
 	class DrawableGameComponent : public GameComponent
 	{
 		RTTI_DECLARATIONS(DrawableGameComponent, GameComponent)
 
+		friend class Game;
+
 	public:
 		DrawableGameComponent();
 		DrawableGameComponent(Game& game);
@@ -23,14 +28,26 @@ namespace Library
 		Camera* GetCamera();
 		void SetCamera(Camera* camera);
 
+		UINT SpatialProxy() const;
+		void SubmitPrograms(std::vector<ShaderProgramBuild>& builds);
+
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds);
+		virtual bool WorldBounds(BoundingBox& bounds) const;
+		virtual bool Record(const GameTime& gameTime, RenderCommandList& commandList);
 		virtual void Draw(const GameTime& gameTime);
 
 	protected:
+		void BuildPrograms();
+		void UpdateSpatialProxy();
+
 		bool mVisible;
 		Camera* mCamera;
 
 	private:
 		DrawableGameComponent(const DrawableGameComponent& rhs);
 		DrawableGameComponent& operator=(const DrawableGameComponent& rhs);
+
+		UINT mSpatialProxy;
+		bool mProgramsSubmitted;
 	};
 }
\ No newline at end of file
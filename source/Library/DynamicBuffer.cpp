@@ -0,0 +1,227 @@
+#include "DynamicBuffer.h"
+#include "GameException.h"
+#include "ExtensionHelper.h"
+
+#ifndef GL_MAP_PERSISTENT_BIT
+#define GL_MAP_PERSISTENT_BIT 0x0040
+#endif
+
+#ifndef GL_MAP_COHERENT_BIT
+#define GL_MAP_COHERENT_BIT 0x0080
+#endif
+
+namespace Library
+{
+	RTTI_DEFINITIONS(DynamicBuffer)
+
+	const GLsizeiptr DynamicBuffer::DefaultFrameSize = 1024 * 1024;
+	const UINT DynamicBuffer::DefaultFramesInFlight = 3;
+
+	DynamicBuffer::DynamicBuffer(GLsizeiptr frameSize, UINT framesInFlight)
+		: mBufferStorage(nullptr), mBuffer(0), mMappedData(nullptr), mFrameSize(frameSize), mFramesInFlight(framesInFlight), mFrameIndex(0), mFrameOffset(0),
+		  mFences(framesInFlight, nullptr), mFrequency(0.0), mLastStallTime(0.0), mTotalStallTime(0.0), mStallCount(0)
+	{
+		assert(framesInFlight > 0);
+
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		mFrequency = static_cast<double>(frequency.QuadPart);
+	}
+
+	DynamicBuffer::~DynamicBuffer()
+	{
+		for (GLsync fence : mFences)
+		{
+			if (fence != nullptr)
+			{
+				glDeleteSync(fence);
+			}
+		}
+
+		if (mBuffer != 0)
+		{
+			glBindBuffer(GL_COPY_WRITE_BUFFER, mBuffer);
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+			glDeleteBuffers(1, &mBuffer);
+		}
+	}
+
+	DynamicBuffer* DynamicBuffer::Instance()
+	{
+		return static_cast<DynamicBuffer*>(GlobalServices.GetService(DynamicBuffer::TypeIdClass()));
+	}
+
+	GLuint DynamicBuffer::Buffer() const
+	{
+		return mBuffer;
+	}
+
+	GLsizeiptr DynamicBuffer::FrameSize() const
+	{
+		return mFrameSize;
+	}
+
+	UINT DynamicBuffer::FramesInFlight() const
+	{
+		return mFramesInFlight;
+	}
+
+	GLsizeiptr DynamicBuffer::FrameBytesUsed() const
+	{
+		return mFrameOffset;
+	}
+
+	bool DynamicBuffer::IsSupported() const
+	{
+		return (mBufferStorage != nullptr);
+	}
+
+	bool DynamicBuffer::CanAllocate(GLsizeiptr size, GLsizeiptr alignment) const
+	{
+		// Alignment padding can never exceed alignment - 1 bytes
+		return (IsSupported() && size + alignment - 1 <= mFrameSize - mFrameOffset);
+	}
+
+	void DynamicBuffer::Initialize()
+	{
+		// glBufferStorage is core in 4.4, past what gl3w's headers expose; without it callers keep their own buffers
+		GLint majorVersion = 0;
+		GLint minorVersion = 0;
+		glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+		glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+
+		if (majorVersion > 4 || (majorVersion == 4 && minorVersion >= 4) || ExtensionHelper::IsSupported("GL_ARB_buffer_storage"))
+		{
+			mBufferStorage = reinterpret_cast<BufferStorageFunction>(gl3wGetProcAddress("glBufferStorage"));
+		}
+	}
+
+	void DynamicBuffer::CreateStorage()
+	{
+		GLsizeiptr bufferSize = mFrameSize * mFramesInFlight;
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+		glGenBuffers(1, &mBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, mBuffer);
+		mBufferStorage(GL_COPY_WRITE_BUFFER, bufferSize, nullptr, flags);
+
+		// The mapping stays valid for the lifetime of the buffer; coherent writes need no explicit flush
+		mMappedData = static_cast<GLubyte*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, bufferSize, flags));
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+		if (mMappedData == nullptr)
+		{
+			throw GameException("DynamicBuffer::CreateStorage() glMapBufferRange() failed.");
+		}
+	}
+
+	void DynamicBuffer::BeginFrame()
+	{
+		// Nothing is fenced until the first allocation creates the ring
+		if (mBuffer == 0)
+		{
+			return;
+		}
+
+		mFrameIndex = (mFrameIndex + 1) % mFramesInFlight;
+		mFrameOffset = 0;
+
+		WaitForFrame(mFrameIndex);
+	}
+
+	void DynamicBuffer::EndFrame()
+	{
+		if (mBuffer == 0)
+		{
+			return;
+		}
+
+		assert(mFences[mFrameIndex] == nullptr);
+
+		mFences[mFrameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	}
+
+	DynamicAllocation DynamicBuffer::Allocate(GLsizeiptr size, GLsizeiptr alignment)
+	{
+		assert(IsSupported() && alignment > 0);
+
+		if (mBuffer == 0)
+		{
+			CreateStorage();
+		}
+
+		GLintptr frameStart = mFrameSize * mFrameIndex;
+		GLintptr offset = frameStart + mFrameOffset;
+		offset = ((offset + alignment - 1) / alignment) * alignment;
+
+		if (offset + size > frameStart + mFrameSize)
+		{
+			throw GameException("DynamicBuffer::Allocate() frame capacity exceeded.");
+		}
+
+		mFrameOffset = offset + size - frameStart;
+
+		DynamicAllocation allocation;
+		allocation.Data = mMappedData + offset;
+		allocation.Buffer = mBuffer;
+		allocation.Offset = offset;
+		allocation.Size = size;
+
+		return allocation;
+	}
+
+	double DynamicBuffer::LastStallTime() const
+	{
+		return mLastStallTime;
+	}
+
+	double DynamicBuffer::TotalStallTime() const
+	{
+		return mTotalStallTime;
+	}
+
+	UINT DynamicBuffer::StallCount() const
+	{
+		return mStallCount;
+	}
+
+	void DynamicBuffer::WaitForFrame(UINT frameIndex)
+	{
+		mLastStallTime = 0.0;
+
+		GLsync fence = mFences[frameIndex];
+		if (fence == nullptr)
+		{
+			return;
+		}
+
+		// Only block when the GPU is still reading the region written N frames ago
+		GLenum result = glClientWaitSync(fence, 0, 0);
+		if (result == GL_TIMEOUT_EXPIRED)
+		{
+			LARGE_INTEGER startTime;
+			QueryPerformanceCounter(&startTime);
+
+			const GLuint64 timeout = 1000000000;
+			do
+			{
+				result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, timeout);
+			} while (result == GL_TIMEOUT_EXPIRED);
+
+			LARGE_INTEGER endTime;
+			QueryPerformanceCounter(&endTime);
+
+			mLastStallTime = (endTime.QuadPart - startTime.QuadPart) / mFrequency;
+			mTotalStallTime += mLastStallTime;
+			mStallCount++;
+		}
+
+		glDeleteSync(fence);
+		mFences[frameIndex] = nullptr;
+
+		if (result == GL_WAIT_FAILED)
+		{
+			throw GameException("DynamicBuffer::BeginFrame() glClientWaitSync() failed.");
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "Common.h"
+
+namespace Library
+{
+	struct DynamicAllocation
+	{
+		void* Data;
+		GLuint Buffer;
+		GLintptr Offset;
+		GLsizeiptr Size;
+	};
+
+	class DynamicBuffer : public RTTI
+	{
+		RTTI_DECLARATIONS(DynamicBuffer, RTTI)
+
+	public:
+		DynamicBuffer(GLsizeiptr frameSize = DefaultFrameSize, UINT framesInFlight = DefaultFramesInFlight);
+		~DynamicBuffer();
+
+		static DynamicBuffer* Instance();
+
+		GLuint Buffer() const;
+		GLsizeiptr FrameSize() const;
+		UINT FramesInFlight() const;
+		GLsizeiptr FrameBytesUsed() const;
+		bool IsSupported() const;
+		bool CanAllocate(GLsizeiptr size, GLsizeiptr alignment) const;
+
+		void Initialize();
+		void BeginFrame();
+		void EndFrame();
+		DynamicAllocation Allocate(GLsizeiptr size, GLsizeiptr alignment);
+
+		double LastStallTime() const;
+		double TotalStallTime() const;
+		UINT StallCount() const;
+
+		static const GLsizeiptr DefaultFrameSize;
+		static const UINT DefaultFramesInFlight;
+
+	private:
+		DynamicBuffer(const DynamicBuffer& rhs);
+		DynamicBuffer& operator=(const DynamicBuffer& rhs);
+
+		typedef void (APIENTRY *BufferStorageFunction)(GLenum target, GLsizeiptr size, const void* data, GLbitfield flags);
+
+		void CreateStorage();
+		void WaitForFrame(UINT frameIndex);
+
+		BufferStorageFunction mBufferStorage;
+		GLuint mBuffer;
+		GLubyte* mMappedData;
+		GLsizeiptr mFrameSize;
+		UINT mFramesInFlight;
+		UINT mFrameIndex;
+		GLsizeiptr mFrameOffset;
+		std::vector<GLsync> mFences;
+		double mFrequency;
+		double mLastStallTime;
+		double mTotalStallTime;
+		UINT mStallCount;
+	};
+}
\ No newline at end of file
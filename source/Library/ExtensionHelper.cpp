@@ -0,0 +1,34 @@
+#include "ExtensionHelper.h"
+
+namespace Library
+{
+	std::set<std::string> ExtensionHelper::sExtensions;
+	bool ExtensionHelper::sExtensionsInitialized = false;
+
+	bool ExtensionHelper::IsSupported(const std::string& extensionName)
+	{
+		if (sExtensionsInitialized == false)
+		{
+			InitializeExtensions();
+		}
+
+		return (sExtensions.find(extensionName) != sExtensions.end());
+	}
+
+	void ExtensionHelper::InitializeExtensions()
+	{
+		GLint extensionCount = 0;
+		glGetIntegerv(GL_NUM_EXTENSIONS, &extensionCount);
+
+		for (GLint i = 0; i < extensionCount; i++)
+		{
+			const GLubyte* extensionName = glGetStringi(GL_EXTENSIONS, i);
+			if (extensionName != nullptr)
+			{
+				sExtensions.insert(reinterpret_cast<const char*>(extensionName));
+			}
+		}
+
+		sExtensionsInitialized = true;
+	}
+}
\ No newline at end of file
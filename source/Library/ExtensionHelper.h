@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Common.h"
+#include <set>
+
+namespace Library
+{
+	class ExtensionHelper
+	{
+	public:
+		static bool IsSupported(const std::string& extensionName);
+
+	private:
+		static void InitializeExtensions();
+		static std::set<std::string> sExtensions;
+		static bool sExtensionsInitialized;
+
+		ExtensionHelper();
+		ExtensionHelper(const ExtensionHelper& rhs);
+		ExtensionHelper& operator=(const ExtensionHelper& rhs);
+	};
+}
\ No newline at end of file
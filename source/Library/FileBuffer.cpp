@@ -0,0 +1,135 @@
+#include "FileBuffer.h"
+#include "GameException.h"
+#include "Utility.h"
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+namespace Library
+{
+	FileBuffer::FileBuffer()
+		: mData(nullptr), mSize(0)
+	{
+	}
+
+	FileBuffer::~FileBuffer()
+	{
+	}
+
+	const char* FileBuffer::Data() const
+	{
+		return mData;
+	}
+
+	size_t FileBuffer::Size() const
+	{
+		return mSize;
+	}
+
+	MemoryFileBuffer::MemoryFileBuffer(std::vector<char>& data)
+		: FileBuffer(), mStorage()
+	{
+		mStorage.swap(data);
+		mData = (mStorage.empty() ? nullptr : &mStorage.front());
+		mSize = mStorage.size();
+	}
+
+#if defined(_WIN32)
+	MappedFileBuffer::MappedFileBuffer(const std::wstring& filename)
+		: FileBuffer(), mFile(INVALID_HANDLE_VALUE), mMapping(nullptr)
+	{
+		mFile = CreateFileW(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (mFile == INVALID_HANDLE_VALUE)
+		{
+			throw GameException("CreateFileW() failed.", HRESULT_FROM_WIN32(GetLastError()));
+		}
+
+		LARGE_INTEGER fileSize;
+		if (GetFileSizeEx(mFile, &fileSize) == FALSE)
+		{
+			CloseHandle(mFile);
+			throw GameException("GetFileSizeEx() failed.", HRESULT_FROM_WIN32(GetLastError()));
+		}
+
+		// Zero-length files cannot be mapped; they are exposed as an empty view
+		mSize = static_cast<size_t>(fileSize.QuadPart);
+		if (mSize > 0)
+		{
+			mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (mMapping == nullptr)
+			{
+				CloseHandle(mFile);
+				throw GameException("CreateFileMappingW() failed.", HRESULT_FROM_WIN32(GetLastError()));
+			}
+
+			mData = static_cast<const char*>(MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0));
+			if (mData == nullptr)
+			{
+				CloseHandle(mMapping);
+				CloseHandle(mFile);
+				throw GameException("MapViewOfFile() failed.", HRESULT_FROM_WIN32(GetLastError()));
+			}
+		}
+	}
+
+	MappedFileBuffer::~MappedFileBuffer()
+	{
+		if (mData != nullptr)
+		{
+			UnmapViewOfFile(mData);
+		}
+
+		if (mMapping != nullptr)
+		{
+			CloseHandle(mMapping);
+		}
+
+		CloseHandle(mFile);
+	}
+#else
+	MappedFileBuffer::MappedFileBuffer(const std::wstring& filename)
+		: FileBuffer(), mFile(-1)
+	{
+		mFile = open(Utility::ToString(filename).c_str(), O_RDONLY);
+		if (mFile == -1)
+		{
+			throw GameException("open() failed.");
+		}
+
+		struct stat fileStatus;
+		if (fstat(mFile, &fileStatus) != 0)
+		{
+			close(mFile);
+			throw GameException("fstat() failed.");
+		}
+
+		// Zero-length files cannot be mapped; they are exposed as an empty view
+		mSize = static_cast<size_t>(fileStatus.st_size);
+		if (mSize > 0)
+		{
+			void* mapping = mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFile, 0);
+			if (mapping == MAP_FAILED)
+			{
+				close(mFile);
+				throw GameException("mmap() failed.");
+			}
+
+			mData = static_cast<const char*>(mapping);
+		}
+	}
+
+	MappedFileBuffer::~MappedFileBuffer()
+	{
+		if (mData != nullptr)
+		{
+			munmap(const_cast<char*>(mData), mSize);
+		}
+
+		close(mFile);
+	}
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Common.h"
+
+namespace Library
+{
+	class FileBuffer
+	{
+	public:
+		virtual ~FileBuffer();
+
+		const char* Data() const;
+		size_t Size() const;
+
+	protected:
+		FileBuffer();
+
+		const char* mData;
+		size_t mSize;
+
+	private:
+		FileBuffer(const FileBuffer& rhs);
+		FileBuffer& operator=(const FileBuffer& rhs);
+	};
+
+	class MemoryFileBuffer : public FileBuffer
+	{
+	public:
+		MemoryFileBuffer(std::vector<char>& data);
+
+	private:
+		std::vector<char> mStorage;
+	};
+
+	class MappedFileBuffer : public FileBuffer
+	{
+	public:
+		MappedFileBuffer(const std::wstring& filename);
+		virtual ~MappedFileBuffer();
+
+	private:
+#if defined(_WIN32)
+		HANDLE mFile;
+		HANDLE mMapping;
+#else
+		int mFile;
+#endif
+	};
+}
\ No newline at end of file
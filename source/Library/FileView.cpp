@@ -0,0 +1,46 @@
+#include "FileView.h"
+#include "FileBuffer.h"
+
+namespace Library
+{
+	FileView::FileView()
+		: mBuffer(), mData(nullptr), mSize(0)
+	{
+	}
+
+	FileView::FileView(const std::shared_ptr<const FileBuffer>& buffer)
+		: mBuffer(buffer), mData(buffer->Data()), mSize(buffer->Size())
+	{
+	}
+
+	FileView::FileView(const std::shared_ptr<const FileBuffer>& buffer, size_t offset, size_t size)
+		: mBuffer(buffer), mData(buffer->Data() + offset), mSize(size)
+	{
+		assert(offset + size <= buffer->Size());
+	}
+
+	const char* FileView::Data() const
+	{
+		return mData;
+	}
+
+	size_t FileView::Size() const
+	{
+		return mSize;
+	}
+
+	bool FileView::IsEmpty() const
+	{
+		return (mSize == 0);
+	}
+
+	const char* FileView::begin() const
+	{
+		return mData;
+	}
+
+	const char* FileView::end() const
+	{
+		return mData + mSize;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "Common.h"
+
+namespace Library
+{
+	class FileBuffer;
+
+	class FileView
+	{
+	public:
+		FileView();
+		FileView(const std::shared_ptr<const FileBuffer>& buffer);
+		FileView(const std::shared_ptr<const FileBuffer>& buffer, size_t offset, size_t size);
+
+		const char* Data() const;
+		size_t Size() const;
+		bool IsEmpty() const;
+
+		const char* begin() const;
+		const char* end() const;
+
+	private:
+		std::shared_ptr<const FileBuffer> mBuffer;
+		const char* mData;
+		size_t mSize;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,186 @@
+#include "FrameConstants.h"
+#include "Camera.h"
+#include "DirectionalLight.h"
+#include "SpotLight.h"
+#include "GameTime.h"
+#include "DynamicBuffer.h"
+#include "RenderStateCache.h"
+#include <cstring>
+
+namespace Library
+{
+	RTTI_DEFINITIONS(FrameConstants)
+
+	const GLuint FrameConstants::FrameDataBinding = 0;
+	const GLuint FrameConstants::LightDataBinding = 1;
+
+	FrameConstants::FrameConstants()
+		: mFrameBuffer(0), mLightBuffer(0), mStreamBuffer(nullptr), mUniformAlignment(0), mCamera(nullptr), mAmbientLight(nullptr), mLight(nullptr),
+		  mFrameData(), mLightData(), mLightDataValid(false), mUploadCount(0)
+	{
+	}
+
+	FrameConstants::~FrameConstants()
+	{
+		glDeleteBuffers(1, &mLightBuffer);
+		glDeleteBuffers(1, &mFrameBuffer);
+	}
+
+	FrameConstants* FrameConstants::Instance()
+	{
+		return static_cast<FrameConstants*>(GlobalServices.GetService(FrameConstants::TypeIdClass()));
+	}
+
+	const Camera* FrameConstants::ActiveCamera() const
+	{
+		return mCamera;
+	}
+
+	void FrameConstants::SetCamera(const Camera* camera)
+	{
+		mCamera = camera;
+	}
+
+	const Light* FrameConstants::AmbientLight() const
+	{
+		return mAmbientLight;
+	}
+
+	void FrameConstants::SetAmbientLight(const Light* light)
+	{
+		mAmbientLight = light;
+	}
+
+	const Light* FrameConstants::ActiveLight() const
+	{
+		return mLight;
+	}
+
+	void FrameConstants::SetLight(const Light* light)
+	{
+		mLight = light;
+	}
+
+	void FrameConstants::Initialize()
+	{
+		// Frame data changes every frame, so it streams through the ring whenever persistent mapping is available
+		DynamicBuffer* streamBuffer = DynamicBuffer::Instance();
+		if (streamBuffer != nullptr && streamBuffer->IsSupported())
+		{
+			mStreamBuffer = streamBuffer;
+			glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &mUniformAlignment);
+		}
+		else
+		{
+			glGenBuffers(1, &mFrameBuffer);
+			glBindBuffer(GL_UNIFORM_BUFFER, mFrameBuffer);
+			glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameData), nullptr, GL_DYNAMIC_DRAW);
+		}
+
+		glGenBuffers(1, &mLightBuffer);
+		glBindBuffer(GL_UNIFORM_BUFFER, mLightBuffer);
+		glBufferData(GL_UNIFORM_BUFFER, sizeof(LightData), nullptr, GL_DYNAMIC_DRAW);
+
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	}
+
+	void FrameConstants::Update(const GameTime& gameTime)
+	{
+		if (mLightBuffer == 0)
+		{
+			return;
+		}
+
+		// Binding points are shared by every program, so a single bind per frame serves all draws
+		UpdateFrameData(gameTime);
+		UpdateLightData();
+		RenderStateCache::Instance()->BindBufferBase(GL_UNIFORM_BUFFER, LightDataBinding, mLightBuffer);
+	}
+
+	UINT FrameConstants::UploadCount() const
+	{
+		return mUploadCount;
+	}
+
+	void FrameConstants::UpdateFrameData(const GameTime& gameTime)
+	{
+		if (mCamera != nullptr)
+		{
+			mFrameData.View = mCamera->ViewMatrix();
+			mFrameData.Projection = mCamera->ProjectionMatrix();
+			mFrameData.ViewProjection = mCamera->ViewProjectionMatrix();
+			mFrameData.CameraPosition = mCamera->Position();
+		}
+
+		mFrameData.TotalTime = static_cast<float>(gameTime.TotalGameTime());
+		mFrameData.ElapsedTime = static_cast<float>(gameTime.ElapsedGameTime());
+
+		if (mStreamBuffer != nullptr)
+		{
+			// A fresh slice each frame; the GPU may still be reading the previous frames' slices
+			DynamicAllocation allocation = mStreamBuffer->Allocate(sizeof(FrameData), mUniformAlignment);
+			memcpy(allocation.Data, &mFrameData, sizeof(FrameData));
+			RenderStateCache::Instance()->BindBufferRange(GL_UNIFORM_BUFFER, FrameDataBinding, allocation.Buffer, allocation.Offset, sizeof(FrameData));
+		}
+		else
+		{
+			glBindBuffer(GL_UNIFORM_BUFFER, mFrameBuffer);
+			glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameData), &mFrameData);
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			RenderStateCache::Instance()->BindBufferBase(GL_UNIFORM_BUFFER, FrameDataBinding, mFrameBuffer);
+		}
+
+		mUploadCount++;
+	}
+
+	void FrameConstants::UpdateLightData()
+	{
+		LightData lightData;
+		memset(&lightData, 0, sizeof(LightData));
+
+		if (mAmbientLight != nullptr)
+		{
+			lightData.AmbientColor = mAmbientLight->Color();
+		}
+
+		if (mLight != nullptr)
+		{
+			lightData.LightColor = mLight->Color();
+
+			const DirectionalLight* directionalLight = mLight->As<DirectionalLight>();
+			if (directionalLight != nullptr)
+			{
+				lightData.LightDirection = directionalLight->Direction();
+			}
+
+			const PointLight* pointLight = mLight->As<PointLight>();
+			if (pointLight != nullptr)
+			{
+				lightData.LightPosition = pointLight->Position();
+				lightData.LightRadius = pointLight->Radius();
+			}
+
+			const SpotLight* spotLight = mLight->As<SpotLight>();
+			if (spotLight != nullptr)
+			{
+				lightData.LightLookAt = spotLight->Direction();
+				lightData.SpotLightInnerAngle = spotLight->InnerAngle();
+				lightData.SpotLightOuterAngle = spotLight->OuterAngle();
+			}
+		}
+
+		// Lights rarely change from one frame to the next
+		if (mLightDataValid && memcmp(&lightData, &mLightData, sizeof(LightData)) == 0)
+		{
+			return;
+		}
+
+		mLightData = lightData;
+		mLightDataValid = true;
+
+		glBindBuffer(GL_UNIFORM_BUFFER, mLightBuffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightData), &mLightData);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		mUploadCount++;
+	}
+}
\ No newline at end of file
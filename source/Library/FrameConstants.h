@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Common.h"
+
+namespace Library
+{
+	class Camera;
+	class Light;
+	class GameTime;
+	class DynamicBuffer;
+
+	class FrameConstants : public RTTI
+	{
+		RTTI_DECLARATIONS(FrameConstants, RTTI)
+
+	public:
+		FrameConstants();
+		~FrameConstants();
+
+		static FrameConstants* Instance();
+
+		const Camera* ActiveCamera() const;
+		void SetCamera(const Camera* camera);
+		const Light* AmbientLight() const;
+		void SetAmbientLight(const Light* light);
+		const Light* ActiveLight() const;
+		void SetLight(const Light* light);
+
+		void Initialize();
+		void Update(const GameTime& gameTime);
+
+		UINT UploadCount() const;
+
+		// Must match the binding qualifiers in Content\Effects\FrameConstants.glsl
+		static const GLuint FrameDataBinding;
+		static const GLuint LightDataBinding;
+
+	private:
+		FrameConstants(const FrameConstants& rhs);
+		FrameConstants& operator=(const FrameConstants& rhs);
+
+		// std140 layouts; a vec3 followed by a float packs into a single 16-byte slot
+		struct FrameData
+		{
+			glm::mat4 ViewProjection;
+			glm::mat4 View;
+			glm::mat4 Projection;
+			glm::vec3 CameraPosition;
+			float TotalTime;
+			float ElapsedTime;
+			float Padding[3];
+		};
+
+		struct LightData
+		{
+			glm::vec4 AmbientColor;
+			glm::vec4 LightColor;
+			glm::vec3 LightDirection;
+			float LightRadius;
+			glm::vec3 LightPosition;
+			float SpotLightInnerAngle;
+			glm::vec3 LightLookAt;
+			float SpotLightOuterAngle;
+		};
+
+		void UpdateFrameData(const GameTime& gameTime);
+		void UpdateLightData();
+
+		GLuint mFrameBuffer;
+		GLuint mLightBuffer;
+		DynamicBuffer* mStreamBuffer;
+		GLint mUniformAlignment;
+		const Camera* mCamera;
+		const Light* mAmbientLight;
+		const Light* mLight;
+		FrameData mFrameData;
+		LightData mLightData;
+		bool mLightDataValid;
+		UINT mUploadCount;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "Frustum.h"
+#include "BoundingVolume.h"
+#include <xmmintrin.h>
+
+using namespace glm;
+
+namespace Library
+{
+	Frustum::Frustum()
+		: mMatrix(), mPlanes()
+	{
+		SetMatrix(mat4());
+	}
+
+	Frustum::Frustum(const mat4& matrix)
+		: mMatrix(), mPlanes()
+	{
+		SetMatrix(matrix);
+	}
+
+	const mat4& Frustum::Matrix() const
+	{
+		return mMatrix;
+	}
+
+	void Frustum::SetMatrix(const mat4& matrix)
+	{
+		mMatrix = matrix;
+
+		// Planes come straight from the rows of the view-projection matrix (GL clip space, -w <= z <= w)
+		vec4 row0(matrix[0][0], matrix[1][0], matrix[2][0], matrix[3][0]);
+		vec4 row1(matrix[0][1], matrix[1][1], matrix[2][1], matrix[3][1]);
+		vec4 row2(matrix[0][2], matrix[1][2], matrix[2][2], matrix[3][2]);
+		vec4 row3(matrix[0][3], matrix[1][3], matrix[2][3], matrix[3][3]);
+
+		mPlanes[FrustumPlaneLeft] = row3 + row0;
+		mPlanes[FrustumPlaneRight] = row3 - row0;
+		mPlanes[FrustumPlaneBottom] = row3 + row1;
+		mPlanes[FrustumPlaneTop] = row3 - row1;
+		mPlanes[FrustumPlaneNear] = row3 + row2;
+		mPlanes[FrustumPlaneFar] = row3 - row2;
+
+		// Normalized planes give true signed distances, which the sphere test relies on
+		for (vec4& plane : mPlanes)
+		{
+			float length = glm::length(vec3(plane));
+			if (length > 0.0f)
+			{
+				plane /= length;
+			}
+		}
+
+		// The padding lanes repeat real planes, so they can never reject anything the others accept
+		for (UINT i = 0; i < SimdPlaneCount; i++)
+		{
+			const vec4& plane = mPlanes[i % FrustumPlaneEnd];
+			mPlaneX[i] = plane.x;
+			mPlaneY[i] = plane.y;
+			mPlaneZ[i] = plane.z;
+			mPlaneW[i] = plane.w;
+		}
+	}
+
+	const vec4& Frustum::Plane(FrustumPlane plane) const
+	{
+		return mPlanes[plane];
+	}
+
+	const vec4* Frustum::Planes() const
+	{
+		return mPlanes;
+	}
+
+	bool Frustum::Intersects(const vec3& center, float radius) const
+	{
+		__m128 centerX = _mm_set1_ps(center.x);
+		__m128 centerY = _mm_set1_ps(center.y);
+		__m128 centerZ = _mm_set1_ps(center.z);
+		__m128 negativeRadius = _mm_set1_ps(-radius);
+
+		for (UINT i = 0; i < SimdPlaneCount; i += 4)
+		{
+			__m128 distance = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(&mPlaneX[i]), centerX), _mm_loadu_ps(&mPlaneW[i]));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_loadu_ps(&mPlaneY[i]), centerY));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_loadu_ps(&mPlaneZ[i]), centerZ));
+
+			// Entirely behind any one plane means outside
+			if (_mm_movemask_ps(_mm_cmplt_ps(distance, negativeRadius)) != 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool Frustum::Intersects(const BoundingSphere& sphere) const
+	{
+		return Intersects(sphere.Center, sphere.Radius);
+	}
+
+	bool Frustum::Intersects(const BoundingBox& box) const
+	{
+		if (box.IsEmpty())
+		{
+			return false;
+		}
+
+		vec3 center = box.Center();
+		vec3 extents = box.Extents();
+
+		__m128 centerX = _mm_set1_ps(center.x);
+		__m128 centerY = _mm_set1_ps(center.y);
+		__m128 centerZ = _mm_set1_ps(center.z);
+		__m128 extentsX = _mm_set1_ps(extents.x);
+		__m128 extentsY = _mm_set1_ps(extents.y);
+		__m128 extentsZ = _mm_set1_ps(extents.z);
+		__m128 signMask = _mm_set1_ps(-0.0f);
+
+		for (UINT i = 0; i < SimdPlaneCount; i += 4)
+		{
+			__m128 planeX = _mm_loadu_ps(&mPlaneX[i]);
+			__m128 planeY = _mm_loadu_ps(&mPlaneY[i]);
+			__m128 planeZ = _mm_loadu_ps(&mPlaneZ[i]);
+
+			__m128 distance = _mm_add_ps(_mm_mul_ps(planeX, centerX), _mm_loadu_ps(&mPlaneW[i]));
+			distance = _mm_add_ps(distance, _mm_mul_ps(planeY, centerY));
+			distance = _mm_add_ps(distance, _mm_mul_ps(planeZ, centerZ));
+
+			// The box's projected radius onto the plane normal is |n| . extents
+			__m128 radius = _mm_mul_ps(_mm_andnot_ps(signMask, planeX), extentsX);
+			radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(signMask, planeY), extentsY));
+			radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(signMask, planeZ), extentsZ));
+
+			if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps())) != 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool Frustum::Contains(const BoundingBox& box) const
+	{
+		if (box.IsEmpty())
+		{
+			return false;
+		}
+
+		vec3 center = box.Center();
+		vec3 extents = box.Extents();
+
+		__m128 centerX = _mm_set1_ps(center.x);
+		__m128 centerY = _mm_set1_ps(center.y);
+		__m128 centerZ = _mm_set1_ps(center.z);
+		__m128 extentsX = _mm_set1_ps(extents.x);
+		__m128 extentsY = _mm_set1_ps(extents.y);
+		__m128 extentsZ = _mm_set1_ps(extents.z);
+		__m128 signMask = _mm_set1_ps(-0.0f);
+
+		for (UINT i = 0; i < SimdPlaneCount; i += 4)
+		{
+			__m128 planeX = _mm_loadu_ps(&mPlaneX[i]);
+			__m128 planeY = _mm_loadu_ps(&mPlaneY[i]);
+			__m128 planeZ = _mm_loadu_ps(&mPlaneZ[i]);
+
+			__m128 distance = _mm_add_ps(_mm_mul_ps(planeX, centerX), _mm_loadu_ps(&mPlaneW[i]));
+			distance = _mm_add_ps(distance, _mm_mul_ps(planeY, centerY));
+			distance = _mm_add_ps(distance, _mm_mul_ps(planeZ, centerZ));
+
+			__m128 radius = _mm_mul_ps(_mm_andnot_ps(signMask, planeX), extentsX);
+			radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(signMask, planeY), extentsY));
+			radius = _mm_add_ps(radius, _mm_mul_ps(_mm_andnot_ps(signMask, planeZ), extentsZ));
+
+			// Inside only if even the corner nearest each plane is in front of it
+			if (_mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(distance, radius), _mm_setzero_ps())) != 0)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
\ No newline at end of file
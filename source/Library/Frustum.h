@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Common.h"
+
+namespace Library
+{
+	struct BoundingBox;
+	struct BoundingSphere;
+
+	enum FrustumPlane
+	{
+		FrustumPlaneLeft = 0,
+		FrustumPlaneRight,
+		FrustumPlaneBottom,
+		FrustumPlaneTop,
+		FrustumPlaneNear,
+		FrustumPlaneFar,
+		FrustumPlaneEnd
+	};
+
+	class Frustum
+	{
+	public:
+		Frustum();
+		Frustum(const glm::mat4& matrix);
+
+		const glm::mat4& Matrix() const;
+		void SetMatrix(const glm::mat4& matrix);
+
+		const glm::vec4& Plane(FrustumPlane plane) const;
+		const glm::vec4* Planes() const;
+
+		bool Intersects(const glm::vec3& center, float radius) const;
+		bool Intersects(const BoundingSphere& sphere) const;
+		bool Intersects(const BoundingBox& box) const;
+		bool Contains(const BoundingBox& box) const;
+
+	private:
+		// Planes are also kept component-major, padded to two groups of four, so one SSE pass tests four planes
+		static const UINT SimdPlaneCount = 8;
+
+		glm::mat4 mMatrix;
+		glm::vec4 mPlanes[FrustumPlaneEnd];
+		float mPlaneX[SimdPlaneCount];
+		float mPlaneY[SimdPlaneCount];
+		float mPlaneZ[SimdPlaneCount];
+		float mPlaneW[SimdPlaneCount];
+	};
+}
\ No newline at end of file
@@ -1,8 +1,12 @@
 #include "Game.h"
 #include "DrawableGameComponent.h"
+#include "Camera.h"
+#include "BoundingVolume.h"
 #include "GameException.h"
 #include "Utility.h"
+#include "JobSystem.h"
 #include "GLFW/glfw3native.h"
+#include <algorithm>
 
 namespace Library
 {
@@ -10,6 +14,8 @@ namespace Library
 
 	const UINT Game::DefaultScreenWidth = 800;
 	const UINT Game::DefaultScreenHeight = 600;
+	const std::string Game::ContentPackFilename = "Content.pak";
+	const UINT Game::MinimumComponentsPerCommandList = 8;
 
 	Game* Game::sInternalInstance = nullptr;
 
@@ -17,10 +23,37 @@ namespace Library
 		: mInstance(instance), mWindow(nullptr), mWindowTitle(windowTitle),
 		  mScreenWidth(DefaultScreenWidth), mScreenHeight(DefaultScreenHeight), mIsFullScreen(false),		  
 		  mMajorVersion(0), mMinorVersion(0),
-		  mGameClock(), mGameTime(), mComponents(), mServices(), mKeyboardHandlers(),
+		  mGameClock(), mGameTime(), mComponents(), mServices(), mFileSystem(),
+		  mShaderCache(Utility::ExecutableDirectory() + L"/" + ShaderCache::DefaultCacheDirectoryName), mProgramRegistry(), mFrameConstants(), mDynamicBuffer(), mRenderStateCache(), mSamplerCache(), mRenderQueue(), mTransformHierarchy(), mSpatialIndex(), mSpatialInsertCount(0), mOcclusionCuller(), mAnimationSystem(), mClusteredLighting(), mDeferredRenderer(), mCulledComponentCount(0), mOccludedComponentCount(0),
+		  mCullingCameras(), mSpatialQueryResults(),
+		  mVisibleComponents(), mRecordedComponents(), mCommandLists(), mRecordedComponentCount(0), mKeyboardHandlers(),
 		  mDepthStencilBufferEnabled(false)
 	{
 		GlobalServices.AddService(TypeIdClass(), &(*this));
+
+		mFileSystem.Mount("", Utility::ExecutableDirectory());
+
+		// A packed content archive, when shipped, shadows the loose Content folder
+		std::wstring contentPackFilename;
+		if (mFileSystem.ResolvePath(ContentPackFilename, contentPackFilename))
+		{
+			mFileSystem.MountPack("Content", contentPackFilename);
+		}
+
+		GlobalServices.AddService(VirtualFileSystem::TypeIdClass(), &mFileSystem);
+		GlobalServices.AddService(ShaderCache::TypeIdClass(), &mShaderCache);
+		GlobalServices.AddService(ShaderProgramRegistry::TypeIdClass(), &mProgramRegistry);
+		GlobalServices.AddService(FrameConstants::TypeIdClass(), &mFrameConstants);
+		GlobalServices.AddService(DynamicBuffer::TypeIdClass(), &mDynamicBuffer);
+		GlobalServices.AddService(RenderStateCache::TypeIdClass(), &mRenderStateCache);
+		GlobalServices.AddService(SamplerCache::TypeIdClass(), &mSamplerCache);
+		GlobalServices.AddService(RenderQueue::TypeIdClass(), &mRenderQueue);
+		GlobalServices.AddService(TransformHierarchy::TypeIdClass(), &mTransformHierarchy);
+		GlobalServices.AddService(BoundingVolumeHierarchy::TypeIdClass(), &mSpatialIndex);
+		GlobalServices.AddService(OcclusionCuller::TypeIdClass(), &mOcclusionCuller);
+		GlobalServices.AddService(AnimationSystem::TypeIdClass(), &mAnimationSystem);
+		GlobalServices.AddService(ClusteredLighting::TypeIdClass(), &mClusteredLighting);
+		GlobalServices.AddService(DeferredRenderer::TypeIdClass(), &mDeferredRenderer);
 	}
 
 	Game::~Game()
@@ -78,6 +111,91 @@ namespace Library
 		return mServices;
 	}
 
+	VirtualFileSystem& Game::FileSystem()
+	{
+		return mFileSystem;
+	}
+
+	ShaderCache& Game::ProgramCache()
+	{
+		return mShaderCache;
+	}
+
+	ShaderProgramRegistry& Game::ProgramRegistry()
+	{
+		return mProgramRegistry;
+	}
+
+	FrameConstants& Game::FrameData()
+	{
+		return mFrameConstants;
+	}
+
+	DynamicBuffer& Game::StreamBuffer()
+	{
+		return mDynamicBuffer;
+	}
+
+	RenderStateCache& Game::RenderStates()
+	{
+		return mRenderStateCache;
+	}
+
+	SamplerCache& Game::Samplers()
+	{
+		return mSamplerCache;
+	}
+
+	RenderQueue& Game::DrawQueue()
+	{
+		return mRenderQueue;
+	}
+
+	TransformHierarchy& Game::Transforms()
+	{
+		return mTransformHierarchy;
+	}
+
+	BoundingVolumeHierarchy& Game::SpatialIndex()
+	{
+		return mSpatialIndex;
+	}
+
+	OcclusionCuller& Game::OcclusionCulling()
+	{
+		return mOcclusionCuller;
+	}
+
+	AnimationSystem& Game::Animations()
+	{
+		return mAnimationSystem;
+	}
+
+	ClusteredLighting& Game::ClusteredLights()
+	{
+		return mClusteredLighting;
+	}
+
+	DeferredRenderer& Game::DeferredShading()
+	{
+		return mDeferredRenderer;
+	}
+
+	UINT Game::CulledComponentCount() const
+	{
+		return mCulledComponentCount;
+	}
+
+	UINT Game::OccludedComponentCount() const
+	{
+		return mOccludedComponentCount;
+	}
+
+	UINT Game::RecordedComponentCount() const
+	{
+		return mRecordedComponentCount;
+	}
+
 	void Game::Run()
 	{
 		sInternalInstance = this;
@@ -91,8 +209,10 @@ namespace Library
 		while (!glfwWindowShouldClose(mWindow))
 		{
 			mGameClock.UpdateGameTime(mGameTime);
+			mDynamicBuffer.BeginFrame();
 			Update(mGameTime);
 			Draw(mGameTime);
+			mDynamicBuffer.EndFrame();
 
 			glfwPollEvents();
 		}
@@ -107,10 +227,26 @@ namespace Library
 
 	void Game::Initialize()
 	{
+		// Every component's programs compile and link in one batch before any of them loads content; nothing
+		// queries their status until a variable or draw first needs it, by which time the driver has caught up
+		std::vector<ShaderProgramBuild> builds;
+		for (GameComponent* component : mComponents)
+		{
+			DrawableGameComponent* drawableGameComponent = component->As<DrawableGameComponent>();
+			if (drawableGameComponent != nullptr)
+			{
+				drawableGameComponent->SubmitPrograms(builds);
+			}
+		}
+		ShaderProgram::BuildPrograms(builds);
+
 		for (GameComponent* component : mComponents)
 		{
 			component->Initialize();
 		}
+
+		// Components create their resources with raw GL calls, so nothing cached before this point can be trusted
+		mRenderStateCache.Invalidate();
 	}
 
 	void Game::Update(const GameTime& gameTime)
@@ -122,16 +258,187 @@ namespace Library
 				component->Update(gameTime);
 			}
 		}
+
+		// Runs after the components so clips they started or cross-faded this frame are sampled right away
+		mAnimationSystem.Update(gameTime);
 	}
 
 	void Game::Draw(const GameTime& gameTime)
 	{
+		mFrameConstants.Update(gameTime);
+
+		// Flush whatever the updates moved before anything reads world bounds
+		mTransformHierarchy.UpdateWorldMatrices();
+		mAnimationSystem.UploadPalettes();
+
+		const Camera* lightingCamera = mFrameConstants.ActiveCamera();
+		if (lightingCamera != nullptr)
+		{
+			mClusteredLighting.Update(*lightingCamera, mScreenWidth, mScreenHeight);
+		}
+
+		mCulledComponentCount = 0;
+		mOccludedComponentCount = 0;
+		mVisibleComponents.clear();
+
+		mCullingCameras.clear();
+
+		// Unbounded components always draw; bounded ones join the spatial index the first time they are seen
+		UINT indexedComponentCount = 0;
+		UINT insertedComponentCount = 0;
+		BoundingBox bounds;
 		for (GameComponent* component : mComponents)
 		{
 			DrawableGameComponent* drawableGameComponent = component->As<DrawableGameComponent>();
 			if (drawableGameComponent != nullptr && drawableGameComponent->Visible())
 			{
-				drawableGameComponent->Draw(gameTime);
+				Camera* camera = drawableGameComponent->GetCamera();
+				if (camera != nullptr && drawableGameComponent->mSpatialProxy == BoundingVolumeHierarchy::NullNode && drawableGameComponent->WorldBounds(bounds))
+				{
+					drawableGameComponent->mSpatialProxy = mSpatialIndex.Insert(bounds, drawableGameComponent);
+					insertedComponentCount++;
+				}
+
+				if (camera == nullptr || drawableGameComponent->mSpatialProxy == BoundingVolumeHierarchy::NullNode)
+				{
+					mVisibleComponents.push_back(drawableGameComponent);
+					continue;
+				}
+
+				if (std::find(mCullingCameras.begin(), mCullingCameras.end(), camera) == mCullingCameras.end())
+				{
+					mCullingCameras.push_back(camera);
+				}
+
+				indexedComponentCount++;
+			}
+		}
+
+		// Incremental inserts build a poorer tree than the SAH build. In SpatialIndexBenchmark at 100K, a tree built only
+		// by inserts queries about 2x slower than a rebuilt one (slower than a linear scan), while replacing a tenth of
+		// a rebuilt tree stays within ~10% of it. A rebuild costs ~150-200 ms there, near a hundred frames of the worst
+		// gap, so inserts are counted across frames and the tree is rebuilt once they reach half of it (the first frame)
+		mSpatialInsertCount += insertedComponentCount;
+		if (mSpatialInsertCount * 2 > mSpatialIndex.ProxyCount())
+		{
+			mSpatialIndex.Rebuild();
+			mSpatialInsertCount = 0;
+		}
+
+		// One frustum query per camera finds the bounded components in view; occluders are rasterized once per camera
+		bool testOcclusion = (mOcclusionCuller.Enabled() && mOcclusionCuller.OccluderCount() > 0);
+		UINT acceptedComponentCount = 0;
+		for (Camera* camera : mCullingCameras)
+		{
+			mSpatialQueryResults.clear();
+			mSpatialIndex.QueryFrustum(camera->ViewFrustum(), mSpatialQueryResults);
+			if (testOcclusion)
+			{
+				mOcclusionCuller.Rasterize(camera->ViewProjectionMatrix());
+			}
+
+			for (void* userData : mSpatialQueryResults)
+			{
+				DrawableGameComponent* drawableGameComponent = static_cast<DrawableGameComponent*>(userData);
+				if (drawableGameComponent->GetCamera() != camera || drawableGameComponent->Visible() == false)
+				{
+					continue;
+				}
+
+				acceptedComponentCount++;
+				if (testOcclusion && drawableGameComponent->WorldBounds(bounds) && mOcclusionCuller.IsVisible(bounds) == false)
+				{
+					mOccludedComponentCount++;
+					continue;
+				}
+
+				mVisibleComponents.push_back(drawableGameComponent);
+			}
+		}
+
+		mCulledComponentCount = indexedComponentCount - acceptedComponentCount;
+
+		RecordComponents(gameTime);
+
+		// Deferred-layer draws fill the G-buffer and are lit there; the composite leaves the rest of the queue to draw forward
+		if (mDeferredRenderer.Enabled() && lightingCamera != nullptr)
+		{
+			mDeferredRenderer.BeginGeometryPass(mScreenWidth, mScreenHeight);
+			mRenderQueue.Execute(RenderLayerDeferred);
+			mDeferredRenderer.Resolve(*lightingCamera, mClusteredLighting.VisibleLightCount());
+		}
+
+		// Components that draw themselves go after the queued opaque items, so anything they blend lands over them;
+		// what they submit (forward layers only) is sorted in with the transparent layer that follows
+		mRenderQueue.Execute(RenderLayerOpaque);
+		DrawUnrecordedComponents(gameTime);
+		mRenderQueue.Execute();
+	}
+
+	DrawableGameComponent* Game::Pick(const Ray& ray)
+	{
+		// Nearest visible bounded component whose bounds the ray crosses
+		std::vector<RayHit> hits;
+		mSpatialIndex.QueryRay(ray, hits);
+
+		for (const RayHit& hit : hits)
+		{
+			DrawableGameComponent* drawableGameComponent = static_cast<DrawableGameComponent*>(hit.UserData);
+			if (drawableGameComponent->Visible())
+			{
+				return drawableGameComponent;
+			}
+		}
+
+		return nullptr;
+	}
+
+	void Game::RecordComponents(const GameTime& gameTime)
+	{
+		// Each list records a contiguous slice of the visible components on its own worker
+		UINT componentCount = mVisibleComponents.size();
+		UINT listCount = std::min<UINT>(JobSystem::WorkerCount(), componentCount / MinimumComponentsPerCommandList);
+		listCount = (listCount > 0 ? listCount : 1);
+		if (mCommandLists.size() < listCount)
+		{
+			mCommandLists.resize(listCount);
+		}
+
+		UINT listSize = (componentCount + listCount - 1) / listCount;
+		mRecordedComponents.assign(componentCount, GL_FALSE);
+
+		JobSystem::ParallelFor(listCount, 1, [this, &gameTime, componentCount, listSize](UINT begin, UINT end)
+		{
+			for (UINT list = begin; list < end; list++)
+			{
+				RenderCommandList& commandList = mCommandLists[list];
+				commandList.Clear();
+
+				UINT last = std::min<UINT>((list + 1) * listSize, componentCount);
+				for (UINT i = list * listSize; i < last; i++)
+				{
+					mRecordedComponents[i] = (mVisibleComponents[i]->Record(gameTime, commandList) ? GL_TRUE : GL_FALSE);
+				}
+			}
+		});
+
+		mRecordedComponentCount = std::count(mRecordedComponents.begin(), mRecordedComponents.end(), GL_TRUE);
+
+		// Recorded slices merge in component order, so the queue sees the same sequence whatever the worker count
+		for (UINT list = 0; list < listCount; list++)
+		{
+			mRenderQueue.Submit(mCommandLists[list]);
+		}
+	}
+
+	void Game::DrawUnrecordedComponents(const GameTime& gameTime)
+	{
+		// Components that cannot record draw here, on the GL thread, in their usual order
+		for (UINT i = 0; i < mVisibleComponents.size(); i++)
+		{
+			if (mRecordedComponents[i] == GL_FALSE)
+			{
+				mVisibleComponents[i]->Draw(gameTime);
 			}
 		}
 	}
@@ -177,10 +484,15 @@ namespace Library
 		glGetIntegerv(GL_MAJOR_VERSION, &mMajorVersion);
 		glGetIntegerv(GL_MINOR_VERSION, &mMinorVersion);
 
+		mProgramRegistry.InitializeParallelCompile();
+		mDynamicBuffer.Initialize();
+		mFrameConstants.Initialize();
+		mRenderStateCache.Initialize();
+
 		if (mDepthStencilBufferEnabled)
 		{
-			glEnable(GL_DEPTH_TEST);
-			glDepthFunc(GL_LEQUAL);
+			mRenderStateCache.SetDepthTestEnabled(true);
+			mRenderStateCache.SetDepthFunction(GL_LEQUAL);
 		}
 
 		glViewport(0, 0, mScreenWidth, mScreenHeight);
@@ -4,10 +4,28 @@
 #include "GameClock.h"
 #include "GameTime.h"
 #include "GameComponent.h"
+#include "VirtualFileSystem.h"
+#include "ShaderCache.h"
+#include "ShaderProgramRegistry.h"
+#include "FrameConstants.h"
+#include "DynamicBuffer.h"
+#include "RenderStateCache.h"
+#include "SamplerCache.h"
+#include "RenderQueue.h"
+#include "RenderCommandList.h"
+#include "TransformHierarchy.h"
+#include "BoundingVolumeHierarchy.h"
+#include "OcclusionCuller.h"
+#include "AnimationSystem.h"
+#include "ClusteredLighting.h"
+#include "DeferredRenderer.h"
 #include <functional>
 
 namespace Library
 {
+	class Camera;
+	class DrawableGameComponent;
+
 	class Game : public RTTI
 	{
 		RTTI_DECLARATIONS(Game, RTTI)
@@ -30,6 +48,25 @@ namespace Library
 		bool IsFullScreen() const;
 		const std::vector<GameComponent*>& Components() const;
 		const ServiceContainer& Services() const;
+		VirtualFileSystem& FileSystem();
+		ShaderCache& ProgramCache();
+		ShaderProgramRegistry& ProgramRegistry();
+		FrameConstants& FrameData();
+		DynamicBuffer& StreamBuffer();
+		RenderStateCache& RenderStates();
+		SamplerCache& Samplers();
+		RenderQueue& DrawQueue();
+		TransformHierarchy& Transforms();
+		BoundingVolumeHierarchy& SpatialIndex();
+		OcclusionCuller& OcclusionCulling();
+		AnimationSystem& Animations();
+		ClusteredLighting& ClusteredLights();
+		DeferredRenderer& DeferredShading();
+		UINT CulledComponentCount() const;
+		UINT OccludedComponentCount() const;
+		UINT RecordedComponentCount() const;
+
+		DrawableGameComponent* Pick(const Ray& ray);
 
 		virtual void Run();
 		virtual void Exit();
@@ -45,9 +82,14 @@ namespace Library
 		virtual void InitializeOpenGL();
 		virtual void Shutdown();
 
+		void RecordComponents(const GameTime& gameTime);
+		void DrawUnrecordedComponents(const GameTime& gameTime);
+
 		static const UINT DefaultScreenWidth;
 		static const UINT DefaultScreenHeight;
 		static const UINT DefaultFrameRate;
+		static const std::string ContentPackFilename;
+		static const UINT MinimumComponentsPerCommandList;
 		
 		HINSTANCE mInstance;
 		std::wstring mWindowTitle;		
@@ -66,6 +108,29 @@ namespace Library
 
 		std::vector<GameComponent*> mComponents;
 		ServiceContainer mServices;
+		VirtualFileSystem mFileSystem;
+		ShaderCache mShaderCache;
+		ShaderProgramRegistry mProgramRegistry;
+		FrameConstants mFrameConstants;
+		DynamicBuffer mDynamicBuffer;
+		RenderStateCache mRenderStateCache;
+		SamplerCache mSamplerCache;
+		RenderQueue mRenderQueue;
+		TransformHierarchy mTransformHierarchy;
+		BoundingVolumeHierarchy mSpatialIndex;
+		UINT mSpatialInsertCount;
+		OcclusionCuller mOcclusionCuller;
+		AnimationSystem mAnimationSystem;
+		ClusteredLighting mClusteredLighting;
+		DeferredRenderer mDeferredRenderer;
+		UINT mCulledComponentCount;
+		UINT mOccludedComponentCount;
+		std::vector<Camera*> mCullingCameras;
+		std::vector<void*> mSpatialQueryResults;
+		std::vector<DrawableGameComponent*> mVisibleComponents;
+		std::vector<GLboolean> mRecordedComponents;
+		std::vector<RenderCommandList> mCommandLists;
+		UINT mRecordedComponentCount;
 
 		std::map<KeyboardHandler*, KeyboardHandler> mKeyboardHandlers;
 
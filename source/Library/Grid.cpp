@@ -4,8 +4,9 @@
 #include "Camera.h"
 #include "ColorHelper.h"
 #include "VectorHelper.h"
-#include "Utility.h"
 #include "VertexDeclarations.h"
+#include "DynamicBuffer.h"
+#include <cstring>
 
 using namespace glm;
 
@@ -18,15 +19,15 @@ namespace Library
 	const vec4 Grid::DefaultColor = vec4(0.961f, 0.871f, 0.702f, 1.0f);
 
 	Grid::Grid(Game& game, Camera& camera)
-		: DrawableGameComponent(game), mVertexArrayObject(0), mVertexBuffer(0),
+		: DrawableGameComponent(game), mVertexArrayObject(0), mVertexBuffer(0), mVertexBufferSize(0), mVertices(), mVerticesChanged(false),
 		  mPosition(Vector3Helper::Zero), mSize(DefaultSize), mScale(DefaultScale), mColor(DefaultColor),
-		  mWorldMatrix(), mVertexCount(0)
+		  mWorldMatrix()
 	{
 		mCamera = &camera;
 	}
 
 	Grid::Grid(Game& game, Camera& camera, GLuint size, GLuint scale, const vec4& color)
-		: DrawableGameComponent(game), mVertexArrayObject(0), mVertexBuffer(0),
+		: DrawableGameComponent(game), mVertexArrayObject(0), mVertexBuffer(0), mVertexBufferSize(0), mVertices(), mVerticesChanged(false),
 		  mPosition(Vector3Helper::Zero), mSize(size), mScale(scale), mColor(color), mWorldMatrix()
 	{
 		mCamera = &camera;
@@ -88,18 +89,26 @@ namespace Library
 		InitializeGrid();
 	}
 
-	void Grid::Initialize()
+	void Grid::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
 	{
-		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content/Effects/BasicEffect.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content/Effects/BasicEffect.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
 
+	void Grid::Initialize()
+	{
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\BasicEffect.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\BasicEffect.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 
 		InitializeGrid();
 
+		// The lines live in a static buffer; Draw only re-uploads them after a setter has changed the grid
+		mShaderProgram.CreateVertexBuffer(&mVertices[0], mVertices.size(), mVertexBuffer);
+		mVertexBufferSize = sizeof(VertexPositionColor) * mVertices.size();
+		mVerticesChanged = false;
+
 		// Create the vertex array object
 		glGenVertexArrays(1, &mVertexArrayObject);		
 		mShaderProgram.Initialize(mVertexArrayObject);
@@ -108,23 +117,58 @@ namespace Library
 
 	void Grid::Draw(const GameTime& gameTime)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+		RenderStateCache& renderStates = mGame->RenderStates();
+
+		renderStates.BindVertexArray(mVertexArrayObject);
+
+		if (mVerticesChanged)
+		{
+			UpdateVertexBuffer();
+		}
 	
 		mShaderProgram.Use();
 
 		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
 		mShaderProgram.WorldViewProjection() << wvp;
+		mShaderProgram.CommitUniforms();
 
-		glDrawArrays(GL_LINES, 0, mVertexCount);
-		glBindVertexArray(0);
+		glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(mVertices.size()));
+	}
+
+	void Grid::UpdateVertexBuffer()
+	{
+		GLsizeiptr size = sizeof(VertexPositionColor) * mVertices.size();
+		DynamicBuffer& streamBuffer = mGame->StreamBuffer();
+
+		if (size > mVertexBufferSize || streamBuffer.CanAllocate(size, sizeof(float)) == false)
+		{
+			mGame->RenderStates().BindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+			glBufferData(GL_ARRAY_BUFFER, size, &mVertices[0], GL_STATIC_DRAW);
+			mVertexBufferSize = size;
+		}
+		else
+		{
+			// Stage the lines in this frame's slice of the ring and let the GPU copy them across,
+			// so the update never waits on draws still reading the old lines
+			DynamicAllocation allocation = streamBuffer.Allocate(size, sizeof(float));
+			memcpy(allocation.Data, &mVertices[0], size);
+
+			glBindBuffer(GL_COPY_READ_BUFFER, allocation.Buffer);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, mVertexBuffer);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, allocation.Offset, 0, size);
+			glBindBuffer(GL_COPY_READ_BUFFER, 0);
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		}
+
+		mVerticesChanged = false;
 	}
 
 	void Grid::InitializeGrid()
 	{
-		mVertexCount = (mSize + 1) * 4;
-		std::unique_ptr<VertexPositionColor> vertexData(new VertexPositionColor[mVertexCount]);
-		VertexPositionColor* vertices = vertexData.get();
+		// Regenerating only touches client memory; the vertex buffer is refreshed on the next draw
+		mVertices.resize((mSize + 1) * 4);
+		mVerticesChanged = true;
+		VertexPositionColor* vertices = &mVertices[0];
 
 		float adjustedScale = mScale * 0.1f;
 		float maxPosition = mSize * adjustedScale / 2;
@@ -141,9 +185,5 @@ namespace Library
             vertices[j + 2] = VertexPositionColor(vec4(maxPosition, 0.0f, position, 1.0f), mColor);
             vertices[j + 3] = VertexPositionColor(vec4(-maxPosition, 0.0f, position, 1.0f), mColor);
         }
-
-		glDeleteBuffers(1, &mVertexBuffer);
-
-		mShaderProgram.CreateVertexBuffer(vertices, mVertexCount, mVertexBuffer);
 	}
 }
\ No newline at end of file
@@ -26,6 +26,7 @@ namespace Library
 		void SetSize(GLuint size);
 		void SetScale(GLuint scale);
 
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Draw(const GameTime& gameTime) override;
 
@@ -35,6 +36,7 @@ namespace Library
 		Grid& operator=(const Grid& rhs);
 		
 		void InitializeGrid();
+		void UpdateVertexBuffer();
 
 		static const GLuint DefaultSize;
 		static const GLuint DefaultScale;
@@ -43,12 +45,14 @@ namespace Library
 		BasicEffect mShaderProgram;
 		GLuint mVertexArrayObject;
 		GLuint mVertexBuffer;
+		GLsizeiptr mVertexBufferSize;
+		std::vector<VertexPositionColor> mVertices;
+		bool mVerticesChanged;
 	
 		glm::vec3 mPosition;
 		GLuint mSize;
 		GLuint mScale;
 		glm::vec4 mColor;
 		glm::mat4 mWorldMatrix;
-		UINT mVertexCount;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "HashHelper.h"
+
+namespace Library
+{
+	// 64-bit FNV-1a
+	const std::uint64_t HashHelper::OffsetBasis = 14695981039346656037ULL;
+	const std::uint64_t HashHelper::Prime = 1099511628211ULL;
+
+	std::uint64_t HashHelper::Hash(const void* data, size_t size, std::uint64_t seed)
+	{
+		const unsigned char* bytes = static_cast<const unsigned char*>(data);
+		std::uint64_t hash = seed;
+
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= bytes[i];
+			hash *= Prime;
+		}
+
+		return hash;
+	}
+
+	std::uint64_t HashHelper::Hash(const std::string& value, std::uint64_t seed)
+	{
+		return Hash(value.c_str(), value.size(), seed);
+	}
+
+	std::uint64_t HashHelper::Combine(std::uint64_t seed, std::uint64_t value)
+	{
+		return Hash(&value, sizeof(value), seed);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Common.h"
+#include <cstdint>
+
+namespace Library
+{
+	class HashHelper
+	{
+	public:
+		static std::uint64_t Hash(const void* data, size_t size, std::uint64_t seed = OffsetBasis);
+		static std::uint64_t Hash(const std::string& value, std::uint64_t seed = OffsetBasis);
+		static std::uint64_t Combine(std::uint64_t seed, std::uint64_t value);
+
+		static const std::uint64_t OffsetBasis;
+
+	private:
+		static const std::uint64_t Prime;
+
+		HashHelper();
+		HashHelper(const HashHelper& rhs);
+		HashHelper& operator=(const HashHelper& rhs);
+	};
+}
\ No newline at end of file
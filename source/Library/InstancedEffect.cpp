@@ -0,0 +1,78 @@
+#include "InstancedEffect.h"
+#include "GameException.h"
+#include "Mesh.h"
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(InstancedEffect)
+
+	InstancedEffect::InstancedEffect()
+		: ShaderProgram()
+	{
+	}
+
+	void InstancedEffect::Initialize(GLuint vertexArrayObject)
+	{
+		ShaderProgram::Initialize(vertexArrayObject);
+
+		glVertexAttribPointer(VertexAttributePosition, 4, GL_FLOAT, GL_FALSE, sizeof(VertexPositionNormal), (void*)offsetof(VertexPositionNormal, Position));
+		glEnableVertexAttribArray(VertexAttributePosition);
+
+		glVertexAttribPointer(VertexAttributeNormal, 3, GL_FLOAT, GL_FALSE, sizeof(VertexPositionNormal), (void*)offsetof(VertexPositionNormal, Normal));
+		glEnableVertexAttribArray(VertexAttributeNormal);
+	}
+
+	void InstancedEffect::InitializeInstanceAttributes()
+	{
+		// Sourced from the buffer bound to GL_ARRAY_BUFFER, advancing once per instance; the world matrix spans four locations
+		for (UINT column = 0; column < 4; column++)
+		{
+			GLuint location = VertexAttributeWorld + column;
+			glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceWorldColor), (void*)(offsetof(InstanceWorldColor, World) + sizeof(vec4) * column));
+			glVertexAttribDivisor(location, 1);
+			glEnableVertexAttribArray(location);
+		}
+
+		glVertexAttribPointer(VertexAttributeColor, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceWorldColor), (void*)offsetof(InstanceWorldColor, Color));
+		glVertexAttribDivisor(VertexAttributeColor, 1);
+		glEnableVertexAttribArray(VertexAttributeColor);
+	}
+
+	void InstancedEffect::CreateVertexBuffer(const Mesh& mesh, GLuint& vertexBuffer) const
+	{
+		const std::vector<vec3>& sourceVertices = mesh.Vertices();
+
+		const std::vector<vec3>& normals = mesh.Normals();
+		assert(normals.size() == sourceVertices.size());
+
+		std::vector<VertexPositionNormal> vertices;
+		vertices.reserve(sourceVertices.size());
+		for (UINT i = 0; i < sourceVertices.size(); i++)
+		{
+			vec3 position = sourceVertices.at(i);
+			vec3 normal = normals.at(i);
+			vertices.push_back(VertexPositionNormal(vec4(position.x, position.y, position.z, 1.0f), normal));
+		}
+
+		CreateVertexBuffer(&vertices[0], vertices.size(), vertexBuffer);
+	}
+
+	void InstancedEffect::CreateVertexBuffer(VertexPositionNormal* vertices, UINT vertexCount, GLuint& vertexBuffer) const
+	{
+		glGenBuffers(1, &vertexBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, VertexSize() * vertexCount, &vertices[0], GL_STATIC_DRAW);
+	}
+
+	UINT InstancedEffect::VertexSize() const
+	{
+		return sizeof(VertexPositionNormal);
+	}
+
+	UINT InstancedEffect::InstanceSize() const
+	{
+		return sizeof(InstanceWorldColor);
+	}
+}
\ No newline at end of file
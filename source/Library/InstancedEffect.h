@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Common.h"
+#include "ShaderProgram.h"
+#include "VertexDeclarations.h"
+
+namespace Library
+{
+	class InstancedEffect : public ShaderProgram
+	{
+		RTTI_DECLARATIONS(InstancedEffect, ShaderProgram)
+
+	public:
+		InstancedEffect();
+
+		virtual void Initialize(GLuint vertexArrayObject) override;
+		void InitializeInstanceAttributes();
+		virtual void CreateVertexBuffer(const Mesh& mesh, GLuint& vertexBuffer) const override;
+		void CreateVertexBuffer(VertexPositionNormal* vertices, UINT vertexCount, GLuint& vertexBuffer) const;
+		virtual UINT VertexSize() const override;
+		UINT InstanceSize() const;
+
+	private:
+		InstancedEffect(const InstancedEffect& rhs);
+		InstancedEffect& operator=(const InstancedEffect& rhs);
+
+		enum VertexAttribute
+		{
+			VertexAttributePosition = 0,
+			VertexAttributeNormal = 1,
+			VertexAttributeWorld = 2,
+			VertexAttributeColor = 6
+		};
+	};
+}
\ No newline at end of file
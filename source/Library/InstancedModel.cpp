@@ -0,0 +1,168 @@
+#include "InstancedModel.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Camera.h"
+#include "Model.h"
+#include "Mesh.h"
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(InstancedModel)
+
+	InstancedModel::InstancedModel(Game& game, Camera& camera, const std::string& modelFileName)
+		: DrawableGameComponent(game, camera),
+		  mModelFileName(modelFileName), mShaderProgram(), mMeshes(), mInstanceBuffer(0), mInstanceCapacity(0),
+		  mInstances(), mSphereBounds(), mVisibleInstanceCount(0)
+	{
+	}
+
+	InstancedModel::~InstancedModel()
+	{
+		for (MeshBuffers& mesh : mMeshes)
+		{
+			glDeleteBuffers(1, &mesh.IndexBuffer);
+			glDeleteBuffers(1, &mesh.VertexBuffer);
+			glDeleteVertexArrays(1, &mesh.VertexArray);
+		}
+
+		glDeleteBuffers(1, &mInstanceBuffer);
+	}
+
+	std::vector<InstanceWorldColor>& InstancedModel::Instances()
+	{
+		return mInstances;
+	}
+
+	UINT InstancedModel::AddInstance(const mat4& world, const vec4& color)
+	{
+		mInstances.push_back(InstanceWorldColor(world, color));
+
+		return mInstances.size() - 1;
+	}
+
+	void InstancedModel::ClearInstances()
+	{
+		mInstances.clear();
+	}
+
+	UINT InstancedModel::InstanceCount() const
+	{
+		return mInstances.size();
+	}
+
+	UINT InstancedModel::VisibleInstanceCount() const
+	{
+		return mVisibleInstanceCount;
+	}
+
+	void InstancedModel::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content/Effects/InstancedEffect.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content/Effects/InstancedEffect.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
+	void InstancedModel::Initialize()
+	{
+		// Build the shader program
+		BuildPrograms();
+
+		std::unique_ptr<Model> model(new Model(*mGame, mModelFileName, true));
+
+		// The instance buffer is shared by every mesh and refilled each frame
+		glGenBuffers(1, &mInstanceBuffer);
+
+		for (Mesh* mesh : model->Meshes())
+		{
+			MeshBuffers buffers;
+			mShaderProgram.CreateVertexBuffer(*mesh, buffers.VertexBuffer);
+			mesh->CreateIndexBuffer(buffers.IndexBuffer);
+			buffers.IndexCount = mesh->Indices().size();
+
+			// Create the vertex array object
+			glGenVertexArrays(1, &buffers.VertexArray);
+			mShaderProgram.Initialize(buffers.VertexArray);
+			glBindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+			mShaderProgram.InitializeInstanceAttributes();
+			glBindVertexArray(0);
+
+			mMeshes.push_back(buffers);
+		}
+
+		// The model-space sphere; each instance carries it through its own transform
+		mSphereBounds = model->SphereBounds();
+	}
+
+	void InstancedModel::Draw(const GameTime& gameTime)
+	{
+		mVisibleInstanceCount = 0;
+		if (mInstances.empty() || mMeshes.empty())
+		{
+			return;
+		}
+
+		RenderStateCache& renderStates = mGame->RenderStates();
+		renderStates.BindBuffer(GL_ARRAY_BUFFER, mInstanceBuffer);
+
+		if (mInstances.size() > mInstanceCapacity)
+		{
+			mInstanceCapacity = mInstances.size();
+			glBufferData(GL_ARRAY_BUFFER, mShaderProgram.InstanceSize() * mInstanceCapacity, nullptr, GL_STREAM_DRAW);
+		}
+
+		// Invalidating orphans last frame's storage, so the map never waits on draws still in flight
+		void* instanceData = glMapBufferRange(GL_ARRAY_BUFFER, 0, mShaderProgram.InstanceSize() * mInstances.size(), GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+		if (instanceData == nullptr)
+		{
+			throw GameException("InstancedModel::Draw() glMapBufferRange() failed.");
+		}
+
+		float nearestDepth;
+		mVisibleInstanceCount = CullInstances(static_cast<InstanceWorldColor*>(instanceData), nearestDepth);
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+
+		if (mVisibleInstanceCount == 0)
+		{
+			return;
+		}
+
+		for (const MeshBuffers& mesh : mMeshes)
+		{
+			DrawItem drawItem;
+			drawItem.Program = &mShaderProgram;
+			drawItem.VertexArray = mesh.VertexArray;
+			drawItem.VertexBuffer = mesh.VertexBuffer;
+			drawItem.IndexBuffer = mesh.IndexBuffer;
+			drawItem.Count = mesh.IndexCount;
+			drawItem.InstanceCount = mVisibleInstanceCount;
+			drawItem.Depth = nearestDepth;
+
+			mGame->DrawQueue().Submit(drawItem);
+		}
+	}
+
+	UINT InstancedModel::CullInstances(InstanceWorldColor* visibleInstances, float& nearestDepth) const
+	{
+		UINT visibleCount = 0;
+		nearestDepth = FLT_MAX;
+
+		const Frustum& frustum = mCamera->ViewFrustum();
+		for (const InstanceWorldColor& instance : mInstances)
+		{
+			BoundingSphere sphere = mSphereBounds.Transform(instance.World);
+			if (frustum.Intersects(sphere))
+			{
+				// Written straight into the mapped buffer, in order, so the visible set stays packed
+				visibleInstances[visibleCount++] = instance;
+
+				float depth = RenderQueue::ViewDepth(*mCamera, sphere.Center) - sphere.Radius;
+				nearestDepth = (depth < nearestDepth ? depth : nearestDepth);
+			}
+		}
+
+		return visibleCount;
+	}
+}
\ No newline at end of file
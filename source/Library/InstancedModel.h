@@ -0,0 +1,56 @@
+#pragma once
+
+#include "DrawableGameComponent.h"
+#include "InstancedEffect.h"
+#include "BoundingVolume.h"
+#include "ColorHelper.h"
+
+namespace Library
+{
+	// Draws every instance of a model with one instanced draw per mesh. Instances outside the camera
+	// frustum are culled on the CPU and the survivors are packed into the instance buffer. Transforms and
+	// lighting come from the shared FrameData/LightData blocks, so the game must feed FrameConstants.
+	class InstancedModel : public DrawableGameComponent
+	{
+		RTTI_DECLARATIONS(InstancedModel, DrawableGameComponent)
+
+	public:
+		InstancedModel(Game& game, Camera& camera, const std::string& modelFileName);
+		~InstancedModel();
+
+		std::vector<InstanceWorldColor>& Instances();
+		UINT AddInstance(const glm::mat4& world, const glm::vec4& color = ColorHelper::White);
+		void ClearInstances();
+
+		UINT InstanceCount() const;
+		UINT VisibleInstanceCount() const;
+
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
+		virtual void Initialize() override;
+		virtual void Draw(const GameTime& gameTime) override;
+
+	private:
+		InstancedModel();
+		InstancedModel(const InstancedModel& rhs);
+		InstancedModel& operator=(const InstancedModel& rhs);
+
+		struct MeshBuffers
+		{
+			GLuint VertexArray;
+			GLuint VertexBuffer;
+			GLuint IndexBuffer;
+			UINT IndexCount;
+		};
+
+		UINT CullInstances(InstanceWorldColor* visibleInstances, float& nearestDepth) const;
+
+		std::string mModelFileName;
+		InstancedEffect mShaderProgram;
+		std::vector<MeshBuffers> mMeshes;
+		GLuint mInstanceBuffer;
+		UINT mInstanceCapacity;
+		std::vector<InstanceWorldColor> mInstances;
+		BoundingSphere mSphereBounds;
+		UINT mVisibleInstanceCount;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#include "JobSystem.h"
+#include <algorithm>
+#include <future>
+#include <thread>
+
+namespace Library
+{
+	UINT JobSystem::WorkerCount()
+	{
+		UINT workerCount = std::thread::hardware_concurrency();
+		return (workerCount > 0 ? workerCount : 1);
+	}
+
+	void JobSystem::ParallelFor(UINT count, UINT minimumPerWorker, const std::function<void(UINT, UINT)>& job)
+	{
+		UINT workerCount = std::min<UINT>(WorkerCount(), count / std::max<UINT>(minimumPerWorker, 1));
+		if (workerCount <= 1)
+		{
+			if (count > 0)
+			{
+				job(0, count);
+			}
+
+			return;
+		}
+
+		std::vector<std::future<void>> tasks;
+		tasks.reserve(workerCount);
+
+		// The calling thread takes the last chunk rather than idling on the join
+		UINT chunkSize = (count + workerCount - 1) / workerCount;
+		UINT begin = 0;
+		for (; begin + chunkSize < count; begin += chunkSize)
+		{
+			tasks.push_back(std::async(std::launch::async, job, begin, begin + chunkSize));
+		}
+
+		job(begin, count);
+
+		for (std::future<void>& task : tasks)
+		{
+			task.get();
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include "Common.h"
+#include <functional>
+
+namespace Library
+{
+	// Splits an index range into contiguous [begin, end) chunks and runs them on std::async workers, joining
+	// before it returns. Jobs must keep their writes disjoint; ranges too small to pay for a thread hop run inline.
+	class JobSystem
+	{
+	public:
+		static UINT WorkerCount();
+		static void ParallelFor(UINT count, UINT minimumPerWorker, const std::function<void(UINT, UINT)>& job);
+
+	private:
+		JobSystem();
+		JobSystem(const JobSystem& rhs);
+		JobSystem& operator=(const JobSystem& rhs);
+	};
+}
\ No newline at end of file
@@ -0,0 +1,190 @@
+#include "LZ4Helper.h"
+#include "GameException.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace Library
+{
+	// Encoder and decoder for the LZ4 block format (no frame header)
+	const size_t LZ4Helper::MinMatch = 4;
+	const size_t LZ4Helper::LastLiterals = 5;
+	const size_t LZ4Helper::MatchFindLimit = 12;
+	const size_t LZ4Helper::MaxOffset = 65535;
+	const UINT LZ4Helper::HashLog = 16;
+
+	void LZ4Helper::Compress(const char* source, size_t sourceSize, std::vector<char>& destination)
+	{
+		const unsigned char* input = reinterpret_cast<const unsigned char*>(source);
+		destination.clear();
+		destination.reserve(sourceSize + sourceSize / 255 + 16);
+
+		size_t anchor = 0;
+		size_t position = 0;
+
+		if (sourceSize > MatchFindLimit)
+		{
+			std::vector<size_t> hashTable(1 << HashLog, SIZE_MAX);
+			size_t matchStartLimit = sourceSize - MatchFindLimit;
+			size_t matchEndLimit = sourceSize - LastLiterals;
+
+			while (position <= matchStartLimit)
+			{
+				UINT sequence;
+				memcpy(&sequence, input + position, sizeof(sequence));
+				UINT hash = (sequence * 2654435761U) >> (32 - HashLog);
+
+				size_t candidate = hashTable[hash];
+				hashTable[hash] = position;
+
+				if (candidate == SIZE_MAX || position - candidate > MaxOffset || memcmp(input + candidate, input + position, MinMatch) != 0)
+				{
+					position++;
+					continue;
+				}
+
+				size_t matchLength = MinMatch;
+				while (position + matchLength < matchEndLimit && input[candidate + matchLength] == input[position + matchLength])
+				{
+					matchLength++;
+				}
+
+				WriteSequence(input + anchor, position - anchor, position - candidate, matchLength, destination);
+
+				position += matchLength;
+				anchor = position;
+			}
+		}
+
+		// The final sequence carries the remaining literals and no match
+		size_t literalLength = sourceSize - anchor;
+		destination.push_back(static_cast<char>(std::min<size_t>(literalLength, 15) << 4));
+		if (literalLength >= 15)
+		{
+			WriteLength(literalLength - 15, destination);
+		}
+
+		destination.insert(destination.end(), source + anchor, source + sourceSize);
+	}
+
+	void LZ4Helper::Decompress(const char* source, size_t sourceSize, char* destination, size_t destinationSize)
+	{
+		const unsigned char* input = reinterpret_cast<const unsigned char*>(source);
+		const unsigned char* inputEnd = input + sourceSize;
+		size_t output = 0;
+
+		while (input < inputEnd)
+		{
+			UINT token = *input++;
+
+			size_t literalLength = token >> 4;
+			if (literalLength == 15)
+			{
+				UINT lengthByte;
+				do
+				{
+					if (input >= inputEnd)
+					{
+						throw GameException("LZ4Helper::Decompress() truncated literal length.");
+					}
+
+					lengthByte = *input++;
+					literalLength += lengthByte;
+				} while (lengthByte == 255);
+			}
+
+			if (literalLength > static_cast<size_t>(inputEnd - input) || literalLength > destinationSize - output)
+			{
+				throw GameException("LZ4Helper::Decompress() literals overrun the buffer.");
+			}
+
+			memcpy(destination + output, input, literalLength);
+			input += literalLength;
+			output += literalLength;
+
+			if (input >= inputEnd)
+			{
+				break;
+			}
+
+			if (inputEnd - input < 2)
+			{
+				throw GameException("LZ4Helper::Decompress() truncated match offset.");
+			}
+
+			size_t offset = input[0] | (input[1] << 8);
+			input += 2;
+			if (offset == 0 || offset > output)
+			{
+				throw GameException("LZ4Helper::Decompress() invalid match offset.");
+			}
+
+			size_t matchLength = token & 0x0F;
+			if (matchLength == 15)
+			{
+				UINT lengthByte;
+				do
+				{
+					if (input >= inputEnd)
+					{
+						throw GameException("LZ4Helper::Decompress() truncated match length.");
+					}
+
+					lengthByte = *input++;
+					matchLength += lengthByte;
+				} while (lengthByte == 255);
+			}
+
+			matchLength += MinMatch;
+			if (matchLength > destinationSize - output)
+			{
+				throw GameException("LZ4Helper::Decompress() match overruns the buffer.");
+			}
+
+			// Matches may overlap their own output, so copy byte by byte
+			char* match = destination + output - offset;
+			for (size_t i = 0; i < matchLength; i++)
+			{
+				destination[output + i] = match[i];
+			}
+
+			output += matchLength;
+		}
+
+		if (output != destinationSize)
+		{
+			throw GameException("LZ4Helper::Decompress() size mismatch.");
+		}
+	}
+
+	void LZ4Helper::WriteLength(size_t length, std::vector<char>& destination)
+	{
+		while (length >= 255)
+		{
+			destination.push_back(static_cast<char>(255));
+			length -= 255;
+		}
+
+		destination.push_back(static_cast<char>(length));
+	}
+
+	void LZ4Helper::WriteSequence(const unsigned char* literals, size_t literalLength, size_t offset, size_t matchLength, std::vector<char>& destination)
+	{
+		size_t encodedMatchLength = matchLength - MinMatch;
+		destination.push_back(static_cast<char>((std::min<size_t>(literalLength, 15) << 4) | std::min<size_t>(encodedMatchLength, 15)));
+
+		if (literalLength >= 15)
+		{
+			WriteLength(literalLength - 15, destination);
+		}
+
+		destination.insert(destination.end(), reinterpret_cast<const char*>(literals), reinterpret_cast<const char*>(literals) + literalLength);
+
+		destination.push_back(static_cast<char>(offset & 0xFF));
+		destination.push_back(static_cast<char>((offset >> 8) & 0xFF));
+
+		if (encodedMatchLength >= 15)
+		{
+			WriteLength(encodedMatchLength - 15, destination);
+		}
+	}
+}
\ No newline at end of file
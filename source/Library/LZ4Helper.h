@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Common.h"
+
+namespace Library
+{
+	class LZ4Helper
+	{
+	public:
+		static void Compress(const char* source, size_t sourceSize, std::vector<char>& destination);
+		static void Decompress(const char* source, size_t sourceSize, char* destination, size_t destinationSize);
+
+	private:
+		static void WriteLength(size_t length, std::vector<char>& destination);
+		static void WriteSequence(const unsigned char* literals, size_t literalLength, size_t offset, size_t matchLength, std::vector<char>& destination);
+
+		static const size_t MinMatch;
+		static const size_t LastLiterals;
+		static const size_t MatchFindLimit;
+		static const size_t MaxOffset;
+		static const UINT HashLog;
+
+		LZ4Helper();
+		LZ4Helper(const LZ4Helper& rhs);
+		LZ4Helper& operator=(const LZ4Helper& rhs);
+	};
+}
\ No newline at end of file
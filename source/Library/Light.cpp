@@ -5,6 +5,11 @@ namespace Library
 {
 	RTTI_DEFINITIONS(Light)
 
+	Light::Light()
+		: GameComponent(), mColor(ColorHelper::White)
+	{
+	}
+
 	Light::Light(Game& game)
 		: GameComponent(game), mColor(ColorHelper::White)
 	{
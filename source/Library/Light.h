@@ -10,6 +10,7 @@ namespace Library
 		RTTI_DECLARATIONS(Light, GameComponent)
 
 	public:
+		Light();
 		Light(Game& game);
 		virtual ~Light();
 
@@ -1,9 +1,23 @@
 #include "MatrixHelper.h"
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// MSVC emits AVX2 intrinsics in any translation unit; other compilers need the kernels tagged
+#if defined(_MSC_VER)
+#define SIMD_TARGET_AVX2
+#else
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
 
 using namespace glm;
 
 namespace Library
 {
+	const SimdLevel MatrixHelper::sSupportedSimdLevel = MatrixHelper::DetectSimdLevel();
+	SimdLevel MatrixHelper::sSimdLevel = MatrixHelper::sSupportedSimdLevel;
+
 	void MatrixHelper::GetForward(mat4& matrix, vec3& vector)
 	{
 		vec4 m3 = matrix[2];
@@ -83,4 +97,364 @@ namespace Library
 
 		matrix[3] = m4;
 	}
+
+	void MatrixHelper::Decompose(const mat4& matrix, vec3& translation, quat& rotation, vec3& scale)
+	{
+		// Shear is not representable and is dropped; a mirrored basis is carried by a negative x scale
+		vec3 right(matrix[0]);
+		vec3 up(matrix[1]);
+		vec3 backward(matrix[2]);
+		scale = vec3(length(right), length(up), length(backward));
+		if (dot(cross(right, up), backward) < 0.0f)
+		{
+			scale.x = -scale.x;
+		}
+
+		translation = vec3(matrix[3]);
+		rotation = quat_cast(mat3(right / scale.x, up / scale.y, backward / scale.z));
+	}
+
+	mat4 MatrixHelper::Compose(const vec3& translation, const quat& rotation, const vec3& scale)
+	{
+		mat4 matrix = mat4_cast(rotation);
+		matrix[0] *= scale.x;
+		matrix[1] *= scale.y;
+		matrix[2] *= scale.z;
+		matrix[3] = vec4(translation, 1.0f);
+
+		return matrix;
+	}
+
+	SimdLevel MatrixHelper::SupportedSimdLevel()
+	{
+		return sSupportedSimdLevel;
+	}
+
+	SimdLevel MatrixHelper::ActiveSimdLevel()
+	{
+		return sSimdLevel;
+	}
+
+	void MatrixHelper::SetSimdLevel(SimdLevel level)
+	{
+		// Lowering the level is how the kernels are checked against each other; raising it past the CPU is refused
+		sSimdLevel = (level < sSupportedSimdLevel ? level : sSupportedSimdLevel);
+	}
+
+	void MatrixHelper::TransformPoints(const mat4& matrix, const vec3* points, vec3* results, UINT count)
+	{
+		switch (sSimdLevel)
+		{
+			case SimdLevelAvx2:
+				TransformAvx2(matrix, points, results, count, 1.0f);
+				break;
+
+			case SimdLevelSse:
+				TransformSse(matrix, points, results, count, 1.0f);
+				break;
+
+			default:
+				TransformScalar(matrix, points, results, count, 1.0f);
+				break;
+		}
+	}
+
+	void MatrixHelper::TransformPoints(const mat4& matrix, const vec3* points, vec4* results, UINT count)
+	{
+		switch (sSimdLevel)
+		{
+			case SimdLevelAvx2:
+				TransformHomogeneousAvx2(matrix, points, results, count);
+				break;
+
+			case SimdLevelSse:
+				TransformHomogeneousSse(matrix, points, results, count);
+				break;
+
+			default:
+				TransformHomogeneousScalar(matrix, points, results, count);
+				break;
+		}
+	}
+
+	void MatrixHelper::TransformDirections(const mat4& matrix, const vec3* directions, vec3* results, UINT count)
+	{
+		switch (sSimdLevel)
+		{
+			case SimdLevelAvx2:
+				TransformAvx2(matrix, directions, results, count, 0.0f);
+				break;
+
+			case SimdLevelSse:
+				TransformSse(matrix, directions, results, count, 0.0f);
+				break;
+
+			default:
+				TransformScalar(matrix, directions, results, count, 0.0f);
+				break;
+		}
+	}
+
+	void MatrixHelper::MultiplyMatrices(const mat4* lefts, const mat4* rights, mat4* results, UINT count)
+	{
+		switch (sSimdLevel)
+		{
+			case SimdLevelAvx2:
+				MultiplyAvx2(lefts, 1, rights, results, count);
+				break;
+
+			case SimdLevelSse:
+				MultiplySse(lefts, 1, rights, results, count);
+				break;
+
+			default:
+				MultiplyScalar(lefts, 1, rights, results, count);
+				break;
+		}
+	}
+
+	void MatrixHelper::MultiplyMatrices(const mat4& left, const mat4* rights, mat4* results, UINT count)
+	{
+		// A zero stride keeps the shared left-hand matrix in registers for the whole batch
+		switch (sSimdLevel)
+		{
+			case SimdLevelAvx2:
+				MultiplyAvx2(&left, 0, rights, results, count);
+				break;
+
+			case SimdLevelSse:
+				MultiplySse(&left, 0, rights, results, count);
+				break;
+
+			default:
+				MultiplyScalar(&left, 0, rights, results, count);
+				break;
+		}
+	}
+
+	void MatrixHelper::ComputeWorldViewProjections(const mat4& viewProjection, const mat4* worlds, mat4* results, UINT count)
+	{
+		MultiplyMatrices(viewProjection, worlds, results, count);
+	}
+
+	SimdLevel MatrixHelper::DetectSimdLevel()
+	{
+#if defined(_MSC_VER)
+		int info[4];
+		__cpuid(info, 0);
+		int maxLeaf = info[0];
+
+		__cpuid(info, 1);
+		bool sse2 = ((info[3] & (1 << 26)) != 0);
+		bool fma = ((info[2] & (1 << 12)) != 0);
+		bool osxsave = ((info[2] & (1 << 27)) != 0);
+		bool avx = ((info[2] & (1 << 28)) != 0);
+
+		bool avx2 = false;
+		if (maxLeaf >= 7)
+		{
+			__cpuidex(info, 7, 0);
+			avx2 = ((info[1] & (1 << 5)) != 0);
+		}
+
+		// The OS must also save the upper YMM halves across context switches
+		if (fma && osxsave && avx && avx2 && (_xgetbv(0) & 0x6) == 0x6)
+		{
+			return SimdLevelAvx2;
+		}
+
+		return (sse2 ? SimdLevelSse : SimdLevelScalar);
+#else
+		__builtin_cpu_init();
+		if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+		{
+			return SimdLevelAvx2;
+		}
+
+		return (__builtin_cpu_supports("sse2") ? SimdLevelSse : SimdLevelScalar);
+#endif
+	}
+
+	void MatrixHelper::TransformScalar(const mat4& matrix, const vec3* vectors, vec3* results, UINT count, float w)
+	{
+		for (UINT i = 0; i < count; i++)
+		{
+			results[i] = vec3(matrix * vec4(vectors[i], w));
+		}
+	}
+
+	void MatrixHelper::TransformSse(const mat4& matrix, const vec3* vectors, vec3* results, UINT count, float w)
+	{
+		__m128 column0 = _mm_loadu_ps(&matrix[0][0]);
+		__m128 column1 = _mm_loadu_ps(&matrix[1][0]);
+		__m128 column2 = _mm_loadu_ps(&matrix[2][0]);
+		__m128 column3 = _mm_mul_ps(_mm_loadu_ps(&matrix[3][0]), _mm_set1_ps(w));
+
+		for (UINT i = 0; i < count; i++)
+		{
+			const vec3& vector = vectors[i];
+			__m128 result = _mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(vector.x)), column3);
+			result = _mm_add_ps(result, _mm_mul_ps(column1, _mm_set1_ps(vector.y)));
+			result = _mm_add_ps(result, _mm_mul_ps(column2, _mm_set1_ps(vector.z)));
+
+			// Three-float stores, so the element after the last result is never touched
+			_mm_storel_pi(reinterpret_cast<__m64*>(&results[i].x), result);
+			_mm_store_ss(&results[i].z, _mm_movehl_ps(result, result));
+		}
+	}
+
+	SIMD_TARGET_AVX2 void MatrixHelper::TransformAvx2(const mat4& matrix, const vec3* vectors, vec3* results, UINT count, float w)
+	{
+		__m256 column0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[0][0]));
+		__m256 column1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[1][0]));
+		__m256 column2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[2][0]));
+		__m256 column3 = _mm256_mul_ps(_mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[3][0])), _mm256_set1_ps(w));
+
+		// Two vectors per iteration: six packed floats are masked in, splatted per lane, and the six results masked out
+		const __m256i pairMask = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+		const __m256i splatX = _mm256_setr_epi32(0, 0, 0, 0, 3, 3, 3, 3);
+		const __m256i splatY = _mm256_setr_epi32(1, 1, 1, 1, 4, 4, 4, 4);
+		const __m256i splatZ = _mm256_setr_epi32(2, 2, 2, 2, 5, 5, 5, 5);
+		const __m256i pack = _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 0, 0);
+
+		UINT pairCount = count & ~1U;
+		for (UINT i = 0; i < pairCount; i += 2)
+		{
+			__m256 pair = _mm256_maskload_ps(&vectors[i].x, pairMask);
+			__m256 result = _mm256_fmadd_ps(column0, _mm256_permutevar8x32_ps(pair, splatX), column3);
+			result = _mm256_fmadd_ps(column1, _mm256_permutevar8x32_ps(pair, splatY), result);
+			result = _mm256_fmadd_ps(column2, _mm256_permutevar8x32_ps(pair, splatZ), result);
+			_mm256_maskstore_ps(&results[i].x, pairMask, _mm256_permutevar8x32_ps(result, pack));
+		}
+
+		// Clear the upper YMM halves first, or every legacy SSE instruction in the tail pays a transition penalty
+		if (pairCount < count)
+		{
+			_mm256_zeroupper();
+			TransformSse(matrix, vectors + pairCount, results + pairCount, count - pairCount, w);
+		}
+	}
+
+	void MatrixHelper::TransformHomogeneousScalar(const mat4& matrix, const vec3* points, vec4* results, UINT count)
+	{
+		for (UINT i = 0; i < count; i++)
+		{
+			results[i] = matrix * vec4(points[i], 1.0f);
+		}
+	}
+
+	void MatrixHelper::TransformHomogeneousSse(const mat4& matrix, const vec3* points, vec4* results, UINT count)
+	{
+		__m128 column0 = _mm_loadu_ps(&matrix[0][0]);
+		__m128 column1 = _mm_loadu_ps(&matrix[1][0]);
+		__m128 column2 = _mm_loadu_ps(&matrix[2][0]);
+		__m128 column3 = _mm_loadu_ps(&matrix[3][0]);
+
+		for (UINT i = 0; i < count; i++)
+		{
+			const vec3& point = points[i];
+			__m128 result = _mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(point.x)), column3);
+			result = _mm_add_ps(result, _mm_mul_ps(column1, _mm_set1_ps(point.y)));
+			result = _mm_add_ps(result, _mm_mul_ps(column2, _mm_set1_ps(point.z)));
+			_mm_storeu_ps(&results[i].x, result);
+		}
+	}
+
+	SIMD_TARGET_AVX2 void MatrixHelper::TransformHomogeneousAvx2(const mat4& matrix, const vec3* points, vec4* results, UINT count)
+	{
+		__m256 column0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[0][0]));
+		__m256 column1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[1][0]));
+		__m256 column2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[2][0]));
+		__m256 column3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&matrix[3][0]));
+
+		const __m256i pairMask = _mm256_setr_epi32(-1, -1, -1, -1, -1, -1, 0, 0);
+		const __m256i splatX = _mm256_setr_epi32(0, 0, 0, 0, 3, 3, 3, 3);
+		const __m256i splatY = _mm256_setr_epi32(1, 1, 1, 1, 4, 4, 4, 4);
+		const __m256i splatZ = _mm256_setr_epi32(2, 2, 2, 2, 5, 5, 5, 5);
+
+		UINT pairCount = count & ~1U;
+		for (UINT i = 0; i < pairCount; i += 2)
+		{
+			__m256 pair = _mm256_maskload_ps(&points[i].x, pairMask);
+			__m256 result = _mm256_fmadd_ps(column0, _mm256_permutevar8x32_ps(pair, splatX), column3);
+			result = _mm256_fmadd_ps(column1, _mm256_permutevar8x32_ps(pair, splatY), result);
+			result = _mm256_fmadd_ps(column2, _mm256_permutevar8x32_ps(pair, splatZ), result);
+			_mm256_storeu_ps(&results[i].x, result);
+		}
+
+		if (pairCount < count)
+		{
+			_mm256_zeroupper();
+			TransformHomogeneousSse(matrix, points + pairCount, results + pairCount, count - pairCount);
+		}
+	}
+
+	void MatrixHelper::MultiplyScalar(const mat4* lefts, UINT leftStride, const mat4* rights, mat4* results, UINT count)
+	{
+		for (UINT i = 0; i < count; i++)
+		{
+			results[i] = lefts[i * leftStride] * rights[i];
+		}
+	}
+
+	void MatrixHelper::MultiplySse(const mat4* lefts, UINT leftStride, const mat4* rights, mat4* results, UINT count)
+	{
+		for (UINT i = 0; i < count; i++)
+		{
+			const float* left = &lefts[i * leftStride][0][0];
+			__m128 left0 = _mm_loadu_ps(left);
+			__m128 left1 = _mm_loadu_ps(left + 4);
+			__m128 left2 = _mm_loadu_ps(left + 8);
+			__m128 left3 = _mm_loadu_ps(left + 12);
+
+			// Both operands are read before anything is written, so results may alias either input
+			const float* right = &rights[i][0][0];
+			__m128 columns[4];
+			for (UINT j = 0; j < 4; j++)
+			{
+				__m128 column = _mm_loadu_ps(right + j * 4);
+				__m128 result = _mm_mul_ps(left0, _mm_shuffle_ps(column, column, _MM_SHUFFLE(0, 0, 0, 0)));
+				result = _mm_add_ps(result, _mm_mul_ps(left1, _mm_shuffle_ps(column, column, _MM_SHUFFLE(1, 1, 1, 1))));
+				result = _mm_add_ps(result, _mm_mul_ps(left2, _mm_shuffle_ps(column, column, _MM_SHUFFLE(2, 2, 2, 2))));
+				columns[j] = _mm_add_ps(result, _mm_mul_ps(left3, _mm_shuffle_ps(column, column, _MM_SHUFFLE(3, 3, 3, 3))));
+			}
+
+			float* output = &results[i][0][0];
+			for (UINT j = 0; j < 4; j++)
+			{
+				_mm_storeu_ps(output + j * 4, columns[j]);
+			}
+		}
+	}
+
+	SIMD_TARGET_AVX2 void MatrixHelper::MultiplyAvx2(const mat4* lefts, UINT leftStride, const mat4* rights, mat4* results, UINT count)
+	{
+		for (UINT i = 0; i < count; i++)
+		{
+			const float* left = &lefts[i * leftStride][0][0];
+			__m256 left0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left));
+			__m256 left1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left + 4));
+			__m256 left2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left + 8));
+			__m256 left3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left + 12));
+
+			// Two result columns per register; the in-lane shuffles splat each right-hand element across its column
+			const float* right = &rights[i][0][0];
+			__m256 columns01 = _mm256_loadu_ps(right);
+			__m256 columns23 = _mm256_loadu_ps(right + 8);
+
+			__m256 result01 = _mm256_mul_ps(left0, _mm256_shuffle_ps(columns01, columns01, _MM_SHUFFLE(0, 0, 0, 0)));
+			result01 = _mm256_fmadd_ps(left1, _mm256_shuffle_ps(columns01, columns01, _MM_SHUFFLE(1, 1, 1, 1)), result01);
+			result01 = _mm256_fmadd_ps(left2, _mm256_shuffle_ps(columns01, columns01, _MM_SHUFFLE(2, 2, 2, 2)), result01);
+			result01 = _mm256_fmadd_ps(left3, _mm256_shuffle_ps(columns01, columns01, _MM_SHUFFLE(3, 3, 3, 3)), result01);
+
+			__m256 result23 = _mm256_mul_ps(left0, _mm256_shuffle_ps(columns23, columns23, _MM_SHUFFLE(0, 0, 0, 0)));
+			result23 = _mm256_fmadd_ps(left1, _mm256_shuffle_ps(columns23, columns23, _MM_SHUFFLE(1, 1, 1, 1)), result23);
+			result23 = _mm256_fmadd_ps(left2, _mm256_shuffle_ps(columns23, columns23, _MM_SHUFFLE(2, 2, 2, 2)), result23);
+			result23 = _mm256_fmadd_ps(left3, _mm256_shuffle_ps(columns23, columns23, _MM_SHUFFLE(3, 3, 3, 3)), result23);
+
+			float* output = &results[i][0][0];
+			_mm256_storeu_ps(output, result01);
+			_mm256_storeu_ps(output + 8, result23);
+		}
+	}
 }
\ No newline at end of file
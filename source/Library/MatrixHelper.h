@@ -1,9 +1,17 @@
 #pragma once
 
 #include "Common.h"
+#include "glm/gtc/quaternion.hpp"
 
 namespace Library
 {
+	enum SimdLevel
+	{
+		SimdLevelScalar = 0,
+		SimdLevelSse,
+		SimdLevelAvx2
+	};
+
 	class MatrixHelper
 	{
 	public:
@@ -17,9 +25,40 @@ namespace Library
 		static void SetRight(glm::mat4& matrix, glm::vec3& right);
 		static void SetTranslation(glm::mat4& matrix, glm::vec3& translation);
 
+		static void Decompose(const glm::mat4& matrix, glm::vec3& translation, glm::quat& rotation, glm::vec3& scale);
+		static glm::mat4 Compose(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale);
+
+		// Batched kernels, dispatched to AVX2/FMA or SSE when the CPU has them and to plain glm otherwise.
+		// Results may alias their inputs only when both point at the same element type.
+		static SimdLevel SupportedSimdLevel();
+		static SimdLevel ActiveSimdLevel();
+		static void SetSimdLevel(SimdLevel level);
+
+		static void TransformPoints(const glm::mat4& matrix, const glm::vec3* points, glm::vec3* results, UINT count);
+		static void TransformPoints(const glm::mat4& matrix, const glm::vec3* points, glm::vec4* results, UINT count);
+		static void TransformDirections(const glm::mat4& matrix, const glm::vec3* directions, glm::vec3* results, UINT count);
+		static void MultiplyMatrices(const glm::mat4* lefts, const glm::mat4* rights, glm::mat4* results, UINT count);
+		static void MultiplyMatrices(const glm::mat4& left, const glm::mat4* rights, glm::mat4* results, UINT count);
+		static void ComputeWorldViewProjections(const glm::mat4& viewProjection, const glm::mat4* worlds, glm::mat4* results, UINT count);
+
 	private:
 		MatrixHelper();
 		MatrixHelper(const MatrixHelper& rhs);
 		MatrixHelper& operator=(const MatrixHelper& rhs);
+
+		static SimdLevel DetectSimdLevel();
+
+		static void TransformScalar(const glm::mat4& matrix, const glm::vec3* vectors, glm::vec3* results, UINT count, float w);
+		static void TransformSse(const glm::mat4& matrix, const glm::vec3* vectors, glm::vec3* results, UINT count, float w);
+		static void TransformAvx2(const glm::mat4& matrix, const glm::vec3* vectors, glm::vec3* results, UINT count, float w);
+		static void TransformHomogeneousScalar(const glm::mat4& matrix, const glm::vec3* points, glm::vec4* results, UINT count);
+		static void TransformHomogeneousSse(const glm::mat4& matrix, const glm::vec3* points, glm::vec4* results, UINT count);
+		static void TransformHomogeneousAvx2(const glm::mat4& matrix, const glm::vec3* points, glm::vec4* results, UINT count);
+		static void MultiplyScalar(const glm::mat4* lefts, UINT leftStride, const glm::mat4* rights, glm::mat4* results, UINT count);
+		static void MultiplySse(const glm::mat4* lefts, UINT leftStride, const glm::mat4* rights, glm::mat4* results, UINT count);
+		static void MultiplyAvx2(const glm::mat4* lefts, UINT leftStride, const glm::mat4* rights, glm::mat4* results, UINT count);
+
+		static const SimdLevel sSupportedSimdLevel;
+		static SimdLevel sSimdLevel;
 	};
 }
\ No newline at end of file
@@ -8,7 +8,7 @@ namespace Library
 {
     Mesh::Mesh(Model& model, aiMesh& mesh)
         : mModel(model), mMaterial(nullptr), mName(mesh.mName.C_Str()), mVertices(), mNormals(), mTangents(), mBiNormals(), mTextureCoordinates(), mVertexColors(),
-		  mFaceCount(0), mIndices()
+		  mFaceCount(0), mIndices(), mBoneIndices(), mBoneWeights(), mBounds(), mSphereBounds()
     {
 		mMaterial = mModel.Materials().at(mesh.mMaterialIndex);
 
@@ -20,6 +20,10 @@ namespace Library
 			mVertices.push_back(glm::vec3(v.x, v.y, v.z));
         }
 
+		// Bounds are computed once at import so culling never has to revisit the vertices
+		mBounds = BoundingBox::FromPoints(mVertices);
+		mSphereBounds = BoundingSphere::FromPoints(mVertices, mBounds);
+
         // Normals
         if (mesh.HasNormals())
         {
@@ -92,6 +96,45 @@ namespace Library
                 }
             }
         }
+
+        // Bones, trimmed to the four strongest influences per vertex to fit VertexSkinnedPositionTextureNormal
+        if (mesh.HasBones())
+        {
+            mBoneIndices.assign(mesh.mNumVertices, glm::uvec4(0));
+            mBoneWeights.assign(mesh.mNumVertices, glm::vec4(0.0f));
+            for (UINT i = 0; i < mesh.mNumBones; i++)
+            {
+                aiBone* bone = mesh.mBones[i];
+                UINT boneIndex = mModel.AddBone(bone->mName.C_Str(), glm::transpose(glm::make_mat4(&bone->mOffsetMatrix.a1)));
+
+                for (UINT j = 0; j < bone->mNumWeights; j++)
+                {
+                    const aiVertexWeight& vertexWeight = bone->mWeights[j];
+                    glm::vec4& weights = mBoneWeights[vertexWeight.mVertexId];
+
+                    UINT weakest = 0;
+                    for (UINT k = 1; k < 4; k++)
+                    {
+                        weakest = (weights[k] < weights[weakest] ? k : weakest);
+                    }
+
+                    if (vertexWeight.mWeight > weights[weakest])
+                    {
+                        weights[weakest] = vertexWeight.mWeight;
+                        mBoneIndices[vertexWeight.mVertexId][weakest] = boneIndex;
+                    }
+                }
+            }
+
+            for (glm::vec4& weights : mBoneWeights)
+            {
+                float totalWeight = weights.x + weights.y + weights.z + weights.w;
+                if (totalWeight > 0.0f)
+                {
+                    weights /= totalWeight;
+                }
+            }
+        }
     }
 
     Mesh::~Mesh()
@@ -162,6 +205,31 @@ namespace Library
         return mIndices;
     }
 
+    bool Mesh::HasBones() const
+    {
+        return (mBoneIndices.size() > 0);
+    }
+
+    const std::vector<glm::uvec4>& Mesh::BoneIndices() const
+    {
+        return mBoneIndices;
+    }
+
+    const std::vector<glm::vec4>& Mesh::BoneWeights() const
+    {
+        return mBoneWeights;
+    }
+
+    const BoundingBox& Mesh::Bounds() const
+    {
+        return mBounds;
+    }
+
+    const BoundingSphere& Mesh::SphereBounds() const
+    {
+        return mSphereBounds;
+    }
+
     void Mesh::CreateIndexBuffer(GLuint& indexBuffer)
     {
 		glGenBuffers(1, &indexBuffer);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common.h"
+#include "BoundingVolume.h"
 
 struct aiMesh;
 
@@ -28,6 +29,11 @@ namespace Library
         const std::vector<std::vector<glm::vec4>*>& VertexColors() const;
         UINT FaceCount() const;
         const std::vector<UINT>& Indices() const;
+        bool HasBones() const;
+        const std::vector<glm::uvec4>& BoneIndices() const;
+        const std::vector<glm::vec4>& BoneWeights() const;
+        const BoundingBox& Bounds() const;
+        const BoundingSphere& SphereBounds() const;
 
         void CreateIndexBuffer(GLuint& indexBuffer);
 
@@ -47,5 +53,9 @@ namespace Library
         std::vector<std::vector<glm::vec4>*> mVertexColors;
         UINT mFaceCount;
         std::vector<UINT> mIndices;
+        std::vector<glm::uvec4> mBoneIndices;
+        std::vector<glm::vec4> mBoneWeights;
+        BoundingBox mBounds;
+        BoundingSphere mSphereBounds;
     };
 }
\ No newline at end of file
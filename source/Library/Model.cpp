@@ -3,16 +3,22 @@
 #include "GameException.h"
 #include "Mesh.h"
 #include "ModelMaterial.h"
+#include "AnimationClip.h"
+#include "VirtualFileSystem.h"
+#include "AssimpIOSystem.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
 
 namespace Library
 {
+	const UINT Model::NullNode = 0xFFFFFFFF;
+
     Model::Model(Game& game, const std::string& filename, bool flipUVs)
-		: mGame(game), mMeshes(), mMaterials()
+		: mGame(game), mMeshes(), mMaterials(), mNodes(), mNodeIndexMapping(), mBones(), mBoneIndexMapping(), mAnimations(), mBounds(), mSphereBounds()
     {
         Assimp::Importer importer;
+		importer.SetIOHandler(new AssimpIOSystem(VirtualFileSystem::Instance()));
 
 		UINT flags = aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_SortByPType;
         if (flipUVs)
@@ -40,8 +46,47 @@ namespace Library
             {	
 				Mesh* mesh = new Mesh(*this, *(scene->mMeshes[i]));
                 mMeshes.push_back(mesh);
+				mBounds.Merge(mesh->Bounds());
             }
         }
+
+		// Measured from the model's box center against every vertex, which is tighter than merging mesh spheres
+		float radiusSquared = 0.0f;
+		mSphereBounds.Center = mBounds.Center();
+		for (Mesh* mesh : mMeshes)
+		{
+			for (const glm::vec3& vertex : mesh->Vertices())
+			{
+				glm::vec3 offset = vertex - mSphereBounds.Center;
+				float distanceSquared = glm::dot(offset, offset);
+				radiusSquared = (distanceSquared > radiusSquared ? distanceSquared : radiusSquared);
+			}
+		}
+
+		mSphereBounds.Radius = sqrt(radiusSquared);
+
+		if (scene->mRootNode != nullptr)
+		{
+			AddNode(*(scene->mRootNode), NullNode);
+		}
+
+		// Meshes register bones by name before the node tree exists, so the nodes are resolved afterwards
+		for (ModelBone& bone : mBones)
+		{
+			bone.Node = NodeIndex(bone.Name);
+			if (bone.Node == NullNode)
+			{
+				throw GameException("Model::Model() bone has no matching node.");
+			}
+		}
+
+		if (scene->HasAnimations())
+		{
+			for (UINT i = 0; i < scene->mNumAnimations; i++)
+			{
+				mAnimations.push_back(new AnimationClip(*this, *(scene->mAnimations[i])));
+			}
+		}
 	}
 	
     Model::~Model()
@@ -55,6 +100,11 @@ namespace Library
         {
             delete material;
         }
+
+        for (AnimationClip* animation : mAnimations)
+        {
+            delete animation;
+        }
     }
 
     Game& Model::GetGame()
@@ -72,6 +122,16 @@ namespace Library
         return (mMaterials.size() > 0);
     }
 
+    bool Model::HasBones() const
+    {
+        return (mBones.size() > 0);
+    }
+
+    bool Model::HasAnimations() const
+    {
+        return (mAnimations.size() > 0);
+    }
+
     const std::vector<Mesh*>& Model::Meshes() const
     {
         return mMeshes;
@@ -81,4 +141,74 @@ namespace Library
     {
         return mMaterials;
     }
-}
+
+    const std::vector<ModelNode>& Model::Nodes() const
+    {
+        return mNodes;
+    }
+
+    const std::vector<ModelBone>& Model::Bones() const
+    {
+        return mBones;
+    }
+
+    const std::vector<AnimationClip*>& Model::Animations() const
+    {
+        return mAnimations;
+    }
+
+    UINT Model::NodeIndex(const std::string& name) const
+    {
+        std::map<std::string, UINT>::const_iterator it = mNodeIndexMapping.find(name);
+        return (it != mNodeIndexMapping.end() ? it->second : NullNode);
+    }
+
+    const BoundingBox& Model::Bounds() const
+    {
+        return mBounds;
+    }
+
+    const BoundingSphere& Model::SphereBounds() const
+    {
+        return mSphereBounds;
+    }
+
+	void Model::AddNode(const aiNode& node, UINT parent)
+	{
+		UINT index = mNodes.size();
+		mNodes.push_back(ModelNode());
+		mNodeIndexMapping.insert(std::make_pair(std::string(node.mName.C_Str()), index));
+
+		// Assimp matrices are row-major
+		ModelNode& modelNode = mNodes.back();
+		modelNode.Name = node.mName.C_Str();
+		modelNode.Parent = parent;
+		modelNode.Transform = glm::transpose(glm::make_mat4(&node.mTransformation.a1));
+		modelNode.MeshIndices.assign(node.mMeshes, node.mMeshes + node.mNumMeshes);
+
+		for (UINT i = 0; i < node.mNumChildren; i++)
+		{
+			AddNode(*(node.mChildren[i]), index);
+		}
+	}
+
+	UINT Model::AddBone(const std::string& name, const glm::mat4& offsetTransform)
+	{
+		// Bones shared by several meshes keep one index, so every mesh indexes the same palette
+		std::map<std::string, UINT>::iterator it = mBoneIndexMapping.find(name);
+		if (it != mBoneIndexMapping.end())
+		{
+			return it->second;
+		}
+
+		UINT index = mBones.size();
+		ModelBone bone;
+		bone.Name = name;
+		bone.Node = NullNode;
+		bone.OffsetTransform = offsetTransform;
+		mBones.push_back(bone);
+		mBoneIndexMapping.insert(std::make_pair(name, index));
+
+		return index;
+	}
+}
\ No newline at end of file
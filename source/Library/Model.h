@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Common.h"
+#include "BoundingVolume.h"
 
 struct aiNode;
 
@@ -11,6 +12,23 @@ namespace Library
     class ModelMaterial;
 	class AnimationClip;
 
+	// One entry of the imported node tree, stored depth-first so parents precede their children
+	struct ModelNode
+	{
+		std::string Name;
+		UINT Parent;
+		glm::mat4 Transform;
+		std::vector<UINT> MeshIndices;
+	};
+
+	// A node that deforms vertices; the offset takes mesh space into the bone's bind-pose space
+	struct ModelBone
+	{
+		std::string Name;
+		UINT Node;
+		glm::mat4 OffsetTransform;
+	};
+
     class Model
     {
 		friend class Mesh;
@@ -22,16 +40,36 @@ namespace Library
         Game& GetGame();
         bool HasMeshes() const;
         bool HasMaterials() const;
+        bool HasBones() const;
+        bool HasAnimations() const;
 
         const std::vector<Mesh*>& Meshes() const;
         const std::vector<ModelMaterial*>& Materials() const;
+        const std::vector<ModelNode>& Nodes() const;
+        const std::vector<ModelBone>& Bones() const;
+        const std::vector<AnimationClip*>& Animations() const;
+        UINT NodeIndex(const std::string& name) const;
+        const BoundingBox& Bounds() const;
+        const BoundingSphere& SphereBounds() const;
+
+		static const UINT NullNode;
 
     private:
         Model(const Model& rhs);
         Model& operator=(const Model& rhs);
 
+		void AddNode(const aiNode& node, UINT parent);
+		UINT AddBone(const std::string& name, const glm::mat4& offsetTransform);
+
         Game& mGame;
         std::vector<Mesh*> mMeshes;
         std::vector<ModelMaterial*> mMaterials;
+        std::vector<ModelNode> mNodes;
+        std::map<std::string, UINT> mNodeIndexMapping;
+        std::vector<ModelBone> mBones;
+        std::map<std::string, UINT> mBoneIndexMapping;
+        std::vector<AnimationClip*> mAnimations;
+        BoundingBox mBounds;
+        BoundingSphere mSphereBounds;
     };
 }
@@ -0,0 +1,483 @@
+#include "OcclusionCuller.h"
+#include "GameException.h"
+#include "JobSystem.h"
+#include "Utility.h"
+#include "MatrixHelper.h"
+#include "Model.h"
+#include "Mesh.h"
+#include <algorithm>
+#include <fstream>
+#include <xmmintrin.h>
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(OcclusionCuller)
+
+	const UINT OcclusionCuller::DefaultWidth = 256;
+	const UINT OcclusionCuller::DefaultHeight = 128;
+	const UINT OcclusionCuller::TileWidth = 8;
+	const UINT OcclusionCuller::TileHeight = 8;
+	const float OcclusionCuller::MinimumClipW = 0.0001f;
+	const UINT OcclusionCuller::MinimumTileRowsPerWorker = 2;
+	const UINT OcclusionCuller::MinimumTestsPerWorker = 64;
+
+	OcclusionCuller::OcclusionCuller(UINT width, UINT height)
+		: mWidth(0), mHeight(0), mTileColumns(0), mTileRows(0), mDepthBuffer(), mTileMaxDepth(),
+		  mOccluders(), mFreeOccluders(), mTriangles(), mClipVertices(), mViewProjection(), mEnabled(true)
+	{
+		if (width == 0 || height == 0)
+		{
+			throw GameException("OcclusionCuller::OcclusionCuller() resolution must be non-zero.");
+		}
+
+		// Whole tiles keep every SSE step inside its row
+		mTileColumns = (width + TileWidth - 1) / TileWidth;
+		mTileRows = (height + TileHeight - 1) / TileHeight;
+		mWidth = mTileColumns * TileWidth;
+		mHeight = mTileRows * TileHeight;
+
+		mDepthBuffer.assign(mWidth * mHeight, 1.0f);
+		mTileMaxDepth.assign(mTileColumns * mTileRows, 1.0f);
+	}
+
+	OcclusionCuller::~OcclusionCuller()
+	{
+	}
+
+	OcclusionCuller* OcclusionCuller::Instance()
+	{
+		return static_cast<OcclusionCuller*>(GlobalServices.GetService(OcclusionCuller::TypeIdClass()));
+	}
+
+	UINT OcclusionCuller::AddOccluder(const std::vector<vec3>& vertices, const std::vector<UINT>& indices, const mat4& world)
+	{
+		if (indices.size() % 3 != 0)
+		{
+			throw GameException("OcclusionCuller::AddOccluder() index count must be a multiple of three.");
+		}
+
+		for (UINT index : indices)
+		{
+			if (index >= vertices.size())
+			{
+				throw GameException("OcclusionCuller::AddOccluder() index out of range.");
+			}
+		}
+
+		UINT occluder;
+		if (mFreeOccluders.empty())
+		{
+			occluder = mOccluders.size();
+			mOccluders.push_back(Occluder());
+		}
+		else
+		{
+			occluder = mFreeOccluders.back();
+			mFreeOccluders.pop_back();
+		}
+
+		Occluder& entry = mOccluders[occluder];
+		entry.Vertices = vertices;
+		entry.Indices = indices;
+		entry.World = world;
+		entry.Active = true;
+
+		return occluder;
+	}
+
+	UINT OcclusionCuller::AddOccluder(const Mesh& mesh, const mat4& world)
+	{
+		return AddOccluder(mesh.Vertices(), mesh.Indices(), world);
+	}
+
+	void OcclusionCuller::RemoveOccluder(UINT occluder)
+	{
+		Occluder& entry = GetOccluder(occluder);
+		entry.Active = false;
+		std::vector<vec3>().swap(entry.Vertices);
+		std::vector<UINT>().swap(entry.Indices);
+
+		mFreeOccluders.push_back(occluder);
+	}
+
+	void OcclusionCuller::SetOccluderTransform(UINT occluder, const mat4& world)
+	{
+		GetOccluder(occluder).World = world;
+	}
+
+	void OcclusionCuller::ClearOccluders()
+	{
+		mOccluders.clear();
+		mFreeOccluders.clear();
+		mTriangles.clear();
+	}
+
+	bool& OcclusionCuller::Enabled()
+	{
+		return mEnabled;
+	}
+
+	UINT OcclusionCuller::Width() const
+	{
+		return mWidth;
+	}
+
+	UINT OcclusionCuller::Height() const
+	{
+		return mHeight;
+	}
+
+	UINT OcclusionCuller::OccluderCount() const
+	{
+		return mOccluders.size() - mFreeOccluders.size();
+	}
+
+	UINT OcclusionCuller::RasterizedTriangleCount() const
+	{
+		return mTriangles.size();
+	}
+
+	const std::vector<float>& OcclusionCuller::DepthBuffer() const
+	{
+		return mDepthBuffer;
+	}
+
+	void OcclusionCuller::Rasterize(const mat4& viewProjection)
+	{
+		mViewProjection = viewProjection;
+
+		// Triangle setup is serial; the per-pixel work is split by tile row so workers never share a row
+		mTriangles.clear();
+		for (const Occluder& occluder : mOccluders)
+		{
+			if (occluder.Active)
+			{
+				SetupTriangles(occluder, viewProjection * occluder.World);
+			}
+		}
+
+		JobSystem::ParallelFor(mTileRows, MinimumTileRowsPerWorker, [this](UINT begin, UINT end)
+		{
+			RasterizeTileRows(begin, end);
+		});
+	}
+
+	bool OcclusionCuller::IsVisible(const BoundingBox& bounds) const
+	{
+		if (mEnabled == false || mTriangles.empty() || bounds.IsEmpty())
+		{
+			return true;
+		}
+
+		float minX = FLT_MAX;
+		float minY = FLT_MAX;
+		float maxX = -FLT_MAX;
+		float maxY = -FLT_MAX;
+		float minDepth = FLT_MAX;
+
+		for (UINT i = 0; i < 8; i++)
+		{
+			vec3 corner((i & 1) ? bounds.Maximum.x : bounds.Minimum.x, (i & 2) ? bounds.Maximum.y : bounds.Minimum.y, (i & 4) ? bounds.Maximum.z : bounds.Minimum.z);
+			vec4 clip = mViewProjection * vec4(corner, 1.0f);
+
+			// A box reaching behind the near plane has no finite screen rectangle, so it is never rejected
+			if (clip.w < MinimumClipW)
+			{
+				return true;
+			}
+
+			float inverseW = 1.0f / clip.w;
+			float x = (clip.x * inverseW * 0.5f + 0.5f) * mWidth;
+			float y = (clip.y * inverseW * 0.5f + 0.5f) * mHeight;
+			float depth = clip.z * inverseW * 0.5f + 0.5f;
+
+			minX = (x < minX ? x : minX);
+			maxX = (x > maxX ? x : maxX);
+			minY = (y < minY ? y : minY);
+			maxY = (y > maxY ? y : maxY);
+			minDepth = (depth < minDepth ? depth : minDepth);
+		}
+
+		if (maxX < 0.0f || maxY < 0.0f || minX >= mWidth || minY >= mHeight)
+		{
+			return false;
+		}
+
+		int x0 = static_cast<int>(std::max<float>(minX, 0.0f));
+		int y0 = static_cast<int>(std::max<float>(minY, 0.0f));
+		int x1 = static_cast<int>(std::min<float>(maxX, static_cast<float>(mWidth - 1)));
+		int y1 = static_cast<int>(std::min<float>(maxY, static_cast<float>(mHeight - 1)));
+
+		__m128 boxDepth = _mm_set1_ps(minDepth);
+		for (int tileRow = y0 / static_cast<int>(TileHeight); tileRow <= y1 / static_cast<int>(TileHeight); tileRow++)
+		{
+			for (int tileColumn = x0 / static_cast<int>(TileWidth); tileColumn <= x1 / static_cast<int>(TileWidth); tileColumn++)
+			{
+				// Every occluder pixel in this tile is nearer than the box's nearest point
+				if (minDepth > mTileMaxDepth[tileRow * mTileColumns + tileColumn])
+				{
+					continue;
+				}
+
+				int tileX0 = std::max<int>(x0, tileColumn * TileWidth);
+				int tileX1 = std::min<int>(x1, tileColumn * TileWidth + TileWidth - 1);
+				int tileY0 = std::max<int>(y0, tileRow * TileHeight);
+				int tileY1 = std::min<int>(y1, tileRow * TileHeight + TileHeight - 1);
+
+				for (int y = tileY0; y <= tileY1; y++)
+				{
+					const float* row = &mDepthBuffer[y * mWidth];
+					for (int x = tileX0 & ~3; x <= tileX1; x += 4)
+					{
+						int lanes = _mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(row + x), boxDepth));
+						if (x < tileX0)
+						{
+							lanes &= (0xF << (tileX0 - x));
+						}
+
+						if (x + 3 > tileX1)
+						{
+							lanes &= (0xF >> (x + 3 - tileX1));
+						}
+
+						if (lanes != 0)
+						{
+							return true;
+						}
+					}
+				}
+			}
+		}
+
+		return false;
+	}
+
+	void OcclusionCuller::TestVisibility(const std::vector<BoundingBox>& bounds, std::vector<GLboolean>& visible) const
+	{
+		visible.resize(bounds.size());
+
+		JobSystem::ParallelFor(bounds.size(), MinimumTestsPerWorker, [this, &bounds, &visible](UINT begin, UINT end)
+		{
+			for (UINT i = begin; i < end; i++)
+			{
+				visible[i] = (IsVisible(bounds[i]) ? GL_TRUE : GL_FALSE);
+			}
+		});
+	}
+
+	void OcclusionCuller::DumpDepthBuffer(const std::wstring& filename) const
+	{
+		// Stretch the written range over the grey scale; cleared pixels stay white
+		float nearest = FLT_MAX;
+		float farthest = -FLT_MAX;
+		for (float depth : mDepthBuffer)
+		{
+			if (depth < 1.0f)
+			{
+				nearest = (depth < nearest ? depth : nearest);
+				farthest = (depth > farthest ? depth : farthest);
+			}
+		}
+
+		float scale = (farthest > nearest ? 254.0f / (farthest - nearest) : 0.0f);
+
+		// The buffer is bottom-up like a GL framebuffer; PGM rows run top-down
+		std::vector<char> pixels(mWidth * mHeight);
+		for (UINT y = 0; y < mHeight; y++)
+		{
+			const float* row = &mDepthBuffer[(mHeight - 1 - y) * mWidth];
+			for (UINT x = 0; x < mWidth; x++)
+			{
+				UINT value = (row[x] >= 1.0f ? 255 : static_cast<UINT>((row[x] - nearest) * scale));
+				pixels[y * mWidth + x] = static_cast<char>(value);
+			}
+		}
+
+#if defined(_WIN32)
+		std::ofstream file(filename.c_str(), std::ios::binary | std::ios::trunc);
+#else
+		std::ofstream file(Utility::ToString(filename).c_str(), std::ios::binary | std::ios::trunc);
+#endif
+		if (file.fail())
+		{
+			throw GameException("OcclusionCuller::DumpDepthBuffer() could not open file.");
+		}
+
+		file << "P5\n" << mWidth << " " << mHeight << "\n255\n";
+		file.write(&pixels.front(), pixels.size());
+	}
+
+	OcclusionCuller::Occluder& OcclusionCuller::GetOccluder(UINT occluder)
+	{
+		if (occluder >= mOccluders.size() || mOccluders[occluder].Active == false)
+		{
+			throw GameException("OcclusionCuller::GetOccluder() invalid occluder.");
+		}
+
+		return mOccluders[occluder];
+	}
+
+	void OcclusionCuller::SetupTriangles(const Occluder& occluder, const mat4& worldViewProjection)
+	{
+		if (occluder.Vertices.empty())
+		{
+			return;
+		}
+
+		mClipVertices.resize(occluder.Vertices.size());
+		MatrixHelper::TransformPoints(worldViewProjection, &occluder.Vertices.front(), &mClipVertices.front(), occluder.Vertices.size());
+
+		float width = static_cast<float>(mWidth);
+		float height = static_cast<float>(mHeight);
+
+		for (UINT i = 0; i < occluder.Indices.size(); i += 3)
+		{
+			const vec4& clip0 = mClipVertices[occluder.Indices[i]];
+			const vec4& clip1 = mClipVertices[occluder.Indices[i + 1]];
+			const vec4& clip2 = mClipVertices[occluder.Indices[i + 2]];
+
+			// Dropping occluder triangles only hides less, so anything crossing the near plane is skipped rather than clipped
+			if (clip0.w < MinimumClipW || clip1.w < MinimumClipW || clip2.w < MinimumClipW)
+			{
+				continue;
+			}
+
+			if ((clip0.x > clip0.w && clip1.x > clip1.w && clip2.x > clip2.w) ||
+				(clip0.x < -clip0.w && clip1.x < -clip1.w && clip2.x < -clip2.w) ||
+				(clip0.y > clip0.w && clip1.y > clip1.w && clip2.y > clip2.w) ||
+				(clip0.y < -clip0.w && clip1.y < -clip1.w && clip2.y < -clip2.w) ||
+				(clip0.z > clip0.w && clip1.z > clip1.w && clip2.z > clip2.w))
+			{
+				continue;
+			}
+
+			vec3 vertices[3];
+			const vec4* clips[3] = { &clip0, &clip1, &clip2 };
+			for (UINT j = 0; j < 3; j++)
+			{
+				float inverseW = 1.0f / clips[j]->w;
+				vertices[j] = vec3((clips[j]->x * inverseW * 0.5f + 0.5f) * width, (clips[j]->y * inverseW * 0.5f + 0.5f) * height, clips[j]->z * inverseW * 0.5f + 0.5f);
+			}
+
+			float area = (vertices[1].x - vertices[0].x) * (vertices[2].y - vertices[0].y) - (vertices[1].y - vertices[0].y) * (vertices[2].x - vertices[0].x);
+			if (area > -FLT_EPSILON && area < FLT_EPSILON)
+			{
+				continue;
+			}
+
+			// Both windings are rasterized so open occluders such as single-sided walls work from either side
+			if (area < 0.0f)
+			{
+				std::swap(vertices[1], vertices[2]);
+				area = -area;
+			}
+
+			ScreenTriangle triangle;
+			for (UINT j = 0; j < 3; j++)
+			{
+				const vec3& a = vertices[(j + 1) % 3];
+				const vec3& b = vertices[(j + 2) % 3];
+				triangle.Edges[j] = vec3(a.y - b.y, b.x - a.x, a.x * b.y - a.y * b.x);
+			}
+
+			triangle.DepthPlane = (triangle.Edges[0] * vertices[0].z + triangle.Edges[1] * vertices[1].z + triangle.Edges[2] * vertices[2].z) / area;
+
+			vec3 minimum = min(min(vertices[0], vertices[1]), vertices[2]);
+			vec3 maximum = max(max(vertices[0], vertices[1]), vertices[2]);
+			triangle.MinX = std::max<int>(static_cast<int>(floor(minimum.x)), 0);
+			triangle.MinY = std::max<int>(static_cast<int>(floor(minimum.y)), 0);
+			triangle.MaxX = std::min<int>(static_cast<int>(ceil(maximum.x)), mWidth - 1);
+			triangle.MaxY = std::min<int>(static_cast<int>(ceil(maximum.y)), mHeight - 1);
+
+			if (triangle.MinX <= triangle.MaxX && triangle.MinY <= triangle.MaxY)
+			{
+				mTriangles.push_back(triangle);
+			}
+		}
+	}
+
+	void OcclusionCuller::RasterizeTileRows(UINT tileRowBegin, UINT tileRowEnd)
+	{
+		int minY = tileRowBegin * TileHeight;
+		int maxY = tileRowEnd * TileHeight - 1;
+		std::fill(mDepthBuffer.begin() + minY * mWidth, mDepthBuffer.begin() + (maxY + 1) * mWidth, 1.0f);
+
+		for (const ScreenTriangle& triangle : mTriangles)
+		{
+			if (triangle.MaxY >= minY && triangle.MinY <= maxY)
+			{
+				RasterizeTriangle(triangle, std::max<int>(triangle.MinY, minY), std::min<int>(triangle.MaxY, maxY));
+			}
+		}
+
+		// Refresh the farthest depth per tile for the occludee early-out
+		for (UINT tileRow = tileRowBegin; tileRow < tileRowEnd; tileRow++)
+		{
+			for (UINT tileColumn = 0; tileColumn < mTileColumns; tileColumn++)
+			{
+				__m128 farthest = _mm_setzero_ps();
+				for (UINT y = tileRow * TileHeight; y < (tileRow + 1) * TileHeight; y++)
+				{
+					const float* row = &mDepthBuffer[y * mWidth + tileColumn * TileWidth];
+					for (UINT x = 0; x < TileWidth; x += 4)
+					{
+						farthest = _mm_max_ps(farthest, _mm_loadu_ps(row + x));
+					}
+				}
+
+				farthest = _mm_max_ps(farthest, _mm_movehl_ps(farthest, farthest));
+				farthest = _mm_max_ss(farthest, _mm_shuffle_ps(farthest, farthest, _MM_SHUFFLE(1, 1, 1, 1)));
+				_mm_store_ss(&mTileMaxDepth[tileRow * mTileColumns + tileColumn], farthest);
+			}
+		}
+	}
+
+	void OcclusionCuller::RasterizeTriangle(const ScreenTriangle& triangle, int minY, int maxY)
+	{
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 laneCenters = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+
+		// Edge and depth values step four pixels at a time along each row
+		int startX = triangle.MinX & ~3;
+		__m128 columns = _mm_add_ps(_mm_set1_ps(static_cast<float>(startX)), laneCenters);
+
+		__m128 edgeStart[3];
+		__m128 edgeStep[3];
+		for (UINT i = 0; i < 3; i++)
+		{
+			edgeStart[i] = _mm_mul_ps(_mm_set1_ps(triangle.Edges[i].x), columns);
+			edgeStep[i] = _mm_set1_ps(triangle.Edges[i].x * 4.0f);
+		}
+
+		__m128 depthStart = _mm_mul_ps(_mm_set1_ps(triangle.DepthPlane.x), columns);
+		__m128 depthStep = _mm_set1_ps(triangle.DepthPlane.x * 4.0f);
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			float rowCenter = y + 0.5f;
+			__m128 edge0 = _mm_add_ps(edgeStart[0], _mm_set1_ps(triangle.Edges[0].y * rowCenter + triangle.Edges[0].z));
+			__m128 edge1 = _mm_add_ps(edgeStart[1], _mm_set1_ps(triangle.Edges[1].y * rowCenter + triangle.Edges[1].z));
+			__m128 edge2 = _mm_add_ps(edgeStart[2], _mm_set1_ps(triangle.Edges[2].y * rowCenter + triangle.Edges[2].z));
+			__m128 depth = _mm_add_ps(depthStart, _mm_set1_ps(triangle.DepthPlane.y * rowCenter + triangle.DepthPlane.z));
+
+			float* row = &mDepthBuffer[y * mWidth];
+			for (int x = startX; x <= triangle.MaxX; x += 4)
+			{
+				__m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(edge0, zero), _mm_cmpge_ps(edge1, zero)), _mm_cmpge_ps(edge2, zero));
+				if (_mm_movemask_ps(inside) != 0)
+				{
+					__m128 stored = _mm_loadu_ps(row + x);
+					__m128 nearest = _mm_min_ps(stored, depth);
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, stored)));
+				}
+
+				edge0 = _mm_add_ps(edge0, edgeStep[0]);
+				edge1 = _mm_add_ps(edge1, edgeStep[1]);
+				edge2 = _mm_add_ps(edge2, edgeStep[2]);
+				depth = _mm_add_ps(depth, depthStep);
+			}
+		}
+	}
+}
\ No newline at end of file
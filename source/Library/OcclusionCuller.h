@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Common.h"
+#include "BoundingVolume.h"
+
+namespace Library
+{
+	class Mesh;
+
+	// A low-resolution CPU depth buffer for occlusion culling. Registered occluders are rasterized each frame,
+	// four pixels per SSE step, into a float buffer divided into 8x8 tiles that workers fill a tile row at a time.
+	// Occludee boxes are rejected against each tile's farthest depth before the covered pixels are read. Nothing
+	// touches GL, so results can be checked offline with DumpDepthBuffer.
+	class OcclusionCuller : public RTTI
+	{
+		RTTI_DECLARATIONS(OcclusionCuller, RTTI)
+
+	public:
+		OcclusionCuller(UINT width = DefaultWidth, UINT height = DefaultHeight);
+		~OcclusionCuller();
+
+		static OcclusionCuller* Instance();
+
+		UINT AddOccluder(const std::vector<glm::vec3>& vertices, const std::vector<UINT>& indices, const glm::mat4& world);
+		UINT AddOccluder(const Mesh& mesh, const glm::mat4& world);
+		void RemoveOccluder(UINT occluder);
+		void SetOccluderTransform(UINT occluder, const glm::mat4& world);
+		void ClearOccluders();
+
+		bool& Enabled();
+		UINT Width() const;
+		UINT Height() const;
+		UINT OccluderCount() const;
+		UINT RasterizedTriangleCount() const;
+		const std::vector<float>& DepthBuffer() const;
+
+		void Rasterize(const glm::mat4& viewProjection);
+		bool IsVisible(const BoundingBox& bounds) const;
+		void TestVisibility(const std::vector<BoundingBox>& bounds, std::vector<GLboolean>& visible) const;
+		void DumpDepthBuffer(const std::wstring& filename) const;
+
+		static const UINT DefaultWidth;
+		static const UINT DefaultHeight;
+		static const UINT TileWidth;
+		static const UINT TileHeight;
+
+	private:
+		OcclusionCuller(const OcclusionCuller& rhs);
+		OcclusionCuller& operator=(const OcclusionCuller& rhs);
+
+		struct Occluder
+		{
+			std::vector<glm::vec3> Vertices;
+			std::vector<UINT> Indices;
+			glm::mat4 World;
+			bool Active;
+		};
+
+		// Edge functions and the depth plane are stored as a*x + b*y + c in pixel coordinates
+		struct ScreenTriangle
+		{
+			glm::vec3 Edges[3];
+			glm::vec3 DepthPlane;
+			int MinX;
+			int MinY;
+			int MaxX;
+			int MaxY;
+		};
+
+		Occluder& GetOccluder(UINT occluder);
+		void SetupTriangles(const Occluder& occluder, const glm::mat4& worldViewProjection);
+		void RasterizeTileRows(UINT tileRowBegin, UINT tileRowEnd);
+		void RasterizeTriangle(const ScreenTriangle& triangle, int minY, int maxY);
+
+		static const float MinimumClipW;
+		static const UINT MinimumTileRowsPerWorker;
+		static const UINT MinimumTestsPerWorker;
+
+		UINT mWidth;
+		UINT mHeight;
+		UINT mTileColumns;
+		UINT mTileRows;
+		std::vector<float> mDepthBuffer;
+		std::vector<float> mTileMaxDepth;
+		std::vector<Occluder> mOccluders;
+		std::vector<UINT> mFreeOccluders;
+		std::vector<ScreenTriangle> mTriangles;
+		std::vector<glm::vec4> mClipVertices;
+		glm::mat4 mViewProjection;
+		bool mEnabled;
+	};
+}
\ No newline at end of file
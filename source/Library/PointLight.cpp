@@ -8,6 +8,11 @@ namespace Library
 
 	const float PointLight::DefaultRadius = 10.0f;
 
+	PointLight::PointLight()
+		: Light(), mPosition(0), mRadius(DefaultRadius)
+	{
+	}
+
 	PointLight::PointLight(Game& game)
 		: Light(game), mPosition(0), mRadius(DefaultRadius)
 	{
@@ -10,6 +10,7 @@ namespace Library
 		RTTI_DECLARATIONS(PointLight, Light)
 
 	public:
+		PointLight();
 		PointLight(Game& game);
 		virtual ~PointLight();
 
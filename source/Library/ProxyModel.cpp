@@ -3,12 +3,11 @@
 #include "GameException.h"
 #include "Camera.h"
 #include "VectorHelper.h"
-#include "MatrixHelper.h"
 #include "ColorHelper.h"
 #include "Model.h"
 #include "Mesh.h"
-#include "Utility.h"
 #include "VertexDeclarations.h"
+#include "RenderCommandList.h"
 
 using namespace glm;
 
@@ -19,14 +18,17 @@ namespace Library
 	ProxyModel::ProxyModel(Game& game, Camera& camera, const std::string& modelFileName, float scale)
 		: DrawableGameComponent(game, camera),
 		  mModelFileName(modelFileName), mShaderProgram(), mVertexArrayObject(0), mVertexBuffer(0),
-		  mIndexBuffer(0), mIndexCount(0), mWorldMatrix(), mScaleMatrix(), mDisplayWireframe(true),
+		  mIndexBuffer(0), mIndexCount(0), mBounds(),
+		  mTransform(game.Transforms().CreateNode()), mWorldVersion(0), mWorldMatrix(), mDisplayWireframe(true),
 		  mPosition(Vector3Helper::Zero), mDirection(Vector3Helper::Forward), mUp(Vector3Helper::Up), mRight(Vector3Helper::Right)
 	{
-		mScaleMatrix = glm::scale(mat4(), vec3(scale));
+		mGame->Transforms().SetLocalScale(mTransform, vec3(scale));
 	}
 
 	ProxyModel::~ProxyModel()
 	{
+		mGame->Transforms().DestroyNode(mTransform);
+
 		glDeleteBuffers(1, &mIndexBuffer);
 		glDeleteBuffers(1, &mVertexBuffer);
 		glDeleteVertexArrays(1, &mVertexArrayObject);
@@ -52,6 +54,11 @@ namespace Library
         return mRight;
     }
 
+	UINT ProxyModel::TransformNode() const
+	{
+		return mTransform;
+	}
+
 	bool& ProxyModel::DisplayWireframe()
 	{
 		return mDisplayWireframe;
@@ -59,12 +66,13 @@ namespace Library
 
 	void ProxyModel::SetPosition(FLOAT x, FLOAT y, FLOAT z)
     {
-		mPosition = vec3(x, y, z);
+		SetPosition(vec3(x, y, z));
     }
 
     void ProxyModel::SetPosition(const vec3& position)
     {
         mPosition = position;
+		mGame->Transforms().SetLocalTranslation(mTransform, mPosition);
     }
 
 	void ProxyModel::ApplyRotation(const mat4& transform)
@@ -77,17 +85,29 @@ namespace Library
 
 		mRight = cross(mDirection, mUp);
 		mUp = cross(mRight, mDirection);
+
+		// Same basis the MatrixHelper setters produce: right, up and backward in the first three columns
+		mGame->Transforms().SetLocalRotation(mTransform, quat_cast(mat3(mRight, mUp, -mDirection)));
 	}
 
-	void ProxyModel::Initialize()
+	bool ProxyModel::WorldBounds(BoundingBox& bounds) const
 	{
-		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
+		bounds = mBounds.Transform(mWorldMatrix);
+		return true;
+	}
 
-		// Build the shader program
+	void ProxyModel::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
 		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\BasicEffect.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\BasicEffect.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content/Effects/BasicEffect.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content/Effects/BasicEffect.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
+	void ProxyModel::Initialize()
+	{
+		// Build the shader program
+		BuildPrograms();
 
 		std::unique_ptr<Model> model(new Model(*mGame, mModelFileName, true));
 
@@ -96,49 +116,71 @@ namespace Library
 		mShaderProgram.CreateVertexBuffer(*mesh, mVertexBuffer);
 		mesh->CreateIndexBuffer(mIndexBuffer);
 		mIndexCount = mesh->Indices().size();
+		mBounds = mesh->Bounds();
 
 		// Create the vertex array object
 		glGenVertexArrays(1, &mVertexArrayObject);
 		mShaderProgram.Initialize(mVertexArrayObject);
 		glBindVertexArray(0);
+
+		RefreshWorldMatrix();
 	}
 
 	void ProxyModel::Update(const GameTime& gameTime)
 	{
-		mat4 worldMatrix;
-		MatrixHelper::SetForward(worldMatrix, mDirection);
-		MatrixHelper::SetUp(worldMatrix, mUp);
-		MatrixHelper::SetRight(worldMatrix, mRight);
-		MatrixHelper::SetTranslation(worldMatrix, mPosition);
-
-		mWorldMatrix = worldMatrix * mScaleMatrix;
+		RefreshWorldMatrix();
 	}
 
-	void ProxyModel::Draw(const GameTime& gameTime)
+	void ProxyModel::RefreshWorldMatrix()
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+		// The hierarchy bumps a node's version only when its world matrix was recomputed, so a resting proxy costs a compare
+		TransformHierarchy& transforms = mGame->Transforms();
+		UINT worldVersion = transforms.WorldVersion(mTransform);
+		if (worldVersion == mWorldVersion)
+		{
+			return;
+		}
 
-		mShaderProgram.Use();
+		mWorldVersion = worldVersion;
+		mWorldMatrix = transforms.WorldMatrix(mTransform);
 
-		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
-		mShaderProgram.WorldViewProjection() << wvp;
+		// Refit the proxy's leaf; the tree only restructures once the bounds leave their fattened margin
+		UpdateSpatialProxy();
+	}
 
-		glEnable(GL_CULL_FACE);
-		glFrontFace(GL_CCW);
+	bool ProxyModel::Record(const GameTime& gameTime, RenderCommandList& commandList)
+	{
+		// Only reads: Game::Draw has flushed the hierarchy, so parent movement since Update is already in the world matrix
+		const mat4& world = mGame->Transforms().UpdatedWorldMatrix(mTransform);
 
-		if (mDisplayWireframe)
-		{
-			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-			glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
-			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-		}
-		else
+		// Proxies are usually drawn by their owning demo, which bypasses the component-level cull in Game::Draw
+		if (mCamera->ViewFrustum().Intersects(mBounds.Transform(world)) == false)
 		{
-			glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
+			return true;
 		}
 
-		glBindVertexArray(0);
+		DrawItem drawItem;
+		drawItem.Program = &mShaderProgram;
+		drawItem.VertexArray = mVertexArrayObject;
+		drawItem.VertexBuffer = mVertexBuffer;
+		drawItem.IndexBuffer = mIndexBuffer;
+		drawItem.Count = mIndexCount;
+		drawItem.PolygonMode = (mDisplayWireframe ? GL_LINE : GL_FILL);
+		drawItem.Depth = RenderQueue::ViewDepth(*mCamera, vec3(world[3]));
+
+		commandList.Submit(drawItem);
+		commandList.SetUniform(mShaderProgram.WorldViewProjection(), mCamera->ViewProjectionMatrix() * world);
+
+		return true;
+	}
+
+	void ProxyModel::Draw(const GameTime& gameTime)
+	{
+		// Picks up parent movement that happened after this proxy's Update; Record leaves the spatial index alone
+		RefreshWorldMatrix();
+
+		RenderCommandList commandList;
+		Record(gameTime, commandList);
+		mGame->DrawQueue().Submit(commandList);
 	}
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "Common.h"
 #include "DrawableGameComponent.h"
 #include "BasicEffect.h"
+#include "BoundingVolume.h"
 
 namespace Library
 {
@@ -21,6 +22,7 @@ namespace Library
         const glm::vec3& Up() const;
         const glm::vec3& Right() const;
 
+		UINT TransformNode() const;
 		bool& DisplayWireframe();
 
 		void SetPosition(FLOAT x, FLOAT y, FLOAT z);
@@ -28,8 +30,11 @@ namespace Library
 
         void ApplyRotation(const glm::mat4& transform);
 
+		virtual bool WorldBounds(BoundingBox& bounds) const override;
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
 		virtual void Initialize() override;
 		virtual void Update(const GameTime& gameTime) override;		
+		virtual bool Record(const GameTime& gameTime, RenderCommandList& commandList) override;
 		virtual void Draw(const GameTime& gameTime) override;
 
 	private:
@@ -37,15 +42,19 @@ namespace Library
 		ProxyModel(const ProxyModel& rhs);
 		ProxyModel& operator=(const ProxyModel& rhs);
 
+		void RefreshWorldMatrix();
+
 		std::string mModelFileName;
 		BasicEffect mShaderProgram;
 		GLuint mVertexArrayObject;
 		GLuint mVertexBuffer;
 		GLuint mIndexBuffer;
 		UINT mIndexCount;
+		BoundingBox mBounds;
+		UINT mTransform;
+		UINT mWorldVersion;
         
 		glm::mat4 mWorldMatrix;
-		glm::mat4 mScaleMatrix;
 
 		bool mDisplayWireframe;
 		glm::vec3 mPosition;
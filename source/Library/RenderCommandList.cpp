@@ -0,0 +1,102 @@
+#include "RenderCommandList.h"
+#include "GameException.h"
+
+using namespace glm;
+
+namespace Library
+{
+	RenderCommandList::RenderCommandList()
+		: mItems(), mUniforms()
+	{
+	}
+
+	void RenderCommandList::Submit(const DrawItem& item)
+	{
+		if (item.Program == nullptr)
+		{
+			throw GameException("RenderCommandList::Submit() draw item has no shader program.");
+		}
+
+		mItems.push_back(item);
+
+		DrawItem& recordedItem = mItems.back();
+		recordedItem.FirstUniform = mUniforms.size();
+		recordedItem.UniformCount = 0;
+	}
+
+	void RenderCommandList::SetUniform(Variable& variable, const mat4& value)
+	{
+		RecordedUniform& uniform = AddUniform(variable, UniformValueTypeMat4);
+		memcpy(uniform.Values, &value[0][0], sizeof(mat4));
+	}
+
+	void RenderCommandList::SetUniform(Variable& variable, const vec4& value)
+	{
+		RecordedUniform& uniform = AddUniform(variable, UniformValueTypeVec4);
+		memcpy(uniform.Values, &value[0], sizeof(vec4));
+	}
+
+	void RenderCommandList::SetUniform(Variable& variable, const vec3& value)
+	{
+		RecordedUniform& uniform = AddUniform(variable, UniformValueTypeVec3);
+		memcpy(uniform.Values, &value[0], sizeof(vec3));
+	}
+
+	void RenderCommandList::SetUniform(Variable& variable, const vec2& value)
+	{
+		RecordedUniform& uniform = AddUniform(variable, UniformValueTypeVec2);
+		memcpy(uniform.Values, &value[0], sizeof(vec2));
+	}
+
+	void RenderCommandList::SetUniform(Variable& variable, float value)
+	{
+		RecordedUniform& uniform = AddUniform(variable, UniformValueTypeFloat);
+		uniform.Values[0] = value;
+	}
+
+	void RenderCommandList::SetUniform(Variable& variable, int value)
+	{
+		RecordedUniform& uniform = AddUniform(variable, UniformValueTypeInt);
+		uniform.Integer = value;
+	}
+
+	void RenderCommandList::Clear()
+	{
+		// Keeps the capacity, so a list reused every frame stops allocating once it has seen its peak
+		mItems.clear();
+		mUniforms.clear();
+	}
+
+	UINT RenderCommandList::ItemCount() const
+	{
+		return mItems.size();
+	}
+
+	const std::vector<DrawItem>& RenderCommandList::Items() const
+	{
+		return mItems;
+	}
+
+	const std::vector<RecordedUniform>& RenderCommandList::Uniforms() const
+	{
+		return mUniforms;
+	}
+
+	RecordedUniform& RenderCommandList::AddUniform(Variable& variable, UniformValueType type)
+	{
+		if (mItems.empty())
+		{
+			throw GameException("RenderCommandList::SetUniform() no draw item has been submitted.");
+		}
+
+		RecordedUniform uniform;
+		uniform.Target = &variable;
+		uniform.Type = type;
+		uniform.Integer = 0;
+
+		mUniforms.push_back(uniform);
+		mItems.back().UniformCount++;
+
+		return mUniforms.back();
+	}
+}
\ No newline at end of file
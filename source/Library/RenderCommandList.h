@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Common.h"
+#include "RenderQueue.h"
+
+namespace Library
+{
+	class Variable;
+
+	// A backend-neutral list of draws that can be filled off the GL thread. Uniforms are captured by value
+	// against the most recently submitted draw, so recording makes no GL calls; RenderQueue::Submit merges
+	// the list and the values are staged when the queue executes. Each list must be filled by one thread.
+	class RenderCommandList
+	{
+	public:
+		RenderCommandList();
+
+		void Submit(const DrawItem& item);
+
+		void SetUniform(Variable& variable, const glm::mat4& value);
+		void SetUniform(Variable& variable, const glm::vec4& value);
+		void SetUniform(Variable& variable, const glm::vec3& value);
+		void SetUniform(Variable& variable, const glm::vec2& value);
+		void SetUniform(Variable& variable, float value);
+		void SetUniform(Variable& variable, int value);
+
+		void Clear();
+
+		UINT ItemCount() const;
+		const std::vector<DrawItem>& Items() const;
+		const std::vector<RecordedUniform>& Uniforms() const;
+
+	private:
+		RecordedUniform& AddUniform(Variable& variable, UniformValueType type);
+
+		std::vector<DrawItem> mItems;
+		std::vector<RecordedUniform> mUniforms;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,410 @@
+#include "RenderQueue.h"
+#include "RenderCommandList.h"
+#include "RenderStateCache.h"
+#include "ShaderProgram.h"
+#include "Camera.h"
+#include "HashHelper.h"
+#include "GameException.h"
+#include "Variable.h"
+#include <algorithm>
+
+namespace Library
+{
+	RTTI_DEFINITIONS(RenderQueue)
+
+	// Key layout, most significant first:
+	//   opaque:      layer | program | material | depth       (front-to-back within a state group)
+	//   transparent: layer | ~depth  | program  | material    (back-to-front, state only breaks ties)
+	const UINT RenderQueue::LayerBits = 2;
+	const UINT RenderQueue::ProgramBits = 12;
+	const UINT RenderQueue::MaterialBits = 16;
+	const UINT RenderQueue::DepthKeyBits = 24;
+	const UINT RenderQueue::RadixBits = 8;
+
+	DrawItem::DrawItem()
+		: Layer(RenderLayerOpaque), Program(nullptr), VertexArray(0), VertexBuffer(0), IndexBuffer(0), IndirectBuffer(0), TextureCount(0),
+		  PrimitiveType(GL_TRIANGLES), Count(0), InstanceCount(1), FirstIndex(0), BaseVertex(0), BaseInstance(0), PolygonMode(GL_FILL), CullingEnabled(true), FrontFace(GL_CCW), Depth(0.0f),
+		  DepthTestEnabled(true), DepthWriteEnabled(true), FirstUniform(0), UniformCount(0), ApplyUniforms()
+	{
+		std::fill(TextureTargets, TextureTargets + MaxTextures, GL_TEXTURE_2D);
+		memset(Textures, 0, sizeof(Textures));
+		memset(Samplers, 0, sizeof(Samplers));
+	}
+
+	RenderQueue::RenderQueue()
+		: mItems(), mUniforms(), mEntries(), mScratch(), mProgramIds(), mIsSorted(true), mExecutedCount(0), mLayerExecutedCount(0)
+	{
+	}
+
+	RenderQueue::~RenderQueue()
+	{
+	}
+
+	RenderQueue* RenderQueue::Instance()
+	{
+		return static_cast<RenderQueue*>(GlobalServices.GetService(RenderQueue::TypeIdClass()));
+	}
+
+	void RenderQueue::Submit(const DrawItem& item)
+	{
+		if (item.UniformCount > 0)
+		{
+			throw GameException("RenderQueue::Submit() draw item references recorded uniforms; submit its command list instead.");
+		}
+
+		Append(item);
+	}
+
+	void RenderQueue::Submit(const RenderCommandList& commandList)
+	{
+		// Lists are appended whole and in call order, and the sort is stable, so merging is deterministic
+		UINT uniformBase = mUniforms.size();
+		mUniforms.insert(mUniforms.end(), commandList.Uniforms().begin(), commandList.Uniforms().end());
+
+		mItems.reserve(mItems.size() + commandList.ItemCount());
+		mEntries.reserve(mEntries.size() + commandList.ItemCount());
+		for (const DrawItem& item : commandList.Items())
+		{
+			Append(item);
+			mItems.back().FirstUniform += uniformBase;
+		}
+	}
+
+	void RenderQueue::Append(const DrawItem& item)
+	{
+		if (item.Program == nullptr)
+		{
+			throw GameException("RenderQueue::Submit() draw item has no shader program.");
+		}
+
+		if (item.TextureCount > DrawItem::MaxTextures)
+		{
+			throw GameException("RenderQueue::Submit() draw item exceeds the texture limit.");
+		}
+
+		SortEntry entry;
+		entry.Key = SortKey(item);
+		entry.Index = mItems.size();
+
+		mItems.push_back(item);
+		mEntries.push_back(entry);
+		mIsSorted = false;
+	}
+
+	void RenderQueue::Sort()
+	{
+		if (mIsSorted == false)
+		{
+			RadixSort(mEntries, mScratch);
+			mIsSorted = true;
+		}
+	}
+
+	void RenderQueue::Execute()
+	{
+		Sort();
+		ExecuteEntries(mEntries.begin(), mEntries.end());
+
+		mExecutedCount = mLayerExecutedCount + mEntries.size();
+		Clear();
+	}
+
+	void RenderQueue::Execute(RenderLayer layer)
+	{
+		Sort();
+
+		// The layer is the top of the key, so each layer is one contiguous run of the sorted entries
+		const UINT layerShift = 64 - LayerBits;
+		auto inLayer = [layer, layerShift](const SortEntry& entry)
+		{
+			return ((entry.Key >> layerShift) == static_cast<std::uint64_t>(layer));
+		};
+
+		auto first = std::find_if(mEntries.begin(), mEntries.end(), inLayer);
+		auto last = std::find_if_not(first, mEntries.end(), inLayer);
+		ExecuteEntries(first, last);
+
+		// The items stay put until the next Execute() clears the queue; only their entries are dropped
+		mLayerExecutedCount += (last - first);
+		mEntries.erase(first, last);
+	}
+
+	void RenderQueue::ExecuteEntries(std::vector<SortEntry>::const_iterator first, std::vector<SortEntry>::const_iterator last)
+	{
+		// Components that draw themselves may have changed state behind the cache since the last run
+		RenderStateCache& renderStates = *RenderStateCache::Instance();
+		renderStates.Invalidate();
+
+		for (auto entry = first; entry != last; ++entry)
+		{
+			const DrawItem& item = mItems[entry->Index];
+
+			renderStates.BindVertexArray(item.VertexArray);
+			if (item.VertexBuffer != 0)
+			{
+				renderStates.BindBuffer(GL_ARRAY_BUFFER, item.VertexBuffer);
+			}
+
+			if (item.IndexBuffer != 0)
+			{
+				renderStates.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, item.IndexBuffer);
+			}
+
+			item.Program->Use();
+			for (UINT i = 0; i < item.UniformCount; i++)
+			{
+				ApplyUniform(mUniforms[item.FirstUniform + i]);
+			}
+
+			if (item.ApplyUniforms)
+			{
+				item.ApplyUniforms();
+			}
+			item.Program->CommitUniforms();
+
+			if (item.TextureCount > 0)
+			{
+				renderStates.BindSamplers(0, item.TextureCount, item.Samplers);
+				renderStates.BindTextures(0, item.TextureCount, item.TextureTargets, item.Textures);
+			}
+
+			renderStates.SetCullingEnabled(item.CullingEnabled);
+			renderStates.SetFrontFace(item.FrontFace);
+			renderStates.SetPolygonMode(item.PolygonMode);
+			renderStates.SetDepthTestEnabled(item.DepthTestEnabled);
+			renderStates.SetDepthWriteEnabled(item.DepthWriteEnabled);
+
+			if (item.Layer == RenderLayerTransparent)
+			{
+				renderStates.SetBlendEnabled(true);
+				renderStates.SetBlendFunction(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			}
+			else
+			{
+				renderStates.SetBlendEnabled(false);
+			}
+
+			if (item.IndirectBuffer != 0)
+			{
+				// Count is the number of commands in the indirect buffer
+				renderStates.BindBuffer(GL_DRAW_INDIRECT_BUFFER, item.IndirectBuffer);
+				glMultiDrawElementsIndirect(item.PrimitiveType, GL_UNSIGNED_INT, 0, item.Count, 0);
+			}
+			else if (item.IndexBuffer != 0)
+			{
+				if (item.FirstIndex != 0 || item.BaseVertex != 0 || item.BaseInstance != 0)
+				{
+					const GLvoid* firstIndex = reinterpret_cast<const GLvoid*>(sizeof(GLuint) * item.FirstIndex);
+					glDrawElementsInstancedBaseVertexBaseInstance(item.PrimitiveType, item.Count, GL_UNSIGNED_INT, firstIndex, item.InstanceCount, item.BaseVertex, item.BaseInstance);
+				}
+				else if (item.InstanceCount != 1)
+				{
+					glDrawElementsInstanced(item.PrimitiveType, item.Count, GL_UNSIGNED_INT, 0, item.InstanceCount);
+				}
+				else
+				{
+					glDrawElements(item.PrimitiveType, item.Count, GL_UNSIGNED_INT, 0);
+				}
+			}
+			else
+			{
+				if (item.InstanceCount != 1)
+				{
+					glDrawArraysInstanced(item.PrimitiveType, 0, item.Count, item.InstanceCount);
+				}
+				else
+				{
+					glDrawArrays(item.PrimitiveType, 0, item.Count);
+				}
+			}
+		}
+
+		// Leave the defaults that immediate-mode components expect
+		renderStates.SetBlendEnabled(false);
+		renderStates.SetPolygonMode(GL_FILL);
+		renderStates.SetDepthTestEnabled(true);
+		renderStates.SetDepthWriteEnabled(true);
+	}
+
+	void RenderQueue::Clear()
+	{
+		mItems.clear();
+		mUniforms.clear();
+		mEntries.clear();
+		mIsSorted = true;
+		mLayerExecutedCount = 0;
+	}
+
+	UINT RenderQueue::ItemCount() const
+	{
+		return mItems.size();
+	}
+
+	UINT RenderQueue::ExecutedCount() const
+	{
+		return mExecutedCount;
+	}
+
+	float RenderQueue::ViewDepth(const Camera& camera, const glm::vec3& position)
+	{
+		return glm::dot(position - camera.Position(), camera.Direction());
+	}
+
+	std::uint64_t RenderQueue::SortKey(const DrawItem& item)
+	{
+		std::uint64_t layer = static_cast<std::uint64_t>(item.Layer) & ((1ULL << LayerBits) - 1);
+		std::uint64_t program = ProgramId(item.Program->Program());
+		std::uint64_t material = MaterialId(item);
+		std::uint64_t depth = DepthBits(item.Depth);
+
+		std::uint64_t key = layer << (64 - LayerBits);
+		if (item.Layer == RenderLayerTransparent)
+		{
+			depth = ~depth & ((1ULL << DepthKeyBits) - 1);
+			key |= depth << (64 - LayerBits - DepthKeyBits);
+			key |= program << (64 - LayerBits - DepthKeyBits - ProgramBits);
+			key |= material << (64 - LayerBits - DepthKeyBits - ProgramBits - MaterialBits);
+		}
+		else
+		{
+			key |= program << (64 - LayerBits - ProgramBits);
+			key |= material << (64 - LayerBits - ProgramBits - MaterialBits);
+			key |= depth << (64 - LayerBits - ProgramBits - MaterialBits - DepthKeyBits);
+		}
+
+		return key;
+	}
+
+	UINT RenderQueue::ProgramId(GLuint program)
+	{
+		// Ids are handed out in first-use order so they stay small and stable across frames
+		auto it = mProgramIds.find(program);
+		if (it == mProgramIds.end())
+		{
+			// A wrapped id would interleave two programs' draws and break state grouping
+			assert(mProgramIds.size() < (1U << ProgramBits));
+			UINT id = mProgramIds.size() & ((1U << ProgramBits) - 1);
+			it = mProgramIds.insert(std::pair<GLuint, UINT>(program, id)).first;
+		}
+
+		return it->second;
+	}
+
+	UINT RenderQueue::MaterialId(const DrawItem& item)
+	{
+		// A collision only costs grouping, never correctness
+		std::uint64_t hash = HashHelper::OffsetBasis;
+		hash = HashHelper::Combine(hash, item.VertexArray);
+		hash = HashHelper::Combine(hash, item.PolygonMode);
+		hash = HashHelper::Combine(hash, item.CullingEnabled);
+		hash = HashHelper::Combine(hash, item.DepthWriteEnabled);
+		hash = HashHelper::Hash(item.Textures, sizeof(GLuint) * item.TextureCount, hash);
+		hash = HashHelper::Hash(item.Samplers, sizeof(GLuint) * item.TextureCount, hash);
+
+		hash ^= (hash >> 32);
+		hash ^= (hash >> 16);
+
+		return static_cast<UINT>(hash & ((1U << MaterialBits) - 1));
+	}
+
+	UINT RenderQueue::DepthBits(float depth)
+	{
+		// Non-negative IEEE floats order like their bit patterns, so the top bits are a monotonic quantization
+		if (!(depth > 0.0f))
+		{
+			return 0;
+		}
+
+		std::uint32_t bits;
+		memcpy(&bits, &depth, sizeof(bits));
+
+		return (bits >> (32 - DepthKeyBits));
+	}
+
+	void RenderQueue::RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch)
+	{
+		const UINT count = entries.size();
+		if (count < 2)
+		{
+			return;
+		}
+
+		const UINT radixSize = 1 << RadixBits;
+		const std::uint64_t radixMask = radixSize - 1;
+
+		scratch.resize(count);
+		SortEntry* source = &entries[0];
+		SortEntry* destination = &scratch[0];
+		std::vector<UINT> offsets(radixSize);
+
+		// Least-significant digit first; each pass is stable, so submission order breaks key ties
+		for (UINT shift = 0; shift < 64; shift += RadixBits)
+		{
+			std::fill(offsets.begin(), offsets.end(), 0);
+			for (UINT i = 0; i < count; i++)
+			{
+				offsets[(source[i].Key >> shift) & radixMask]++;
+			}
+
+			// A digit shared by every key would leave the order unchanged
+			if (offsets[(source[0].Key >> shift) & radixMask] == count)
+			{
+				continue;
+			}
+
+			UINT total = 0;
+			for (UINT digit = 0; digit < radixSize; digit++)
+			{
+				UINT digitCount = offsets[digit];
+				offsets[digit] = total;
+				total += digitCount;
+			}
+
+			for (UINT i = 0; i < count; i++)
+			{
+				destination[offsets[(source[i].Key >> shift) & radixMask]++] = source[i];
+			}
+
+			std::swap(source, destination);
+		}
+
+		if (source != &entries[0])
+		{
+			entries.swap(scratch);
+		}
+	}
+
+	void RenderQueue::ApplyUniform(const RecordedUniform& uniform)
+	{
+		Variable& variable = *uniform.Target;
+		switch (uniform.Type)
+		{
+			case UniformValueTypeMat4:
+				variable << glm::make_mat4(uniform.Values);
+				break;
+
+			case UniformValueTypeVec4:
+				variable << glm::make_vec4(uniform.Values);
+				break;
+
+			case UniformValueTypeVec3:
+				variable << glm::make_vec3(uniform.Values);
+				break;
+
+			case UniformValueTypeVec2:
+				variable << glm::make_vec2(uniform.Values);
+				break;
+
+			case UniformValueTypeFloat:
+				variable << uniform.Values[0];
+				break;
+
+			case UniformValueTypeInt:
+				variable << static_cast<int>(uniform.Integer);
+				break;
+
+			default:
+				throw GameException("RenderQueue::ApplyUniform() unknown uniform value type.");
+		}
+	}
+}
\ No newline at end of file
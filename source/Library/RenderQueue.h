@@ -0,0 +1,143 @@
+#pragma once
+
+#include "Common.h"
+#include <cstdint>
+#include <functional>
+
+namespace Library
+{
+	class Camera;
+	class ShaderProgram;
+	class Variable;
+	class RenderCommandList;
+
+	// Deferred items are drawn with ShaderPermutationGBuffer programs and only by the deferred geometry pass, so
+	// components submit there only while Game::DeferredShading() is enabled; everything else shades forward
+	enum RenderLayer
+	{
+		RenderLayerDeferred = 0,
+		RenderLayerOpaque,
+		RenderLayerTransparent,
+		RenderLayerEnd
+	};
+
+	enum UniformValueType
+	{
+		UniformValueTypeMat4 = 0,
+		UniformValueTypeVec4,
+		UniformValueTypeVec3,
+		UniformValueTypeVec2,
+		UniformValueTypeFloat,
+		UniformValueTypeInt
+	};
+
+	// A uniform value captured when a draw is recorded and staged on the GL thread when it executes
+	struct RecordedUniform
+	{
+		Variable* Target;
+		UniformValueType Type;
+		float Values[16];
+		GLint Integer;
+	};
+
+	struct DrawItem
+	{
+		static const UINT MaxTextures = 4;
+
+		RenderLayer Layer;
+		ShaderProgram* Program;
+		GLuint VertexArray;
+		GLuint VertexBuffer;
+		GLuint IndexBuffer;
+		GLuint IndirectBuffer;
+
+		// Multi-bind infers each texture's target, but the state cache and the per-unit fallback need it
+		GLenum TextureTargets[MaxTextures];
+		GLuint Textures[MaxTextures];
+		GLuint Samplers[MaxTextures];
+		UINT TextureCount;
+		GLenum PrimitiveType;
+		GLsizei Count;
+		GLsizei InstanceCount;
+
+		// Offsets into shared index and vertex buffers; the base instance also offsets per-instance attributes
+		GLuint FirstIndex;
+		GLint BaseVertex;
+		GLuint BaseInstance;
+
+		GLenum PolygonMode;
+		bool CullingEnabled;
+		GLenum FrontFace;
+		float Depth;
+
+		// Blended items usually test against the opaque depth without writing their own
+		bool DepthTestEnabled;
+		bool DepthWriteEnabled;
+
+		// Range of recorded uniforms in the owning command list or queue; staged before ApplyUniforms
+		UINT FirstUniform;
+		UINT UniformCount;
+
+		// Stages the per-draw uniforms; invoked with the program bound, right before the draw
+		std::function<void()> ApplyUniforms;
+
+		DrawItem();
+	};
+
+	class RenderQueue : public RTTI
+	{
+		RTTI_DECLARATIONS(RenderQueue, RTTI)
+
+	public:
+		RenderQueue();
+		~RenderQueue();
+
+		static RenderQueue* Instance();
+
+		void Submit(const DrawItem& item);
+		void Submit(const RenderCommandList& commandList);
+		void Sort();
+		void Execute();
+		void Execute(RenderLayer layer);
+		void Clear();
+
+		UINT ItemCount() const;
+		UINT ExecutedCount() const;
+
+		static float ViewDepth(const Camera& camera, const glm::vec3& position);
+
+	private:
+		RenderQueue(const RenderQueue& rhs);
+		RenderQueue& operator=(const RenderQueue& rhs);
+
+		struct SortEntry
+		{
+			std::uint64_t Key;
+			UINT Index;
+		};
+
+		void Append(const DrawItem& item);
+		void ExecuteEntries(std::vector<SortEntry>::const_iterator first, std::vector<SortEntry>::const_iterator last);
+		std::uint64_t SortKey(const DrawItem& item);
+		UINT ProgramId(GLuint program);
+		static UINT MaterialId(const DrawItem& item);
+		static UINT DepthBits(float depth);
+		static void RadixSort(std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch);
+		static void ApplyUniform(const RecordedUniform& uniform);
+
+		static const UINT LayerBits;
+		static const UINT ProgramBits;
+		static const UINT MaterialBits;
+		static const UINT DepthKeyBits;
+		static const UINT RadixBits;
+
+		std::vector<DrawItem> mItems;
+		std::vector<RecordedUniform> mUniforms;
+		std::vector<SortEntry> mEntries;
+		std::vector<SortEntry> mScratch;
+		std::map<GLuint, UINT> mProgramIds;
+		bool mIsSorted;
+		UINT mExecutedCount;
+		UINT mLayerExecutedCount;
+	};
+}
\ No newline at end of file
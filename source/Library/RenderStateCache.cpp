@@ -0,0 +1,510 @@
+#include "RenderStateCache.h"
+#include "GameException.h"
+#include "ExtensionHelper.h"
+#include <algorithm>
+
+namespace Library
+{
+	RTTI_DEFINITIONS(RenderStateCache)
+
+	const UINT RenderStateCache::TrackedTextureUnits = 32;
+	const UINT RenderStateCache::TrackedBufferBindings = 16;
+	const GLuint RenderStateCache::Unknown = 0xFFFFFFFF;
+
+	// A unit holds one binding per target, so each tracked target has its own slot; others pass straight through
+	const GLenum RenderStateCache::TrackedTextureTargets[] = { GL_TEXTURE_2D, GL_TEXTURE_CUBE_MAP, GL_TEXTURE_2D_ARRAY, GL_TEXTURE_3D };
+	const UINT RenderStateCache::TrackedTextureTargetCount = sizeof(RenderStateCache::TrackedTextureTargets) / sizeof(GLenum);
+
+	RenderStateCache::RenderStateCache()
+		: mBindTextures(nullptr), mBindSamplers(nullptr),
+		  mProgram(Unknown), mVertexArray(Unknown), mArrayBuffer(Unknown), mElementArrayBuffer(Unknown), mDrawIndirectBuffer(Unknown),
+		  mActiveTexture(Unknown), mTextures(TrackedTextureUnits * TrackedTextureTargetCount, Unknown), mSamplers(TrackedTextureUnits, Unknown),
+		  mUniformBuffers(), mStorageBuffers(),
+		  mBlendEnabled(Unknown), mBlendSourceFactor(Unknown), mBlendDestinationFactor(Unknown),
+		  mDepthTestEnabled(Unknown), mDepthWriteEnabled(Unknown), mDepthFunction(Unknown),
+		  mCullingEnabled(Unknown), mCullFace(Unknown), mFrontFace(Unknown), mPolygonMode(Unknown),
+		  mStateChangeCount(0), mFilteredChangeCount(0)
+	{
+		// Sizes the indexed binding tables, which have no single-value initializer
+		Invalidate();
+	}
+
+	RenderStateCache::~RenderStateCache()
+	{
+	}
+
+	RenderStateCache* RenderStateCache::Instance()
+	{
+		return static_cast<RenderStateCache*>(GlobalServices.GetService(RenderStateCache::TypeIdClass()));
+	}
+
+	void RenderStateCache::Initialize()
+	{
+		// Multi-bind is core in 4.4, past what gl3w's headers expose; without it ranges bind one unit at a time
+		GLint majorVersion = 0;
+		GLint minorVersion = 0;
+		glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+		glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+
+		mBindTextures = nullptr;
+		mBindSamplers = nullptr;
+		if (majorVersion > 4 || (majorVersion == 4 && minorVersion >= 4) || ExtensionHelper::IsSupported("GL_ARB_multi_bind"))
+		{
+			mBindTextures = reinterpret_cast<BindNamesFunction>(gl3wGetProcAddress("glBindTextures"));
+			mBindSamplers = reinterpret_cast<BindNamesFunction>(gl3wGetProcAddress("glBindSamplers"));
+			if (mBindTextures == nullptr || mBindSamplers == nullptr)
+			{
+				mBindTextures = nullptr;
+				mBindSamplers = nullptr;
+			}
+		}
+
+		Invalidate();
+	}
+
+	void RenderStateCache::Invalidate()
+	{
+		// Anything that touches GL state directly must call this before the next cached call
+		mProgram = Unknown;
+		mVertexArray = Unknown;
+		mArrayBuffer = Unknown;
+		mElementArrayBuffer = Unknown;
+		mDrawIndirectBuffer = Unknown;
+		mActiveTexture = Unknown;
+		mTextures.assign(TrackedTextureUnits * TrackedTextureTargetCount, Unknown);
+		mSamplers.assign(TrackedTextureUnits, Unknown);
+		mBlendEnabled = Unknown;
+		mBlendSourceFactor = Unknown;
+		mBlendDestinationFactor = Unknown;
+		mDepthTestEnabled = Unknown;
+		mDepthWriteEnabled = Unknown;
+		mDepthFunction = Unknown;
+		mCullingEnabled = Unknown;
+		mCullFace = Unknown;
+		mFrontFace = Unknown;
+		mPolygonMode = Unknown;
+
+		IndexedBufferBinding unknownBinding = { Unknown, 0, 0 };
+		mUniformBuffers.assign(TrackedBufferBindings, unknownBinding);
+		mStorageBuffers.assign(TrackedBufferBindings, unknownBinding);
+	}
+
+	void RenderStateCache::UseProgram(GLuint program)
+	{
+		if (Change(mProgram, program))
+		{
+			glUseProgram(program);
+		}
+	}
+
+	void RenderStateCache::BindVertexArray(GLuint vertexArray)
+	{
+		if (Change(mVertexArray, vertexArray))
+		{
+			glBindVertexArray(vertexArray);
+
+			// The element array binding is part of the vertex array's state
+			mElementArrayBuffer = Unknown;
+		}
+	}
+
+	void RenderStateCache::BindBuffer(GLenum target, GLuint buffer)
+	{
+		GLuint* cachedBuffer;
+		switch (target)
+		{
+			case GL_ARRAY_BUFFER:
+				cachedBuffer = &mArrayBuffer;
+				break;
+
+			case GL_ELEMENT_ARRAY_BUFFER:
+				cachedBuffer = &mElementArrayBuffer;
+				break;
+
+			case GL_DRAW_INDIRECT_BUFFER:
+				cachedBuffer = &mDrawIndirectBuffer;
+				break;
+
+			default:
+				// Transfer targets and the generic uniform/storage points only serve uploads, which bind transiently;
+				// glBindBufferBase/Range also move the generic point, so it is never worth caching
+				glBindBuffer(target, buffer);
+				return;
+		}
+
+		if (Change(*cachedBuffer, buffer))
+		{
+			glBindBuffer(target, buffer);
+		}
+	}
+
+	void RenderStateCache::BindBufferBase(GLenum target, GLuint index, GLuint buffer)
+	{
+		// A whole-buffer binding is cached as offset and size zero, which no range binding can have
+		IndexedBufferBinding* cachedBinding = CachedBufferBinding(target, index);
+		if (cachedBinding == nullptr || Change(*cachedBinding, buffer, 0, 0))
+		{
+			glBindBufferBase(target, index, buffer);
+		}
+	}
+
+	void RenderStateCache::BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size)
+	{
+		IndexedBufferBinding* cachedBinding = CachedBufferBinding(target, index);
+		if (cachedBinding == nullptr || Change(*cachedBinding, buffer, offset, size))
+		{
+			glBindBufferRange(target, index, buffer, offset, size);
+		}
+	}
+
+	void RenderStateCache::BindTexture(GLuint unit, GLenum target, GLuint texture)
+	{
+		GLuint* cachedTexture = CachedTexture(unit, target);
+		if (cachedTexture == nullptr || Change(*cachedTexture, texture))
+		{
+			ActiveTexture(unit);
+			glBindTexture(target, texture);
+		}
+	}
+
+	void RenderStateCache::BindTextures(GLuint first, GLsizei count, const GLenum* targets, const GLuint* textures)
+	{
+		if (textures == nullptr)
+		{
+			// A null list unbinds every target of every unit in the range
+			if (mBindTextures != nullptr)
+			{
+				mBindTextures(first, count, nullptr);
+			}
+			else
+			{
+				for (GLuint unit = first; unit < first + count; unit++)
+				{
+					ActiveTexture(unit);
+					for (UINT i = 0; i < TrackedTextureTargetCount; i++)
+					{
+						glBindTexture(TrackedTextureTargets[i], 0);
+					}
+				}
+			}
+
+			for (GLuint unit = first; unit < first + count; unit++)
+			{
+				ClearUnitTextures(unit);
+			}
+
+			mStateChangeCount++;
+			return;
+		}
+
+		// Narrow the call to the span of units that actually differ
+		GLsizei begin = 0;
+		while (begin < count && IsTextureBound(first + begin, targets[begin], textures[begin]))
+		{
+			begin++;
+		}
+
+		if (begin == count)
+		{
+			mFilteredChangeCount++;
+			return;
+		}
+
+		GLsizei end = count;
+		while (IsTextureBound(first + end - 1, targets[end - 1], textures[end - 1]))
+		{
+			end--;
+		}
+
+		if (mBindTextures == nullptr)
+		{
+			for (GLsizei i = begin; i < end; i++)
+			{
+				BindTexture(first + i, targets[i], textures[i]);
+			}
+
+			return;
+		}
+
+		mBindTextures(first + begin, end - begin, textures + begin);
+		mStateChangeCount++;
+
+		for (GLsizei i = begin; i < end; i++)
+		{
+			// Multi-binding zero clears every target of the unit, not just the one named
+			if (textures[i] == 0)
+			{
+				ClearUnitTextures(first + i);
+			}
+			else
+			{
+				GLuint* cachedTexture = CachedTexture(first + i, targets[i]);
+				if (cachedTexture != nullptr)
+				{
+					*cachedTexture = textures[i];
+				}
+			}
+		}
+	}
+
+	void RenderStateCache::BindSampler(GLuint unit, GLuint sampler)
+	{
+		if (unit >= TrackedTextureUnits || Change(mSamplers[unit], sampler))
+		{
+			glBindSampler(unit, sampler);
+		}
+	}
+
+	void RenderStateCache::BindSamplers(GLuint first, GLsizei count, const GLuint* samplers)
+	{
+		if (samplers == nullptr)
+		{
+			// A null list falls back to each texture's own sampling state
+			if (mBindSamplers != nullptr)
+			{
+				mBindSamplers(first, count, nullptr);
+			}
+			else
+			{
+				for (GLuint unit = first; unit < first + count; unit++)
+				{
+					glBindSampler(unit, 0);
+				}
+			}
+
+			for (GLuint unit = first; unit < first + count && unit < TrackedTextureUnits; unit++)
+			{
+				mSamplers[unit] = 0;
+			}
+
+			mStateChangeCount++;
+			return;
+		}
+
+		GLsizei begin = 0;
+		while (begin < count && IsSamplerBound(first + begin, samplers[begin]))
+		{
+			begin++;
+		}
+
+		if (begin == count)
+		{
+			mFilteredChangeCount++;
+			return;
+		}
+
+		GLsizei end = count;
+		while (IsSamplerBound(first + end - 1, samplers[end - 1]))
+		{
+			end--;
+		}
+
+		if (mBindSamplers == nullptr)
+		{
+			for (GLsizei i = begin; i < end; i++)
+			{
+				BindSampler(first + i, samplers[i]);
+			}
+
+			return;
+		}
+
+		mBindSamplers(first + begin, end - begin, samplers + begin);
+		mStateChangeCount++;
+
+		for (GLsizei i = begin; i < end && first + i < TrackedTextureUnits; i++)
+		{
+			mSamplers[first + i] = samplers[i];
+		}
+	}
+
+	void RenderStateCache::SetBlendEnabled(bool enabled)
+	{
+		SetCapability(GL_BLEND, mBlendEnabled, enabled);
+	}
+
+	void RenderStateCache::SetBlendFunction(GLenum sourceFactor, GLenum destinationFactor)
+	{
+		bool sourceChanged = Change(mBlendSourceFactor, sourceFactor);
+		bool destinationChanged = Change(mBlendDestinationFactor, destinationFactor);
+		if (sourceChanged || destinationChanged)
+		{
+			glBlendFunc(sourceFactor, destinationFactor);
+		}
+	}
+
+	void RenderStateCache::SetDepthTestEnabled(bool enabled)
+	{
+		SetCapability(GL_DEPTH_TEST, mDepthTestEnabled, enabled);
+	}
+
+	void RenderStateCache::SetDepthWriteEnabled(bool enabled)
+	{
+		if (Change(mDepthWriteEnabled, enabled ? GL_TRUE : GL_FALSE))
+		{
+			glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+		}
+	}
+
+	void RenderStateCache::SetDepthFunction(GLenum function)
+	{
+		if (Change(mDepthFunction, function))
+		{
+			glDepthFunc(function);
+		}
+	}
+
+	void RenderStateCache::SetCullingEnabled(bool enabled)
+	{
+		SetCapability(GL_CULL_FACE, mCullingEnabled, enabled);
+	}
+
+	void RenderStateCache::SetCullFace(GLenum face)
+	{
+		if (Change(mCullFace, face))
+		{
+			glCullFace(face);
+		}
+	}
+
+	void RenderStateCache::SetFrontFace(GLenum frontFace)
+	{
+		if (Change(mFrontFace, frontFace))
+		{
+			glFrontFace(frontFace);
+		}
+	}
+
+	void RenderStateCache::SetPolygonMode(GLenum mode)
+	{
+		if (Change(mPolygonMode, mode))
+		{
+			glPolygonMode(GL_FRONT_AND_BACK, mode);
+		}
+	}
+
+	UINT RenderStateCache::StateChangeCount() const
+	{
+		return mStateChangeCount;
+	}
+
+	UINT RenderStateCache::FilteredChangeCount() const
+	{
+		return mFilteredChangeCount;
+	}
+
+	void RenderStateCache::ResetCounts()
+	{
+		mStateChangeCount = 0;
+		mFilteredChangeCount = 0;
+	}
+
+	bool RenderStateCache::Change(GLuint& cachedValue, GLuint value)
+	{
+		if (cachedValue == value)
+		{
+			mFilteredChangeCount++;
+			return false;
+		}
+
+		cachedValue = value;
+		mStateChangeCount++;
+
+		return true;
+	}
+
+	bool RenderStateCache::Change(IndexedBufferBinding& cachedBinding, GLuint buffer, GLintptr offset, GLsizeiptr size)
+	{
+		if (cachedBinding.Buffer == buffer && cachedBinding.Offset == offset && cachedBinding.Size == size)
+		{
+			mFilteredChangeCount++;
+			return false;
+		}
+
+		cachedBinding.Buffer = buffer;
+		cachedBinding.Offset = offset;
+		cachedBinding.Size = size;
+		mStateChangeCount++;
+
+		return true;
+	}
+
+	void RenderStateCache::SetCapability(GLenum capability, GLuint& cachedValue, bool enabled)
+	{
+		if (Change(cachedValue, enabled ? GL_TRUE : GL_FALSE))
+		{
+			if (enabled)
+			{
+				glEnable(capability);
+			}
+			else
+			{
+				glDisable(capability);
+			}
+		}
+	}
+
+	void RenderStateCache::ActiveTexture(GLuint unit)
+	{
+		if (Change(mActiveTexture, unit))
+		{
+			glActiveTexture(GL_TEXTURE0 + unit);
+		}
+	}
+
+	GLuint* RenderStateCache::CachedTexture(GLuint unit, GLenum target)
+	{
+		if (unit < TrackedTextureUnits)
+		{
+			for (UINT i = 0; i < TrackedTextureTargetCount; i++)
+			{
+				if (TrackedTextureTargets[i] == target)
+				{
+					return &mTextures[unit * TrackedTextureTargetCount + i];
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+	bool RenderStateCache::IsTextureBound(GLuint unit, GLenum target, GLuint texture)
+	{
+		GLuint* cachedTexture = CachedTexture(unit, target);
+		return (cachedTexture != nullptr && *cachedTexture == texture);
+	}
+
+	void RenderStateCache::ClearUnitTextures(GLuint unit)
+	{
+		if (unit < TrackedTextureUnits)
+		{
+			auto unitTextures = mTextures.begin() + unit * TrackedTextureTargetCount;
+			std::fill(unitTextures, unitTextures + TrackedTextureTargetCount, 0);
+		}
+	}
+
+	bool RenderStateCache::IsSamplerBound(GLuint unit, GLuint sampler) const
+	{
+		return (unit < TrackedTextureUnits && mSamplers[unit] == sampler);
+	}
+
+	RenderStateCache::IndexedBufferBinding* RenderStateCache::CachedBufferBinding(GLenum target, GLuint index)
+	{
+		if (index < TrackedBufferBindings)
+		{
+			switch (target)
+			{
+				case GL_UNIFORM_BUFFER:
+					return &mUniformBuffers[index];
+
+				case GL_SHADER_STORAGE_BUFFER:
+					return &mStorageBuffers[index];
+
+				default:
+					break;
+			}
+		}
+
+		return nullptr;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "Common.h"
+
+namespace Library
+{
+	class RenderStateCache : public RTTI
+	{
+		RTTI_DECLARATIONS(RenderStateCache, RTTI)
+
+	public:
+		RenderStateCache();
+		~RenderStateCache();
+
+		static RenderStateCache* Instance();
+
+		void Initialize();
+		void Invalidate();
+
+		void UseProgram(GLuint program);
+		void BindVertexArray(GLuint vertexArray);
+		void BindBuffer(GLenum target, GLuint buffer);
+		void BindBufferBase(GLenum target, GLuint index, GLuint buffer);
+		void BindBufferRange(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+		void BindTexture(GLuint unit, GLenum target, GLuint texture);
+		void BindTextures(GLuint first, GLsizei count, const GLenum* targets, const GLuint* textures);
+		void BindSampler(GLuint unit, GLuint sampler);
+		void BindSamplers(GLuint first, GLsizei count, const GLuint* samplers);
+
+		void SetBlendEnabled(bool enabled);
+		void SetBlendFunction(GLenum sourceFactor, GLenum destinationFactor);
+		void SetDepthTestEnabled(bool enabled);
+		void SetDepthWriteEnabled(bool enabled);
+		void SetDepthFunction(GLenum function);
+		void SetCullingEnabled(bool enabled);
+		void SetCullFace(GLenum face);
+		void SetFrontFace(GLenum frontFace);
+		void SetPolygonMode(GLenum mode);
+
+		UINT StateChangeCount() const;
+		UINT FilteredChangeCount() const;
+		void ResetCounts();
+
+		static const UINT TrackedTextureUnits;
+		static const UINT TrackedBufferBindings;
+
+	private:
+		RenderStateCache(const RenderStateCache& rhs);
+		RenderStateCache& operator=(const RenderStateCache& rhs);
+
+		typedef void (APIENTRY *BindNamesFunction)(GLuint first, GLsizei count, const GLuint* names);
+
+		struct IndexedBufferBinding
+		{
+			GLuint Buffer;
+			GLintptr Offset;
+			GLsizeiptr Size;
+		};
+
+		bool Change(GLuint& cachedValue, GLuint value);
+		bool Change(IndexedBufferBinding& cachedBinding, GLuint buffer, GLintptr offset, GLsizeiptr size);
+		void SetCapability(GLenum capability, GLuint& cachedValue, bool enabled);
+		void ActiveTexture(GLuint unit);
+		GLuint* CachedTexture(GLuint unit, GLenum target);
+		bool IsTextureBound(GLuint unit, GLenum target, GLuint texture);
+		void ClearUnitTextures(GLuint unit);
+		bool IsSamplerBound(GLuint unit, GLuint sampler) const;
+		IndexedBufferBinding* CachedBufferBinding(GLenum target, GLuint index);
+
+		static const GLuint Unknown;
+		static const GLenum TrackedTextureTargets[];
+		static const UINT TrackedTextureTargetCount;
+
+		BindNamesFunction mBindTextures;
+		BindNamesFunction mBindSamplers;
+
+		GLuint mProgram;
+		GLuint mVertexArray;
+		GLuint mArrayBuffer;
+		GLuint mElementArrayBuffer;
+		GLuint mDrawIndirectBuffer;
+		GLuint mActiveTexture;
+		std::vector<GLuint> mTextures;
+		std::vector<GLuint> mSamplers;
+		std::vector<IndexedBufferBinding> mUniformBuffers;
+		std::vector<IndexedBufferBinding> mStorageBuffers;
+		GLuint mBlendEnabled;
+		GLuint mBlendSourceFactor;
+		GLuint mBlendDestinationFactor;
+		GLuint mDepthTestEnabled;
+		GLuint mDepthWriteEnabled;
+		GLuint mDepthFunction;
+		GLuint mCullingEnabled;
+		GLuint mCullFace;
+		GLuint mFrontFace;
+		GLuint mPolygonMode;
+
+		UINT mStateChangeCount;
+		UINT mFilteredChangeCount;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,136 @@
+#include "SamplerCache.h"
+#include "ExtensionHelper.h"
+#include "HashHelper.h"
+
+#ifndef GL_TEXTURE_MAX_ANISOTROPY_EXT
+#define GL_TEXTURE_MAX_ANISOTROPY_EXT 0x84FE
+#endif
+
+namespace Library
+{
+	RTTI_DEFINITIONS(SamplerCache)
+
+	const SamplerDescription SamplerDescription::LinearWrap(GL_LINEAR, GL_LINEAR, GL_REPEAT);
+	const SamplerDescription SamplerDescription::LinearClamp(GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE);
+	const SamplerDescription SamplerDescription::TrilinearWrap(GL_LINEAR_MIPMAP_LINEAR, GL_LINEAR, GL_REPEAT);
+
+	// Defaults match a freshly generated GL sampler object
+	SamplerDescription::SamplerDescription()
+		: MinFilter(GL_NEAREST_MIPMAP_LINEAR), MagFilter(GL_LINEAR), WrapS(GL_REPEAT), WrapT(GL_REPEAT), WrapR(GL_REPEAT),
+		  MaxAnisotropy(1.0f), LodBias(0.0f), CompareMode(GL_NONE), CompareFunction(GL_LEQUAL), BorderColor(0.0f)
+	{
+	}
+
+	SamplerDescription::SamplerDescription(GLenum minFilter, GLenum magFilter, GLenum wrap)
+		: MinFilter(minFilter), MagFilter(magFilter), WrapS(wrap), WrapT(wrap), WrapR(wrap),
+		  MaxAnisotropy(1.0f), LodBias(0.0f), CompareMode(GL_NONE), CompareFunction(GL_LEQUAL), BorderColor(0.0f)
+	{
+	}
+
+	bool SamplerDescription::operator==(const SamplerDescription& rhs) const
+	{
+		return (MinFilter == rhs.MinFilter && MagFilter == rhs.MagFilter && WrapS == rhs.WrapS && WrapT == rhs.WrapT && WrapR == rhs.WrapR &&
+				MaxAnisotropy == rhs.MaxAnisotropy && LodBias == rhs.LodBias && CompareMode == rhs.CompareMode &&
+				CompareFunction == rhs.CompareFunction && BorderColor == rhs.BorderColor);
+	}
+
+	std::uint64_t SamplerDescription::Hash() const
+	{
+		std::uint64_t hash = HashHelper::OffsetBasis;
+		hash = HashHelper::Combine(hash, MinFilter);
+		hash = HashHelper::Combine(hash, MagFilter);
+		hash = HashHelper::Combine(hash, WrapS);
+		hash = HashHelper::Combine(hash, WrapT);
+		hash = HashHelper::Combine(hash, WrapR);
+		hash = HashHelper::Hash(&MaxAnisotropy, sizeof(MaxAnisotropy), hash);
+		hash = HashHelper::Hash(&LodBias, sizeof(LodBias), hash);
+		hash = HashHelper::Combine(hash, CompareMode);
+		hash = HashHelper::Combine(hash, CompareFunction);
+		hash = HashHelper::Hash(&BorderColor[0], sizeof(BorderColor), hash);
+
+		return hash;
+	}
+
+	SamplerCache::SamplerCache()
+		: mSamplers(), mSamplerCount(0), mRequestCount(0)
+	{
+	}
+
+	SamplerCache::~SamplerCache()
+	{
+		Clear();
+	}
+
+	SamplerCache* SamplerCache::Instance()
+	{
+		return static_cast<SamplerCache*>(GlobalServices.GetService(SamplerCache::TypeIdClass()));
+	}
+
+	GLuint SamplerCache::Sampler(const SamplerDescription& description)
+	{
+		mRequestCount++;
+
+		std::vector<SamplerEntry>& entries = mSamplers[description.Hash()];
+		for (const SamplerEntry& entry : entries)
+		{
+			if (entry.Description == description)
+			{
+				return entry.Sampler;
+			}
+		}
+
+		SamplerEntry entry;
+		entry.Description = description;
+		entry.Sampler = CreateSampler(description);
+		entries.push_back(entry);
+		mSamplerCount++;
+
+		return entry.Sampler;
+	}
+
+	void SamplerCache::Clear()
+	{
+		for (auto& bucket : mSamplers)
+		{
+			for (SamplerEntry& entry : bucket.second)
+			{
+				glDeleteSamplers(1, &entry.Sampler);
+			}
+		}
+
+		mSamplers.clear();
+		mSamplerCount = 0;
+	}
+
+	UINT SamplerCache::SamplerCount() const
+	{
+		return mSamplerCount;
+	}
+
+	UINT SamplerCache::RequestCount() const
+	{
+		return mRequestCount;
+	}
+
+	GLuint SamplerCache::CreateSampler(const SamplerDescription& description)
+	{
+		GLuint sampler;
+		glGenSamplers(1, &sampler);
+		glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, description.MinFilter);
+		glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, description.MagFilter);
+		glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, description.WrapS);
+		glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, description.WrapT);
+		glSamplerParameteri(sampler, GL_TEXTURE_WRAP_R, description.WrapR);
+		glSamplerParameterf(sampler, GL_TEXTURE_LOD_BIAS, description.LodBias);
+		glSamplerParameteri(sampler, GL_TEXTURE_COMPARE_MODE, description.CompareMode);
+		glSamplerParameteri(sampler, GL_TEXTURE_COMPARE_FUNC, description.CompareFunction);
+		glSamplerParameterfv(sampler, GL_TEXTURE_BORDER_COLOR, &description.BorderColor[0]);
+
+		if (description.MaxAnisotropy > 1.0f && ExtensionHelper::IsSupported("GL_EXT_texture_filter_anisotropic"))
+		{
+			glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT, description.MaxAnisotropy);
+		}
+
+		return sampler;
+	}
+}
\ No newline at end of file
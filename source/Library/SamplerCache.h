@@ -0,0 +1,64 @@
+#pragma once
+
+#include "Common.h"
+#include <cstdint>
+
+namespace Library
+{
+	struct SamplerDescription
+	{
+		GLenum MinFilter;
+		GLenum MagFilter;
+		GLenum WrapS;
+		GLenum WrapT;
+		GLenum WrapR;
+		GLfloat MaxAnisotropy;
+		GLfloat LodBias;
+		GLenum CompareMode;
+		GLenum CompareFunction;
+		glm::vec4 BorderColor;
+
+		SamplerDescription();
+		SamplerDescription(GLenum minFilter, GLenum magFilter, GLenum wrap);
+
+		bool operator==(const SamplerDescription& rhs) const;
+		std::uint64_t Hash() const;
+
+		static const SamplerDescription LinearWrap;
+		static const SamplerDescription LinearClamp;
+		static const SamplerDescription TrilinearWrap;
+	};
+
+	class SamplerCache : public RTTI
+	{
+		RTTI_DECLARATIONS(SamplerCache, RTTI)
+
+	public:
+		SamplerCache();
+		~SamplerCache();
+
+		static SamplerCache* Instance();
+
+		GLuint Sampler(const SamplerDescription& description);
+		void Clear();
+
+		UINT SamplerCount() const;
+		UINT RequestCount() const;
+
+	private:
+		SamplerCache(const SamplerCache& rhs);
+		SamplerCache& operator=(const SamplerCache& rhs);
+
+		struct SamplerEntry
+		{
+			SamplerDescription Description;
+			GLuint Sampler;
+		};
+
+		GLuint CreateSampler(const SamplerDescription& description);
+
+		std::map<std::uint64_t, std::vector<SamplerEntry>> mSamplers;
+		UINT mSamplerCount;
+		UINT mRequestCount;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "ShaderCache.h"
+#include "FileBuffer.h"
+#include "HashHelper.h"
+#include "Utility.h"
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#endif
+
+namespace Library
+{
+	RTTI_DEFINITIONS(ShaderCache)
+
+	const std::wstring ShaderCache::DefaultCacheDirectoryName = L"ShaderCache";
+	const char ShaderCache::Magic[4] = { 'L', 'S', 'P', 'B' };
+	const std::uint32_t ShaderCache::Version = 1;
+
+	ShaderCache::ShaderCache(const std::wstring& cacheDirectory)
+		: mCacheDirectory(cacheDirectory), mEnabled(true), mDriverInitialized(false), mBinariesSupported(false), mDriverHash(0),
+		  mHitCount(0), mMissCount(0), mRejectedCount(0)
+	{
+	}
+
+	ShaderCache::~ShaderCache()
+	{
+	}
+
+	ShaderCache* ShaderCache::Instance()
+	{
+		return static_cast<ShaderCache*>(GlobalServices.GetService(ShaderCache::TypeIdClass()));
+	}
+
+	const std::wstring& ShaderCache::CacheDirectory() const
+	{
+		return mCacheDirectory;
+	}
+
+	bool ShaderCache::Enabled() const
+	{
+		return mEnabled;
+	}
+
+	void ShaderCache::SetEnabled(bool enabled)
+	{
+		mEnabled = enabled;
+	}
+
+	bool ShaderCache::LoadProgram(std::uint64_t key, GLuint program)
+	{
+		InitializeDriver();
+		if (mEnabled == false || mBinariesSupported == false)
+		{
+			return false;
+		}
+
+		std::unique_ptr<MappedFileBuffer> file;
+		try
+		{
+			file.reset(new MappedFileBuffer(CacheFilename(key)));
+		}
+		catch (...)
+		{
+			mMissCount++;
+			return false;
+		}
+
+		const BinaryHeader* header = reinterpret_cast<const BinaryHeader*>(file->Data());
+		if (file->Size() < sizeof(BinaryHeader) || memcmp(header->Magic, Magic, sizeof(Magic)) != 0 || header->Version != Version ||
+			header->Key != DriverKey(key) || file->Size() - sizeof(BinaryHeader) < header->BinaryLength)
+		{
+			file.reset();
+			RemoveProgram(key);
+			mRejectedCount++;
+			return false;
+		}
+
+		glProgramBinary(program, header->BinaryFormat, file->Data() + sizeof(BinaryHeader), header->BinaryLength);
+
+		// Drivers reject binaries after an update or for a different GPU; the caller rebuilds from source
+		GLint linkStatus;
+		glGetProgramiv(program, GL_LINK_STATUS, &linkStatus);
+		if (linkStatus != GL_TRUE)
+		{
+			file.reset();
+			RemoveProgram(key);
+			mRejectedCount++;
+			return false;
+		}
+
+		mHitCount++;
+		return true;
+	}
+
+	void ShaderCache::SaveProgram(std::uint64_t key, GLuint program)
+	{
+		InitializeDriver();
+		if (mEnabled == false || mBinariesSupported == false)
+		{
+			return;
+		}
+
+		GLint binaryLength = 0;
+		glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &binaryLength);
+		if (binaryLength <= 0)
+		{
+			return;
+		}
+
+		std::vector<char> binary(binaryLength);
+		GLenum binaryFormat = 0;
+		glGetProgramBinary(program, binaryLength, nullptr, &binaryFormat, &binary.front());
+
+		BinaryHeader header;
+		memcpy(header.Magic, Magic, sizeof(header.Magic));
+		header.Version = Version;
+		header.Key = DriverKey(key);
+		header.BinaryFormat = binaryFormat;
+		header.BinaryLength = binaryLength;
+
+#if defined(_WIN32)
+		CreateDirectoryW(mCacheDirectory.c_str(), nullptr);
+		std::ofstream file(CacheFilename(key).c_str(), std::ios::binary | std::ios::trunc);
+#else
+		mkdir(Utility::ToString(mCacheDirectory).c_str(), 0755);
+		std::ofstream file(Utility::ToString(CacheFilename(key)).c_str(), std::ios::binary | std::ios::trunc);
+#endif
+
+		// The cache is an optimization only; failing to write it is not an error
+		if (file.good())
+		{
+			file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+			file.write(&binary.front(), binary.size());
+		}
+	}
+
+	void ShaderCache::RemoveProgram(std::uint64_t key)
+	{
+#if defined(_WIN32)
+		DeleteFileW(CacheFilename(key).c_str());
+#else
+		remove(Utility::ToString(CacheFilename(key)).c_str());
+#endif
+	}
+
+	UINT ShaderCache::HitCount() const
+	{
+		return mHitCount;
+	}
+
+	UINT ShaderCache::MissCount() const
+	{
+		return mMissCount;
+	}
+
+	UINT ShaderCache::RejectedCount() const
+	{
+		return mRejectedCount;
+	}
+
+	void ShaderCache::InitializeDriver()
+	{
+		if (mDriverInitialized)
+		{
+			return;
+		}
+
+		GLint binaryFormatCount = 0;
+		glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+		mBinariesSupported = (binaryFormatCount > 0);
+
+		// Binaries are only valid for the exact driver that produced them
+		static const GLenum driverStrings[] = { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION };
+
+		mDriverHash = HashHelper::OffsetBasis;
+		for (GLenum driverString : driverStrings)
+		{
+			const GLubyte* value = glGetString(driverString);
+			if (value != nullptr)
+			{
+				mDriverHash = HashHelper::Hash(reinterpret_cast<const char*>(value), strlen(reinterpret_cast<const char*>(value)), mDriverHash);
+			}
+		}
+
+		mDriverInitialized = true;
+	}
+
+	std::uint64_t ShaderCache::DriverKey(std::uint64_t key) const
+	{
+		return HashHelper::Combine(mDriverHash, key);
+	}
+
+	std::wstring ShaderCache::CacheFilename(std::uint64_t key) const
+	{
+		std::wostringstream filename;
+		filename << mCacheDirectory << L"/" << std::hex << std::setw(16) << std::setfill(L'0') << DriverKey(key) << L".bin";
+
+		return filename.str();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Common.h"
+#include <cstdint>
+
+namespace Library
+{
+	class ShaderCache : public RTTI
+	{
+		RTTI_DECLARATIONS(ShaderCache, RTTI)
+
+	public:
+		ShaderCache(const std::wstring& cacheDirectory);
+		~ShaderCache();
+
+		static ShaderCache* Instance();
+
+		const std::wstring& CacheDirectory() const;
+		bool Enabled() const;
+		void SetEnabled(bool enabled);
+
+		bool LoadProgram(std::uint64_t key, GLuint program);
+		void SaveProgram(std::uint64_t key, GLuint program);
+		void RemoveProgram(std::uint64_t key);
+
+		UINT HitCount() const;
+		UINT MissCount() const;
+		UINT RejectedCount() const;
+
+		static const std::wstring DefaultCacheDirectoryName;
+
+	private:
+		ShaderCache();
+		ShaderCache(const ShaderCache& rhs);
+		ShaderCache& operator=(const ShaderCache& rhs);
+
+		struct BinaryHeader
+		{
+			char Magic[4];
+			std::uint32_t Version;
+			std::uint64_t Key;
+			std::uint32_t BinaryFormat;
+			std::uint32_t BinaryLength;
+		};
+
+		void InitializeDriver();
+		std::uint64_t DriverKey(std::uint64_t key) const;
+		std::wstring CacheFilename(std::uint64_t key) const;
+
+		std::wstring mCacheDirectory;
+		bool mEnabled;
+		bool mDriverInitialized;
+		bool mBinariesSupported;
+		std::uint64_t mDriverHash;
+		UINT mHitCount;
+		UINT mMissCount;
+		UINT mRejectedCount;
+
+		static const char Magic[4];
+		static const std::uint32_t Version;
+	};
+}
\ No newline at end of file
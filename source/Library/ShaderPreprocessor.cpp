@@ -0,0 +1,173 @@
+#include "ShaderPreprocessor.h"
+#include "GameException.h"
+#include "VirtualFileSystem.h"
+#include <algorithm>
+#include <sstream>
+
+namespace Library
+{
+	std::string ShaderPreprocessor::Preprocess(const std::string& filename, UINT permutation)
+	{
+		return Preprocess(filename, PermutationDefines(permutation));
+	}
+
+	std::string ShaderPreprocessor::Preprocess(const std::string& filename, const std::vector<std::string>& defines)
+	{
+		IncludeState state;
+		std::string output;
+		ProcessFile(VirtualFileSystem::NormalizePath(filename), defines, state, output);
+
+		return output;
+	}
+
+	std::vector<std::string> ShaderPreprocessor::PermutationDefines(UINT permutation)
+	{
+		static const std::pair<UINT, const char*> permutationNames[] =
+		{
+			std::pair<UINT, const char*>(ShaderPermutationFog, "FOG"),
+			std::pair<UINT, const char*>(ShaderPermutationNormalMap, "NORMAL_MAP"),
+			std::pair<UINT, const char*>(ShaderPermutationAlphaMap, "ALPHA_MAP"),
+			std::pair<UINT, const char*>(ShaderPermutationPointLight, "POINT_LIGHT"),
+			std::pair<UINT, const char*>(ShaderPermutationSpotLight, "SPOT_LIGHT"),
+			std::pair<UINT, const char*>(ShaderPermutationClusteredLights, "CLUSTERED_LIGHTS"),
+			std::pair<UINT, const char*>(ShaderPermutationGBuffer, "GBUFFER")
+		};
+
+		std::vector<std::string> defines;
+		for (const std::pair<UINT, const char*>& permutationName : permutationNames)
+		{
+			if ((permutation & permutationName.first) != 0)
+			{
+				defines.push_back(permutationName.second);
+			}
+		}
+
+		return defines;
+	}
+
+	void ShaderPreprocessor::ProcessFile(const std::string& filename, const std::vector<std::string>& defines, IncludeState& state, std::string& output)
+	{
+		if (std::find(state.Stack.begin(), state.Stack.end(), filename) != state.Stack.end())
+		{
+			throw GameException(("ShaderPreprocessor::ProcessFile() recursive include of " + filename + ".").c_str());
+		}
+
+		// Every file is included at most once per program stage
+		if (state.Included.insert(filename).second == false)
+		{
+			return;
+		}
+
+		FileView source = VirtualFileSystem::Instance().OpenFile(filename);
+
+		// GLSL identifies source strings by number; the index into Files maps it back to a filename
+		UINT fileIndex = state.Files.size();
+		state.Files.push_back(filename);
+		state.Stack.push_back(filename);
+
+		std::string directory;
+		size_t separator = filename.find_last_of('/');
+		if (separator != std::string::npos)
+		{
+			directory = filename.substr(0, separator + 1);
+		}
+
+		std::ostringstream stream;
+		if (fileIndex > 0)
+		{
+			stream << "#line 1 " << fileIndex << "\n";
+		}
+
+		bool definesEmitted = (fileIndex > 0);
+		UINT lineNumber = 0;
+		const char* current = source.begin();
+		while (current < source.end())
+		{
+			const char* lineEnd = std::find(current, source.end(), '\n');
+			std::string line(current, lineEnd);
+			current = (lineEnd < source.end() ? lineEnd + 1 : lineEnd);
+			lineNumber++;
+
+			if (line.empty() == false && line.back() == '\r')
+			{
+				line.pop_back();
+			}
+
+			std::string argument;
+			if (ParseDirective(line, "version", argument))
+			{
+				// #version must be the first statement, so defines go immediately after it
+				stream << line << "\n";
+				if (definesEmitted == false)
+				{
+					for (const std::string& define : defines)
+					{
+						stream << "#define " << define << " 1\n";
+					}
+					stream << "#line " << (lineNumber + 1) << " " << fileIndex << "\n";
+					definesEmitted = true;
+				}
+			}
+			else if (ParseDirective(line, "include", argument))
+			{
+				if (argument.size() < 2 || argument.front() != '"' || argument.back() != '"')
+				{
+					throw GameException(("ShaderPreprocessor::ProcessFile() malformed #include in " + filename + ".").c_str());
+				}
+
+				output += stream.str();
+				stream.str(std::string());
+
+				std::string includeFilename = VirtualFileSystem::NormalizePath(directory + argument.substr(1, argument.size() - 2));
+				ProcessFile(includeFilename, defines, state, output);
+				stream << "#line " << (lineNumber + 1) << " " << fileIndex << "\n";
+			}
+			else
+			{
+				stream << line << "\n";
+			}
+		}
+
+		output += stream.str();
+		state.Stack.pop_back();
+
+		if (definesEmitted == false)
+		{
+			// Sources without a #version line still honor the requested defines
+			std::ostringstream prefix;
+			for (const std::string& define : defines)
+			{
+				prefix << "#define " << define << " 1\n";
+			}
+			prefix << "#line 1 0\n";
+			output.insert(0, prefix.str());
+		}
+	}
+
+	bool ShaderPreprocessor::ParseDirective(const std::string& line, const std::string& directive, std::string& argument)
+	{
+		size_t position = line.find_first_not_of(" \t");
+		if (position == std::string::npos || line[position] != '#')
+		{
+			return false;
+		}
+
+		position = line.find_first_not_of(" \t", position + 1);
+		if (position == std::string::npos || line.compare(position, directive.size(), directive) != 0)
+		{
+			return false;
+		}
+
+		position += directive.size();
+		if (position < line.size() && line[position] != ' ' && line[position] != '\t')
+		{
+			return false;
+		}
+
+		size_t argumentBegin = line.find_first_not_of(" \t", position);
+		size_t argumentEnd = line.find_last_not_of(" \t");
+		argument = (argumentBegin == std::string::npos ? std::string() : line.substr(argumentBegin, argumentEnd - argumentBegin + 1));
+
+		return true;
+	}
+}
\ No newline at end of file
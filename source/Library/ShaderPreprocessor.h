@@ -0,0 +1,42 @@
+#pragma once
+
+#include "Common.h"
+#include <set>
+
+namespace Library
+{
+	enum ShaderPermutation
+	{
+		ShaderPermutationNone = 0,
+		ShaderPermutationFog = 0x01,
+		ShaderPermutationNormalMap = 0x02,
+		ShaderPermutationAlphaMap = 0x04,
+		ShaderPermutationPointLight = 0x08,
+		ShaderPermutationSpotLight = 0x10,
+		ShaderPermutationClusteredLights = 0x20,
+		ShaderPermutationGBuffer = 0x40
+	};
+
+	class ShaderPreprocessor
+	{
+	public:
+		static std::string Preprocess(const std::string& filename, UINT permutation = ShaderPermutationNone);
+		static std::string Preprocess(const std::string& filename, const std::vector<std::string>& defines);
+		static std::vector<std::string> PermutationDefines(UINT permutation);
+
+	private:
+		struct IncludeState
+		{
+			std::vector<std::string> Files;
+			std::vector<std::string> Stack;
+			std::set<std::string> Included;
+		};
+
+		static void ProcessFile(const std::string& filename, const std::vector<std::string>& defines, IncludeState& state, std::string& output);
+		static bool ParseDirective(const std::string& line, const std::string& directive, std::string& argument);
+
+		ShaderPreprocessor();
+		ShaderPreprocessor(const ShaderPreprocessor& rhs);
+		ShaderPreprocessor& operator=(const ShaderPreprocessor& rhs);
+	};
+}
\ No newline at end of file
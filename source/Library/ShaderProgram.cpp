@@ -1,24 +1,26 @@
 #include "ShaderProgram.h"
 #include "GameException.h"
 #include "Utility.h"
+#include "ShaderPreprocessor.h"
+#include "ShaderCache.h"
+#include "RenderStateCache.h"
+#include "HashHelper.h"
 #include "Model.h"
 #include "Mesh.h"
-#include <sstream>
+#include <algorithm>
 
 namespace Library
 {
 	RTTI_DEFINITIONS(ShaderProgram)
 
 	ShaderProgram::ShaderProgram()
-		: mProgram(0), mVariables(), mVariablesByName()
+		: mProgram(0), mSharedProgram(), mShaderDefinitions(), mPermutation(ShaderPermutationNone), mVariants(), mVariant(nullptr),
+		  mUniformNames(), mVariables(), mVariablesByName()
 	{
-		mProgram = glCreateProgram();
 	}
 
 	ShaderProgram::~ShaderProgram()
 	{
-		glDeleteProgram(mProgram);
-
 		for (Variable* variable : mVariables)
 		{
 			delete variable;
@@ -27,41 +29,38 @@ namespace Library
 
 	GLuint ShaderProgram::CompileShaderFromFile(GLenum shaderType, const std::wstring& filename)
 	{
-		std::vector<char> shaderSource;
-		Utility::LoadBinaryFile(filename, shaderSource);
-		GLchar* sourcePointer = &shaderSource[0];
-		GLint length = shaderSource.size();
+		std::string shaderSource = ShaderPreprocessor::Preprocess(Utility::ToString(filename));
+
+		return CompileShaderFromSource(shaderType, shaderSource.c_str(), static_cast<GLint>(shaderSource.size()));
+	}
 
+	GLuint ShaderProgram::CompileShaderFromSource(GLenum shaderType, const GLchar* source, GLint length)
+	{
 		GLuint shader = glCreateShader(shaderType);
-		glShaderSource(shader, 1, &sourcePointer, &length);
+		glShaderSource(shader, 1, &source, &length);
 		glCompileShader(shader);
 
-		GLint compileStatus;
-		glGetShaderiv(shader, GL_COMPILE_STATUS, &compileStatus);
-		if (compileStatus != GL_TRUE)
-		{
-			GLint logLength;
-			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
-
-			std::string log;
-			log.reserve(logLength);
-
-			glGetShaderInfoLog(shader, logLength, nullptr, const_cast<GLchar*>(log.c_str()));
-
-			std::stringstream errorMessage;
-			errorMessage << "glCompileShader() failed.\n" << log.c_str();
-
-			throw GameException(errorMessage.str().c_str());
-		}
-
+		// Querying the status here would wait for the compile; a failed compile surfaces when the program fails to link
 		return shader;
 	}
 
 	GLuint ShaderProgram::Program() const
 	{
+		if (mSharedProgram != nullptr)
+		{
+			mSharedProgram->Resolve();
+		}
+
 		return mProgram;
 	}
 
+	GLint ShaderProgram::UniformLocation(const std::string& name) const
+	{
+		assert(mSharedProgram != nullptr);
+
+		return mSharedProgram->UniformLocation(name);
+	}
+
 	const std::vector<Variable*>& ShaderProgram::Variables() const
 	{
 		return mVariables;
@@ -74,44 +73,204 @@ namespace Library
 
 	void ShaderProgram::BuildProgram(const std::vector<ShaderDefinition>& shaderDefinitions)
 	{
-		std::vector<GLuint> compiledShaders;
-		compiledShaders.reserve(shaderDefinitions.size());
+		std::vector<ShaderProgramBuild> builds;
+		builds.push_back(ShaderProgramBuild(this, shaderDefinitions));
+
+		BuildPrograms(builds);
+	}
+
+	void ShaderProgram::BuildPrograms(const std::vector<ShaderProgramBuild>& builds)
+	{
+		std::vector<SharedProgram*> pendingPrograms;
+
+		// Submit every compile before any link so the driver can work on them concurrently
+		for (const ShaderProgramBuild& build : builds)
+		{
+			ShaderProgram& shaderProgram = *build.first;
+			shaderProgram.mShaderDefinitions = build.second;
+			shaderProgram.mVariants.clear();
+			shaderProgram.mVariant = nullptr;
+			shaderProgram.SubmitVariant(pendingPrograms);
+		}
+
+		// Status is checked on first use, giving the driver time to finish while assets load
+		for (SharedProgram* pendingProgram : pendingPrograms)
+		{
+			pendingProgram->Link();
+		}
+	}
+
+	UINT ShaderProgram::Permutation() const
+	{
+		return mPermutation;
+	}
+
+	void ShaderProgram::SetPermutation(UINT permutation)
+	{
+		mPermutation = permutation;
+
+		auto variant = mVariants.find(permutation);
+		if (variant != mVariants.end())
+		{
+			mVariant = &variant->second;
+			mSharedProgram = mVariant->Program;
+			mProgram = mSharedProgram->Program();
+		}
+		else if (mShaderDefinitions.size() > 0)
+		{
+			// Variants are only compiled once they are actually selected
+			std::vector<SharedProgram*> pendingPrograms;
+			SubmitVariant(pendingPrograms);
+
+			for (SharedProgram* pendingProgram : pendingPrograms)
+			{
+				pendingProgram->Link();
+			}
+		}
+	}
+
+	void ShaderProgram::SubmitVariant(std::vector<SharedProgram*>& pendingPrograms)
+	{
+		// Components built from the same stage files and defines share one linked program
+		ShaderProgramRegistry* registry = ShaderProgramRegistry::Instance();
+		std::uint64_t registryKey = ShaderProgramRegistry::Key(mShaderDefinitions, mPermutation);
+		if (registry != nullptr)
+		{
+			mSharedProgram = registry->Find(registryKey);
+			if (mSharedProgram != nullptr)
+			{
+				mProgram = mSharedProgram->Program();
+				ActivateVariant();
+				return;
+			}
+		}
+
+		std::vector<std::string> shaderSources;
+		shaderSources.reserve(mShaderDefinitions.size());
 
-		for (ShaderDefinition shaderDefiniton : shaderDefinitions)
+		std::uint64_t binaryKey = HashHelper::OffsetBasis;
+		for (const ShaderDefinition& shaderDefiniton : mShaderDefinitions)
 		{
-			GLuint compiledShader = CompileShaderFromFile(shaderDefiniton.first, shaderDefiniton.second);
-			glAttachShader(mProgram, compiledShader);
-			compiledShaders.push_back(compiledShader);
+			std::string shaderSource = ShaderPreprocessor::Preprocess(Utility::ToString(shaderDefiniton.second), mPermutation);
+			binaryKey = HashHelper::Combine(binaryKey, shaderDefiniton.first);
+			binaryKey = HashHelper::Hash(shaderSource, binaryKey);
+			shaderSources.push_back(shaderSource);
 		}
 
-		glLinkProgram(mProgram);
-		GLint linkStatus;
-		glGetProgramiv(mProgram, GL_LINK_STATUS, &linkStatus);
-		if (linkStatus != GL_TRUE)
+		mSharedProgram = nullptr;
+
+		GLuint program = glCreateProgram();
+		ShaderCache* shaderCache = ShaderCache::Instance();
+		if (shaderCache != nullptr)
 		{
-			GLint logLength;
-			glGetProgramiv(mProgram, GL_INFO_LOG_LENGTH, &logLength);
+			if (shaderCache->LoadProgram(binaryKey, program))
+			{
+				mSharedProgram = std::make_shared<SharedProgram>(program);
+			}
+			else
+			{
+				// A rejected binary can leave the program object in an unusable state
+				glDeleteProgram(program);
+				program = glCreateProgram();
+				glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+			}
+		}
 
-			std::string log;
-			log.reserve(logLength);
+		if (mSharedProgram == nullptr)
+		{
+			std::vector<GLuint> shaders;
+			shaders.reserve(mShaderDefinitions.size());
 
-			glGetProgramInfoLog(mProgram, logLength, nullptr, const_cast<GLchar*>(log.c_str()));
+			for (size_t i = 0; i < mShaderDefinitions.size(); i++)
+			{
+				GLuint shader = glCreateShader(mShaderDefinitions[i].first);
+				const GLchar* source = shaderSources[i].c_str();
+				GLint length = static_cast<GLint>(shaderSources[i].size());
+				glShaderSource(shader, 1, &source, &length);
+				glCompileShader(shader);
 
-			std::stringstream errorMessage;
-			errorMessage << "glCompileShader() failed.\n" << log.c_str();
+				glAttachShader(program, shader);
+				shaders.push_back(shader);
+			}
 
-			throw GameException(errorMessage.str().c_str());
+			mSharedProgram = std::make_shared<SharedProgram>(program, shaders, binaryKey);
+			pendingPrograms.push_back(mSharedProgram.get());
 		}
 
-		for (GLuint compiledShader : compiledShaders)
+		mProgram = program;
+		ActivateVariant();
+		if (registry != nullptr)
 		{
-			glDeleteShader(compiledShader);
+			registry->Register(registryKey, mSharedProgram);
 		}
 	}
 
+	void ShaderProgram::ActivateVariant()
+	{
+		ShaderVariant& variant = mVariants[mPermutation];
+		variant.Program = mSharedProgram;
+		variant.Uniforms.clear();
+
+		mVariant = &variant;
+	}
+
+	UINT ShaderProgram::UniformHandle(const std::string& name)
+	{
+		auto uniformName = std::find(mUniformNames.begin(), mUniformNames.end(), name);
+		if (uniformName != mUniformNames.end())
+		{
+			return static_cast<UINT>(uniformName - mUniformNames.begin());
+		}
+
+		mUniformNames.push_back(name);
+
+		return mUniformNames.size() - 1;
+	}
+
+	const ShaderUniform* ShaderProgram::Uniform(UINT handle)
+	{
+		assert(mVariant != nullptr && handle < mUniformNames.size());
+
+		// Handles are resolved against each variant's reflection table once, the first time they are used with it
+		std::vector<const ShaderUniform*>& uniforms = mVariant->Uniforms;
+		for (size_t i = uniforms.size(); i <= handle; i++)
+		{
+			uniforms.push_back(mVariant->Program->FindUniform(mUniformNames[i]));
+		}
+
+		return uniforms[handle];
+	}
+
+	void ShaderProgram::StageUniform(const ShaderUniform& uniform, const void* value, UINT size)
+	{
+		assert(mSharedProgram != nullptr);
+
+		mSharedProgram->StageUniform(uniform, value, size);
+	}
+
+	void ShaderProgram::CommitUniforms()
+	{
+		assert(mSharedProgram != nullptr);
+
+		mSharedProgram->CommitUniforms();
+	}
+
+	bool ShaderProgram::IsReady() const
+	{
+		return (mSharedProgram != nullptr && mSharedProgram->IsComplete());
+	}
+
 	void ShaderProgram::Use() const
 	{
-		glUseProgram(mProgram);
+		RenderStateCache* renderStates = RenderStateCache::Instance();
+		if (renderStates != nullptr)
+		{
+			renderStates->UseProgram(Program());
+		}
+		else
+		{
+			glUseProgram(Program());
+		}
 	}
 
 	void ShaderProgram::CreateVertexBuffer(const Model& model, std::vector<GLuint>& vertexBuffers) const
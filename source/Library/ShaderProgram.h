@@ -2,13 +2,16 @@
 
 #include "Common.h"
 #include "Variable.h"
+#include "ShaderProgramRegistry.h"
+#include "ShaderPreprocessor.h"
 
 namespace Library
 {
 	class Model;
 	class Mesh;
+	class ShaderProgram;
 
-	typedef std::pair<GLenum, std::wstring> ShaderDefinition;
+	typedef std::pair<ShaderProgram*, std::vector<ShaderDefinition>> ShaderProgramBuild;
 
 	class ShaderProgram : public RTTI
 	{
@@ -19,14 +22,25 @@ namespace Library
 		virtual ~ShaderProgram();
 		
 		static GLuint CompileShaderFromFile(GLenum shaderType, const std::wstring& filename);
+		static GLuint CompileShaderFromSource(GLenum shaderType, const GLchar* source, GLint length);
 
 		Variable* operator[](const std::string& variableName);
 
 		GLuint Program() const;	
+		GLint UniformLocation(const std::string& name) const;
+		UINT UniformHandle(const std::string& name);
+		const ShaderUniform* Uniform(UINT handle);
+		void StageUniform(const ShaderUniform& uniform, const void* value, UINT size);
+		void CommitUniforms();
 		const std::vector<Variable*>& Variables() const;
 		const std::map<std::string, Variable*>& VariablesByName() const;
 
 		void BuildProgram(const std::vector<ShaderDefinition>& shaderDefinitions);
+		static void BuildPrograms(const std::vector<ShaderProgramBuild>& builds);
+		bool IsReady() const;
+
+		UINT Permutation() const;
+		void SetPermutation(UINT permutation);
 
 		virtual void Initialize(GLuint vertexArrayObject);
 		virtual void Use() const;
@@ -35,13 +49,28 @@ namespace Library
 		virtual UINT VertexSize() const;
 
 	protected:
+		struct ShaderVariant
+		{
+			std::shared_ptr<SharedProgram> Program;
+			std::vector<const ShaderUniform*> Uniforms;
+		};
+
 		GLuint mProgram;
+		std::shared_ptr<SharedProgram> mSharedProgram;
+		std::vector<ShaderDefinition> mShaderDefinitions;
+		UINT mPermutation;
+		std::map<UINT, ShaderVariant> mVariants;
+		ShaderVariant* mVariant;
+		std::vector<std::string> mUniformNames;
 		std::vector<Variable*> mVariables;
 		std::map<std::string, Variable*> mVariablesByName;
 
 	private:
 		ShaderProgram(const ShaderProgram& rhs);
 		ShaderProgram& operator=(const ShaderProgram& rhs);	
+
+		void SubmitVariant(std::vector<SharedProgram*>& pendingPrograms);
+		void ActivateVariant();
 	};
 
 	#define SHADER_VARIABLE_DECLARATION(VariableName)   \
@@ -0,0 +1,446 @@
+#include "ShaderProgramRegistry.h"
+#include "ShaderCache.h"
+#include "ExtensionHelper.h"
+#include "GameException.h"
+#include "HashHelper.h"
+#include "VirtualFileSystem.h"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+
+#ifndef GL_MAX_SHADER_COMPILER_THREADS_KHR
+#define GL_MAX_SHADER_COMPILER_THREADS_KHR 0x91B0
+#endif
+
+#ifndef GL_COMPLETION_STATUS_KHR
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace Library
+{
+	RTTI_DEFINITIONS(ShaderProgramRegistry)
+
+	typedef void (APIENTRY *PFNGLMAXSHADERCOMPILERTHREADSKHRPROC)(GLuint count);
+
+	UINT SharedProgram::sUniformUploadCount = 0;
+	UINT SharedProgram::sAvoidedUniformUploadCount = 0;
+
+	SharedProgram::SharedProgram(GLuint program)
+		: mProgram(program), mShaders(), mBinaryKey(0), mLinked(true), mResolved(true), mUniforms(), mUniformBlocks(),
+		  mUniformValues(), mDirtyUniforms()
+	{
+		Reflect();
+	}
+
+	SharedProgram::SharedProgram(GLuint program, const std::vector<GLuint>& shaders, std::uint64_t binaryKey)
+		: mProgram(program), mShaders(shaders), mBinaryKey(binaryKey), mLinked(false), mResolved(false), mUniforms(), mUniformBlocks(),
+		  mUniformValues(), mDirtyUniforms()
+	{
+	}
+
+	SharedProgram::~SharedProgram()
+	{
+		for (GLuint shader : mShaders)
+		{
+			glDeleteShader(shader);
+		}
+
+		glDeleteProgram(mProgram);
+	}
+
+	GLuint SharedProgram::Program() const
+	{
+		return mProgram;
+	}
+
+	GLint SharedProgram::UniformLocation(const std::string& name)
+	{
+		const ShaderUniform* uniform = FindUniform(name);
+
+		return (uniform != nullptr ? uniform->Location : -1);
+	}
+
+	const ShaderUniform* SharedProgram::FindUniform(const std::string& name)
+	{
+		Resolve();
+
+		auto uniform = std::lower_bound(mUniforms.begin(), mUniforms.end(), name, [](const ShaderUniform& lhs, const std::string& rhs) { return lhs.Name < rhs; });
+		if (uniform == mUniforms.end() || uniform->Name != name)
+		{
+			return nullptr;
+		}
+
+		return &(*uniform);
+	}
+
+	const std::vector<ShaderUniform>& SharedProgram::Uniforms()
+	{
+		Resolve();
+
+		return mUniforms;
+	}
+
+	const std::vector<ShaderUniformBlock>& SharedProgram::UniformBlocks()
+	{
+		Resolve();
+
+		return mUniformBlocks;
+	}
+
+	bool SharedProgram::StageUniform(const ShaderUniform& uniform, const void* value, UINT size)
+	{
+		assert(size <= sizeof(UniformValue::Data));
+
+		UINT index = static_cast<UINT>(&uniform - &mUniforms.front());
+		assert(index < mUniformValues.size());
+
+		// The shadow mirrors what the program holds (or will hold once committed), so matching values need no upload
+		UniformValue& shadow = mUniformValues[index];
+		if (shadow.Valid && memcmp(shadow.Data, value, size) == 0)
+		{
+			sAvoidedUniformUploadCount++;
+			return false;
+		}
+
+		memcpy(shadow.Data, value, size);
+		shadow.Valid = true;
+
+		if (shadow.Dirty == false)
+		{
+			shadow.Dirty = true;
+			mDirtyUniforms.push_back(index);
+		}
+
+		return true;
+	}
+
+	void SharedProgram::CommitUniforms()
+	{
+		// Program uniforms are written directly, so committing does not depend on (or disturb) the bound program
+		for (UINT index : mDirtyUniforms)
+		{
+			const ShaderUniform& uniform = mUniforms[index];
+			UniformValue& shadow = mUniformValues[index];
+
+			switch (uniform.Type)
+			{
+				case GL_FLOAT_MAT4:
+					glProgramUniformMatrix4fv(mProgram, uniform.Location, 1, GL_FALSE, shadow.Data);
+					break;
+
+				case GL_FLOAT_VEC4:
+					glProgramUniform4fv(mProgram, uniform.Location, 1, shadow.Data);
+					break;
+
+				case GL_FLOAT_VEC3:
+					glProgramUniform3fv(mProgram, uniform.Location, 1, shadow.Data);
+					break;
+
+				case GL_FLOAT_VEC2:
+					glProgramUniform2fv(mProgram, uniform.Location, 1, shadow.Data);
+					break;
+
+				case GL_FLOAT:
+					glProgramUniform1fv(mProgram, uniform.Location, 1, shadow.Data);
+					break;
+
+				default:
+					// Integers, booleans and sampler bindings are all staged through the integer overload
+					glProgramUniform1iv(mProgram, uniform.Location, 1, reinterpret_cast<const GLint*>(shadow.Data));
+					break;
+			}
+
+			shadow.Dirty = false;
+			sUniformUploadCount++;
+		}
+
+		mDirtyUniforms.clear();
+	}
+
+	UINT SharedProgram::UniformUploadCount()
+	{
+		return sUniformUploadCount;
+	}
+
+	UINT SharedProgram::AvoidedUniformUploadCount()
+	{
+		return sAvoidedUniformUploadCount;
+	}
+
+	bool SharedProgram::IsLinked() const
+	{
+		return mLinked;
+	}
+
+	bool SharedProgram::IsComplete() const
+	{
+		if (mResolved)
+		{
+			return true;
+		}
+
+		if (mLinked == false)
+		{
+			return false;
+		}
+
+		// Without the extension any status query blocks, so report the program as ready
+		ShaderProgramRegistry* registry = ShaderProgramRegistry::Instance();
+		if (registry == nullptr || registry->ParallelCompileSupported() == false)
+		{
+			return true;
+		}
+
+		GLint completionStatus;
+		glGetProgramiv(mProgram, GL_COMPLETION_STATUS_KHR, &completionStatus);
+
+		return (completionStatus == GL_TRUE);
+	}
+
+	void SharedProgram::Link()
+	{
+		if (mLinked == false)
+		{
+			glLinkProgram(mProgram);
+			mLinked = true;
+		}
+	}
+
+	void SharedProgram::Resolve()
+	{
+		if (mResolved)
+		{
+			return;
+		}
+
+		Link();
+
+		GLint linkStatus;
+		glGetProgramiv(mProgram, GL_LINK_STATUS, &linkStatus);
+		if (linkStatus != GL_TRUE)
+		{
+			std::stringstream errorMessage;
+
+			// Compile errors only surface here because compile status is no longer checked at submission
+			for (GLuint shader : mShaders)
+			{
+				GLint compileStatus;
+				glGetShaderiv(shader, GL_COMPILE_STATUS, &compileStatus);
+				if (compileStatus != GL_TRUE)
+				{
+					GLint logLength;
+					glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &logLength);
+
+					std::string log;
+					log.reserve(logLength);
+
+					glGetShaderInfoLog(shader, logLength, nullptr, const_cast<GLchar*>(log.c_str()));
+
+					errorMessage << "glCompileShader() failed.\n" << log.c_str();
+					throw GameException(errorMessage.str().c_str());
+				}
+			}
+
+			GLint logLength;
+			glGetProgramiv(mProgram, GL_INFO_LOG_LENGTH, &logLength);
+
+			std::string log;
+			log.reserve(logLength);
+
+			glGetProgramInfoLog(mProgram, logLength, nullptr, const_cast<GLchar*>(log.c_str()));
+
+			errorMessage << "glLinkProgram() failed.\n" << log.c_str();
+			throw GameException(errorMessage.str().c_str());
+		}
+
+		for (GLuint shader : mShaders)
+		{
+			glDetachShader(mProgram, shader);
+			glDeleteShader(shader);
+		}
+		mShaders.clear();
+		mResolved = true;
+
+		Reflect();
+
+		ShaderCache* shaderCache = ShaderCache::Instance();
+		if (shaderCache != nullptr)
+		{
+			shaderCache->SaveProgram(mBinaryKey, mProgram);
+		}
+	}
+
+	void SharedProgram::Reflect()
+	{
+		mUniforms.clear();
+		mUniformBlocks.clear();
+
+		std::vector<GLchar> name;
+
+		GLint uniformCount = 0;
+		glGetProgramInterfaceiv(mProgram, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+		mUniforms.reserve(uniformCount);
+
+		static const GLenum uniformProperties[] = { GL_NAME_LENGTH, GL_TYPE, GL_LOCATION, GL_ARRAY_SIZE, GL_BLOCK_INDEX };
+		for (GLint i = 0; i < uniformCount; i++)
+		{
+			GLint values[ARRAYSIZE(uniformProperties)];
+			glGetProgramResourceiv(mProgram, GL_UNIFORM, i, ARRAYSIZE(uniformProperties), uniformProperties, ARRAYSIZE(values), nullptr, values);
+
+			name.resize(values[0]);
+			glGetProgramResourceName(mProgram, GL_UNIFORM, i, values[0], nullptr, &name.front());
+
+			ShaderUniform uniform;
+			uniform.Name = &name.front();
+			uniform.Type = values[1];
+			uniform.Location = values[2];
+			uniform.ArraySize = values[3];
+			uniform.BlockIndex = values[4];
+
+			// Arrays are reported as "Name[0]" but are addressed by their base name
+			size_t subscript = uniform.Name.find("[0]");
+			if (subscript != std::string::npos && subscript + 3 == uniform.Name.size())
+			{
+				uniform.Name.erase(subscript);
+			}
+
+			mUniforms.push_back(uniform);
+		}
+
+		std::sort(mUniforms.begin(), mUniforms.end(), [](const ShaderUniform& lhs, const ShaderUniform& rhs) { return lhs.Name < rhs.Name; });
+
+		UniformValue emptyValue = { { 0 }, false, false };
+		mUniformValues.assign(mUniforms.size(), emptyValue);
+		mDirtyUniforms.clear();
+
+		GLint blockCount = 0;
+		glGetProgramInterfaceiv(mProgram, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &blockCount);
+		mUniformBlocks.reserve(blockCount);
+
+		static const GLenum blockProperties[] = { GL_NAME_LENGTH, GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE };
+		for (GLint i = 0; i < blockCount; i++)
+		{
+			GLint values[ARRAYSIZE(blockProperties)];
+			glGetProgramResourceiv(mProgram, GL_UNIFORM_BLOCK, i, ARRAYSIZE(blockProperties), blockProperties, ARRAYSIZE(values), nullptr, values);
+
+			name.resize(values[0]);
+			glGetProgramResourceName(mProgram, GL_UNIFORM_BLOCK, i, values[0], nullptr, &name.front());
+
+			ShaderUniformBlock block;
+			block.Name = &name.front();
+			block.Binding = values[1];
+			block.DataSize = values[2];
+
+			mUniformBlocks.push_back(block);
+		}
+	}
+
+	ShaderProgramRegistry::ShaderProgramRegistry()
+		: mPrograms(), mSharedCount(0), mParallelCompileSupported(false)
+	{
+	}
+
+	ShaderProgramRegistry::~ShaderProgramRegistry()
+	{
+	}
+
+	ShaderProgramRegistry* ShaderProgramRegistry::Instance()
+	{
+		return static_cast<ShaderProgramRegistry*>(GlobalServices.GetService(ShaderProgramRegistry::TypeIdClass()));
+	}
+
+	std::uint64_t ShaderProgramRegistry::Key(const std::vector<ShaderDefinition>& shaderDefinitions, UINT permutation)
+	{
+		std::uint64_t key = HashHelper::Combine(HashHelper::OffsetBasis, permutation);
+		for (const ShaderDefinition& shaderDefinition : shaderDefinitions)
+		{
+			key = HashHelper::Combine(key, shaderDefinition.first);
+			key = HashHelper::Hash(VirtualFileSystem::NormalizePath(shaderDefinition.second), key);
+		}
+
+		return key;
+	}
+
+	void ShaderProgramRegistry::InitializeParallelCompile()
+	{
+		const char* maxThreadsFunction = nullptr;
+		if (ExtensionHelper::IsSupported("GL_KHR_parallel_shader_compile"))
+		{
+			maxThreadsFunction = "glMaxShaderCompilerThreadsKHR";
+		}
+		else if (ExtensionHelper::IsSupported("GL_ARB_parallel_shader_compile"))
+		{
+			maxThreadsFunction = "glMaxShaderCompilerThreadsARB";
+		}
+
+		mParallelCompileSupported = (maxThreadsFunction != nullptr);
+		if (mParallelCompileSupported)
+		{
+			PFNGLMAXSHADERCOMPILERTHREADSKHRPROC glMaxShaderCompilerThreadsKHR = reinterpret_cast<PFNGLMAXSHADERCOMPILERTHREADSKHRPROC>(gl3wGetProcAddress(maxThreadsFunction));
+			if (glMaxShaderCompilerThreadsKHR != nullptr)
+			{
+				// Let the driver pick as many compiler threads as it sees fit
+				glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+			}
+		}
+	}
+
+	bool ShaderProgramRegistry::ParallelCompileSupported() const
+	{
+		return mParallelCompileSupported;
+	}
+
+	std::shared_ptr<SharedProgram> ShaderProgramRegistry::Find(std::uint64_t key)
+	{
+		auto entry = mPrograms.find(key);
+		if (entry == mPrograms.end())
+		{
+			return std::shared_ptr<SharedProgram>();
+		}
+
+		std::shared_ptr<SharedProgram> program = entry->second.lock();
+		if (program == nullptr)
+		{
+			mPrograms.erase(entry);
+		}
+		else
+		{
+			mSharedCount++;
+		}
+
+		return program;
+	}
+
+	void ShaderProgramRegistry::Register(std::uint64_t key, const std::shared_ptr<SharedProgram>& program)
+	{
+		RemoveExpired();
+		mPrograms[key] = program;
+	}
+
+	UINT ShaderProgramRegistry::ProgramCount()
+	{
+		RemoveExpired();
+
+		return mPrograms.size();
+	}
+
+	UINT ShaderProgramRegistry::SharedCount() const
+	{
+		return mSharedCount;
+	}
+
+	void ShaderProgramRegistry::RemoveExpired()
+	{
+		for (auto entry = mPrograms.begin(); entry != mPrograms.end();)
+		{
+			if (entry->second.expired())
+			{
+				entry = mPrograms.erase(entry);
+			}
+			else
+			{
+				++entry;
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Common.h"
+#include <cstdint>
+
+namespace Library
+{
+	typedef std::pair<GLenum, std::wstring> ShaderDefinition;
+
+	struct ShaderUniform
+	{
+		std::string Name;
+		GLenum Type;
+		GLint Location;
+		GLint ArraySize;
+		GLint BlockIndex;
+	};
+
+	struct ShaderUniformBlock
+	{
+		std::string Name;
+		GLint Binding;
+		GLint DataSize;
+	};
+
+	class SharedProgram
+	{
+	public:
+		explicit SharedProgram(GLuint program);
+		SharedProgram(GLuint program, const std::vector<GLuint>& shaders, std::uint64_t binaryKey);
+		~SharedProgram();
+
+		GLuint Program() const;
+		GLint UniformLocation(const std::string& name);
+		const ShaderUniform* FindUniform(const std::string& name);
+		const std::vector<ShaderUniform>& Uniforms();
+		const std::vector<ShaderUniformBlock>& UniformBlocks();
+
+		bool StageUniform(const ShaderUniform& uniform, const void* value, UINT size);
+		void CommitUniforms();
+		static UINT UniformUploadCount();
+		static UINT AvoidedUniformUploadCount();
+
+		bool IsLinked() const;
+		bool IsComplete() const;
+		void Link();
+		void Resolve();
+
+	private:
+		struct UniformValue
+		{
+			GLfloat Data[16];
+			bool Valid;
+			bool Dirty;
+		};
+
+		SharedProgram();
+		SharedProgram(const SharedProgram& rhs);
+		SharedProgram& operator=(const SharedProgram& rhs);
+
+		void Reflect();
+
+		GLuint mProgram;
+		std::vector<GLuint> mShaders;
+		std::uint64_t mBinaryKey;
+		bool mLinked;
+		bool mResolved;
+		std::vector<ShaderUniform> mUniforms;
+		std::vector<ShaderUniformBlock> mUniformBlocks;
+		std::vector<UniformValue> mUniformValues;
+		std::vector<UINT> mDirtyUniforms;
+
+		static UINT sUniformUploadCount;
+		static UINT sAvoidedUniformUploadCount;
+	};
+
+	class ShaderProgramRegistry : public RTTI
+	{
+		RTTI_DECLARATIONS(ShaderProgramRegistry, RTTI)
+
+	public:
+		ShaderProgramRegistry();
+		~ShaderProgramRegistry();
+
+		static ShaderProgramRegistry* Instance();
+		static std::uint64_t Key(const std::vector<ShaderDefinition>& shaderDefinitions, UINT permutation);
+
+		void InitializeParallelCompile();
+		bool ParallelCompileSupported() const;
+
+		std::shared_ptr<SharedProgram> Find(std::uint64_t key);
+		void Register(std::uint64_t key, const std::shared_ptr<SharedProgram>& program);
+
+		UINT ProgramCount();
+		UINT SharedCount() const;
+
+	private:
+		ShaderProgramRegistry(const ShaderProgramRegistry& rhs);
+		ShaderProgramRegistry& operator=(const ShaderProgramRegistry& rhs);
+
+		void RemoveExpired();
+
+		std::map<std::uint64_t, std::weak_ptr<SharedProgram>> mPrograms;
+		UINT mSharedCount;
+		bool mParallelCompileSupported;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,96 @@
+#include "Skeleton.h"
+#include "GameException.h"
+#include "Model.h"
+#include "MatrixHelper.h"
+
+using namespace glm;
+
+namespace Library
+{
+	const UINT Skeleton::NullJoint = 0xFFFFFFFF;
+
+	Skeleton::Skeleton(const Model& model)
+		: mParents(), mBindPose(), mBoneJoints(), mBoneOffsets(), mRootInverse()
+	{
+		const std::vector<ModelNode>& nodes = model.Nodes();
+		if (nodes.empty())
+		{
+			throw GameException("Skeleton::Skeleton() model has no nodes.");
+		}
+
+		mParents.reserve(nodes.size());
+		mBindPose.Resize(nodes.size());
+		for (UINT i = 0; i < nodes.size(); i++)
+		{
+			const ModelNode& node = nodes[i];
+			mParents.push_back(node.Parent != Model::NullNode ? node.Parent : NullJoint);
+
+			vec3 translation;
+			vec3 scale;
+			MatrixHelper::Decompose(node.Transform, translation, mBindPose.Rotations[i], scale);
+			mBindPose.Translations[i] = vec4(translation, 0.0f);
+			mBindPose.Scales[i] = vec4(scale, 0.0f);
+		}
+
+		for (const ModelBone& bone : model.Bones())
+		{
+			mBoneJoints.push_back(bone.Node);
+			mBoneOffsets.push_back(bone.OffsetTransform);
+		}
+
+		// Skinned vertices stay in the space of the model root rather than gaining its transform twice
+		mRootInverse = inverse(nodes.front().Transform);
+	}
+
+	UINT Skeleton::JointCount() const
+	{
+		return mParents.size();
+	}
+
+	UINT Skeleton::BoneCount() const
+	{
+		return mBoneJoints.size();
+	}
+
+	const std::vector<UINT>& Skeleton::Parents() const
+	{
+		return mParents;
+	}
+
+	const AnimationPose& Skeleton::BindPose() const
+	{
+		return mBindPose;
+	}
+
+	void Skeleton::ComputeModelMatrices(const AnimationPose& pose, mat4* modelMatrices) const
+	{
+		if (pose.JointCount() != mParents.size())
+		{
+			throw GameException("Skeleton::ComputeModelMatrices() pose does not match the skeleton.");
+		}
+
+		// Each joint waits on its parent, so this stays a plain multiply; batching each depth level through the SIMD kernel
+		// measured slower, since the gather and scatter cost more than the kernel saves on a few joints per level
+		for (UINT i = 0; i < mParents.size(); i++)
+		{
+			mat4 local = MatrixHelper::Compose(vec3(pose.Translations[i]), pose.Rotations[i], vec3(pose.Scales[i]));
+			const mat4& parent = (mParents[i] != NullJoint ? modelMatrices[mParents[i]] : mRootInverse);
+			modelMatrices[i] = parent * local;
+		}
+	}
+
+	void Skeleton::ComputeSkinningPalette(const mat4* modelMatrices, mat4* palette) const
+	{
+		if (mBoneJoints.empty())
+		{
+			return;
+		}
+
+		for (UINT i = 0; i < mBoneJoints.size(); i++)
+		{
+			palette[i] = modelMatrices[mBoneJoints[i]];
+		}
+
+		MatrixHelper::MultiplyMatrices(palette, &mBoneOffsets.front(), palette, mBoneJoints.size());
+	}
+}
\ No newline at end of file
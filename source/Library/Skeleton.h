@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Common.h"
+#include "AnimationPose.h"
+
+namespace Library
+{
+	class Model;
+
+	// The joint hierarchy of a model, in the model's depth-first node order so parents precede children.
+	// Bones are the joints that deform vertices; their palette entries follow the model's bone indices.
+	class Skeleton
+	{
+	public:
+		explicit Skeleton(const Model& model);
+
+		UINT JointCount() const;
+		UINT BoneCount() const;
+		const std::vector<UINT>& Parents() const;
+		const AnimationPose& BindPose() const;
+
+		void ComputeModelMatrices(const AnimationPose& pose, glm::mat4* modelMatrices) const;
+		void ComputeSkinningPalette(const glm::mat4* modelMatrices, glm::mat4* palette) const;
+
+		static const UINT NullJoint;
+
+	private:
+		Skeleton(const Skeleton& rhs);
+		Skeleton& operator=(const Skeleton& rhs);
+
+		std::vector<UINT> mParents;
+		AnimationPose mBindPose;
+		std::vector<UINT> mBoneJoints;
+		std::vector<glm::mat4> mBoneOffsets;
+		glm::mat4 mRootInverse;
+	};
+}
\ No newline at end of file
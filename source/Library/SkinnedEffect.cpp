@@ -0,0 +1,80 @@
+#include "SkinnedEffect.h"
+#include "GameException.h"
+#include "Mesh.h"
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(SkinnedEffect)
+
+	SkinnedEffect::SkinnedEffect()
+		: ShaderProgram(),
+		  SHADER_VARIABLE_INITIALIZATION(World), SHADER_VARIABLE_INITIALIZATION(Color), SHADER_VARIABLE_INITIALIZATION(BoneOffset)
+	{
+	}
+
+	SHADER_VARIABLE_DEFINITION(SkinnedEffect, World)
+	SHADER_VARIABLE_DEFINITION(SkinnedEffect, Color)
+	SHADER_VARIABLE_DEFINITION(SkinnedEffect, BoneOffset)
+
+	void SkinnedEffect::Initialize(GLuint vertexArrayObject)
+	{
+		ShaderProgram::Initialize(vertexArrayObject);
+
+		SHADER_VARIABLE_INSTANTIATE(World)
+		SHADER_VARIABLE_INSTANTIATE(Color)
+		SHADER_VARIABLE_INSTANTIATE(BoneOffset)
+
+		glVertexAttribPointer(VertexAttributePosition, 4, GL_FLOAT, GL_FALSE, sizeof(VertexSkinnedPositionTextureNormal), (void*)offsetof(VertexSkinnedPositionTextureNormal, Position));
+		glEnableVertexAttribArray(VertexAttributePosition);
+
+		glVertexAttribPointer(VertexAttributeNormal, 3, GL_FLOAT, GL_FALSE, sizeof(VertexSkinnedPositionTextureNormal), (void*)offsetof(VertexSkinnedPositionTextureNormal, Normal));
+		glEnableVertexAttribArray(VertexAttributeNormal);
+
+		// Integer attribute; glVertexAttribPointer would convert the indices to floats
+		glVertexAttribIPointer(VertexAttributeBoneIndices, 4, GL_UNSIGNED_INT, sizeof(VertexSkinnedPositionTextureNormal), (void*)offsetof(VertexSkinnedPositionTextureNormal, BoneIndices));
+		glEnableVertexAttribArray(VertexAttributeBoneIndices);
+
+		glVertexAttribPointer(VertexAttributeBoneWeights, 4, GL_FLOAT, GL_FALSE, sizeof(VertexSkinnedPositionTextureNormal), (void*)offsetof(VertexSkinnedPositionTextureNormal, BoneWeights));
+		glEnableVertexAttribArray(VertexAttributeBoneWeights);
+	}
+
+	void SkinnedEffect::CreateVertexBuffer(const Mesh& mesh, GLuint& vertexBuffer) const
+	{
+		const std::vector<vec3>& sourceVertices = mesh.Vertices();
+
+		const std::vector<vec3>& normals = mesh.Normals();
+		assert(normals.size() == sourceVertices.size());
+
+		// Meshes without influences get zero weights, which the vertex shader treats as rigid to the model root
+		const std::vector<uvec4>& boneIndices = mesh.BoneIndices();
+		const std::vector<vec4>& boneWeights = mesh.BoneWeights();
+		bool hasBones = mesh.HasBones();
+		const std::vector<vec3>* textureCoordinates = (mesh.TextureCoordinates().size() > 0 ? mesh.TextureCoordinates().at(0) : nullptr);
+
+		std::vector<VertexSkinnedPositionTextureNormal> vertices;
+		vertices.reserve(sourceVertices.size());
+		for (UINT i = 0; i < sourceVertices.size(); i++)
+		{
+			vec3 position = sourceVertices.at(i);
+			vec2 uv = (textureCoordinates != nullptr ? (vec2)textureCoordinates->at(i) : vec2());
+			vertices.push_back(VertexSkinnedPositionTextureNormal(vec4(position.x, position.y, position.z, 1.0f), uv, normals.at(i),
+				(hasBones ? boneIndices.at(i) : uvec4(0)), (hasBones ? boneWeights.at(i) : vec4(0.0f))));
+		}
+
+		CreateVertexBuffer(&vertices[0], vertices.size(), vertexBuffer);
+	}
+
+	void SkinnedEffect::CreateVertexBuffer(VertexSkinnedPositionTextureNormal* vertices, UINT vertexCount, GLuint& vertexBuffer) const
+	{
+		glGenBuffers(1, &vertexBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, VertexSize() * vertexCount, &vertices[0], GL_STATIC_DRAW);
+	}
+
+	UINT SkinnedEffect::VertexSize() const
+	{
+		return sizeof(VertexSkinnedPositionTextureNormal);
+	}
+}
\ No newline at end of file
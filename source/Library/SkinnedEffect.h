@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Common.h"
+#include "ShaderProgram.h"
+#include "VertexDeclarations.h"
+
+namespace Library
+{
+	class SkinnedEffect : public ShaderProgram
+	{
+		RTTI_DECLARATIONS(SkinnedEffect, ShaderProgram)
+
+		SHADER_VARIABLE_DECLARATION(World)
+		SHADER_VARIABLE_DECLARATION(Color)
+		SHADER_VARIABLE_DECLARATION(BoneOffset)
+
+	public:
+		SkinnedEffect();
+
+		virtual void Initialize(GLuint vertexArrayObject) override;
+		virtual void CreateVertexBuffer(const Mesh& mesh, GLuint& vertexBuffer) const override;
+		void CreateVertexBuffer(VertexSkinnedPositionTextureNormal* vertices, UINT vertexCount, GLuint& vertexBuffer) const;
+		virtual UINT VertexSize() const override;
+
+	private:
+		SkinnedEffect(const SkinnedEffect& rhs);
+		SkinnedEffect& operator=(const SkinnedEffect& rhs);
+
+		enum VertexAttribute
+		{
+			VertexAttributePosition = 0,
+			VertexAttributeNormal = 1,
+			VertexAttributeBoneIndices = 2,
+			VertexAttributeBoneWeights = 3
+		};
+	};
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+#include "SkinnedModel.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Camera.h"
+#include "ColorHelper.h"
+#include "Model.h"
+#include "Mesh.h"
+#include "Skeleton.h"
+#include "AnimationClip.h"
+#include "AnimationPlayer.h"
+#include "RenderCommandList.h"
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(SkinnedModel)
+
+	// Fraction of the bind-pose extents added on every side, so poses that reach past the bind pose are not culled
+	const float SkinnedModel::BoundsPadding = 0.25f;
+
+	SkinnedModel::SkinnedModel(Game& game, Camera& camera, const std::string& modelFileName)
+		: DrawableGameComponent(game, camera),
+		  mModelFileName(modelFileName), mShaderProgram(), mMeshes(), mModel(), mSkeleton(), mPlayer(), mBounds(),
+		  mTransform(game.Transforms().CreateNode()), mWorldVersion(0), mColor(ColorHelper::White)
+	{
+	}
+
+	SkinnedModel::~SkinnedModel()
+	{
+		if (mPlayer != nullptr)
+		{
+			mGame->Animations().RemovePlayer(*mPlayer);
+		}
+
+		mGame->Transforms().DestroyNode(mTransform);
+
+		for (MeshBuffers& mesh : mMeshes)
+		{
+			glDeleteBuffers(1, &mesh.IndexBuffer);
+			glDeleteBuffers(1, &mesh.VertexBuffer);
+			glDeleteVertexArrays(1, &mesh.VertexArray);
+		}
+	}
+
+	const Model& SkinnedModel::GetModel() const
+	{
+		if (mModel == nullptr)
+		{
+			throw GameException("SkinnedModel::GetModel() called before Initialize().");
+		}
+
+		return *mModel;
+	}
+
+	AnimationPlayer& SkinnedModel::Player()
+	{
+		if (mPlayer == nullptr)
+		{
+			throw GameException("SkinnedModel::Player() called before Initialize().");
+		}
+
+		return *mPlayer;
+	}
+
+	UINT SkinnedModel::TransformNode() const
+	{
+		return mTransform;
+	}
+
+	vec4& SkinnedModel::Color()
+	{
+		return mColor;
+	}
+
+	bool SkinnedModel::WorldBounds(BoundingBox& bounds) const
+	{
+		if (mModel == nullptr)
+		{
+			return false;
+		}
+
+		bounds = mBounds.Transform(mGame->Transforms().WorldMatrix(mTransform));
+		return true;
+	}
+
+	void SkinnedModel::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		// Shading matches the instanced path
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content/Effects/SkinnedEffect.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content/Effects/InstancedEffect.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
+	void SkinnedModel::Initialize()
+	{
+		// Build the shader program
+		BuildPrograms();
+
+		mModel.reset(new Model(*mGame, mModelFileName, true));
+		if (mModel->HasBones() == false)
+		{
+			throw GameException("SkinnedModel::Initialize() model has no bones.");
+		}
+
+		mSkeleton.reset(new Skeleton(*mModel));
+		mPlayer.reset(new AnimationPlayer(*mSkeleton));
+		if (mModel->HasAnimations())
+		{
+			mPlayer->Play(*mModel->Animations().front());
+		}
+
+		mGame->Animations().AddPlayer(*mPlayer);
+
+		for (Mesh* mesh : mModel->Meshes())
+		{
+			MeshBuffers buffers;
+			mShaderProgram.CreateVertexBuffer(*mesh, buffers.VertexBuffer);
+			mesh->CreateIndexBuffer(buffers.IndexBuffer);
+			buffers.IndexCount = mesh->Indices().size();
+
+			// Create the vertex array object
+			glGenVertexArrays(1, &buffers.VertexArray);
+			mShaderProgram.Initialize(buffers.VertexArray);
+			glBindVertexArray(0);
+
+			mMeshes.push_back(buffers);
+		}
+
+		vec3 padding = mModel->Bounds().Extents() * BoundsPadding;
+		mBounds = BoundingBox(mModel->Bounds().Minimum - padding, mModel->Bounds().Maximum + padding);
+	}
+
+	void SkinnedModel::Update(const GameTime& gameTime)
+	{
+		// Refit the spatial index leaf only when the character's node has actually moved
+		UINT worldVersion = mGame->Transforms().WorldVersion(mTransform);
+		if (worldVersion != mWorldVersion)
+		{
+			mWorldVersion = worldVersion;
+			UpdateSpatialProxy();
+		}
+	}
+
+	bool SkinnedModel::Record(const GameTime& gameTime, RenderCommandList& commandList)
+	{
+		// Only reads: Game::Draw has flushed the hierarchy and AnimationSystem has assigned palette offsets
+		const mat4& world = mGame->Transforms().UpdatedWorldMatrix(mTransform);
+		float depth = RenderQueue::ViewDepth(*mCamera, vec3(world * vec4(mBounds.Center(), 1.0f)));
+		int boneOffset = static_cast<int>(mPlayer->PaletteOffset());
+
+		for (const MeshBuffers& mesh : mMeshes)
+		{
+			DrawItem drawItem;
+			drawItem.Program = &mShaderProgram;
+			drawItem.VertexArray = mesh.VertexArray;
+			drawItem.VertexBuffer = mesh.VertexBuffer;
+			drawItem.IndexBuffer = mesh.IndexBuffer;
+			drawItem.Count = mesh.IndexCount;
+			drawItem.Depth = depth;
+
+			commandList.Submit(drawItem);
+			commandList.SetUniform(mShaderProgram.World(), world);
+			commandList.SetUniform(mShaderProgram.Color(), mColor);
+			commandList.SetUniform(mShaderProgram.BoneOffset(), boneOffset);
+		}
+
+		return true;
+	}
+
+	void SkinnedModel::Draw(const GameTime& gameTime)
+	{
+		// On the GL thread the lazy accessor can flush anything moved since Game::Draw, which Record will not
+		mGame->Transforms().WorldVersion(mTransform);
+
+		RenderCommandList commandList;
+		Record(gameTime, commandList);
+		mGame->DrawQueue().Submit(commandList);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "Common.h"
+#include "DrawableGameComponent.h"
+#include "SkinnedEffect.h"
+#include "BoundingVolume.h"
+
+namespace Library
+{
+	class Model;
+	class Skeleton;
+	class AnimationPlayer;
+
+	// An animated character. Its player is stepped by the game's AnimationSystem together with every other
+	// character, and the vertex shader skins against this character's slice of the shared bone palette.
+	class SkinnedModel : public DrawableGameComponent
+	{
+		RTTI_DECLARATIONS(SkinnedModel, DrawableGameComponent)
+
+	public:
+		SkinnedModel(Game& game, Camera& camera, const std::string& modelFileName);
+		~SkinnedModel();
+
+		const Model& GetModel() const;
+		AnimationPlayer& Player();
+		UINT TransformNode() const;
+		glm::vec4& Color();
+
+		virtual bool WorldBounds(BoundingBox& bounds) const override;
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
+		virtual void Initialize() override;
+		virtual void Update(const GameTime& gameTime) override;
+		virtual bool Record(const GameTime& gameTime, RenderCommandList& commandList) override;
+		virtual void Draw(const GameTime& gameTime) override;
+
+	private:
+		SkinnedModel();
+		SkinnedModel(const SkinnedModel& rhs);
+		SkinnedModel& operator=(const SkinnedModel& rhs);
+
+		struct MeshBuffers
+		{
+			GLuint VertexArray;
+			GLuint VertexBuffer;
+			GLuint IndexBuffer;
+			UINT IndexCount;
+		};
+
+		static const float BoundsPadding;
+
+		std::string mModelFileName;
+		SkinnedEffect mShaderProgram;
+		std::vector<MeshBuffers> mMeshes;
+		std::unique_ptr<Model> mModel;
+		std::unique_ptr<Skeleton> mSkeleton;
+		std::unique_ptr<AnimationPlayer> mPlayer;
+		BoundingBox mBounds;
+		UINT mTransform;
+		UINT mWorldVersion;
+		glm::vec4 mColor;
+	};
+}
\ No newline at end of file
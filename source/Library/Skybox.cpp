@@ -7,7 +7,7 @@
 #include "ColorHelper.h"
 #include "Model.h"
 #include "Mesh.h"
-#include "Utility.h"
+#include "CubemapLoader.h"
 #include "VertexDeclarations.h"
 #include "SOIL.h"
 
@@ -28,24 +28,26 @@ namespace Library
 
 	Skybox::~Skybox()
 	{
-		glDeleteSamplers(1, &mSkyboxTextureSampler);
 		glDeleteTextures(1,&mSkyboxTexture);
 		glDeleteBuffers(1, &mIndexBuffer);
 		glDeleteBuffers(1, &mVertexBuffer);
 		glDeleteVertexArrays(1, &mVertexArrayObject);
 	}
 
-	void Skybox::Initialize()
+	void Skybox::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
 	{
-		SetCurrentDirectory(Utility::ExecutableDirectory().c_str());
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content/Effects/Skybox.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content/Effects/Skybox.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
 
+	void Skybox::Initialize()
+	{
 		// Build the shader program
-		std::vector<ShaderDefinition> shaders;
-		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content\\Effects\\Skybox.vert"));
-		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content\\Effects\\Skybox.frag"));
-		mShaderProgram.BuildProgram(shaders);
+		BuildPrograms();
 
-		std::unique_ptr<Model> model(new Model(*mGame, "Content\\Models\\Sphere.obj"));
+		std::unique_ptr<Model> model(new Model(*mGame, "Content/Models/Sphere.obj"));
 
 		// Create the vertex and index buffers
 		Mesh* mesh = model->Meshes().at(0);
@@ -53,18 +55,9 @@ namespace Library
 		mesh->CreateIndexBuffer(mIndexBuffer);
 		mIndexCount = mesh->Indices().size();
 	
-		mSkyboxTexture = SOIL_load_OGL_cubemap(mPosXFilename.c_str(), mNegXFilename.c_str(), mPosYFilename.c_str(), mNegYFilename.c_str(), mPosZFilename.c_str(), mNegZFilename.c_str(), SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID, SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT);
-		if (mSkyboxTexture == 0)
-		{
-			throw GameException("SOIL_load_OGL_cubemap() failed.");
-		}
-
-		glGenSamplers(1, &mSkyboxTextureSampler);
-		glSamplerParameteri(mSkyboxTextureSampler, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glSamplerParameteri(mSkyboxTextureSampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glSamplerParameteri(mSkyboxTextureSampler, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glSamplerParameteri(mSkyboxTextureSampler, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glSamplerParameteri(mSkyboxTextureSampler, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+		mSkyboxTexture = CubemapLoader::LoadCubemap(mPosXFilename, mNegXFilename, mPosYFilename, mNegYFilename, mPosZFilename, mNegZFilename, SOIL_FLAG_NTSC_SAFE_RGB | SOIL_FLAG_COMPRESS_TO_DXT);
+
+		mSkyboxTextureSampler = mGame->Samplers().Sampler(SamplerDescription::LinearClamp);
 		
 		// Create the vertex array object
 		glGenVertexArrays(1, &mVertexArrayObject);
@@ -78,19 +71,22 @@ namespace Library
 
 	void Skybox::Draw(const GameTime& gameTime)
 	{
-		glBindVertexArray(mVertexArrayObject);
-		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
-		glBindSampler(0, mSkyboxTextureSampler);
+		RenderStateCache& renderStates = mGame->RenderStates();
+
+		renderStates.BindVertexArray(mVertexArrayObject);
+		renderStates.BindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+		renderStates.BindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+		renderStates.BindSampler(0, mSkyboxTextureSampler);
 
 		mShaderProgram.Use();
 
 		mat4 wvp = mCamera->ViewProjectionMatrix() * mWorldMatrix;
 		mShaderProgram.WorldViewProjection() << wvp;
+		mShaderProgram.CommitUniforms();
 		
-		glBindTexture(GL_TEXTURE_CUBE_MAP, mSkyboxTexture);
+		renderStates.BindTexture(0, GL_TEXTURE_CUBE_MAP, mSkyboxTexture);
 
-		glDisable(GL_CULL_FACE);
+		renderStates.SetCullingEnabled(false);
 
 		glDrawElements(GL_TRIANGLES, mIndexCount, GL_UNSIGNED_INT, 0);
 	}
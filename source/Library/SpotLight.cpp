@@ -35,7 +35,7 @@ namespace Library
 		return mRight;
 	}
 
-	float SpotLight::InnerAngle()
+	float SpotLight::InnerAngle() const
 	{
 		return mInnerAngle;
 	}
@@ -45,7 +45,7 @@ namespace Library
 		mInnerAngle = value;
 	}
 
-	float SpotLight::OuterAngle()
+	float SpotLight::OuterAngle() const
 	{
 		return mOuterAngle;
 	}
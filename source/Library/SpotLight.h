@@ -17,10 +17,10 @@ namespace Library
 		const glm::vec3& Up() const;
 		const glm::vec3& Right() const;
 
-		float InnerAngle();
+		float InnerAngle() const;
 		void SetInnerAngle(float value);
 		
-		float OuterAngle();
+		float OuterAngle() const;
 		void SetOuterAngle(float value);
 
         void ApplyRotation(const glm::mat4& transform);
@@ -0,0 +1,263 @@
+#include "StaticBatch.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Camera.h"
+#include "Model.h"
+#include "Mesh.h"
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(StaticBatch)
+
+	const GLuint StaticBatch::DrawDataBinding = 2;
+
+	StaticBatch::StaticBatch(Game& game, Camera& camera)
+		: DrawableGameComponent(game, camera),
+		  mShaderProgram(), mPendingDraws(), mDrawConstants(), mCommands(), mDrawBounds(), mVertexArrayObject(0), mVertexBuffer(0), mIndexBuffer(0),
+		  mDrawIdBuffer(0), mIndirectBuffer(0), mDrawDataBuffer(0), mDrawCount(0), mVertexCount(0), mIndexCount(0),
+		  mBounds(), mBatched(true)
+	{
+	}
+
+	StaticBatch::~StaticBatch()
+	{
+		DeletePendingDraws();
+		glDeleteVertexArrays(1, &mVertexArrayObject);
+		glDeleteBuffers(1, &mDrawDataBuffer);
+		glDeleteBuffers(1, &mIndirectBuffer);
+		glDeleteBuffers(1, &mDrawIdBuffer);
+		glDeleteBuffers(1, &mIndexBuffer);
+		glDeleteBuffers(1, &mVertexBuffer);
+	}
+
+	UINT StaticBatch::Add(const Mesh& mesh, const mat4& world, const vec4& color)
+	{
+		if (IsBuilt())
+		{
+			throw GameException("StaticBatch::Add() the batch has already been built.");
+		}
+
+		// The effect lays the vertices out once; Build() only has to copy them between buffers
+		PendingDraw pendingDraw;
+		mShaderProgram.CreateVertexBuffer(mesh, pendingDraw.VertexBuffer);
+		pendingDraw.VertexCount = mesh.Vertices().size();
+		pendingDraw.Indices = mesh.Indices();
+		mPendingDraws.push_back(pendingDraw);
+
+		DrawConstants drawConstants;
+		drawConstants.World = world;
+		drawConstants.Color = color;
+		mDrawConstants.push_back(drawConstants);
+
+		BoundingBox drawBounds = mesh.Bounds().Transform(world);
+		mDrawBounds.push_back(drawBounds);
+		mBounds.Merge(drawBounds);
+		UpdateSpatialProxy();
+
+		return mDrawConstants.size() - 1;
+	}
+
+	void StaticBatch::Add(const Model& model, const mat4& world, const vec4& color)
+	{
+		for (Mesh* mesh : model.Meshes())
+		{
+			Add(*mesh, world, color);
+		}
+	}
+
+	void StaticBatch::Build()
+	{
+		if (mPendingDraws.empty())
+		{
+			return;
+		}
+
+		UINT vertexCount = 0;
+		UINT indexCount = 0;
+		for (const PendingDraw& pendingDraw : mPendingDraws)
+		{
+			vertexCount += pendingDraw.VertexCount;
+			indexCount += pendingDraw.Indices.size();
+		}
+
+		// Bind the batch's own vertex array first; Build() can run mid-frame from Draw(), while another
+		// component's vertex array is still bound, and the element buffer bind below would land in it
+		glGenVertexArrays(1, &mVertexArrayObject);
+		glBindVertexArray(mVertexArrayObject);
+
+		// Gather the vertices on the GPU and the indices on the CPU; base vertex keeps the indices mesh-relative
+		const UINT vertexSize = mShaderProgram.VertexSize();
+		glGenBuffers(1, &mVertexBuffer);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, mVertexBuffer);
+		glBufferData(GL_COPY_WRITE_BUFFER, vertexSize * vertexCount, nullptr, GL_STATIC_DRAW);
+
+		std::vector<UINT> indices;
+		indices.reserve(indexCount);
+
+		mCommands.reserve(mPendingDraws.size());
+
+		std::vector<GLuint> drawIds;
+		drawIds.reserve(mPendingDraws.size());
+
+		UINT baseVertex = 0;
+		for (const PendingDraw& pendingDraw : mPendingDraws)
+		{
+			glBindBuffer(GL_COPY_READ_BUFFER, pendingDraw.VertexBuffer);
+			glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, vertexSize * baseVertex, vertexSize * pendingDraw.VertexCount);
+
+			DrawElementsIndirectCommand command;
+			command.Count = pendingDraw.Indices.size();
+			command.InstanceCount = 1;
+			command.FirstIndex = indices.size();
+			command.BaseVertex = baseVertex;
+			command.BaseInstance = mCommands.size();
+
+			drawIds.push_back(mCommands.size());
+			mCommands.push_back(command);
+			indices.insert(indices.end(), pendingDraw.Indices.begin(), pendingDraw.Indices.end());
+			baseVertex += pendingDraw.VertexCount;
+		}
+
+		glBindBuffer(GL_COPY_READ_BUFFER, 0);
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		DeletePendingDraws();
+
+		glGenBuffers(1, &mIndexBuffer);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(UINT) * indices.size(), &indices[0], GL_STATIC_DRAW);
+
+		glGenBuffers(1, &mIndirectBuffer);
+		glBindBuffer(GL_DRAW_INDIRECT_BUFFER, mIndirectBuffer);
+		glBufferData(GL_DRAW_INDIRECT_BUFFER, sizeof(DrawElementsIndirectCommand) * mCommands.size(), &mCommands[0], GL_STATIC_DRAW);
+
+		glGenBuffers(1, &mDrawDataBuffer);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, mDrawDataBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(DrawConstants) * mDrawConstants.size(), &mDrawConstants[0], GL_STATIC_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+		glGenBuffers(1, &mDrawIdBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, mDrawIdBuffer);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(GLuint) * drawIds.size(), &drawIds[0], GL_STATIC_DRAW);
+
+		// Set up the vertex array object
+		mShaderProgram.InitializeDrawIdAttribute();
+		glBindBuffer(GL_ARRAY_BUFFER, mVertexBuffer);
+		mShaderProgram.Initialize(mVertexArrayObject);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mIndexBuffer);
+		glBindVertexArray(0);
+
+		mDrawCount = mCommands.size();
+		mVertexCount = vertexCount;
+		mIndexCount = indexCount;
+
+		// Raw binds above bypassed the state cache
+		mGame->RenderStates().Invalidate();
+	}
+
+	bool StaticBatch::IsBuilt() const
+	{
+		return (mDrawCount > 0);
+	}
+
+	bool StaticBatch::IsBatched() const
+	{
+		return mBatched;
+	}
+
+	void StaticBatch::SetBatched(bool batched)
+	{
+		mBatched = batched;
+	}
+
+	UINT StaticBatch::DrawCount() const
+	{
+		return mDrawCount;
+	}
+
+	UINT StaticBatch::VertexCount() const
+	{
+		return mVertexCount;
+	}
+
+	UINT StaticBatch::IndexCount() const
+	{
+		return mIndexCount;
+	}
+
+	bool StaticBatch::WorldBounds(BoundingBox& bounds) const
+	{
+		bounds = mBounds;
+		return true;
+	}
+
+	void StaticBatch::CollectPrograms(std::vector<ShaderProgramBuild>& builds)
+	{
+		// The lighting is shared with the instanced effect
+		std::vector<ShaderDefinition> shaders;
+		shaders.push_back(ShaderDefinition(GL_VERTEX_SHADER, L"Content/Effects/StaticBatchEffect.vert"));
+		shaders.push_back(ShaderDefinition(GL_FRAGMENT_SHADER, L"Content/Effects/InstancedEffect.frag"));
+		builds.push_back(ShaderProgramBuild(&mShaderProgram, shaders));
+	}
+
+	void StaticBatch::Initialize()
+	{
+		// Build the shader program
+		BuildPrograms();
+	}
+
+	void StaticBatch::Draw(const GameTime& gameTime)
+	{
+		if (mPendingDraws.empty() == false)
+		{
+			Build();
+		}
+
+		if (mDrawCount == 0)
+		{
+			return;
+		}
+
+		DrawItem drawItem;
+		drawItem.Program = &mShaderProgram;
+		drawItem.VertexArray = mVertexArrayObject;
+		drawItem.IndexBuffer = mIndexBuffer;
+		drawItem.ApplyUniforms = [this]()
+		{
+			mGame->RenderStates().BindBufferBase(GL_SHADER_STORAGE_BUFFER, DrawDataBinding, mDrawDataBuffer);
+		};
+
+		if (mBatched)
+		{
+			drawItem.IndirectBuffer = mIndirectBuffer;
+			drawItem.Count = mDrawCount;
+			drawItem.Depth = RenderQueue::ViewDepth(*mCamera, mBounds.Center());
+			mGame->DrawQueue().Submit(drawItem);
+		}
+		else
+		{
+			// The same commands issued one by one, as the meshes would be drawn without a batch
+			for (UINT i = 0; i < mDrawCount; i++)
+			{
+				const DrawElementsIndirectCommand& command = mCommands[i];
+				drawItem.Count = command.Count;
+				drawItem.FirstIndex = command.FirstIndex;
+				drawItem.BaseVertex = command.BaseVertex;
+				drawItem.BaseInstance = command.BaseInstance;
+				drawItem.Depth = RenderQueue::ViewDepth(*mCamera, mDrawBounds[i].Center());
+				mGame->DrawQueue().Submit(drawItem);
+			}
+		}
+	}
+
+	void StaticBatch::DeletePendingDraws()
+	{
+		for (PendingDraw& pendingDraw : mPendingDraws)
+		{
+			glDeleteBuffers(1, &pendingDraw.VertexBuffer);
+		}
+
+		mPendingDraws.clear();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "DrawableGameComponent.h"
+#include "StaticBatchEffect.h"
+#include "ColorHelper.h"
+#include "BoundingVolume.h"
+
+namespace Library
+{
+	class Model;
+	class Mesh;
+
+	// Matches the layout glMultiDrawElementsIndirect reads from GL_DRAW_INDIRECT_BUFFER
+	struct DrawElementsIndirectCommand
+	{
+		GLuint Count;
+		GLuint InstanceCount;
+		GLuint FirstIndex;
+		GLint BaseVertex;
+		GLuint BaseInstance;
+	};
+
+	// Merges static meshes into one vertex buffer and one index buffer and draws them all with a single
+	// glMultiDrawElementsIndirect. Each draw's base instance doubles as its draw id, which the vertex shader
+	// uses to fetch its transform and color from a storage buffer. A batch is built once; Draw() builds it
+	// if the caller has not. Every mesh is shaded with the instanced material (position and normal, lit by
+	// the shared FrameData/LightData blocks, tinted by its draw's color), so only meshes drawn with that
+	// material belong in a batch. Unbatched, the same buffers are drawn with one call per mesh.
+	class StaticBatch : public DrawableGameComponent
+	{
+		RTTI_DECLARATIONS(StaticBatch, DrawableGameComponent)
+
+	public:
+		StaticBatch(Game& game, Camera& camera);
+		~StaticBatch();
+
+		UINT Add(const Mesh& mesh, const glm::mat4& world, const glm::vec4& color = ColorHelper::White);
+		void Add(const Model& model, const glm::mat4& world, const glm::vec4& color = ColorHelper::White);
+		void Build();
+		bool IsBuilt() const;
+		bool IsBatched() const;
+		void SetBatched(bool batched);
+
+		UINT DrawCount() const;
+		UINT VertexCount() const;
+		UINT IndexCount() const;
+
+		virtual bool WorldBounds(BoundingBox& bounds) const override;
+		virtual void CollectPrograms(std::vector<ShaderProgramBuild>& builds) override;
+		virtual void Initialize() override;
+		virtual void Draw(const GameTime& gameTime) override;
+
+		static const GLuint DrawDataBinding;
+
+	private:
+		StaticBatch();
+		StaticBatch(const StaticBatch& rhs);
+		StaticBatch& operator=(const StaticBatch& rhs);
+
+		struct PendingDraw
+		{
+			GLuint VertexBuffer;
+			UINT VertexCount;
+			std::vector<UINT> Indices;
+		};
+
+		struct DrawConstants
+		{
+			glm::mat4 World;
+			glm::vec4 Color;
+		};
+
+		void DeletePendingDraws();
+
+		StaticBatchEffect mShaderProgram;
+		std::vector<PendingDraw> mPendingDraws;
+		std::vector<DrawConstants> mDrawConstants;
+		std::vector<DrawElementsIndirectCommand> mCommands;
+		std::vector<BoundingBox> mDrawBounds;
+		GLuint mVertexArrayObject;
+		GLuint mVertexBuffer;
+		GLuint mIndexBuffer;
+		GLuint mDrawIdBuffer;
+		GLuint mIndirectBuffer;
+		GLuint mDrawDataBuffer;
+		UINT mDrawCount;
+		UINT mVertexCount;
+		UINT mIndexCount;
+		BoundingBox mBounds;
+		bool mBatched;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "StaticBatchEffect.h"
+#include "GameException.h"
+#include "Mesh.h"
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(StaticBatchEffect)
+
+	StaticBatchEffect::StaticBatchEffect()
+		: ShaderProgram()
+	{
+	}
+
+	void StaticBatchEffect::Initialize(GLuint vertexArrayObject)
+	{
+		ShaderProgram::Initialize(vertexArrayObject);
+
+		glVertexAttribPointer(VertexAttributePosition, 4, GL_FLOAT, GL_FALSE, sizeof(VertexPositionNormal), (void*)offsetof(VertexPositionNormal, Position));
+		glEnableVertexAttribArray(VertexAttributePosition);
+
+		glVertexAttribPointer(VertexAttributeNormal, 3, GL_FLOAT, GL_FALSE, sizeof(VertexPositionNormal), (void*)offsetof(VertexPositionNormal, Normal));
+		glEnableVertexAttribArray(VertexAttributeNormal);
+	}
+
+	void StaticBatchEffect::InitializeDrawIdAttribute()
+	{
+		// One id per instance; each indirect command's base instance selects its own entry
+		glVertexAttribIPointer(VertexAttributeDrawId, 1, GL_UNSIGNED_INT, sizeof(GLuint), 0);
+		glVertexAttribDivisor(VertexAttributeDrawId, 1);
+		glEnableVertexAttribArray(VertexAttributeDrawId);
+	}
+
+	void StaticBatchEffect::CreateVertexBuffer(const Mesh& mesh, GLuint& vertexBuffer) const
+	{
+		const std::vector<vec3>& sourceVertices = mesh.Vertices();
+
+		const std::vector<vec3>& normals = mesh.Normals();
+		assert(normals.size() == sourceVertices.size());
+
+		std::vector<VertexPositionNormal> vertices;
+		vertices.reserve(sourceVertices.size());
+		for (UINT i = 0; i < sourceVertices.size(); i++)
+		{
+			vec3 position = sourceVertices.at(i);
+			vec3 normal = normals.at(i);
+			vertices.push_back(VertexPositionNormal(vec4(position.x, position.y, position.z, 1.0f), normal));
+		}
+
+		CreateVertexBuffer(&vertices[0], vertices.size(), vertexBuffer);
+	}
+
+	void StaticBatchEffect::CreateVertexBuffer(VertexPositionNormal* vertices, UINT vertexCount, GLuint& vertexBuffer) const
+	{
+		glGenBuffers(1, &vertexBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+		glBufferData(GL_ARRAY_BUFFER, VertexSize() * vertexCount, &vertices[0], GL_STATIC_DRAW);
+	}
+
+	UINT StaticBatchEffect::VertexSize() const
+	{
+		return sizeof(VertexPositionNormal);
+	}
+}
\ No newline at end of file
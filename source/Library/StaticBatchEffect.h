@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Common.h"
+#include "ShaderProgram.h"
+#include "VertexDeclarations.h"
+
+namespace Library
+{
+	class StaticBatchEffect : public ShaderProgram
+	{
+		RTTI_DECLARATIONS(StaticBatchEffect, ShaderProgram)
+
+	public:
+		StaticBatchEffect();
+
+		virtual void Initialize(GLuint vertexArrayObject) override;
+		void InitializeDrawIdAttribute();
+		virtual void CreateVertexBuffer(const Mesh& mesh, GLuint& vertexBuffer) const override;
+		void CreateVertexBuffer(VertexPositionNormal* vertices, UINT vertexCount, GLuint& vertexBuffer) const;
+		virtual UINT VertexSize() const override;
+
+	private:
+		StaticBatchEffect(const StaticBatchEffect& rhs);
+		StaticBatchEffect& operator=(const StaticBatchEffect& rhs);
+
+		enum VertexAttribute
+		{
+			VertexAttributePosition = 0,
+			VertexAttributeNormal = 1,
+			VertexAttributeDrawId = 2
+		};
+	};
+}
\ No newline at end of file
@@ -0,0 +1,338 @@
+#include "TransformHierarchy.h"
+#include "GameException.h"
+#include "Model.h"
+#include "MatrixHelper.h"
+
+using namespace glm;
+
+namespace Library
+{
+	RTTI_DEFINITIONS(TransformHierarchy)
+
+	const UINT TransformHierarchy::NullNode = 0xFFFFFFFF;
+
+	TransformHierarchy::TransformHierarchy()
+		: mParentIndices(), mNodeHandles(), mTranslations(), mRotations(), mScales(), mWorldMatrices(), mWorldVersions(), mLocalDirty(),
+		  mHandleIndices(), mFreeHandles(), mFirstDirty(NullNode), mVersion(0), mUpdatedNodeCount(0)
+	{
+	}
+
+	TransformHierarchy::~TransformHierarchy()
+	{
+	}
+
+	TransformHierarchy* TransformHierarchy::Instance()
+	{
+		return static_cast<TransformHierarchy*>(GlobalServices.GetService(TransformHierarchy::TypeIdClass()));
+	}
+
+	UINT TransformHierarchy::CreateNode(UINT parent)
+	{
+		UINT parentIndex = (parent != NullNode ? IndexOf(parent) : NullNode);
+
+		UINT node;
+		if (mFreeHandles.empty())
+		{
+			node = mHandleIndices.size();
+			mHandleIndices.push_back(NullNode);
+		}
+		else
+		{
+			node = mFreeHandles.back();
+			mFreeHandles.pop_back();
+		}
+
+		// Appending keeps the order topological, since the parent is already in the arrays
+		UINT index = mNodeHandles.size();
+		mHandleIndices[node] = index;
+		mNodeHandles.push_back(node);
+		mParentIndices.push_back(parentIndex);
+		mTranslations.push_back(vec3(0.0f));
+		mRotations.push_back(quat());
+		mScales.push_back(vec3(1.0f));
+		mWorldMatrices.push_back(mat4());
+		mWorldVersions.push_back(0);
+		mLocalDirty.push_back(0);
+		MarkDirty(index);
+
+		return node;
+	}
+
+	UINT TransformHierarchy::Instantiate(const Model& model, UINT parent, std::vector<UINT>& nodes)
+	{
+		const std::vector<ModelNode>& modelNodes = model.Nodes();
+		if (modelNodes.empty())
+		{
+			throw GameException("TransformHierarchy::Instantiate() model has no nodes.");
+		}
+
+		// Model nodes are stored depth-first, so each node's parent has been created before it
+		nodes.resize(modelNodes.size());
+		for (UINT i = 0; i < modelNodes.size(); i++)
+		{
+			const ModelNode& modelNode = modelNodes[i];
+			nodes[i] = CreateNode(modelNode.Parent != Model::NullNode ? nodes[modelNode.Parent] : parent);
+			SetLocalTransform(nodes[i], modelNode.Transform);
+		}
+
+		return nodes.front();
+	}
+
+	void TransformHierarchy::DestroyNode(UINT node)
+	{
+		UINT index = IndexOf(node);
+
+		std::vector<char> inSubtree;
+		CollectSubtree(index, inSubtree);
+
+		std::vector<UINT> order;
+		order.reserve(mNodeHandles.size());
+		for (UINT i = 0; i < mNodeHandles.size(); i++)
+		{
+			if (inSubtree[i])
+			{
+				mHandleIndices[mNodeHandles[i]] = NullNode;
+				mFreeHandles.push_back(mNodeHandles[i]);
+			}
+			else
+			{
+				order.push_back(i);
+			}
+		}
+
+		Reorder(order);
+	}
+
+	void TransformHierarchy::SetParent(UINT node, UINT parent)
+	{
+		UINT index = IndexOf(node);
+		UINT parentIndex = (parent != NullNode ? IndexOf(parent) : NullNode);
+
+		std::vector<char> inSubtree;
+		CollectSubtree(index, inSubtree);
+		if (parentIndex != NullNode && inSubtree[parentIndex])
+		{
+			throw GameException("TransformHierarchy::SetParent() parent is a descendant of the node.");
+		}
+
+		mParentIndices[index] = parentIndex;
+		MarkDirty(index);
+
+		// A parent stored after the node would break the single forward pass, so the subtree moves to the end
+		if (parentIndex != NullNode && parentIndex > index)
+		{
+			std::vector<UINT> order;
+			order.reserve(mNodeHandles.size());
+			for (UINT i = 0; i < mNodeHandles.size(); i++)
+			{
+				if (inSubtree[i] == 0)
+				{
+					order.push_back(i);
+				}
+			}
+
+			for (UINT i = index; i < mNodeHandles.size(); i++)
+			{
+				if (inSubtree[i])
+				{
+					order.push_back(i);
+				}
+			}
+
+			Reorder(order);
+		}
+	}
+
+	UINT TransformHierarchy::Parent(UINT node) const
+	{
+		UINT parentIndex = mParentIndices[IndexOf(node)];
+		return (parentIndex != NullNode ? mNodeHandles[parentIndex] : NullNode);
+	}
+
+	const vec3& TransformHierarchy::LocalTranslation(UINT node) const
+	{
+		return mTranslations[IndexOf(node)];
+	}
+
+	const quat& TransformHierarchy::LocalRotation(UINT node) const
+	{
+		return mRotations[IndexOf(node)];
+	}
+
+	const vec3& TransformHierarchy::LocalScale(UINT node) const
+	{
+		return mScales[IndexOf(node)];
+	}
+
+	void TransformHierarchy::SetLocalTranslation(UINT node, const vec3& translation)
+	{
+		UINT index = IndexOf(node);
+		mTranslations[index] = translation;
+		MarkDirty(index);
+	}
+
+	void TransformHierarchy::SetLocalRotation(UINT node, const quat& rotation)
+	{
+		UINT index = IndexOf(node);
+		mRotations[index] = rotation;
+		MarkDirty(index);
+	}
+
+	void TransformHierarchy::SetLocalScale(UINT node, const vec3& scale)
+	{
+		UINT index = IndexOf(node);
+		mScales[index] = scale;
+		MarkDirty(index);
+	}
+
+	void TransformHierarchy::SetLocalTransform(UINT node, const mat4& transform)
+	{
+		UINT index = IndexOf(node);
+		MatrixHelper::Decompose(transform, mTranslations[index], mRotations[index], mScales[index]);
+		MarkDirty(index);
+	}
+
+	const mat4& TransformHierarchy::WorldMatrix(UINT node)
+	{
+		UINT index = IndexOf(node);
+		if (mFirstDirty != NullNode)
+		{
+			UpdateWorldMatrices();
+		}
+
+		return mWorldMatrices[index];
+	}
+
+	UINT TransformHierarchy::WorldVersion(UINT node)
+	{
+		UINT index = IndexOf(node);
+		if (mFirstDirty != NullNode)
+		{
+			UpdateWorldMatrices();
+		}
+
+		return mWorldVersions[index];
+	}
+
+	const mat4& TransformHierarchy::UpdatedWorldMatrix(UINT node) const
+	{
+		assert(mFirstDirty == NullNode);
+		return mWorldMatrices[IndexOf(node)];
+	}
+
+	void TransformHierarchy::UpdateWorldMatrices()
+	{
+		mUpdatedNodeCount = 0;
+		if (mFirstDirty == NullNode)
+		{
+			return;
+		}
+
+		// Nodes before the first flagged one cannot have changed, and parents always precede their children
+		mVersion++;
+		for (UINT i = mFirstDirty; i < mNodeHandles.size(); i++)
+		{
+			UINT parentIndex = mParentIndices[i];
+			bool parentChanged = (parentIndex != NullNode && mWorldVersions[parentIndex] == mVersion);
+			if (mLocalDirty[i] || parentChanged)
+			{
+				mat4 local = MatrixHelper::Compose(mTranslations[i], mRotations[i], mScales[i]);
+				mWorldMatrices[i] = (parentIndex != NullNode ? mWorldMatrices[parentIndex] * local : local);
+				mWorldVersions[i] = mVersion;
+				mLocalDirty[i] = 0;
+				mUpdatedNodeCount++;
+			}
+		}
+
+		mFirstDirty = NullNode;
+	}
+
+	UINT TransformHierarchy::NodeCount() const
+	{
+		return mNodeHandles.size();
+	}
+
+	UINT TransformHierarchy::UpdatedNodeCount() const
+	{
+		return mUpdatedNodeCount;
+	}
+
+	UINT TransformHierarchy::IndexOf(UINT node) const
+	{
+		if (node >= mHandleIndices.size() || mHandleIndices[node] == NullNode)
+		{
+			throw GameException("TransformHierarchy::IndexOf() invalid node.");
+		}
+
+		return mHandleIndices[node];
+	}
+
+	void TransformHierarchy::MarkDirty(UINT index)
+	{
+		mLocalDirty[index] = 1;
+		mFirstDirty = (index < mFirstDirty ? index : mFirstDirty);
+	}
+
+	void TransformHierarchy::CollectSubtree(UINT index, std::vector<char>& inSubtree) const
+	{
+		// Descendants are always stored after their ancestors, so one forward scan finds them all
+		inSubtree.assign(mNodeHandles.size(), 0);
+		inSubtree[index] = 1;
+		for (UINT i = index + 1; i < mNodeHandles.size(); i++)
+		{
+			UINT parentIndex = mParentIndices[i];
+			if (parentIndex != NullNode && inSubtree[parentIndex])
+			{
+				inSubtree[i] = 1;
+			}
+		}
+	}
+
+	void TransformHierarchy::Reorder(const std::vector<UINT>& order)
+	{
+		std::vector<UINT> newIndices(mNodeHandles.size(), NullNode);
+		for (UINT i = 0; i < order.size(); i++)
+		{
+			newIndices[order[i]] = i;
+		}
+
+		std::vector<UINT> parentIndices(order.size());
+		std::vector<UINT> nodeHandles(order.size());
+		std::vector<vec3> translations(order.size());
+		std::vector<quat> rotations(order.size());
+		std::vector<vec3> scales(order.size());
+		std::vector<mat4> worldMatrices(order.size());
+		std::vector<UINT> worldVersions(order.size());
+		std::vector<char> localDirty(order.size());
+
+		mFirstDirty = NullNode;
+		for (UINT i = 0; i < order.size(); i++)
+		{
+			UINT oldIndex = order[i];
+			UINT parentIndex = mParentIndices[oldIndex];
+			parentIndices[i] = (parentIndex != NullNode ? newIndices[parentIndex] : NullNode);
+			nodeHandles[i] = mNodeHandles[oldIndex];
+			translations[i] = mTranslations[oldIndex];
+			rotations[i] = mRotations[oldIndex];
+			scales[i] = mScales[oldIndex];
+			worldMatrices[i] = mWorldMatrices[oldIndex];
+			worldVersions[i] = mWorldVersions[oldIndex];
+			localDirty[i] = mLocalDirty[oldIndex];
+
+			mHandleIndices[nodeHandles[i]] = i;
+			if (localDirty[i] && mFirstDirty == NullNode)
+			{
+				mFirstDirty = i;
+			}
+		}
+
+		mParentIndices.swap(parentIndices);
+		mNodeHandles.swap(nodeHandles);
+		mTranslations.swap(translations);
+		mRotations.swap(rotations);
+		mScales.swap(scales);
+		mWorldMatrices.swap(worldMatrices);
+		mWorldVersions.swap(worldVersions);
+		mLocalDirty.swap(localDirty);
+	}
+}
\ No newline at end of file
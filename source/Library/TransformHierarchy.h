@@ -0,0 +1,76 @@
+#pragma once
+
+#include "Common.h"
+#include "glm/gtc/quaternion.hpp"
+
+namespace Library
+{
+	class Model;
+
+	// Scene transforms in flat arrays sorted so every parent precedes its children. Setting a local translation,
+	// rotation or scale only flags the node; UpdateWorldMatrices then makes one forward pass from the first flagged
+	// node, recomputing a node when it was flagged or its parent was recomputed in the same pass. A scene with
+	// nothing flagged returns immediately. Nodes are addressed by stable handles, since reparenting and
+	// destruction reorder the arrays.
+	class TransformHierarchy : public RTTI
+	{
+		RTTI_DECLARATIONS(TransformHierarchy, RTTI)
+
+	public:
+		TransformHierarchy();
+		~TransformHierarchy();
+
+		static TransformHierarchy* Instance();
+
+		UINT CreateNode(UINT parent = NullNode);
+		UINT Instantiate(const Model& model, UINT parent, std::vector<UINT>& nodes);
+		void DestroyNode(UINT node);
+		void SetParent(UINT node, UINT parent);
+		UINT Parent(UINT node) const;
+
+		const glm::vec3& LocalTranslation(UINT node) const;
+		const glm::quat& LocalRotation(UINT node) const;
+		const glm::vec3& LocalScale(UINT node) const;
+
+		void SetLocalTranslation(UINT node, const glm::vec3& translation);
+		void SetLocalRotation(UINT node, const glm::quat& rotation);
+		void SetLocalScale(UINT node, const glm::vec3& scale);
+		void SetLocalTransform(UINT node, const glm::mat4& transform);
+
+		const glm::mat4& WorldMatrix(UINT node);
+		UINT WorldVersion(UINT node);
+		void UpdateWorldMatrices();
+
+		// Worker-safe: never updates, so the hierarchy must have been flushed on the main thread since the last edit
+		const glm::mat4& UpdatedWorldMatrix(UINT node) const;
+
+		UINT NodeCount() const;
+		UINT UpdatedNodeCount() const;
+
+		static const UINT NullNode;
+
+	private:
+		TransformHierarchy(const TransformHierarchy& rhs);
+		TransformHierarchy& operator=(const TransformHierarchy& rhs);
+
+		UINT IndexOf(UINT node) const;
+		void MarkDirty(UINT index);
+		void CollectSubtree(UINT index, std::vector<char>& inSubtree) const;
+		void Reorder(const std::vector<UINT>& order);
+
+		std::vector<UINT> mParentIndices;
+		std::vector<UINT> mNodeHandles;
+		std::vector<glm::vec3> mTranslations;
+		std::vector<glm::quat> mRotations;
+		std::vector<glm::vec3> mScales;
+		std::vector<glm::mat4> mWorldMatrices;
+		std::vector<UINT> mWorldVersions;
+		std::vector<char> mLocalDirty;
+
+		std::vector<UINT> mHandleIndices;
+		std::vector<UINT> mFreeHandles;
+		UINT mFirstDirty;
+		UINT mVersion;
+		UINT mUpdatedNodeCount;
+	};
+}
\ No newline at end of file
@@ -5,13 +5,10 @@
 namespace Library
 {
 	Variable::Variable(ShaderProgram& shaderProgram, const std::string& name)
-		: mShaderProgram(shaderProgram), mLocation(-1), mName(name)
+		: mShaderProgram(shaderProgram), mHandle(0), mProgram(0), mUniform(nullptr), mLocation(-1), mType(GL_NONE), mName(name)
 	{
-		mLocation = glGetUniformLocation(mShaderProgram.Program(), name.c_str());
-		if (mLocation == -1)
-		{
-			throw GameException("glGetUniformLocation() did not find uniform location.");
-		}
+		// The location is looked up on first use, so instantiating variables never waits on the program's link
+		mHandle = mShaderProgram.UniformHandle(name);
 	}
 
 	ShaderProgram& Variable::GetShaderProgram()
@@ -19,10 +16,29 @@ namespace Library
 		return mShaderProgram;
 	}
 
+	UINT Variable::Handle() const
+	{
+		return mHandle;
+	}
+
 	const GLint& Variable::Location() const
 	{
+		UpdateLocation();
+
 		return mLocation;
 	}
+
+	GLenum Variable::Type() const
+	{
+		UpdateLocation();
+
+		return mType;
+	}
+
+	bool Variable::IsActive() const
+	{
+		return (Location() != -1);
+	}
 	
 	const std::string& Variable::Name() const
 	{
@@ -31,43 +47,123 @@ namespace Library
 
 	Variable& Variable::operator<<(const glm::mat4& value)
 	{
-		glUniformMatrix4fv(mLocation, 1, GL_FALSE, &value[0][0]);
+		Stage(GL_FLOAT_MAT4, value);
 
 		return *this;
 	}
 
 	Variable& Variable::operator<<(const glm::vec4& value)
 	{
-		glUniform4fv(mLocation, 1, &value[0]);
-	
+		Stage(GL_FLOAT_VEC4, value);
+
 		return *this;
 	}
 
 	Variable& Variable::operator<<(const glm::vec3& value)
 	{
-		glUniform3fv(mLocation, 1, &value[0]);
+		Stage(GL_FLOAT_VEC3, value);
 
 		return *this;
 	}
 
 	Variable& Variable::operator<<(const glm::vec2& value)
 	{
-		glUniform2fv(mLocation, 1, &value[0]);
+		Stage(GL_FLOAT_VEC2, value);
 
 		return *this;
 	}
 
 	Variable& Variable::operator<<(float value)
 	{
-		glUniform1f(mLocation, value);				
+		Stage(GL_FLOAT, value);
 
 		return *this;
 	}
 
 	Variable& Variable::operator<<(int value)
 	{
-		glUniform1i(mLocation, value);
+		Stage(GL_INT, value);
 
 		return *this;
 	}
+
+	template <typename T>
+	void Variable::Stage(GLenum valueType, const T& value)
+	{
+		UpdateLocation();
+
+		// Uniforms the compiler optimized out (or a variant does not declare) are silently skipped
+		if (mLocation == -1)
+		{
+			return;
+		}
+
+		if (IsCompatible(mType, valueType) == false)
+		{
+			throw GameException(("Variable::operator<<() value type does not match uniform " + mName + ".").c_str());
+		}
+
+		// Values are shadowed and uploaded in a batch by ShaderProgram::CommitUniforms() just before drawing
+		mShaderProgram.StageUniform(*mUniform, &value, sizeof(T));
+	}
+
+	void Variable::UpdateLocation() const
+	{
+		// Switching permutations swaps the underlying program, and locations differ between variants
+		GLuint program = mShaderProgram.Program();
+		if (mProgram != program)
+		{
+			mUniform = mShaderProgram.Uniform(mHandle);
+			mLocation = (mUniform != nullptr ? mUniform->Location : -1);
+			mType = (mUniform != nullptr ? mUniform->Type : GL_NONE);
+			mProgram = program;
+		}
+	}
+
+	bool Variable::IsCompatible(GLenum uniformType, GLenum valueType)
+	{
+		if (uniformType == valueType)
+		{
+			return true;
+		}
+
+		if (valueType != GL_INT)
+		{
+			return false;
+		}
+
+		// Booleans and sampler bindings are set through the integer overload
+		switch (uniformType)
+		{
+			case GL_BOOL:
+			case GL_SAMPLER_1D:
+			case GL_SAMPLER_2D:
+			case GL_SAMPLER_3D:
+			case GL_SAMPLER_CUBE:
+			case GL_SAMPLER_1D_SHADOW:
+			case GL_SAMPLER_2D_SHADOW:
+			case GL_SAMPLER_1D_ARRAY:
+			case GL_SAMPLER_2D_ARRAY:
+			case GL_SAMPLER_1D_ARRAY_SHADOW:
+			case GL_SAMPLER_2D_ARRAY_SHADOW:
+			case GL_SAMPLER_2D_MULTISAMPLE:
+			case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+			case GL_SAMPLER_CUBE_SHADOW:
+			case GL_SAMPLER_BUFFER:
+			case GL_SAMPLER_2D_RECT:
+			case GL_SAMPLER_2D_RECT_SHADOW:
+			case GL_INT_SAMPLER_2D:
+			case GL_INT_SAMPLER_3D:
+			case GL_INT_SAMPLER_CUBE:
+			case GL_INT_SAMPLER_2D_ARRAY:
+			case GL_UNSIGNED_INT_SAMPLER_2D:
+			case GL_UNSIGNED_INT_SAMPLER_3D:
+			case GL_UNSIGNED_INT_SAMPLER_CUBE:
+			case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+				return true;
+
+			default:
+				return false;
+		}
+	}
 }
\ No newline at end of file
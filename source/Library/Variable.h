@@ -5,6 +5,7 @@
 namespace Library
 {
 	class ShaderProgram;
+	struct ShaderUniform;
 
     class Variable
     {
@@ -12,7 +13,10 @@ namespace Library
 		Variable(ShaderProgram& shaderProgram, const std::string& name);		
 
         ShaderProgram& GetShaderProgram();
+		UINT Handle() const;
 		const GLint& Location() const;
+		GLenum Type() const;
+		bool IsActive() const;
         const std::string& Name() const;
 
         Variable& operator<<(const glm::mat4& value);
@@ -26,8 +30,17 @@ namespace Library
         Variable(const Variable& rhs);
         Variable& operator=(const Variable& rhs);
 
+		template <typename T>
+		void Stage(GLenum valueType, const T& value);
+		void UpdateLocation() const;
+		static bool IsCompatible(GLenum uniformType, GLenum valueType);
+
 		ShaderProgram& mShaderProgram;
-		GLint mLocation;
+		UINT mHandle;
+		mutable GLuint mProgram;
+		mutable const ShaderUniform* mUniform;
+		mutable GLint mLocation;
+		mutable GLenum mType;
         std::string mName;
     };
 }
\ No newline at end of file
@@ -118,4 +118,16 @@ namespace Library
 		VertexSkinnedPositionTextureNormal(const glm::vec4& position, const glm::vec2& textureCoordinates, const glm::vec3& normal, const glm::uvec4& boneIndices, const glm::vec4& boneWeights)
 			: Position(position), TextureCoordinates(textureCoordinates), Normal(normal), BoneIndices(boneIndices), BoneWeights(boneWeights) { }
 	};
+
+	class InstanceWorldColor
+	{
+	public:
+		glm::mat4 World;
+		glm::vec4 Color;
+
+		InstanceWorldColor() { }
+
+		InstanceWorldColor(const glm::mat4& world, const glm::vec4& color)
+			: World(world), Color(color) { }
+	};
 }
@@ -0,0 +1,329 @@
+#include "VirtualFileSystem.h"
+#include "AssetPack.h"
+#include "FileBuffer.h"
+#include "GameException.h"
+#include "Utility.h"
+#include <fstream>
+#include <sstream>
+
+#if !defined(_WIN32)
+#include <sys/stat.h>
+#endif
+
+namespace Library
+{
+	RTTI_DEFINITIONS(VirtualFileSystem)
+
+	const size_t VirtualFileSystem::DefaultSmallFileThreshold = 64 * 1024;
+
+	VirtualFileSystem::VirtualFileSystem()
+		: mMountPoints(), mCache(), mSmallFileThreshold(DefaultSmallFileThreshold), mMutex()
+	{
+	}
+
+	VirtualFileSystem::~VirtualFileSystem()
+	{
+	}
+
+	VirtualFileSystem& VirtualFileSystem::Instance()
+	{
+		return *static_cast<VirtualFileSystem*>(GlobalServices.GetService(VirtualFileSystem::TypeIdClass()));
+	}
+
+	std::string VirtualFileSystem::NormalizePath(const std::string& path)
+	{
+		std::vector<std::string> segments;
+		std::string segment;
+
+		for (std::string::size_type i = 0; i <= path.size(); i++)
+		{
+			char c = (i < path.size() ? path[i] : '/');
+			if (c != '/' && c != '\\')
+			{
+				segment.push_back(c);
+				continue;
+			}
+
+			if (segment == "..")
+			{
+				if (segments.empty())
+				{
+					throw GameException("VirtualFileSystem::NormalizePath() path escapes its mount point.");
+				}
+
+				segments.pop_back();
+			}
+			else if (segment.empty() == false && segment != ".")
+			{
+				segments.push_back(segment);
+			}
+
+			segment.clear();
+		}
+
+		std::string normalizedPath;
+		for (const std::string& normalizedSegment : segments)
+		{
+			if (normalizedPath.empty() == false)
+			{
+				normalizedPath.push_back('/');
+			}
+
+			normalizedPath += normalizedSegment;
+		}
+
+		return normalizedPath;
+	}
+
+	std::string VirtualFileSystem::NormalizePath(const std::wstring& path)
+	{
+		return NormalizePath(Utility::ToString(path));
+	}
+
+	void VirtualFileSystem::Mount(const std::string& mountPoint, const std::wstring& directory)
+	{
+		MountPoint newMountPoint;
+		newMountPoint.Prefix = NormalizePath(mountPoint);
+		newMountPoint.Directory = directory;
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		mMountPoints.push_back(newMountPoint);
+		mCache.clear();
+	}
+
+	void VirtualFileSystem::MountPack(const std::string& mountPoint, const std::wstring& packFilename)
+	{
+		MountPoint newMountPoint;
+		newMountPoint.Prefix = NormalizePath(mountPoint);
+		newMountPoint.Pack = std::make_shared<AssetPack>(packFilename);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		mMountPoints.push_back(newMountPoint);
+		mCache.clear();
+	}
+
+	void VirtualFileSystem::Unmount(const std::string& mountPoint)
+	{
+		std::string prefix = NormalizePath(mountPoint);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (auto it = mMountPoints.begin(); it != mMountPoints.end();)
+		{
+			if (it->Prefix == prefix)
+			{
+				it = mMountPoints.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		mCache.clear();
+	}
+
+	bool VirtualFileSystem::Exists(const std::string& path) const
+	{
+		std::string normalizedPath = NormalizePath(path);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+		for (auto it = mMountPoints.rbegin(); it != mMountPoints.rend(); ++it)
+		{
+			std::string relativePath;
+			if (MatchMountPoint(*it, normalizedPath, relativePath))
+			{
+				if (it->Pack != nullptr ? it->Pack->Contains(relativePath) : FileExists(it->Directory + L"/" + Utility::ToWideString(relativePath)))
+				{
+					return true;
+				}
+			}
+		}
+
+		return false;
+	}
+
+	bool VirtualFileSystem::ResolvePath(const std::string& path, std::wstring& physicalPath) const
+	{
+		std::string normalizedPath = NormalizePath(path);
+
+		std::lock_guard<std::mutex> lock(mMutex);
+
+		// Later mounts shadow earlier ones; packs have no physical path
+		for (auto it = mMountPoints.rbegin(); it != mMountPoints.rend(); ++it)
+		{
+			const MountPoint& mountPoint = *it;
+
+			std::string relativePath;
+			if (mountPoint.Pack != nullptr || MatchMountPoint(mountPoint, normalizedPath, relativePath) == false)
+			{
+				continue;
+			}
+
+			std::wstring candidate = mountPoint.Directory + L"/" + Utility::ToWideString(relativePath);
+			if (FileExists(candidate))
+			{
+				physicalPath = candidate;
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	FileView VirtualFileSystem::OpenFile(const std::string& path)
+	{
+		std::string normalizedPath = NormalizePath(path);
+
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			auto cachedFile = mCache.find(normalizedPath);
+			if (cachedFile != mCache.end())
+			{
+				return cachedFile->second;
+			}
+		}
+
+		std::vector<MountPoint> mountPoints;
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+			mountPoints = mMountPoints;
+		}
+
+		// Later mounts shadow earlier ones
+		for (auto it = mountPoints.rbegin(); it != mountPoints.rend(); ++it)
+		{
+			const MountPoint& mountPoint = *it;
+
+			std::string relativePath;
+			if (MatchMountPoint(mountPoint, normalizedPath, relativePath) == false)
+			{
+				continue;
+			}
+
+			FileView fileView;
+			if (mountPoint.Pack != nullptr)
+			{
+				if (mountPoint.Pack->OpenFile(relativePath, fileView) == false)
+				{
+					continue;
+				}
+			}
+			else
+			{
+				std::wstring physicalPath = mountPoint.Directory + L"/" + Utility::ToWideString(relativePath);
+				if (FileExists(physicalPath) == false)
+				{
+					continue;
+				}
+
+				fileView = FileView(LoadFile(physicalPath));
+			}
+
+			if (fileView.Size() <= mSmallFileThreshold)
+			{
+				std::lock_guard<std::mutex> lock(mMutex);
+				mCache[normalizedPath] = fileView;
+			}
+
+			return fileView;
+		}
+
+		std::stringstream errorMessage;
+		errorMessage << "VirtualFileSystem::OpenFile() could not find " << normalizedPath << ".";
+
+		throw GameException(errorMessage.str().c_str());
+	}
+
+	size_t VirtualFileSystem::SmallFileThreshold() const
+	{
+		return mSmallFileThreshold;
+	}
+
+	void VirtualFileSystem::SetSmallFileThreshold(size_t threshold)
+	{
+		mSmallFileThreshold = threshold;
+	}
+
+	void VirtualFileSystem::ClearCache()
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mCache.clear();
+	}
+
+	bool VirtualFileSystem::MatchMountPoint(const MountPoint& mountPoint, const std::string& normalizedPath, std::string& relativePath)
+	{
+		if (mountPoint.Prefix.empty())
+		{
+			relativePath = normalizedPath;
+			return true;
+		}
+
+		if (normalizedPath.size() > mountPoint.Prefix.size() && normalizedPath[mountPoint.Prefix.size()] == '/' && normalizedPath.compare(0, mountPoint.Prefix.size(), mountPoint.Prefix) == 0)
+		{
+			relativePath = normalizedPath.substr(mountPoint.Prefix.size() + 1);
+			return true;
+		}
+
+		return false;
+	}
+
+	bool VirtualFileSystem::FileExists(const std::wstring& physicalPath)
+	{
+#if defined(_WIN32)
+		DWORD attributes = GetFileAttributesW(physicalPath.c_str());
+		return (attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) == 0);
+#else
+		struct stat fileStatus;
+		return (stat(Utility::ToString(physicalPath).c_str(), &fileStatus) == 0 && S_ISREG(fileStatus.st_mode));
+#endif
+	}
+
+	size_t VirtualFileSystem::FileSize(const std::wstring& physicalPath)
+	{
+#if defined(_WIN32)
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if (GetFileAttributesExW(physicalPath.c_str(), GetFileExInfoStandard, &attributes) == FALSE)
+		{
+			return 0;
+		}
+
+		return static_cast<size_t>((static_cast<unsigned long long>(attributes.nFileSizeHigh) << 32) | attributes.nFileSizeLow);
+#else
+		struct stat fileStatus;
+		if (stat(Utility::ToString(physicalPath).c_str(), &fileStatus) != 0)
+		{
+			return 0;
+		}
+
+		return static_cast<size_t>(fileStatus.st_size);
+#endif
+	}
+
+	std::shared_ptr<const FileBuffer> VirtualFileSystem::LoadFile(const std::wstring& physicalPath) const
+	{
+		// Small files are read once into memory and cached; everything else is mapped on demand
+		size_t size = FileSize(physicalPath);
+		if (size > mSmallFileThreshold)
+		{
+			return std::shared_ptr<const FileBuffer>(new MappedFileBuffer(physicalPath));
+		}
+
+		std::vector<char> data(size);
+#if defined(_WIN32)
+		std::ifstream file(physicalPath.c_str(), std::ios::binary);
+#else
+		std::ifstream file(Utility::ToString(physicalPath).c_str(), std::ios::binary);
+#endif
+		if (file.fail())
+		{
+			throw GameException("VirtualFileSystem::LoadFile() could not open file.");
+		}
+
+		if (size > 0)
+		{
+			file.read(&data.front(), size);
+		}
+
+		return std::shared_ptr<const FileBuffer>(new MemoryFileBuffer(data));
+	}
+}
\ No newline at end of file
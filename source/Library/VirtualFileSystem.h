@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Common.h"
+#include "FileView.h"
+#include <mutex>
+
+namespace Library
+{
+	class FileBuffer;
+	class AssetPack;
+
+	class VirtualFileSystem : public RTTI
+	{
+		RTTI_DECLARATIONS(VirtualFileSystem, RTTI)
+
+	public:
+		VirtualFileSystem();
+		~VirtualFileSystem();
+
+		static VirtualFileSystem& Instance();
+		static std::string NormalizePath(const std::string& path);
+		static std::string NormalizePath(const std::wstring& path);
+
+		void Mount(const std::string& mountPoint, const std::wstring& directory);
+		void MountPack(const std::string& mountPoint, const std::wstring& packFilename);
+		void Unmount(const std::string& mountPoint);
+
+		bool Exists(const std::string& path) const;
+		bool ResolvePath(const std::string& path, std::wstring& physicalPath) const;
+		FileView OpenFile(const std::string& path);
+
+		size_t SmallFileThreshold() const;
+		void SetSmallFileThreshold(size_t threshold);
+		void ClearCache();
+
+		static const size_t DefaultSmallFileThreshold;
+
+	private:
+		VirtualFileSystem(const VirtualFileSystem& rhs);
+		VirtualFileSystem& operator=(const VirtualFileSystem& rhs);
+
+		struct MountPoint
+		{
+			std::string Prefix;
+			std::wstring Directory;
+			std::shared_ptr<AssetPack> Pack;
+		};
+
+		static bool MatchMountPoint(const MountPoint& mountPoint, const std::string& normalizedPath, std::string& relativePath);
+		static bool FileExists(const std::wstring& physicalPath);
+		static size_t FileSize(const std::wstring& physicalPath);
+		std::shared_ptr<const FileBuffer> LoadFile(const std::wstring& physicalPath) const;
+
+		std::vector<MountPoint> mMountPoints;
+		std::map<std::string, FileView> mCache;
+		size_t mSmallFileThreshold;
+		mutable std::mutex mMutex;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+// Light storage shared by the clustered forward and deferred light volume passes; the binding matches ClusteredLighting::LightBinding.
+// Include after FrameConstants.glsl and Lighting.glsl.
+
+struct ClusteredLight
+{
+	vec4 Position;		// xyz world position, w radius
+	vec4 Color;
+	vec4 Direction;		// xyz spot direction, w inner angle
+	vec4 Parameters;	// x outer angle, y 1 for spot lights
+};
+
+layout (std430, binding = 4) readonly buffer ClusteredLightData
+{
+	ClusteredLight Lights[];
+};
+
+void AccumulateClusteredLight(ClusteredLight light, vec3 worldPosition, vec3 normal, vec3 viewDirection, vec4 sampledColor, vec4 specularColor, float specularPower, inout vec3 diffuse, inout vec3 specular)
+{
+	vec3 lightVector = light.Position.xyz - worldPosition;
+	float attenuation = ComputeAttenuation(lightVector, light.Position.w);
+	if (attenuation <= 0.0f)
+	{
+		return;
+	}
+
+	vec3 lightDirection = normalize(lightVector);
+	if (light.Parameters.y > 0.0f)
+	{
+		attenuation *= ComputeSpotFactor(light.Direction.xyz, -lightDirection, light.Direction.w, light.Parameters.x);
+	}
+
+	vec3 lightDiffuse;
+	vec3 lightSpecular;
+	ComputeBlinnPhong(normal, lightDirection, viewDirection, sampledColor, light.Color, specularColor, specularPower, lightDiffuse, lightSpecular);
+
+	diffuse += lightDiffuse * attenuation;
+	specular += lightSpecular * attenuation;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+// Clustered light lists; the bindings match ClusteredLighting::ClusterBinding and LightIndexBinding.
+// Include after FrameConstants.glsl and Lighting.glsl.
+
+#include "ClusteredLightData.glsl"
+
+layout (std430, binding = 5) readonly buffer ClusterData
+{
+	vec4 ClusterScale;
+	vec4 ClusterBias;
+	uvec4 ClusterDimensions;
+	uvec2 Clusters[];	// x first index, y light count
+};
+
+layout (std430, binding = 6) readonly buffer ClusterLightIndexData
+{
+	uint LightIndices[];
+};
+
+uint ComputeClusterIndex(vec3 worldPosition)
+{
+	float depth = -(View * vec4(worldPosition, 1.0f)).z;
+
+	uvec3 cell;
+	cell.xy = uvec2(gl_FragCoord.xy * ClusterScale.xy);
+	cell.z = uint(max(log(depth) * ClusterScale.z + ClusterBias.z, 0.0f));
+	cell = min(cell, ClusterDimensions.xyz - 1);
+
+	return cell.x + ClusterDimensions.x * (cell.y + ClusterDimensions.y * cell.z);
+}
+
+void AccumulateClusteredLights(vec3 worldPosition, vec3 normal, vec3 viewDirection, vec4 sampledColor, vec4 specularColor, float specularPower, inout vec3 diffuse, inout vec3 specular)
+{
+	uvec2 cluster = Clusters[ComputeClusterIndex(worldPosition)];
+	for (uint i = 0; i < cluster.y; i++)
+	{
+		AccumulateClusteredLight(Lights[LightIndices[cluster.x + i]], worldPosition, normal, viewDirection, sampledColor, specularColor, specularPower, diffuse, specular);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,21 @@
+#version 440 core
+
+// The units match DeferredRenderer::DepthTextureUnit and LightingTextureUnit
+layout (binding = 2) uniform sampler2D DepthSampler;
+layout (binding = 3) uniform sampler2D LightingSampler;
+
+out vec4 Color;
+
+void main()
+{
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(DepthSampler, texel, 0).r;
+	if (depth == 1.0f)
+	{
+		discard;
+	}
+
+	// Written back so forward draws and immediate-mode components depth-test against the deferred geometry
+	gl_FragDepth = depth;
+	Color = vec4(texelFetch(LightingSampler, texel, 0).rgb, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#version 440 core
+
+#include "FrameConstants.glsl"
+#include "Lighting.glsl"
+#include "ClusteredLightData.glsl"
+#include "DeferredLighting.glsl"
+
+flat in uint LightIndex;
+
+out vec4 Color;
+
+void main()
+{
+	GBufferSample gbuffer;
+	if (ReadGBuffer(gbuffer) == false)
+	{
+		discard;
+	}
+
+	// Pixels in front of the volume still reach here when another light marked them; attenuation rejects them
+	vec3 viewDirection = normalize(CameraPosition - gbuffer.WorldPosition);
+	vec3 diffuse = vec3(0.0f);
+	vec3 specular = vec3(0.0f);
+	AccumulateClusteredLight(Lights[LightIndex], gbuffer.WorldPosition, gbuffer.Normal, viewDirection, gbuffer.Albedo, SpecularColor, SpecularPower, diffuse, specular);
+
+	Color = vec4(diffuse + specular, 1.0f);
+}
\ No newline at end of file
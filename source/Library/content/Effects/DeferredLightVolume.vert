@@ -0,0 +1,17 @@
+#version 440 core
+
+#include "FrameConstants.glsl"
+#include "Lighting.glsl"
+#include "ClusteredLightData.glsl"
+
+layout (location = 0) in vec4 Position;
+
+flat out uint LightIndex;
+
+void main()
+{
+	// The unit volume encloses the unit sphere, so scaling it by the radius bounds everything the light reaches
+	ClusteredLight light = Lights[gl_InstanceID];
+	LightIndex = gl_InstanceID;
+	gl_Position = ViewProjection * vec4(light.Position.xyz + (Position.xyz * light.Position.w), 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+// G-buffer inputs for the deferred lighting passes; the texture units match DeferredRenderer's AlbedoTextureUnit, NormalTextureUnit and DepthTextureUnit.
+// Include after FrameConstants.glsl.
+
+#include "GBuffer.glsl"
+
+layout (binding = 0) uniform sampler2D AlbedoSampler;
+layout (binding = 1) uniform sampler2D NormalSampler;
+layout (binding = 2) uniform sampler2D DepthSampler;
+
+uniform mat4 InverseViewProjection;
+uniform vec4 SpecularColor;
+uniform float SpecularPower;
+
+struct GBufferSample
+{
+	vec4 Albedo;		// rgb albedo, a gloss
+	vec3 Normal;
+	vec3 WorldPosition;
+};
+
+bool ReadGBuffer(out GBufferSample gbuffer)
+{
+	ivec2 texel = ivec2(gl_FragCoord.xy);
+	float depth = texelFetch(DepthSampler, texel, 0).r;
+
+	// Nothing was drawn into the G-buffer here
+	if (depth == 1.0f)
+	{
+		return false;
+	}
+
+	vec2 textureCoordinate = gl_FragCoord.xy / vec2(textureSize(DepthSampler, 0));
+	gbuffer.Albedo = texelFetch(AlbedoSampler, texel, 0);
+	gbuffer.Normal = DecodeOctahedral(texelFetch(NormalSampler, texel, 0).xy);
+	gbuffer.WorldPosition = ReconstructWorldPosition(textureCoordinate, depth, InverseViewProjection);
+
+	return true;
+}
\ No newline at end of file
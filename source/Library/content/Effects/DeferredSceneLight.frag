@@ -0,0 +1,48 @@
+#version 440 core
+
+#include "FrameConstants.glsl"
+#include "Lighting.glsl"
+#include "DeferredLighting.glsl"
+
+out vec4 Color;
+
+void main()
+{
+	GBufferSample gbuffer;
+	if (ReadGBuffer(gbuffer) == false)
+	{
+		discard;
+	}
+
+	Color = vec4(AmbientColor.rgb * gbuffer.Albedo.rgb, 1.0f);
+
+	// FrameConstants only fills the fields the active light has, which tells the light types apart
+	vec3 lightDirection;
+	float attenuation = 1.0f;
+	if (LightRadius > 0.0f)
+	{
+		vec3 lightVector = LightPosition - gbuffer.WorldPosition;
+		attenuation = ComputeAttenuation(lightVector, LightRadius);
+		lightDirection = normalize(lightVector);
+
+		if (dot(LightLookAt, LightLookAt) > 0.0f)
+		{
+			attenuation *= ComputeSpotFactor(normalize(-LightLookAt), lightDirection, SpotLightInnerAngle, SpotLightOuterAngle);
+		}
+	}
+	else if (dot(LightDirection, LightDirection) > 0.0f)
+	{
+		lightDirection = normalize(-LightDirection);
+	}
+	else
+	{
+		return;
+	}
+
+	vec3 viewDirection = normalize(CameraPosition - gbuffer.WorldPosition);
+	vec3 diffuse;
+	vec3 specular;
+	ComputeBlinnPhong(gbuffer.Normal, lightDirection, viewDirection, gbuffer.Albedo, LightColor, SpecularColor, SpecularPower, diffuse, specular);
+
+	Color.rgb += attenuation * (diffuse + specular);
+}
\ No newline at end of file
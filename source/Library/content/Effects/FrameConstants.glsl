@@ -0,0 +1,23 @@
+// Per-frame data shared by every program; the bindings match FrameConstants::FrameDataBinding and LightDataBinding
+
+layout (std140, binding = 0) uniform FrameData
+{
+	mat4 ViewProjection;
+	mat4 View;
+	mat4 Projection;
+	vec3 CameraPosition;
+	float TotalTime;
+	float ElapsedTime;
+};
+
+layout (std140, binding = 1) uniform LightData
+{
+	vec4 AmbientColor;
+	vec4 LightColor;
+	vec3 LightDirection;
+	float LightRadius;
+	vec3 LightPosition;
+	float SpotLightInnerAngle;
+	vec3 LightLookAt;
+	float SpotLightOuterAngle;
+};
\ No newline at end of file
@@ -0,0 +1,38 @@
+// G-buffer encodings shared by the GBUFFER permutation and the deferred lighting passes
+
+vec2 SignNotZero(vec2 value)
+{
+	return vec2((value.x >= 0.0f ? 1.0f : -1.0f), (value.y >= 0.0f ? 1.0f : -1.0f));
+}
+
+// Projects the unit normal onto an octahedron and unfolds it into [-1, 1]^2, which two snorm channels store with even precision
+vec2 EncodeOctahedral(vec3 normal)
+{
+	normal /= (abs(normal.x) + abs(normal.y) + abs(normal.z));
+
+	vec2 encoded = normal.xy;
+	if (normal.z < 0.0f)
+	{
+		encoded = (1.0f - abs(normal.yx)) * SignNotZero(normal.xy);
+	}
+
+	return encoded;
+}
+
+vec3 DecodeOctahedral(vec2 encoded)
+{
+	vec3 normal = vec3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+	if (normal.z < 0.0f)
+	{
+		normal.xy = (1.0f - abs(normal.yx)) * SignNotZero(normal.xy);
+	}
+
+	return normalize(normal);
+}
+
+vec3 ReconstructWorldPosition(vec2 textureCoordinate, float depth, mat4 inverseViewProjection)
+{
+	vec4 position = inverseViewProjection * vec4((vec3(textureCoordinate, depth) * 2.0f) - 1.0f, 1.0f);
+
+	return position.xyz / position.w;
+}
\ No newline at end of file
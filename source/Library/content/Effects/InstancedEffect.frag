@@ -0,0 +1,22 @@
+#version 440 core
+
+#include "FrameConstants.glsl"
+
+in VS_OUTPUT
+{
+	vec3 Normal;
+	vec4 Color;
+} IN;
+
+out vec4 Color;
+
+void main()
+{
+	vec3 normal = normalize(IN.Normal);
+	float n_dot_l = clamp(dot(-LightDirection, normal), 0.0f, 1.0f);
+
+	vec3 ambient = AmbientColor.rgb * IN.Color.rgb;
+	vec3 diffuse = LightColor.rgb * n_dot_l * IN.Color.rgb;
+
+	Color = vec4(clamp(ambient + diffuse, 0.0f, 1.0f), IN.Color.a);
+}
\ No newline at end of file
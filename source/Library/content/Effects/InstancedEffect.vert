@@ -0,0 +1,21 @@
+#version 440 core
+
+#include "FrameConstants.glsl"
+
+layout (location = 0) in vec4 Position;
+layout (location = 1) in vec3 Normal;
+layout (location = 2) in mat4 World;
+layout (location = 6) in vec4 Color;
+
+out VS_OUTPUT
+{
+	vec3 Normal;
+	vec4 Color;
+} OUT;
+
+void main()
+{
+	gl_Position = ViewProjection * (World * Position);
+	OUT.Normal = (World * vec4(Normal, 0.0f)).xyz;
+	OUT.Color = Color;
+}
\ No newline at end of file
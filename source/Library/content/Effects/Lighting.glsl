@@ -0,0 +1,35 @@
+// Lighting terms shared by the lit effects; include this after the #version line
+
+void ComputeBlinnPhong(vec3 normal, vec3 lightDirection, vec3 viewDirection, vec4 sampledColor, vec4 lightColor, vec4 specularColor, float specularPower, out vec3 diffuse, out vec3 specular)
+{
+	float n_dot_l = dot(lightDirection, normal);
+	vec3 halfVector = normalize(lightDirection + viewDirection);
+	float n_dot_h = dot(normal, halfVector);
+
+	diffuse = clamp(lightColor.rgb * n_dot_l * sampledColor.rgb, 0.0f, 1.0f);
+
+	// specular = N.H^n with gloss map stored in color texture's alpha channel
+	specular = specularColor.rgb * min(pow(clamp(n_dot_h, 0.0f, 1.0f), specularPower), sampledColor.w);
+}
+
+float ComputeAttenuation(vec3 lightVector, float lightRadius)
+{
+	return clamp(1.0f - (length(lightVector) / lightRadius), 0.0f, 1.0f);
+}
+
+float ComputeSpotFactor(vec3 lightLookAt, vec3 lightDirection, float innerAngle, float outerAngle)
+{
+	float spotFactor = 0.0f;
+	float lightAngle = dot(lightLookAt, lightDirection);
+	if (lightAngle > 0.0f)
+	{
+		spotFactor = smoothstep(outerAngle, innerAngle, lightAngle);
+	}
+
+	return spotFactor;
+}
+
+float ComputeFogAmount(vec3 worldPosition, vec3 cameraPosition, float fogStart, float fogRange)
+{
+	return clamp((distance(worldPosition, cameraPosition) - fogStart) / fogRange, 0.0f, 1.0f);
+}
\ No newline at end of file
@@ -0,0 +1,128 @@
+#version 440 core
+
+#include "FrameConstants.glsl"
+#include "Lighting.glsl"
+#if defined(CLUSTERED_LIGHTS)
+#include "ClusteredLighting.glsl"
+#endif
+#if defined(GBUFFER)
+#include "GBuffer.glsl"
+#endif
+
+layout (binding = 0) uniform sampler2D ColorTextureSampler;
+#if defined(NORMAL_MAP)
+layout (binding = 1) uniform sampler2D NormalMapSampler;
+#endif
+#if defined(ALPHA_MAP) && defined(NORMAL_MAP)
+layout (binding = 2) uniform sampler2D AlphaMapSampler;
+#elif defined(ALPHA_MAP)
+layout (binding = 1) uniform sampler2D AlphaMapSampler;
+#endif
+
+uniform vec4 SpecularColor;
+uniform float SpecularPower;
+
+#if defined(FOG)
+uniform vec4 FogColor;
+#endif
+
+in VS_OUTPUT
+{
+	vec2 TextureCoordinate;
+	vec3 Normal;
+#if defined(NORMAL_MAP)
+	vec3 Tangent;
+	vec3 Binormal;
+#endif
+	vec3 WorldPosition;
+#if defined(POINT_LIGHT) || defined(SPOT_LIGHT)
+	float Attenuation;
+#else
+	vec3 LightDirection;
+#endif
+#if defined(SPOT_LIGHT)
+	vec3 LightLookAt;
+#endif
+#if defined(FOG)
+	float FogAmount;
+#endif
+} IN;
+
+#if defined(GBUFFER)
+layout (location = 0) out vec4 Albedo;
+layout (location = 1) out vec2 EncodedNormal;
+#else
+out vec4 Color;
+#endif
+
+void main()
+{
+	vec4 sampledColor = texture(ColorTextureSampler, IN.TextureCoordinate);
+#if defined(ALPHA_MAP)
+	float alpha = texture(AlphaMapSampler, IN.TextureCoordinate).a;
+#else
+	float alpha = sampledColor.a;
+#endif
+
+#if defined(FOG) && !defined(GBUFFER)
+	if (IN.FogAmount == 1.0f)
+	{
+#if defined(ALPHA_MAP)
+		Color = vec4(FogColor.rgb, alpha);
+#else
+		Color = vec4(FogColor.rgb, 1.0f);
+#endif
+		return;
+	}
+#endif
+
+#if defined(POINT_LIGHT) || defined(SPOT_LIGHT)
+	vec3 lightDirection = normalize(LightPosition - IN.WorldPosition);
+#else
+	vec3 lightDirection = normalize(IN.LightDirection);
+#endif
+	vec3 viewDirection = normalize(CameraPosition - IN.WorldPosition);
+
+#if defined(NORMAL_MAP)
+	vec3 sampledNormal = (2 * texture(NormalMapSampler, IN.TextureCoordinate).xyz) - 1.0f;
+	vec3 normal = normalize(IN.Normal + (sampledNormal.x * IN.Tangent) + (sampledNormal.y * IN.Binormal));
+#else
+	vec3 normal = normalize(IN.Normal);
+#endif
+
+#if defined(GBUFFER)
+	// Lighting is resolved later from these; the gloss map stays in the color texture's alpha
+	Albedo = sampledColor;
+	EncodedNormal = EncodeOctahedral(normal);
+#else
+	vec3 ambient = AmbientColor.rgb * sampledColor.rgb;
+	vec3 diffuse;
+	vec3 specular;
+	ComputeBlinnPhong(normal, lightDirection, viewDirection, sampledColor, LightColor, SpecularColor, SpecularPower, diffuse, specular);
+
+#if defined(POINT_LIGHT) || defined(SPOT_LIGHT)
+	diffuse *= IN.Attenuation;
+	specular *= IN.Attenuation;
+#endif
+
+#if defined(SPOT_LIGHT)
+	float spotFactor = ComputeSpotFactor(normalize(IN.LightLookAt), lightDirection, SpotLightInnerAngle, SpotLightOuterAngle);
+	Color.rgb = ambient + (spotFactor * (diffuse + specular));
+#else
+	Color.rgb = ambient + diffuse + specular;
+#endif
+
+#if defined(CLUSTERED_LIGHTS)
+	// Added on top of whichever single light the permutation selects
+	vec3 clusteredDiffuse = vec3(0.0f);
+	vec3 clusteredSpecular = vec3(0.0f);
+	AccumulateClusteredLights(IN.WorldPosition, normal, viewDirection, sampledColor, SpecularColor, SpecularPower, clusteredDiffuse, clusteredSpecular);
+	Color.rgb += clusteredDiffuse + clusteredSpecular;
+#endif
+	Color.a = alpha;
+
+#if defined(FOG)
+	Color.rgb = mix(Color.rgb, FogColor.rgb, IN.FogAmount);
+#endif
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,68 @@
+#version 440 core
+
+#include "FrameConstants.glsl"
+#include "Lighting.glsl"
+
+uniform mat4 World;
+
+#if defined(FOG)
+uniform float FogStart = 20.0f;
+uniform float FogRange = 40.0f;
+#endif
+
+layout (location = 0) in vec4 Position;
+layout (location = 1) in vec2 TextureCoordinate;
+layout (location = 2) in vec3 Normal;
+#if defined(NORMAL_MAP)
+layout (location = 3) in vec3 Tangent;
+layout (location = 4) in vec3 Binormal;
+#endif
+
+out VS_OUTPUT
+{
+	vec2 TextureCoordinate;
+	vec3 Normal;
+#if defined(NORMAL_MAP)
+	vec3 Tangent;
+	vec3 Binormal;
+#endif
+	vec3 WorldPosition;
+#if defined(POINT_LIGHT) || defined(SPOT_LIGHT)
+	float Attenuation;
+#else
+	vec3 LightDirection;
+#endif
+#if defined(SPOT_LIGHT)
+	vec3 LightLookAt;
+#endif
+#if defined(FOG)
+	float FogAmount;
+#endif
+} OUT;
+
+void main()
+{	
+	vec4 worldPosition = World * Position;
+	gl_Position = ViewProjection * worldPosition;
+	OUT.TextureCoordinate = TextureCoordinate;
+	OUT.Normal = (World * vec4(Normal, 0.0f)).xyz;
+#if defined(NORMAL_MAP)
+	OUT.Tangent = (World * vec4(Tangent, 0.0f)).xyz;
+	OUT.Binormal = (World * vec4(Binormal, 0.0f)).xyz;
+#endif
+	OUT.WorldPosition = worldPosition.xyz;
+
+#if defined(POINT_LIGHT) || defined(SPOT_LIGHT)
+	OUT.Attenuation = ComputeAttenuation(LightPosition - OUT.WorldPosition, LightRadius);
+#else
+	OUT.LightDirection = -LightDirection;
+#endif
+
+#if defined(SPOT_LIGHT)
+	OUT.LightLookAt = -LightLookAt;
+#endif
+
+#if defined(FOG)
+	OUT.FogAmount = ComputeFogAmount(OUT.WorldPosition, CameraPosition, FogStart, FogRange);
+#endif
+}
\ No newline at end of file
@@ -0,0 +1,40 @@
+#version 440 core
+
+#include "FrameConstants.glsl"
+
+// Binding matches AnimationSystem::PaletteBinding; every character's bones live in this one buffer
+layout (std430, binding = 3) readonly buffer SkinningPalette
+{
+	mat4 Bones[];
+};
+
+uniform mat4 World;
+uniform vec4 Color;
+uniform int BoneOffset;
+
+layout (location = 0) in vec4 Position;
+layout (location = 1) in vec3 Normal;
+layout (location = 2) in uvec4 BoneIndices;
+layout (location = 3) in vec4 BoneWeights;
+
+out VS_OUTPUT
+{
+	vec3 Normal;
+	vec4 Color;
+} OUT;
+
+void main()
+{
+	mat4 skinning = Bones[BoneOffset + BoneIndices.x] * BoneWeights.x;
+	skinning += Bones[BoneOffset + BoneIndices.y] * BoneWeights.y;
+	skinning += Bones[BoneOffset + BoneIndices.z] * BoneWeights.z;
+	skinning += Bones[BoneOffset + BoneIndices.w] * BoneWeights.w;
+
+	// Vertices the importer found no influences for follow the model root
+	float weightSum = BoneWeights.x + BoneWeights.y + BoneWeights.z + BoneWeights.w;
+	mat4 world = World * (weightSum > 0.0f ? skinning : mat4(1.0f));
+
+	gl_Position = ViewProjection * (world * Position);
+	OUT.Normal = (world * vec4(Normal, 0.0f)).xyz;
+	OUT.Color = Color;
+}
\ No newline at end of file
@@ -0,0 +1,34 @@
+#version 440 core
+
+#include "FrameConstants.glsl"
+
+struct DrawConstants
+{
+	mat4 World;
+	vec4 Color;
+};
+
+// Binding matches StaticBatch::DrawDataBinding
+layout (std430, binding = 2) readonly buffer DrawData
+{
+	DrawConstants Draws[];
+};
+
+layout (location = 0) in vec4 Position;
+layout (location = 1) in vec3 Normal;
+layout (location = 2) in uint DrawId;
+
+out VS_OUTPUT
+{
+	vec3 Normal;
+	vec4 Color;
+} OUT;
+
+void main()
+{
+	mat4 world = Draws[DrawId].World;
+
+	gl_Position = ViewProjection * (world * Position);
+	OUT.Normal = (world * vec4(Normal, 0.0f)).xyz;
+	OUT.Color = Draws[DrawId].Color;
+}
\ No newline at end of file
@@ -0,0 +1,139 @@
+#include "TestHarness.h"
+#include "TestSuites.h"
+#include "AnimationClip.h"
+#include <cfloat>
+#include <cstdio>
+#include <random>
+#include <sstream>
+
+using namespace glm;
+using namespace Library;
+
+namespace Tests
+{
+	namespace
+	{
+		const UINT KeyCount = 10000;
+		const UINT TrackKeyCount = 64;
+
+		// 15 bits over +-1/sqrt(2) per kept component, rebuilt largest included, is well inside a hundredth of a degree
+		const float MaxRotationErrorDegrees = 0.01f;
+
+		// Angle of the rotation taking one quaternion to the other, from the sine of the half angle because acos near one
+		// cannot resolve errors this small in single precision; q and -q are the same rotation
+		float AngleBetween(const quat& lhs, const quat& rhs)
+		{
+			quat difference = lhs * inverse(rhs);
+			float sine = length(vec3(difference.x, difference.y, difference.z));
+			return degrees(2.0f * asin(sine < 1.0f ? sine : 1.0f));
+		}
+
+		std::string Describe(const char* what, float worst, float limit)
+		{
+			std::ostringstream message;
+			message << what << "; worst " << worst << ", limit " << limit;
+
+			return message.str();
+		}
+	}
+
+	void RunAnimationCodecTests(TestContext& context)
+	{
+		std::mt19937 generator(11);
+		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+		// Smallest three: random rotations, plus the ones whose largest component is exactly one or sits on a tie
+		std::vector<quat> rotations;
+		rotations.push_back(quat(1.0f, 0.0f, 0.0f, 0.0f));
+		rotations.push_back(quat(0.0f, 1.0f, 0.0f, 0.0f));
+		rotations.push_back(quat(0.0f, 0.0f, -1.0f, 0.0f));
+		rotations.push_back(normalize(quat(0.5f, 0.5f, -0.5f, 0.5f)));
+		rotations.push_back(normalize(quat(-0.7071068f, 0.0f, 0.7071068f, 0.0f)));
+		while (rotations.size() < KeyCount)
+		{
+			quat rotation(distribution(generator), distribution(generator), distribution(generator), distribution(generator));
+			if (length(rotation) > 0.01f)
+			{
+				rotations.push_back(normalize(rotation));
+			}
+		}
+
+		std::vector<std::uint16_t> encoded;
+		AnimationClip::EncodeRotations(rotations, encoded);
+		context.Check(encoded.size() == rotations.size() * 3, "rotation keys take three words each");
+
+		float worstAngle = 0.0f;
+		float worstLength = 0.0f;
+		for (UINT i = 0; i < rotations.size(); i++)
+		{
+			quat decoded = AnimationClip::DecodeRotation(&encoded[i * 3]);
+			float angle = AngleBetween(decoded, rotations[i]);
+			float lengthError = abs(length(decoded) - 1.0f);
+			worstAngle = (angle > worstAngle ? angle : worstAngle);
+			worstLength = (lengthError > worstLength ? lengthError : worstLength);
+		}
+
+		printf("  rotations: worst %.5f degrees, worst |length - 1| %.2g\n", worstAngle, worstLength);
+		context.Check(worstAngle <= MaxRotationErrorDegrees, Describe("rotations round-trip within tolerance", worstAngle, MaxRotationErrorDegrees));
+		context.Check(worstLength <= 0.001f, Describe("decoded rotations are unit length", worstLength, 0.001f));
+
+		// The sign of the dropped component is folded into the others, so q and -q encode to the same rotation
+		std::vector<quat> negated(1, -rotations[KeyCount / 2]);
+		AnimationClip::EncodeRotations(negated, encoded);
+		context.Check(AngleBetween(AnimationClip::DecodeRotation(&encoded[0]), rotations[KeyCount / 2]) <= MaxRotationErrorDegrees, "a negated quaternion decodes to the same rotation");
+
+		std::vector<quat> constantRotations(TrackKeyCount, rotations[KeyCount / 3]);
+		AnimationClip::EncodeRotations(constantRotations, encoded);
+		context.Check(encoded.size() == 3, "a constant rotation channel collapses to one key");
+
+		// 16-bit ranges: every axis error is at most half a step of that axis's extent
+		std::vector<vec3> vectors;
+		for (UINT i = 0; i < KeyCount; i++)
+		{
+			vectors.push_back(vec3(distribution(generator) * 100.0f, distribution(generator) * 0.01f, 5.0f + distribution(generator)));
+		}
+
+		vec3 minimum;
+		vec3 extent;
+		AnimationClip::EncodeVectors(vectors, minimum, extent, encoded);
+		context.Check(encoded.size() == vectors.size() * 3, "vector keys take three words each");
+
+		bool withinHalfStep = true;
+		float worstRelativeError = 0.0f;
+		for (UINT i = 0; i < vectors.size(); i++)
+		{
+			vec3 decoded = AnimationClip::DecodeVector(&encoded[i * 3], minimum, extent);
+			for (UINT axis = 0; axis < 3; axis++)
+			{
+				float halfStep = extent[axis] * 0.5f / 65535.0f;
+				float error = abs(decoded[axis] - vectors[i][axis]);
+				withinHalfStep &= (error <= halfStep * 1.01f + abs(vectors[i][axis]) * FLT_EPSILON);
+				worstRelativeError = (error / extent[axis] > worstRelativeError ? error / extent[axis] : worstRelativeError);
+			}
+		}
+
+		printf("  vectors: worst error %.3g of the axis extent (half a step is %.3g)\n", worstRelativeError, 0.5f / 65535.0f);
+		context.Check(withinHalfStep, "vectors round-trip within half a quantization step per axis");
+
+		// An axis that never moves has no extent and must come back exactly
+		std::vector<vec3> planar;
+		for (UINT i = 0; i < TrackKeyCount; i++)
+		{
+			planar.push_back(vec3(distribution(generator), 2.5f, distribution(generator)));
+		}
+
+		AnimationClip::EncodeVectors(planar, minimum, extent, encoded);
+		bool exact = true;
+		for (UINT i = 0; i < planar.size(); i++)
+		{
+			exact &= (AnimationClip::DecodeVector(&encoded[i * 3], minimum, extent).y == 2.5f);
+		}
+		context.Check(exact, "an axis without extent decodes exactly");
+
+		std::vector<vec3> constantVectors(TrackKeyCount, vec3(1.0f, 2.0f, 3.0f));
+		AnimationClip::EncodeVectors(constantVectors, minimum, extent, encoded);
+		context.Check(encoded.size() == 3 && AnimationClip::DecodeVector(&encoded[0], minimum, extent) == constantVectors.front(), "a constant vector channel collapses to one exact key");
+
+		printf("  %u bytes per transform key against %u uncompressed\n", static_cast<UINT>(9 * sizeof(std::uint16_t)), static_cast<UINT>(sizeof(vec3) * 2 + sizeof(quat)));
+	}
+}
\ No newline at end of file
@@ -0,0 +1,157 @@
+#include "TestHarness.h"
+#include "TestSuites.h"
+#include "AssetPack.h"
+#include "AssetPackBuilder.h"
+#include "GameException.h"
+#include "Utility.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+using namespace Library;
+
+namespace Tests
+{
+	namespace
+	{
+		const char* PackFilename = "AssetPack.pak";
+		const char* CorruptPackFilename = "AssetPackCorrupt.pak";
+		const char* StoredPath = "Content/Stored.txt";
+		const char* CompressedPath = "Content/Compressed.txt";
+
+		// Field offsets within the on-disk records, per the layouts in AssetPack.h
+		const std::uint64_t EntryCountOffset = 8;
+		const std::uint64_t EntryTableOffsetOffset = 16;
+		const std::uint64_t StringTableOffsetOffset = 32;
+		const std::uint64_t StringTableSizeOffset = 40;
+		const std::uint64_t PathOffsetOffset = 8;
+		const std::uint64_t PathLengthOffset = 12;
+		const std::uint64_t BlobIndexOffset = 16;
+		const std::uint64_t BlobStoredSizeOffset = 8;
+		const std::uint64_t BlobSizeOffset = 16;
+
+		std::vector<char> ReadBytes(const char* filename)
+		{
+			std::ifstream file(filename, std::ios::binary);
+			return std::vector<char>(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+		}
+
+		void WriteBytes(const char* filename, const std::vector<char>& bytes)
+		{
+			std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+			file.write(&bytes.front(), bytes.size());
+		}
+
+		template <typename T>
+		T Read(const std::vector<char>& bytes, std::uint64_t offset)
+		{
+			T value;
+			memcpy(&value, &bytes[static_cast<size_t>(offset)], sizeof(T));
+			return value;
+		}
+
+		template <typename T>
+		void Write(std::vector<char>& bytes, std::uint64_t offset, T value)
+		{
+			memcpy(&bytes[static_cast<size_t>(offset)], &value, sizeof(T));
+		}
+
+		// Opens a corrupt pack and every file in it; it must be refused with an exception or report the files missing, never read out of bounds
+		bool IsRejected(const std::vector<char>& bytes)
+		{
+			WriteBytes(CorruptPackFilename, bytes);
+
+			try
+			{
+				AssetPack pack(Utility::ToWideString(CorruptPackFilename));
+
+				FileView storedFile;
+				FileView compressedFile;
+				bool storedOpened = pack.OpenFile(StoredPath, storedFile);
+				bool compressedOpened = pack.OpenFile(CompressedPath, compressedFile);
+
+				return (storedOpened == false || compressedOpened == false);
+			}
+			catch (GameException&)
+			{
+				return true;
+			}
+		}
+
+		// Applies the same corruption to every record of a table
+		template <typename T>
+		std::vector<char> CorruptRecords(const std::vector<char>& bytes, std::uint64_t tableOffset, UINT recordCount, std::uint64_t recordSize, std::uint64_t fieldOffset, T value)
+		{
+			std::vector<char> corruptBytes(bytes);
+			for (UINT i = 0; i < recordCount; i++)
+			{
+				Write(corruptBytes, tableOffset + i * recordSize + fieldOffset, value);
+			}
+
+			return corruptBytes;
+		}
+	}
+
+	void RunAssetPackTests(TestContext& context)
+	{
+		std::string storedText("A stored entry is served straight out of the mapping.");
+		std::string compressedText;
+		for (UINT i = 0; i < 256; i++)
+		{
+			compressedText += "Repetitive text compresses well. ";
+		}
+
+		AssetPackBuilder builder;
+		builder.AddData(StoredPath, std::vector<char>(storedText.begin(), storedText.end()), AssetPackCompressionNone);
+		builder.AddData(CompressedPath, std::vector<char>(compressedText.begin(), compressedText.end()), AssetPackCompressionLZ4);
+		builder.Save(Utility::ToWideString(PackFilename));
+
+		std::vector<char> bytes = ReadBytes(PackFilename);
+		if (context.Check(bytes.size() > sizeof(AssetPackHeader), "the builder writes a pack") == false)
+		{
+			return;
+		}
+
+		{
+			AssetPack pack(Utility::ToWideString(PackFilename));
+			FileView storedFile;
+			FileView compressedFile;
+			context.Check(pack.OpenFile(StoredPath, storedFile) && std::string(storedFile.Data(), storedFile.Size()) == storedText, "the stored entry reads back intact");
+			context.Check(pack.OpenFile(CompressedPath, compressedFile) && std::string(compressedFile.Data(), compressedFile.Size()) == compressedText, "the compressed entry reads back intact");
+		}
+
+		const AssetPackHeader header = Read<AssetPackHeader>(bytes, 0);
+
+		context.Check(IsRejected(std::vector<char>(bytes.begin(), bytes.begin() + sizeof(AssetPackHeader) - 1)), "a pack shorter than its header is rejected");
+		context.Check(IsRejected(std::vector<char>(bytes.begin(), bytes.begin() + static_cast<size_t>(header.StringTableOffset))), "a pack truncated before its string table is rejected");
+
+		// Each of these wraps when the offset and length are added in 32 or 64 bits
+		std::vector<char> corruptBytes(bytes);
+		Write<std::uint64_t>(corruptBytes, EntryTableOffsetOffset, ~0ULL - 15);
+		context.Check(IsRejected(corruptBytes), "an entry table offset that wraps is rejected");
+
+		corruptBytes = bytes;
+		Write<std::uint32_t>(corruptBytes, EntryCountOffset, 0xFFFFFFFF);
+		context.Check(IsRejected(corruptBytes), "an entry count whose table size wraps is rejected");
+
+		corruptBytes = bytes;
+		Write<std::uint64_t>(corruptBytes, StringTableSizeOffset, ~header.StringTableOffset + 2);
+		context.Check(IsRejected(corruptBytes), "a string table size that wraps is rejected");
+
+		corruptBytes = bytes;
+		Write<std::uint64_t>(corruptBytes, StringTableOffsetOffset, bytes.size() + 1);
+		context.Check(IsRejected(corruptBytes), "a string table past the end of the pack is rejected");
+
+		context.Check(IsRejected(CorruptRecords<std::uint32_t>(bytes, header.EntryTableOffset, header.EntryCount, sizeof(AssetPackEntry), PathOffsetOffset, 0xFFFFFFFF)) &&
+			IsRejected(CorruptRecords<std::uint32_t>(CorruptRecords<std::uint32_t>(bytes, header.EntryTableOffset, header.EntryCount, sizeof(AssetPackEntry), PathOffsetOffset, 0xFFFFFFFF),
+				header.EntryTableOffset, header.EntryCount, sizeof(AssetPackEntry), PathLengthOffset, 2)), "path ranges that wrap past the string table are rejected");
+
+		context.Check(IsRejected(CorruptRecords<std::uint32_t>(bytes, header.EntryTableOffset, header.EntryCount, sizeof(AssetPackEntry), BlobIndexOffset, header.BlobCount)), "an entry naming a missing blob is rejected");
+		context.Check(IsRejected(CorruptRecords<std::uint64_t>(bytes, header.BlobTableOffset, header.BlobCount, sizeof(AssetPackBlob), 0, ~0ULL - 15)), "a blob offset that wraps is rejected");
+		context.Check(IsRejected(CorruptRecords<std::uint64_t>(bytes, header.BlobTableOffset, header.BlobCount, sizeof(AssetPackBlob), BlobStoredSizeOffset, ~0ULL)), "a blob that runs past the end of the pack is rejected");
+		context.Check(IsRejected(CorruptRecords<std::uint64_t>(bytes, header.BlobTableOffset, header.BlobCount, sizeof(AssetPackBlob), BlobSizeOffset, bytes.size())), "a blob whose size disagrees with its stored bytes is rejected");
+
+		remove(CorruptPackFilename);
+		remove(PackFilename);
+	}
+}
\ No newline at end of file
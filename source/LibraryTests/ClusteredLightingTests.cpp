@@ -0,0 +1,189 @@
+#include "TestHarness.h"
+#include "TestSuites.h"
+#include "ClusteredLighting.h"
+#include "PointLight.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+#include <sstream>
+
+using namespace glm;
+using namespace Library;
+
+namespace Tests
+{
+	namespace
+	{
+		const UINT LightCount = 3000;
+		const UINT ViewportWidth = 1280;
+		const UINT ViewportHeight = 720;
+		const UINT SamplesPerLight = 64;
+		const float FieldOfView = 60.0f;
+		const float NearDepth = 0.01f;
+		const float FarDepth = 1000.0f;
+		const float SliceTolerance = 1e-3f;
+
+		bool IsInCluster(const ClusteredLighting& clusteredLighting, UINT cluster, UINT lightIndex)
+		{
+			const std::vector<UINT>& lights = clusteredLighting.ClusterLights(cluster);
+			return (std::find(lights.begin(), lights.end(), lightIndex) != lights.end());
+		}
+
+		// Every slice must have depth, start where the previous one ended and the last must end at the far plane
+		bool SlicesTileTheFrustum(const ClusteredLighting& clusteredLighting, float nearDepth, float farDepth)
+		{
+			const UINT sliceSize = ClusteredLighting::ClusterCountX * ClusteredLighting::ClusterCountY;
+			float previousFar = nearDepth;
+
+			for (UINT slice = 0; slice < ClusteredLighting::ClusterCountZ; slice++)
+			{
+				const BoundingBox& bounds = clusteredLighting.ClusterBounds(slice * sliceSize);
+				float sliceNear = -bounds.Maximum.z;
+				float sliceFar = -bounds.Minimum.z;
+				if (sliceFar <= sliceNear || abs(sliceNear - previousFar) > SliceTolerance * previousFar)
+				{
+					return false;
+				}
+
+				previousFar = sliceFar;
+			}
+
+			return (abs(previousFar - farDepth) <= SliceTolerance * farDepth);
+		}
+	}
+
+	void RunClusteredLightingTests(TestContext& context)
+	{
+		mat4 projection = perspective(FieldOfView, static_cast<float>(ViewportWidth) / ViewportHeight, NearDepth, FarDepth);
+		mat4 view = lookAt(vec3(3.0f, 2.0f, 10.0f), vec3(0.0f), vec3(0.0f, 1.0f, 0.0f));
+
+		std::mt19937 generator(3);
+		std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+
+		ClusteredLighting clusteredLighting;
+		std::vector<PointLight> lights(LightCount);
+		for (PointLight& light : lights)
+		{
+			light.SetPosition(distribution(generator) * 60.0f, distribution(generator) * 20.0f, distribution(generator) * 60.0f);
+			light.SetRadius(0.5f + (distribution(generator) + 1.0f) * 3.0f);
+			clusteredLighting.AddLight(light);
+		}
+
+		Stopwatch stopwatch;
+		clusteredLighting.AssignLights(view, projection, NearDepth, FarDepth, ViewportWidth, ViewportHeight);
+		printf("  assigned %u of %u lights to %u clusters (%u indices) in %.3f ms\n", clusteredLighting.VisibleLightCount(), clusteredLighting.LightCount(),
+			clusteredLighting.ClusterCount(), clusteredLighting.LightIndexCount(), stopwatch.ElapsedMilliseconds());
+		context.Check(clusteredLighting.VisibleLightCount() > 0 && clusteredLighting.VisibleLightCount() < LightCount, "lights outside the depth range are dropped");
+
+		// Every assigned light must touch its cluster's bounds. The bounds are boxes around the froxels, so a brute-force
+		// sphere-box test also accepts lights the projected tile range rightly rejects; those are only counted. Visible
+		// lights are gathered in registration order, so the brute force re-derives the same indices
+		std::vector<vec3> centers;
+		std::vector<float> radii;
+		for (const PointLight& light : lights)
+		{
+			vec3 center = vec3(view * vec4(light.Position(), 1.0f));
+			float depth = -center.z;
+			if (depth + light.Radius() >= NearDepth && depth - light.Radius() <= FarDepth)
+			{
+				centers.push_back(center);
+				radii.push_back(light.Radius());
+			}
+		}
+		context.Check(centers.size() == clusteredLighting.VisibleLightCount(), "the gathered lights match the depth range");
+
+		UINT mismatchedClusterCount = 0;
+		UINT cappedClusterCount = 0;
+		UINT rejectedLightCount = 0;
+		for (UINT cluster = 0; cluster < clusteredLighting.ClusterCount(); cluster++)
+		{
+			const BoundingBox& bounds = clusteredLighting.ClusterBounds(cluster);
+			std::vector<UINT> expected;
+			for (UINT lightIndex = 0; lightIndex < centers.size(); lightIndex++)
+			{
+				vec3 delta = clamp(centers[lightIndex], bounds.Minimum, bounds.Maximum) - centers[lightIndex];
+				if (dot(delta, delta) <= radii[lightIndex] * radii[lightIndex])
+				{
+					expected.push_back(lightIndex);
+				}
+			}
+
+			if (expected.size() >= ClusteredLighting::MaxLightsPerCluster)
+			{
+				cappedClusterCount++;
+				continue;
+			}
+
+			std::vector<UINT> assigned = clusteredLighting.ClusterLights(cluster);
+			std::sort(assigned.begin(), assigned.end());
+			mismatchedClusterCount += (std::includes(expected.begin(), expected.end(), assigned.begin(), assigned.end()) ? 0 : 1);
+			rejectedLightCount += expected.size() - assigned.size();
+		}
+		printf("  %u clusters mismatched, %u at the %u-light cap, %u box-only overlaps rejected, %u overflowing lights dropped\n", mismatchedClusterCount,
+			cappedClusterCount, ClusteredLighting::MaxLightsPerCluster, rejectedLightCount, clusteredLighting.OverflowLightCount());
+		context.Check(mismatchedClusterCount == 0, "clusters only list lights that touch their bounds");
+
+		// Lights stacked on one spot: every cluster they touch fills to the cap and reports each light past it
+		const UINT StackedOverflow = 10;
+		ClusteredLighting stackedLighting;
+		std::vector<PointLight> stackedLights(ClusteredLighting::MaxLightsPerCluster + StackedOverflow);
+		for (PointLight& light : stackedLights)
+		{
+			light.SetPosition(0.0f, 0.0f, 0.0f);
+			light.SetRadius(1.0f);
+			stackedLighting.AddLight(light);
+		}
+
+		stackedLighting.AssignLights(view, projection, NearDepth, FarDepth, ViewportWidth, ViewportHeight);
+		UINT fullClusterCount = 0;
+		for (UINT cluster = 0; cluster < stackedLighting.ClusterCount(); cluster++)
+		{
+			fullClusterCount += (stackedLighting.ClusterLights(cluster).size() == ClusteredLighting::MaxLightsPerCluster ? 1 : 0);
+		}
+		context.Check(fullClusterCount > 0 && stackedLighting.OverflowLightCount() == fullClusterCount * StackedOverflow, "lights past the per-cluster cap are counted as overflow");
+
+		// Points inside each light, looked up the way the shader does, must find that light in their cluster
+		UINT sampleCount = 0;
+		UINT missedSampleCount = 0;
+		for (UINT lightIndex = 0; lightIndex < centers.size(); lightIndex++)
+		{
+			for (UINT sample = 0; sample < SamplesPerLight; sample++)
+			{
+				vec3 offset(distribution(generator), distribution(generator), distribution(generator));
+				vec3 position = centers[lightIndex] + offset * (radii[lightIndex] / sqrt(3.0f));
+				float depth = -position.z;
+				vec4 clip = projection * vec4(position, 1.0f);
+				vec2 ndc = vec2(clip) / clip.w;
+				if (depth < NearDepth || depth > FarDepth || abs(ndc.x) >= 1.0f || abs(ndc.y) >= 1.0f)
+				{
+					continue;
+				}
+
+				UINT cluster = clusteredLighting.ClusterIndex((ndc * 0.5f + 0.5f) * vec2(ViewportWidth, ViewportHeight), depth);
+				if (clusteredLighting.ClusterLights(cluster).size() < ClusteredLighting::MaxLightsPerCluster)
+				{
+					sampleCount++;
+					missedSampleCount += (IsInCluster(clusteredLighting, cluster, lightIndex) ? 0 : 1);
+				}
+			}
+		}
+		printf("  %u points inside lights looked up, %u missed their light\n", sampleCount, missedSampleCount);
+		context.Check(sampleCount > 0 && missedSampleCount == 0, "shader lookups find every light covering the point");
+
+		context.Check(SlicesTileTheFrustum(clusteredLighting, NearDepth, FarDepth), "slices tile a near plane closer than the first slice depth");
+		context.Check(abs(-clusteredLighting.ClusterBounds(0).Minimum.z - ClusteredLighting::FirstSliceDepth) <= SliceTolerance, "slice 0 ends at the first slice depth");
+
+		// A near plane at or beyond the first slice depth still gets every slice
+		const float farNearDepths[] = { ClusteredLighting::FirstSliceDepth, 4.0f };
+		for (float nearDepth : farNearDepths)
+		{
+			mat4 farNearProjection = perspective(FieldOfView, static_cast<float>(ViewportWidth) / ViewportHeight, nearDepth, FarDepth);
+			clusteredLighting.AssignLights(view, farNearProjection, nearDepth, FarDepth, ViewportWidth, ViewportHeight);
+
+			std::ostringstream message;
+			message << "slices tile a near plane at " << nearDepth;
+			context.Check(SlicesTileTheFrustum(clusteredLighting, nearDepth, FarDepth), message.str());
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,219 @@
+#include "TestHarness.h"
+#include "TestSuites.h"
+#include "CubemapLoader.h"
+#include "VirtualFileSystem.h"
+#include "Utility.h"
+#include "GameException.h"
+#include "SOIL.h"
+#include <cstdio>
+#include <sstream>
+
+// A compatibility-profile format that gl3w's core headers leave out
+#define GL_LUMINANCE_ALPHA 0x190A
+
+using namespace Library;
+
+namespace Tests
+{
+	namespace
+	{
+		const int FaceWidth = 48;
+		const int FaceHeight = 40;
+		const UINT FaceCount = 6;
+		const GLint MaxLevelCount = 16;
+
+		const UINT FlagCombinations[] =
+		{
+			0,
+			SOIL_FLAG_INVERT_Y | SOIL_FLAG_MULTIPLY_ALPHA,
+			SOIL_FLAG_POWER_OF_TWO | SOIL_FLAG_TEXTURE_REPEATS,
+			SOIL_FLAG_MIPMAPS | SOIL_FLAG_NTSC_SAFE_RGB,
+			SOIL_FLAG_MIPMAPS | SOIL_FLAG_COMPRESS_TO_DXT,
+		};
+
+		// Writes six distinct noisy faces with the given channel count; the size is deliberately not a power of two
+		void WriteFaces(int channels, std::string filenames[])
+		{
+			std::vector<unsigned char> pixels(FaceWidth * FaceHeight * channels);
+			UINT seed = channels;
+
+			for (UINT face = 0; face < FaceCount; face++)
+			{
+				for (unsigned char& pixel : pixels)
+				{
+					seed = seed * 1664525 + 1013904223;
+					pixel = static_cast<unsigned char>(seed >> 24);
+				}
+
+				std::ostringstream filename;
+				filename << "CubemapLoader" << channels << "_" << face << ".tga";
+				filenames[face] = filename.str();
+
+				SOIL_save_image(filenames[face].c_str(), SOIL_SAVE_TYPE_TGA, FaceWidth, FaceHeight, channels, &pixels[0]);
+			}
+		}
+
+		// Reads one level of a face back in a format both uploads can answer: SOIL's luminance textures and the loader's swizzled red ones
+		void ReadLevel(GLenum target, GLint level, GLenum format, std::vector<unsigned char>& data)
+		{
+			GLint compressed;
+			glGetTexLevelParameteriv(target, level, GL_TEXTURE_COMPRESSED, &compressed);
+
+			if (compressed)
+			{
+				GLint size;
+				glGetTexLevelParameteriv(target, level, GL_TEXTURE_COMPRESSED_IMAGE_SIZE, &size);
+				data.resize(size);
+				glGetCompressedTexImage(target, level, &data[0]);
+			}
+			else
+			{
+				GLint width;
+				GLint height;
+				glGetTexLevelParameteriv(target, level, GL_TEXTURE_WIDTH, &width);
+				glGetTexLevelParameteriv(target, level, GL_TEXTURE_HEIGHT, &height);
+				data.resize(width * height * 4);
+				glGetTexImage(target, level, format, GL_UNSIGNED_BYTE, &data[0]);
+			}
+		}
+
+		// Compares every face and level of two cubemaps; returns the number of mismatched levels
+		UINT CompareCubemaps(GLuint expected, GLuint actual, int channels)
+		{
+			static const GLenum soilFormats[] = { GL_RED, GL_RED, GL_LUMINANCE_ALPHA, GL_RGB, GL_RGBA };
+			static const GLenum loaderFormats[] = { GL_RED, GL_RED, GL_RG, GL_RGB, GL_RGBA };
+
+			UINT mismatchedLevelCount = 0;
+			std::vector<unsigned char> expectedData;
+			std::vector<unsigned char> actualData;
+
+			for (UINT face = 0; face < FaceCount; face++)
+			{
+				GLenum target = GL_TEXTURE_CUBE_MAP_POSITIVE_X + face;
+
+				for (GLint level = 0; level < MaxLevelCount; level++)
+				{
+					GLint expectedWidth;
+					GLint expectedHeight;
+					GLint actualWidth;
+					GLint actualHeight;
+
+					glBindTexture(GL_TEXTURE_CUBE_MAP, expected);
+					glGetTexLevelParameteriv(target, level, GL_TEXTURE_WIDTH, &expectedWidth);
+					glGetTexLevelParameteriv(target, level, GL_TEXTURE_HEIGHT, &expectedHeight);
+					ReadLevel(target, level, soilFormats[channels], expectedData);
+
+					glBindTexture(GL_TEXTURE_CUBE_MAP, actual);
+					glGetTexLevelParameteriv(target, level, GL_TEXTURE_WIDTH, &actualWidth);
+					glGetTexLevelParameteriv(target, level, GL_TEXTURE_HEIGHT, &actualHeight);
+					ReadLevel(target, level, loaderFormats[channels], actualData);
+
+					if (expectedWidth != actualWidth || expectedHeight != actualHeight || expectedData != actualData)
+					{
+						mismatchedLevelCount++;
+					}
+
+					if (expectedWidth == 0 || actualWidth == 0)
+					{
+						break;
+					}
+				}
+			}
+
+			glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+			return mismatchedLevelCount;
+		}
+
+		GLint TextureParameter(GLuint texture, GLenum name)
+		{
+			GLint value;
+			glBindTexture(GL_TEXTURE_CUBE_MAP, texture);
+			glGetTexParameteriv(GL_TEXTURE_CUBE_MAP, name, &value);
+			glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+
+			return value;
+		}
+	}
+
+	// Loads the same faces through SOIL_load_OGL_cubemap() and CubemapLoader, then compares them face by face and level by level
+	void RunCubemapLoaderTests(TestContext& context)
+	{
+		// SOIL's reference path uploads luminance formats, so the context must not be a core profile
+		if (context.Check(glfwInit() != GL_FALSE, "GLFW initializes") == false)
+		{
+			return;
+		}
+
+		glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+		GLFWwindow* window = glfwCreateWindow(16, 16, "CubemapLoaderTests", nullptr, nullptr);
+		if (context.Check(window != nullptr, "a hidden window provides a GL context") == false)
+		{
+			glfwTerminate();
+			return;
+		}
+
+		glfwMakeContextCurrent(window);
+		if (context.Check(gl3wInit() == 0, "gl3w initializes") == false)
+		{
+			glfwDestroyWindow(window);
+			glfwTerminate();
+			return;
+		}
+
+		VirtualFileSystem fileSystem;
+		fileSystem.Mount("", Utility::ToWideString(Utility::CurrentDirectory()));
+		GlobalServices.AddService(VirtualFileSystem::TypeIdClass(), &fileSystem);
+
+		for (int channels = 1; channels <= 4; channels++)
+		{
+			std::string filenames[FaceCount];
+			WriteFaces(channels, filenames);
+
+			for (UINT flags : FlagCombinations)
+			{
+				GLuint expected = SOIL_load_OGL_cubemap(filenames[0].c_str(), filenames[1].c_str(), filenames[2].c_str(), filenames[3].c_str(), filenames[4].c_str(), filenames[5].c_str(), SOIL_LOAD_AUTO, SOIL_CREATE_NEW_ID, flags);
+				GLuint actual = CubemapLoader::LoadCubemap(filenames[0], filenames[1], filenames[2], filenames[3], filenames[4], filenames[5], flags);
+
+				std::ostringstream description;
+				description << channels << "-channel faces with flags 0x" << std::hex << flags;
+
+				context.Check(expected != 0, "SOIL loads " + description.str());
+				context.Check(CompareCubemaps(expected, actual, channels) == 0, "every face and level matches SOIL for " + description.str());
+				context.Check(TextureParameter(expected, GL_TEXTURE_MIN_FILTER) == TextureParameter(actual, GL_TEXTURE_MIN_FILTER) &&
+					TextureParameter(expected, GL_TEXTURE_WRAP_S) == TextureParameter(actual, GL_TEXTURE_WRAP_S), "sampling state matches SOIL for " + description.str());
+
+				// DXT5 already carries grey-alpha as grey RGB and alpha, so only uncompressed grey-alpha faces swizzle
+				if (channels == 1 || (channels == 2 && (flags & SOIL_FLAG_COMPRESS_TO_DXT) == 0))
+				{
+					GLint expectedAlpha = (channels == 1 ? GL_ONE : GL_GREEN);
+					context.Check(TextureParameter(actual, GL_TEXTURE_SWIZZLE_G) == GL_RED && TextureParameter(actual, GL_TEXTURE_SWIZZLE_B) == GL_RED &&
+						TextureParameter(actual, GL_TEXTURE_SWIZZLE_A) == expectedAlpha, "grey faces sample as luminance for " + description.str());
+				}
+
+				glDeleteTextures(1, &expected);
+				glDeleteTextures(1, &actual);
+			}
+
+			for (const std::string& filename : filenames)
+			{
+				remove(filename.c_str());
+			}
+		}
+
+		bool rejected = false;
+		try
+		{
+			CubemapLoader::LoadCubemap("a", "b", "c", "d", "e", "f", SOIL_FLAG_DDS_LOAD_DIRECT);
+		}
+		catch (GameException&)
+		{
+			rejected = true;
+		}
+		context.Check(rejected, "unsupported SOIL flags are rejected");
+
+		GlobalServices.RemoveService(VirtualFileSystem::TypeIdClass());
+		glfwDestroyWindow(window);
+		glfwTerminate();
+	}
+}
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "TestHarness.h"
+#include "TestSuites.h"
+#include "MatrixHelper.h"
+#include <cfloat>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <sstream>
+
+using namespace glm;
+using namespace Library;
+
+namespace Tests
+{
+	namespace
+	{
+		// Odd sizes leave every kernel a remainder to finish after its wide loop
+		const UINT BatchSizes[] = { 1, 3, 8, 17, 256, 4099, 65536 };
+		const UINT TimedElementCount = 4000000;
+		const float ValueRange = 4.0f;
+		const int MaxUlps = 4;
+
+		const char* SimdLevelNames[] = { "scalar", "sse", "avx2" };
+
+		// Distance in representable floats; sign-magnitude bits are mapped onto a monotonic integer line
+		int UlpDistance(float lhs, float rhs)
+		{
+			int lhsBits;
+			int rhsBits;
+			memcpy(&lhsBits, &lhs, sizeof(float));
+			memcpy(&rhsBits, &rhs, sizeof(float));
+			lhsBits = (lhsBits < 0 ? INT_MIN - lhsBits : lhsBits);
+			rhsBits = (rhsBits < 0 ? INT_MIN - rhsBits : rhsBits);
+
+			long long distance = static_cast<long long>(lhsBits) - rhsBits;
+			return static_cast<int>(distance < 0 ? (-distance > INT_MAX ? INT_MAX : -distance) : (distance > INT_MAX ? INT_MAX : distance));
+		}
+
+		// Fused and split multiply-adds round differently, and a sum that cancels towards zero turns that into a huge
+		// ulp count; the tolerance is therefore also measured in ulps of the largest term that went into the sum.
+		bool NearlyEqual(float value, float expected, float magnitude, int& maxUlps)
+		{
+			int ulps = UlpDistance(value, expected);
+			maxUlps = (ulps > maxUlps ? ulps : maxUlps);
+
+			return (ulps <= MaxUlps || abs(value - expected) <= MaxUlps * FLT_EPSILON * magnitude);
+		}
+
+		mat4 AbsoluteMatrix(const mat4& matrix)
+		{
+			mat4 result;
+			for (int column = 0; column < 4; column++)
+			{
+				result[column] = abs(matrix[column]);
+			}
+
+			return result;
+		}
+
+		template <typename T>
+		bool CompareVectors(const mat4& matrix, const vec3* sources, const T* results, UINT count, float w, int& maxUlps)
+		{
+			mat4 absoluteMatrix = AbsoluteMatrix(matrix);
+			bool equal = true;
+
+			for (UINT i = 0; i < count; i++)
+			{
+				vec4 expected = matrix * vec4(sources[i], w);
+				vec4 magnitude = absoluteMatrix * abs(vec4(sources[i], w));
+				for (int component = 0; component < static_cast<int>(sizeof(T) / sizeof(float)); component++)
+				{
+					equal &= NearlyEqual(results[i][component], expected[component], magnitude[component], maxUlps);
+				}
+			}
+
+			return equal;
+		}
+
+		bool CompareMatrices(const mat4& left, const mat4* rights, const mat4* results, UINT count, int& maxUlps)
+		{
+			mat4 absoluteLeft = AbsoluteMatrix(left);
+			bool equal = true;
+
+			for (UINT i = 0; i < count; i++)
+			{
+				mat4 expected = left * rights[i];
+				mat4 magnitude = absoluteLeft * AbsoluteMatrix(rights[i]);
+				for (int column = 0; column < 4; column++)
+				{
+					for (int row = 0; row < 4; row++)
+					{
+						equal &= NearlyEqual(results[i][column][row], expected[column][row], magnitude[column][row], maxUlps);
+					}
+				}
+			}
+
+			return equal;
+		}
+
+		std::string Describe(const char* kernel, SimdLevel level, UINT batchSize, int maxUlps)
+		{
+			std::ostringstream message;
+			message << kernel << " (" << SimdLevelNames[level] << ", " << batchSize << " elements) matches glm; worst case " << maxUlps << " ulps";
+
+			return message.str();
+		}
+
+		// Nanoseconds per element, running the batch often enough to cover a fixed element count
+		template <typename Kernel>
+		double TimeKernel(UINT batchSize, Kernel kernel)
+		{
+			UINT repeatCount = (TimedElementCount + batchSize - 1) / batchSize;
+
+			Stopwatch stopwatch;
+			for (UINT i = 0; i < repeatCount; i++)
+			{
+				kernel();
+			}
+
+			return stopwatch.ElapsedMilliseconds() * 1000000.0 / (static_cast<double>(repeatCount) * batchSize);
+		}
+	}
+
+	void RunMatrixHelperBenchmark(TestContext& context)
+	{
+		std::mt19937 generator(5);
+		std::uniform_real_distribution<float> distribution(-ValueRange, ValueRange);
+
+		UINT maxBatchSize = BatchSizes[sizeof(BatchSizes) / sizeof(BatchSizes[0]) - 1];
+		std::vector<vec3> points(maxBatchSize);
+		std::vector<mat4> matrices(maxBatchSize);
+		for (vec3& point : points)
+		{
+			point = vec3(distribution(generator), distribution(generator), distribution(generator));
+		}
+
+		for (mat4& matrix : matrices)
+		{
+			for (int column = 0; column < 4; column++)
+			{
+				matrix[column] = vec4(distribution(generator), distribution(generator), distribution(generator), distribution(generator));
+			}
+		}
+
+		const mat4& viewProjection = matrices[maxBatchSize / 2];
+
+		std::vector<vec3> vectorResults(maxBatchSize);
+		std::vector<vec4> homogeneousResults(maxBatchSize);
+		std::vector<mat4> matrixResults(maxBatchSize);
+
+		SimdLevel supportedSimdLevel = MatrixHelper::SupportedSimdLevel();
+		printf("  CPU supports %s\n", SimdLevelNames[supportedSimdLevel]);
+		printf("  %-7s %7s %11s %11s %11s %11s %11s\n", "kernel", "batch", "glm ns", "points ns", "dirs ns", "clip ns", "wvp ns");
+
+		for (int level = SimdLevelScalar; level <= supportedSimdLevel; level++)
+		{
+			SimdLevel simdLevel = static_cast<SimdLevel>(level);
+			MatrixHelper::SetSimdLevel(simdLevel);
+
+			for (UINT batchSize : BatchSizes)
+			{
+				int maxUlps = 0;
+				MatrixHelper::TransformPoints(viewProjection, &points[0], &vectorResults[0], batchSize);
+				context.Check(CompareVectors(viewProjection, &points[0], &vectorResults[0], batchSize, 1.0f, maxUlps), Describe("TransformPoints", simdLevel, batchSize, maxUlps));
+
+				maxUlps = 0;
+				MatrixHelper::TransformDirections(viewProjection, &points[0], &vectorResults[0], batchSize);
+				context.Check(CompareVectors(viewProjection, &points[0], &vectorResults[0], batchSize, 0.0f, maxUlps), Describe("TransformDirections", simdLevel, batchSize, maxUlps));
+
+				maxUlps = 0;
+				MatrixHelper::TransformPoints(viewProjection, &points[0], &homogeneousResults[0], batchSize);
+				context.Check(CompareVectors(viewProjection, &points[0], &homogeneousResults[0], batchSize, 1.0f, maxUlps), Describe("TransformPoints (clip space)", simdLevel, batchSize, maxUlps));
+
+				maxUlps = 0;
+				MatrixHelper::ComputeWorldViewProjections(viewProjection, &matrices[0], &matrixResults[0], batchSize);
+				context.Check(CompareMatrices(viewProjection, &matrices[0], &matrixResults[0], batchSize, maxUlps), Describe("ComputeWorldViewProjections", simdLevel, batchSize, maxUlps));
+
+				// Pairwise products: each left is the matching right, so the reference is that matrix squared
+				maxUlps = 0;
+				bool equal = true;
+				MatrixHelper::MultiplyMatrices(&matrices[0], &matrices[0], &matrixResults[0], batchSize);
+				for (UINT i = 0; i < batchSize; i++)
+				{
+					equal &= CompareMatrices(matrices[i], &matrices[i], &matrixResults[i], 1, maxUlps);
+				}
+				context.Check(equal, Describe("MultiplyMatrices", simdLevel, batchSize, maxUlps));
+
+				// Results may overwrite their own inputs
+				maxUlps = 0;
+				std::vector<vec3> inPlace(points.begin(), points.begin() + batchSize);
+				MatrixHelper::TransformPoints(viewProjection, &inPlace[0], &inPlace[0], batchSize);
+				context.Check(CompareVectors(viewProjection, &points[0], &inPlace[0], batchSize, 1.0f, maxUlps), Describe("TransformPoints in place", simdLevel, batchSize, maxUlps));
+
+				double glmTime = TimeKernel(batchSize, [&]()
+				{
+					for (UINT i = 0; i < batchSize; i++)
+					{
+						vectorResults[i] = vec3(viewProjection * vec4(points[i], 1.0f));
+					}
+				});
+
+				double pointsTime = TimeKernel(batchSize, [&]() { MatrixHelper::TransformPoints(viewProjection, &points[0], &vectorResults[0], batchSize); });
+				double directionsTime = TimeKernel(batchSize, [&]() { MatrixHelper::TransformDirections(viewProjection, &points[0], &vectorResults[0], batchSize); });
+				double clipTime = TimeKernel(batchSize, [&]() { MatrixHelper::TransformPoints(viewProjection, &points[0], &homogeneousResults[0], batchSize); });
+				double worldViewProjectionTime = TimeKernel(batchSize, [&]() { MatrixHelper::ComputeWorldViewProjections(viewProjection, &matrices[0], &matrixResults[0], batchSize); });
+
+				printf("  %-7s %7u %11.2f %11.2f %11.2f %11.2f %11.2f\n", SimdLevelNames[level], batchSize, glmTime, pointsTime, directionsTime, clipTime, worldViewProjectionTime);
+			}
+		}
+
+		MatrixHelper::SetSimdLevel(supportedSimdLevel);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,137 @@
+#include "TestHarness.h"
+#include "TestSuites.h"
+#include "OcclusionCuller.h"
+#include "Utility.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <cstdio>
+#include <fstream>
+
+using namespace glm;
+using namespace Library;
+
+namespace Tests
+{
+	namespace
+	{
+		const char* DepthBufferFilename = "OcclusionCuller.pgm";
+		const float FieldOfView = 45.0f;
+		const float AspectRatio = 2.0f;
+		const float WallDistance = 10.0f;
+		const float WallHalfSize = 5.0f;
+		const float CoverageTolerance = 0.02f;
+		const UINT BatchSize = 1000;
+
+		// A square facing the camera, centred at the given distance down -z
+		UINT AddWall(OcclusionCuller& occlusionCuller, float halfSize, float distance)
+		{
+			std::vector<vec3> vertices;
+			vertices.push_back(vec3(-halfSize, -halfSize, 0.0f));
+			vertices.push_back(vec3(halfSize, -halfSize, 0.0f));
+			vertices.push_back(vec3(halfSize, halfSize, 0.0f));
+			vertices.push_back(vec3(-halfSize, halfSize, 0.0f));
+
+			UINT indices[] = { 0, 1, 2, 0, 2, 3 };
+
+			return occlusionCuller.AddOccluder(vertices, std::vector<UINT>(indices, indices + 6), translate(mat4(), vec3(0.0f, 0.0f, -distance)));
+		}
+
+		// Reads back a PGM written by DumpDepthBuffer; rows come out top-down
+		bool ReadDepthImage(const char* filename, UINT& width, UINT& height, std::vector<unsigned char>& pixels)
+		{
+			std::ifstream file(filename, std::ios::binary);
+			std::string magic;
+			UINT maxValue;
+			file >> magic >> width >> height >> maxValue;
+			if (file.fail() || magic != "P5" || maxValue != 255)
+			{
+				return false;
+			}
+
+			file.get();
+			pixels.resize(width * height);
+			file.read(reinterpret_cast<char*>(&pixels.front()), pixels.size());
+
+			return (file.gcount() == static_cast<std::streamsize>(pixels.size()));
+		}
+	}
+
+	void RunOcclusionCullerTests(TestContext& context)
+	{
+		OcclusionCuller occlusionCuller;
+		AddWall(occlusionCuller, WallHalfSize, WallDistance);
+
+		mat4 viewProjection = perspective(FieldOfView, AspectRatio, 0.1f, 100.0f) * lookAt(vec3(0.0f), vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 1.0f, 0.0f));
+
+		Stopwatch stopwatch;
+		occlusionCuller.Rasterize(viewProjection);
+		printf("  rasterized %u triangles into %ux%u in %.3f ms\n", occlusionCuller.RasterizedTriangleCount(), occlusionCuller.Width(), occlusionCuller.Height(), stopwatch.ElapsedMilliseconds());
+		context.Check(occlusionCuller.RasterizedTriangleCount() == 2, "both wall triangles are rasterized");
+
+		BoundingBox behind(vec3(-1.0f, -1.0f, -21.0f), vec3(1.0f, 1.0f, -19.0f));
+		BoundingBox inFront(vec3(-1.0f, -1.0f, -6.0f), vec3(1.0f, 1.0f, -4.0f));
+		BoundingBox beside(vec3(12.0f, -1.0f, -21.0f), vec3(14.0f, 1.0f, -19.0f));
+		BoundingBox straddling(vec3(4.0f, -1.0f, -21.0f), vec3(12.0f, 1.0f, -19.0f));
+		context.Check(occlusionCuller.IsVisible(behind) == false, "a box behind the wall is occluded");
+		context.Check(occlusionCuller.IsVisible(inFront), "a box in front of the wall is visible");
+		context.Check(occlusionCuller.IsVisible(beside), "a box beside the wall is visible");
+		context.Check(occlusionCuller.IsVisible(straddling), "a box straddling the wall's edge is visible");
+
+		std::vector<BoundingBox> batch(BatchSize, behind);
+		batch[BatchSize / 2] = inFront;
+		std::vector<GLboolean> visible;
+		stopwatch.Restart();
+		occlusionCuller.TestVisibility(batch, visible);
+		printf("  tested %u boxes in %.3f ms\n", BatchSize, stopwatch.ElapsedMilliseconds());
+
+		UINT visibleCount = 0;
+		for (GLboolean isVisible : visible)
+		{
+			visibleCount += (isVisible ? 1 : 0);
+		}
+		context.Check(visible.size() == BatchSize && visibleCount == 1 && visible[BatchSize / 2], "batched tests match the single-box results");
+
+		// The dumped image must agree with the buffer and with the wall's projected footprint
+		occlusionCuller.DumpDepthBuffer(Utility::ToWideString(DepthBufferFilename));
+
+		UINT width;
+		UINT height;
+		std::vector<unsigned char> pixels;
+		if (context.Check(ReadDepthImage(DepthBufferFilename, width, height, pixels), "the depth dump is a readable PGM") == false)
+		{
+			return;
+		}
+		context.Check(width == occlusionCuller.Width() && height == occlusionCuller.Height(), "the depth dump matches the buffer size");
+
+		UINT writtenDepthCount = 0;
+		for (float depth : occlusionCuller.DepthBuffer())
+		{
+			writtenDepthCount += (depth < 1.0f ? 1 : 0);
+		}
+
+		UINT coveredPixelCount = 0;
+		for (unsigned char pixel : pixels)
+		{
+			coveredPixelCount += (pixel < 255 ? 1 : 0);
+		}
+		context.Check(coveredPixelCount == writtenDepthCount, "the dump marks exactly the written pixels");
+
+		// The wall spans the full height and a fixed fraction of the width
+		float halfWidth = WallDistance * tan(radians(FieldOfView * 0.5f)) * AspectRatio;
+		float expectedCoverage = WallHalfSize / halfWidth;
+		float coverage = static_cast<float>(coveredPixelCount) / (width * height);
+		printf("  wall covers %.4f of the buffer, expected %.4f\n", coverage, expectedCoverage);
+		context.Check(abs(coverage - expectedCoverage) < CoverageTolerance, "the wall covers its projected footprint");
+		context.Check(pixels[(height / 2) * width + width / 2] < 255 && pixels[0] == 255, "the centre is covered and the corner is clear");
+
+		// A smaller, nearer square in front of the wall: the nearest depth wins and dumps darker
+		AddWall(occlusionCuller, WallHalfSize * 0.25f, WallDistance * 0.5f);
+		occlusionCuller.Rasterize(viewProjection);
+		occlusionCuller.DumpDepthBuffer(Utility::ToWideString(DepthBufferFilename));
+		if (context.Check(ReadDepthImage(DepthBufferFilename, width, height, pixels), "the second depth dump is a readable PGM"))
+		{
+			unsigned char centre = pixels[(height / 2) * width + width / 2];
+			unsigned char wall = pixels[(height / 2) * width + width / 2 + width / 5];
+			context.Check(centre < wall && wall < 255, "the nearer occluder is kept over the farther one");
+		}
+	}
+}
\ No newline at end of file
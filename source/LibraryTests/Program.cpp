@@ -0,0 +1,70 @@
+#include "Common.h"
+#include "GameException.h"
+#include "TestHarness.h"
+#include "TestSuites.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace Library;
+using namespace Tests;
+
+namespace
+{
+	struct TestSuite
+	{
+		const char* Name;
+		void (*Run)(TestContext& context);
+	};
+
+	const TestSuite Suites[] =
+	{
+		{ "SpatialIndex", RunSpatialIndexBenchmark },
+		{ "OcclusionCuller", RunOcclusionCullerTests },
+		{ "MatrixHelper", RunMatrixHelperBenchmark },
+		{ "AnimationCodec", RunAnimationCodecTests },
+		{ "ClusteredLighting", RunClusteredLightingTests },
+		{ "CubemapLoader", RunCubemapLoaderTests },
+		{ "StaticBatch", RunStaticBatchTests },
+		{ "AssetPack", RunAssetPackTests },
+	};
+}
+
+// Runs every suite, or only those named on the command line; the exit code is the number of failed suites
+int main(int argc, char* argv[])
+{
+	int failedSuiteCount = 0;
+
+	for (const TestSuite& suite : Suites)
+	{
+		bool selected = (argc < 2);
+		for (int i = 1; i < argc; i++)
+		{
+			selected |= (strcmp(argv[i], suite.Name) == 0);
+		}
+
+		if (selected == false)
+		{
+			continue;
+		}
+
+		printf("[%s]\n", suite.Name);
+		TestContext context(suite.Name);
+
+		try
+		{
+			suite.Run(context);
+		}
+		catch (GameException ex)
+		{
+			context.Check(false, ex.what());
+		}
+
+		printf("[%s] %u checks, %u failed\n\n", suite.Name, context.CheckCount(), context.FailureCount());
+		if (context.FailureCount() > 0)
+		{
+			failedSuiteCount++;
+		}
+	}
+
+	return failedSuiteCount;
+}
\ No newline at end of file
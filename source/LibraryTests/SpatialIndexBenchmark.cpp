@@ -0,0 +1,286 @@
+#include "TestHarness.h"
+#include "TestSuites.h"
+#include "BoundingVolumeHierarchy.h"
+#include "Frustum.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+using namespace glm;
+using namespace Library;
+
+namespace Tests
+{
+	namespace
+	{
+		const UINT ObjectCounts[] = { 10000, 100000, 1000000 };
+		const UINT FrustumQueryCount = 16;
+		const UINT BatchQueryCount = 256;
+		const UINT BruteForceRayCount = 16;
+		const float ObjectSpacing = 4.0f;
+		const float DrawDistance = 100.0f;
+		const float MovedObjectFraction = 0.1f;
+
+		// Cameras spread around the middle of the scene, each looking a different way with a fixed draw distance
+		Frustum CreateFrustum(UINT index)
+		{
+			float angle = index * 2.39996f;
+			vec3 direction(cos(angle), 0.25f * sin(3.0f * angle), sin(angle));
+			mat4 projection = perspective(60.0f, 16.0f / 9.0f, 0.5f, DrawDistance);
+
+			return Frustum(projection * lookAt(vec3(0.0f), direction, vec3(0.0f, 1.0f, 0.0f)));
+		}
+
+		// What Game::Draw did before the index existed: test every object's bounds against the frustum
+		void QueryLinear(const std::vector<BoundingBox>& boxes, const std::vector<void*>& userData, const Frustum& frustum, std::vector<void*>& results)
+		{
+			for (UINT i = 0; i < boxes.size(); i++)
+			{
+				if (frustum.Intersects(boxes[i]))
+				{
+					results.push_back(userData[i]);
+				}
+			}
+		}
+
+		bool SameResults(std::vector<void*> lhs, std::vector<void*> rhs)
+		{
+			std::sort(lhs.begin(), lhs.end());
+			std::sort(rhs.begin(), rhs.end());
+
+			return (lhs == rhs);
+		}
+
+		// Every object's bounds against the ray, with the same slab test the tree applies at its leaves
+		void QueryRayLinear(const std::vector<BoundingBox>& boxes, const std::vector<void*>& userData, const Ray& ray, std::vector<RayHit>& hits)
+		{
+			vec3 inverseDirection = 1.0f / ray.Direction;
+			for (UINT i = 0; i < boxes.size(); i++)
+			{
+				vec3 t1 = (boxes[i].Minimum - ray.Origin) * inverseDirection;
+				vec3 t2 = (boxes[i].Maximum - ray.Origin) * inverseDirection;
+				vec3 tNear = glm::min(t1, t2);
+				vec3 tFar = glm::max(t1, t2);
+
+				float entry = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, 0.0f));
+				float exit = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, ray.MaxDistance));
+				if (entry <= exit)
+				{
+					RayHit hit = { userData[i], entry };
+					hits.push_back(hit);
+				}
+			}
+		}
+
+		bool SameHits(std::vector<RayHit> lhs, std::vector<RayHit> rhs)
+		{
+			// Ties in distance may come back in either order, so compare by object
+			auto byObject = [](const RayHit& a, const RayHit& b) { return a.UserData < b.UserData; };
+			std::sort(lhs.begin(), lhs.end(), byObject);
+			std::sort(rhs.begin(), rhs.end(), byObject);
+
+			if (lhs.size() != rhs.size())
+			{
+				return false;
+			}
+
+			for (UINT i = 0; i < lhs.size(); i++)
+			{
+				if (lhs[i].UserData != rhs[i].UserData || lhs[i].Distance != rhs[i].Distance)
+				{
+					return false;
+				}
+			}
+
+			return true;
+		}
+	}
+
+	void RunSpatialIndexBenchmark(TestContext& context)
+	{
+		printf("  %9s %10s %10s %10s %10s %10s %10s %10s %10s %11s %10s %8s\n", "objects", "insert ms", "update ms", "linear ms", "query ms", "rebuilt ms", "batch ms", "rays ms", "rebuild ms", "reinsert ms", "churned ms", "visible");
+
+		for (UINT objectCount : ObjectCounts)
+		{
+			// Constant density and draw distance: the frustum takes in about a tenth of the scene until the scene
+			// outgrows the draw distance, so only the largest run sees a visible count that no longer tracks the total
+			float sceneExtent = ObjectSpacing * pow(static_cast<float>(objectCount), 1.0f / 3.0f);
+			std::mt19937 generator(objectCount);
+			std::uniform_real_distribution<float> position(-sceneExtent * 0.5f, sceneExtent * 0.5f);
+			std::uniform_real_distribution<float> extent(0.1f, 1.5f);
+
+			std::vector<BoundingBox> boxes(objectCount);
+			std::vector<void*> userData(objectCount);
+			for (UINT i = 0; i < objectCount; i++)
+			{
+				vec3 center(position(generator), position(generator), position(generator));
+				vec3 halfSize(extent(generator), extent(generator), extent(generator));
+				boxes[i] = BoundingBox(center - halfSize, center + halfSize);
+				userData[i] = &boxes[i];
+			}
+
+			BoundingVolumeHierarchy index;
+			std::vector<UINT> proxies(objectCount);
+
+			Stopwatch stopwatch;
+			for (UINT i = 0; i < objectCount; i++)
+			{
+				proxies[i] = index.Insert(boxes[i], userData[i]);
+			}
+			double insertTime = stopwatch.ElapsedMilliseconds();
+
+			// A tenth of the scene drifts a little, as moving objects would between frames
+			UINT movedCount = static_cast<UINT>(objectCount * MovedObjectFraction);
+			std::uniform_int_distribution<UINT> objectIndex(0, objectCount - 1);
+			std::uniform_real_distribution<float> drift(-0.5f, 0.5f);
+
+			stopwatch.Restart();
+			for (UINT i = 0; i < movedCount; i++)
+			{
+				UINT moved = objectIndex(generator);
+				vec3 offset(drift(generator), drift(generator), drift(generator));
+				boxes[moved] = BoundingBox(boxes[moved].Minimum + offset, boxes[moved].Maximum + offset);
+				index.Update(proxies[moved], boxes[moved]);
+			}
+			double updateTime = stopwatch.ElapsedMilliseconds();
+
+			std::vector<Frustum> frustums;
+			for (UINT i = 0; i < BatchQueryCount; i++)
+			{
+				frustums.push_back(CreateFrustum(i));
+			}
+
+			std::vector<std::vector<void*>> linearResults(FrustumQueryCount);
+			stopwatch.Restart();
+			for (UINT i = 0; i < FrustumQueryCount; i++)
+			{
+				QueryLinear(boxes, userData, frustums[i], linearResults[i]);
+			}
+			double linearTime = stopwatch.ElapsedMilliseconds() / FrustumQueryCount;
+
+			std::vector<std::vector<void*>> indexResults(FrustumQueryCount);
+			stopwatch.Restart();
+			for (UINT i = 0; i < FrustumQueryCount; i++)
+			{
+				index.QueryFrustum(frustums[i], indexResults[i]);
+			}
+			double queryTime = stopwatch.ElapsedMilliseconds() / FrustumQueryCount;
+
+			// A purely incremental tree can query slower than the linear scan (about 2x at 100K, where a tenth of the
+			// scene is visible and the scan streams through memory); it only pulls ahead once the scene outgrows the
+			// draw distance. The rebuilt tree is what Game::Draw queries, and it stays level with the scan or better
+			bool sameResults = true;
+			for (UINT i = 0; i < FrustumQueryCount; i++)
+			{
+				sameResults &= SameResults(linearResults[i], indexResults[i]);
+			}
+			context.Check(sameResults, "incremental tree frustum query differs from the linear scan");
+
+			stopwatch.Restart();
+			index.Rebuild();
+			double rebuildTime = stopwatch.ElapsedMilliseconds();
+
+			stopwatch.Restart();
+			for (UINT i = 0; i < FrustumQueryCount; i++)
+			{
+				indexResults[i].clear();
+				index.QueryFrustum(frustums[i], indexResults[i]);
+			}
+			double rebuiltQueryTime = stopwatch.ElapsedMilliseconds() / FrustumQueryCount;
+
+			sameResults = true;
+			for (UINT i = 0; i < FrustumQueryCount; i++)
+			{
+				sameResults &= SameResults(linearResults[i], indexResults[i]);
+			}
+			context.Check(sameResults, "rebuilt tree frustum query differs from the linear scan");
+
+			// Batched queries fan out over the job system; per query cost is what a multi-view frame pays
+			std::vector<std::vector<void*>> batchResults;
+			stopwatch.Restart();
+			index.QueryFrustums(frustums, batchResults);
+			double batchTime = stopwatch.ElapsedMilliseconds() / BatchQueryCount;
+			context.Check(batchResults.size() == BatchQueryCount && SameResults(batchResults[0], linearResults[0]), "batched frustum query differs from the single query");
+
+			std::vector<Ray> rays;
+			for (UINT i = 0; i < BatchQueryCount; i++)
+			{
+				// Tilted off the axis: an axis-aligned ray starting exactly on a box face makes the slab test 0 * inf,
+				// and the brute-force check below would then hinge on how each loop was vectorized
+				vec3 origin(position(generator), position(generator), -sceneExtent);
+				rays.push_back(Ray(origin, normalize(vec3(0.05f, 0.03f, 1.0f)), sceneExtent * 2.0f));
+			}
+
+			std::vector<std::vector<RayHit>> rayResults;
+			stopwatch.Restart();
+			index.QueryRays(rays, rayResults);
+			double rayTime = stopwatch.ElapsedMilliseconds() / BatchQueryCount;
+
+			bool nearestFirst = true;
+			for (const std::vector<RayHit>& hits : rayResults)
+			{
+				for (UINT i = 1; i < hits.size(); i++)
+				{
+					nearestFirst &= (hits[i - 1].Distance <= hits[i].Distance);
+				}
+			}
+			context.Check(nearestFirst, "ray hits are not sorted nearest first");
+
+			bool sameHits = true;
+			for (UINT i = 0; i < BruteForceRayCount; i++)
+			{
+				std::vector<RayHit> linearHits;
+				QueryRayLinear(boxes, userData, rays[i], linearHits);
+				sameHits &= SameHits(linearHits, rayResults[i]);
+			}
+			context.Check(sameHits, "ray hits differ from testing every object");
+
+			// A tenth of the scene despawns and respawns elsewhere, so the removed leaves must not be found again
+			UINT churnStride = objectCount / movedCount;
+			stopwatch.Restart();
+			for (UINT i = 0; i < objectCount; i += churnStride)
+			{
+				index.Remove(proxies[i]);
+
+				vec3 center(position(generator), position(generator), position(generator));
+				vec3 halfSize(extent(generator), extent(generator), extent(generator));
+				boxes[i] = BoundingBox(center - halfSize, center + halfSize);
+				proxies[i] = index.Insert(boxes[i], userData[i]);
+			}
+			double reinsertTime = stopwatch.ElapsedMilliseconds();
+			context.Check(index.ProxyCount() == objectCount, "remove and reinsert changed the proxy count");
+
+			stopwatch.Restart();
+			for (UINT i = 0; i < FrustumQueryCount; i++)
+			{
+				indexResults[i].clear();
+				index.QueryFrustum(frustums[i], indexResults[i]);
+			}
+			double churnedQueryTime = stopwatch.ElapsedMilliseconds() / FrustumQueryCount;
+
+			sameResults = true;
+			for (UINT i = 0; i < FrustumQueryCount; i++)
+			{
+				std::vector<void*> churnedResults;
+				QueryLinear(boxes, userData, frustums[i], churnedResults);
+				sameResults &= SameResults(churnedResults, indexResults[i]);
+			}
+			context.Check(sameResults, "frustum query after remove and reinsert differs from the linear scan");
+
+			rayResults.clear();
+			index.QueryRays(rays, rayResults);
+
+			sameHits = true;
+			for (UINT i = 0; i < BruteForceRayCount; i++)
+			{
+				std::vector<RayHit> linearHits;
+				QueryRayLinear(boxes, userData, rays[i], linearHits);
+				sameHits &= SameHits(linearHits, rayResults[i]);
+			}
+			context.Check(sameHits, "ray hits after remove and reinsert differ from testing every object");
+
+			printf("  %9u %10.2f %10.2f %10.3f %10.3f %10.3f %10.3f %10.4f %10.2f %11.2f %10.3f %8u\n", objectCount, insertTime, updateTime, linearTime, queryTime, rebuiltQueryTime, batchTime, rayTime, rebuildTime, reinsertTime, churnedQueryTime, static_cast<UINT>(linearResults[0].size()));
+		}
+	}
+}
\ No newline at end of file
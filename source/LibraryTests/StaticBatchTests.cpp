@@ -0,0 +1,215 @@
+#include "TestHarness.h"
+#include "TestSuites.h"
+#include "Game.h"
+#include "GameException.h"
+#include "Camera.h"
+#include "DirectionalLight.h"
+#include "InstancedModel.h"
+#include "StaticBatch.h"
+#include "Model.h"
+#include "VectorHelper.h"
+#include "glm/gtc/matrix_transform.hpp"
+#include <cstdio>
+#include <sstream>
+
+using namespace glm;
+using namespace Library;
+
+namespace Tests
+{
+	namespace
+	{
+		const int FieldExtent = 4;
+		const float FieldSpacing = 2.5f;
+		const float SphereScale = 0.5f;
+		const int ChannelTolerance = 1;
+		const float InstancedMismatchTolerance = 0.001f;
+
+		// A game whose window stays hidden; the suite drives it by hand instead of through Run()
+		class HiddenGame : public Game
+		{
+		public:
+			HiddenGame()
+				: Game(GetModuleHandle(nullptr), L"StaticBatchTests")
+			{
+				mDepthStencilBufferEnabled = true;
+			}
+
+			void Start()
+			{
+				InitializeWindow();
+				InitializeOpenGL();
+			}
+
+			void Stop()
+			{
+				Shutdown();
+			}
+
+			void AddComponent(GameComponent* component)
+			{
+				mComponents.push_back(component);
+			}
+
+		protected:
+			virtual void InitializeWindow() override
+			{
+				if (!glfwInit())
+				{
+					throw GameException("glfwInit() failed.");
+				}
+
+				glfwWindowHint(GLFW_VISIBLE, GL_FALSE);
+				Game::InitializeWindow();
+			}
+		};
+
+		// Draws the components' queued items into the bound framebuffer and reads the colors back
+		void Render(HiddenGame& game, const GameTime& gameTime, DrawableGameComponent& component, std::vector<unsigned char>& pixels)
+		{
+			static const GLfloat one = 1.0f;
+			static const GLfloat black[] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+			glClearBufferfv(GL_COLOR, 0, black);
+			glClearBufferfv(GL_DEPTH, 0, &one);
+
+			component.Draw(gameTime);
+			game.DrawQueue().Execute();
+
+			pixels.resize(game.ScreenWidth() * game.ScreenHeight() * 4);
+			glPixelStorei(GL_PACK_ALIGNMENT, 1);
+			glReadPixels(0, 0, game.ScreenWidth(), game.ScreenHeight(), GL_RGBA, GL_UNSIGNED_BYTE, &pixels[0]);
+		}
+
+		UINT MismatchedPixelCount(const std::vector<unsigned char>& expected, const std::vector<unsigned char>& actual)
+		{
+			UINT mismatchedPixelCount = 0;
+			for (UINT i = 0; i < expected.size(); i += 4)
+			{
+				for (UINT j = 0; j < 4; j++)
+				{
+					if (abs(expected[i + j] - actual[i + j]) > ChannelTolerance)
+					{
+						mismatchedPixelCount++;
+						break;
+					}
+				}
+			}
+
+			return mismatchedPixelCount;
+		}
+
+		UINT CoveredPixelCount(const std::vector<unsigned char>& pixels)
+		{
+			UINT coveredPixelCount = 0;
+			for (UINT i = 0; i < pixels.size(); i += 4)
+			{
+				coveredPixelCount += (pixels[i + 3] > 0 ? 1 : 0);
+			}
+
+			return coveredPixelCount;
+		}
+	}
+
+	// Renders one field of spheres three ways (multi-draw batch, one draw per sphere from the batch's buffers, and
+	// the instanced model lesson 5.3 draws the same field with) and compares the images pixel by pixel
+	void RunStaticBatchTests(TestContext& context)
+	{
+		HiddenGame game;
+		game.Start();
+
+		// The components release their GL objects when they go out of scope, before the context is destroyed
+		{
+			Camera camera(game);
+			DirectionalLight light(game);
+			Light ambientLight(game);
+			ambientLight.SetColor(0.25f, 0.25f, 0.25f, 1.0f);
+
+			InstancedModel instancedModel(game, camera, "Content/Models/Sphere.obj");
+			StaticBatch staticBatch(game, camera);
+			game.AddComponent(&camera);
+			game.AddComponent(&instancedModel);
+			game.AddComponent(&staticBatch);
+			game.Initialize();
+
+			Model sphere(game, "Content/Models/Sphere.obj", true);
+			UINT sphereCount = 0;
+			for (int z = -FieldExtent; z <= FieldExtent; z++)
+			{
+				for (int x = -FieldExtent; x <= FieldExtent; x++)
+				{
+					mat4 world = scale(translate(mat4(), vec3(x * FieldSpacing, 0.0f, z * FieldSpacing)), vec3(SphereScale));
+					vec4 color((x + FieldExtent) / (2.0f * FieldExtent), (z + FieldExtent) / (2.0f * FieldExtent), 0.5f, 1.0f);
+
+					instancedModel.AddInstance(world, color);
+					staticBatch.Add(sphere, world, color);
+					sphereCount++;
+				}
+			}
+
+			staticBatch.Build();
+			context.Check(staticBatch.DrawCount() == sphereCount * sphere.Meshes().size(), "the batch holds one draw per sphere mesh");
+
+			GameTime gameTime;
+			camera.SetPosition(0.0f, 8.0f, 16.0f);
+			camera.ApplyRotation(rotate(mat4(), 30.0f, Vector3Helper::Left));
+			camera.Update(gameTime);
+
+			game.FrameData().SetCamera(&camera);
+			game.FrameData().SetAmbientLight(&ambientLight);
+			game.FrameData().SetLight(&light);
+			game.FrameData().Update(gameTime);
+
+			// Render off screen; a hidden window's default framebuffer need not own its pixels
+			GLuint colorBuffer;
+			glGenRenderbuffers(1, &colorBuffer);
+			glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, game.ScreenWidth(), game.ScreenHeight());
+
+			GLuint depthBuffer;
+			glGenRenderbuffers(1, &depthBuffer);
+			glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+			glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, game.ScreenWidth(), game.ScreenHeight());
+			glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+			GLuint frameBuffer;
+			glGenFramebuffers(1, &frameBuffer);
+			glBindFramebuffer(GL_FRAMEBUFFER, frameBuffer);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorBuffer);
+			glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depthBuffer);
+			context.Check(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "the off-screen framebuffer is complete");
+
+			std::vector<unsigned char> batchedPixels;
+			std::vector<unsigned char> unbatchedPixels;
+			std::vector<unsigned char> instancedPixels;
+
+			staticBatch.SetBatched(true);
+			Render(game, gameTime, staticBatch, batchedPixels);
+			context.Check(game.DrawQueue().ExecutedCount() == 1, "the batch draws with a single call");
+
+			staticBatch.SetBatched(false);
+			Render(game, gameTime, staticBatch, unbatchedPixels);
+			context.Check(game.DrawQueue().ExecutedCount() == staticBatch.DrawCount(), "unbatched, every sphere mesh is its own call");
+
+			Render(game, gameTime, instancedModel, instancedPixels);
+
+			UINT coveredPixelCount = CoveredPixelCount(batchedPixels);
+			UINT unbatchedMismatchCount = MismatchedPixelCount(batchedPixels, unbatchedPixels);
+			UINT instancedMismatchCount = MismatchedPixelCount(batchedPixels, instancedPixels);
+			printf("  %u spheres cover %u pixels; %u differ unbatched, %u differ instanced\n", sphereCount, coveredPixelCount, unbatchedMismatchCount, instancedMismatchCount);
+
+			context.Check(coveredPixelCount > 0, "the batch draws something");
+			context.Check(unbatchedMismatchCount == 0, "batched and unbatched draws produce the same image");
+
+			// The instanced vertex shader reads its transform from attributes rather than storage, so allow a few edge pixels to round differently
+			context.Check(instancedMismatchCount <= coveredPixelCount * InstancedMismatchTolerance, "the batch matches the instanced model drawing the same field");
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glDeleteFramebuffers(1, &frameBuffer);
+			glDeleteRenderbuffers(1, &depthBuffer);
+			glDeleteRenderbuffers(1, &colorBuffer);
+		}
+
+		game.Stop();
+	}
+}
\ No newline at end of file
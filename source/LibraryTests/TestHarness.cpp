@@ -0,0 +1,60 @@
+#include "TestHarness.h"
+#include <cstdio>
+
+namespace Tests
+{
+	Stopwatch::Stopwatch()
+		: mStartTime(), mFrequency(0.0)
+	{
+		LARGE_INTEGER frequency;
+		QueryPerformanceFrequency(&frequency);
+		mFrequency = static_cast<double>(frequency.QuadPart);
+
+		Restart();
+	}
+
+	void Stopwatch::Restart()
+	{
+		QueryPerformanceCounter(&mStartTime);
+	}
+
+	double Stopwatch::ElapsedMilliseconds() const
+	{
+		LARGE_INTEGER currentTime;
+		QueryPerformanceCounter(&currentTime);
+
+		return (currentTime.QuadPart - mStartTime.QuadPart) * 1000.0 / mFrequency;
+	}
+
+	TestContext::TestContext(const std::string& suiteName)
+		: mSuiteName(suiteName), mCheckCount(0), mFailureCount(0)
+	{
+	}
+
+	const std::string& TestContext::SuiteName() const
+	{
+		return mSuiteName;
+	}
+
+	UINT TestContext::CheckCount() const
+	{
+		return mCheckCount;
+	}
+
+	UINT TestContext::FailureCount() const
+	{
+		return mFailureCount;
+	}
+
+	bool TestContext::Check(bool condition, const std::string& message)
+	{
+		mCheckCount++;
+		if (condition == false)
+		{
+			mFailureCount++;
+			printf("  FAILED: %s\n", message.c_str());
+		}
+
+		return condition;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "Common.h"
+
+namespace Tests
+{
+	// Wall-clock timing for the benchmark suites
+	class Stopwatch
+	{
+	public:
+		Stopwatch();
+
+		void Restart();
+		double ElapsedMilliseconds() const;
+
+	private:
+		LARGE_INTEGER mStartTime;
+		double mFrequency;
+	};
+
+	// Counts the failed checks of one suite; each failure is printed as it happens
+	class TestContext
+	{
+	public:
+		TestContext(const std::string& suiteName);
+
+		const std::string& SuiteName() const;
+		UINT CheckCount() const;
+		UINT FailureCount() const;
+
+		bool Check(bool condition, const std::string& message);
+
+	private:
+		TestContext(const TestContext& rhs);
+		TestContext& operator=(const TestContext& rhs);
+
+		std::string mSuiteName;
+		UINT mCheckCount;
+		UINT mFailureCount;
+	};
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+
+namespace Tests
+{
+	class TestContext;
+
+	void RunSpatialIndexBenchmark(TestContext& context);
+	void RunOcclusionCullerTests(TestContext& context);
+	void RunMatrixHelperBenchmark(TestContext& context);
+	void RunAnimationCodecTests(TestContext& context);
+	void RunClusteredLightingTests(TestContext& context);
+	void RunCubemapLoaderTests(TestContext& context);
+	void RunStaticBatchTests(TestContext& context);
+	void RunAssetPackTests(TestContext& context);
+}
\ No newline at end of file